@@ -0,0 +1,445 @@
+package main
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"log/slog"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/chaz8081/gostt-writer/internal/audio"
+	"github.com/chaz8081/gostt-writer/internal/ble"
+	"github.com/chaz8081/gostt-writer/internal/config"
+	"github.com/chaz8081/gostt-writer/internal/inject"
+	"github.com/chaz8081/gostt-writer/internal/rewrite"
+	"github.com/chaz8081/gostt-writer/internal/transcribe"
+)
+
+// dictationQueueDepth bounds the utterances waiting at each pipeline stage.
+// Past it, submitting blocks until the stage catches up.
+const dictationQueueDepth = 4
+
+// batchDictation is the batch-mode path from hotkey release to injected text.
+// Each utterance is trimmed and split on the event loop, then passes through
+// three stages, each one goroutine connected by bounded FIFO queues:
+// transcribe, rewrite (when enabled) and inject. Utterance N+1 is recorded and
+// transcribed while N is still being rewritten or typed. Because every stage
+// handles one utterance at a time in arrival order, text is injected in the
+// order it was dictated, and the transcriber is never run concurrently.
+//
+// A streaming rewrite hands its utterance to the inject stage as soon as it
+// starts, so words are typed as the LLM generates them; the rewrite stage
+// moves on once generation ends, while the text may still be typing.
+type batchDictation struct {
+	sampleRate    int
+	vad           bool // split at the recorder's VAD segments
+	vadPadSamples int
+
+	transcriber transcribe.Transcriber
+	rewriter    *rewrite.Rewriter // nil when rewriting is disabled
+	stream      bool              // stream the rewrite into the injector
+	injector    inject.DeltaInjector
+
+	seq         int // utterances submitted
+	transcribeQ chan *utterance
+	rewriteQ    chan *utterance
+	injectQ     chan *utterance
+	wg          sync.WaitGroup
+	closeOnce   sync.Once
+}
+
+// utterance is one dictation moving through the pipeline.
+type utterance struct {
+	seq      int
+	chunks   [][]float32
+	released time.Time // when the recording was submitted
+	text     string
+	live     *liveRewrite // set when the rewrite streams; text is then the raw transcription
+}
+
+func newBatchDictation(cfg *config.Config, transcriber transcribe.Transcriber, rewriter *rewrite.Rewriter,
+	injector inject.DeltaInjector) *batchDictation {
+	return &batchDictation{
+		sampleRate:    int(cfg.Audio.SampleRate),
+		vad:           cfg.Audio.VAD.Enabled,
+		vadPadSamples: int(cfg.Audio.SampleRate) * cfg.Audio.VAD.PadMs / 1000,
+		transcriber:   transcriber,
+		rewriter:      rewriter,
+		stream:        streamRewrite(cfg),
+		injector:      injector,
+	}
+}
+
+// streamRewrite reports whether the LLM rewrite is typed as it is generated.
+// Pasting each word would churn the clipboard, so paste waits for the whole
+// rewrite.
+func streamRewrite(cfg *config.Config) bool {
+	return cfg.Rewrite.Stream && cfg.Inject.Method != "paste"
+}
+
+// start launches the pipeline stages. Call close to stop them.
+func (d *batchDictation) start() {
+	d.transcribeQ = make(chan *utterance, dictationQueueDepth)
+	d.rewriteQ = make(chan *utterance, dictationQueueDepth)
+	d.injectQ = make(chan *utterance, dictationQueueDepth)
+
+	d.wg.Add(3)
+	go d.stage(d.transcribeQ, d.rewriteQ, d.transcribe)
+	go d.stage(d.rewriteQ, d.injectQ, d.rewrite)
+	go d.stage(d.injectQ, nil, d.inject)
+}
+
+// close stops accepting utterances and waits until the queued ones have been
+// injected. The transcriber may be closed once it returns. Safe to call more
+// than once.
+func (d *batchDictation) close() {
+	d.closeOnce.Do(func() { close(d.transcribeQ) })
+	d.wg.Wait()
+}
+
+// submit queues chunks, as returned by prepare, for transcription and
+// injection. It only blocks when the transcribe queue is full.
+func (d *batchDictation) submit(chunks [][]float32) {
+	d.seq++
+	u := &utterance{seq: d.seq, chunks: chunks, released: time.Now()}
+	select {
+	case d.transcribeQ <- u:
+	default:
+		slog.Warn("Dictation pipeline full, waiting for earlier utterances",
+			"seq", u.seq, "queued", len(d.transcribeQ))
+		d.transcribeQ <- u
+	}
+}
+
+// stage runs fn on each utterance from in, in order, and passes it to out
+// when fn reports it should continue. out is closed once in is drained.
+func (d *batchDictation) stage(in <-chan *utterance, out chan<- *utterance, fn func(*utterance) bool) {
+	defer d.wg.Done()
+	if out != nil {
+		defer close(out)
+	}
+	for u := range in {
+		if fn(u) && out != nil {
+			out <- u
+		}
+	}
+}
+
+// prepare returns the chunks of a finished recording to transcribe, given the
+// speech the VAD found in it. Returns nil when the recording should be
+// skipped: no speech, or shorter than minRecordingDuration. Speech past
+// maxRecordingDuration is dropped.
+func (d *batchDictation) prepare(samples []float32, speech []audio.Segment) [][]float32 {
+	// Trim silence and split at pauses; without VAD the recording is
+	// transcribed as one chunk
+	chunks := [][]float32{samples}
+	if d.vad {
+		chunks = audio.SplitSpeech(samples, speech, d.vadPadSamples)
+		if len(chunks) == 0 {
+			slog.Info("No speech detected, skipping",
+				"duration_s", fmt.Sprintf("%.1f", float64(len(samples))/float64(d.sampleRate)))
+			return nil
+		}
+	}
+	var speechSamples int
+	for _, c := range chunks {
+		speechSamples += len(c)
+	}
+	duration := float64(speechSamples) / float64(d.sampleRate)
+
+	if duration < minRecordingDuration {
+		slog.Info("Recording too short, skipping",
+			"duration_s", fmt.Sprintf("%.1f", duration),
+			"min_s", minRecordingDuration)
+		return nil
+	}
+
+	if duration > maxRecordingDuration {
+		slog.Warn("Recording exceeds max duration, truncating",
+			"duration_s", fmt.Sprintf("%.1f", duration),
+			"max_s", maxRecordingDuration)
+		maxSamples := int(maxRecordingDuration * float64(d.sampleRate))
+		chunks = truncateChunks(chunks, maxSamples)
+		duration = maxRecordingDuration
+	}
+
+	slog.Info("Captured audio, transcribing...",
+		"duration_s", fmt.Sprintf("%.1f", duration))
+	return chunks
+}
+
+// transcribe fills in the utterance text. Failed or empty transcriptions
+// stop there.
+func (d *batchDictation) transcribe(u *utterance) bool {
+	start := time.Now()
+	text, err := transcribeChunks(d.transcriber, u.chunks)
+	u.chunks = nil
+	if err != nil {
+		slog.Error("Transcription failed", "seq", u.seq, "error", err)
+		return false
+	}
+
+	elapsed := time.Since(start).Round(time.Millisecond)
+
+	if text == "" {
+		slog.Info("No speech detected", "seq", u.seq, "elapsed", elapsed)
+		return false
+	}
+
+	slog.Info("Transcribed", "seq", u.seq, "elapsed", elapsed, "text", text)
+	u.text = text
+	return true
+}
+
+// rewrite replaces the text with the LLM rewrite when enabled, keeping the
+// raw transcription if the rewrite fails. A streaming rewrite passes the
+// utterance on itself before generating, and stops it here. Streaming
+// deletes text as the rewrite grows, so an injector that cannot edit is
+// sent the whole rewrite once instead.
+func (d *batchDictation) rewrite(u *utterance) bool {
+	if d.rewriter == nil {
+		return true
+	}
+	if d.stream && inject.CanEdit(d.injector) {
+		u.live = newLiveRewrite()
+		d.injectQ <- u
+		rewritten, err := d.rewriter.RewriteStream(context.Background(), u.text, func(prefix string) {
+			u.live.set(prefix, false)
+		})
+		if err != nil {
+			slog.Warn("LLM rewrite failed, using raw transcription", "seq", u.seq, "error", err)
+		}
+		u.live.set(rewritten, true)
+		return false
+	}
+	rewritten, err := d.rewriter.Rewrite(context.Background(), u.text)
+	if err != nil {
+		slog.Warn("LLM rewrite failed, using raw transcription", "seq", u.seq, "error", err)
+		return true
+	}
+	u.text = rewritten
+	return true
+}
+
+// inject types the text into the active application.
+func (d *batchDictation) inject(u *utterance) bool {
+	if u.live != nil {
+		return d.injectLive(u)
+	}
+	if err := d.injector.Inject(u.text); err != nil {
+		slog.Error("Text injection failed", "seq", u.seq, "error", err)
+		return false
+	}
+
+	slog.Info("Text injected", "seq", u.seq,
+		"latency", time.Since(u.released).Round(time.Millisecond))
+	return true
+}
+
+// injectLive types a streaming rewrite as it is generated, until the final
+// text is typed. A device found unable to edit once typing started gets
+// only what the final text adds to what it already typed.
+func (d *batchDictation) injectLive(u *utterance) bool {
+	live := liveText{inject: d.injector.InjectDelta}
+	var first time.Duration
+	for {
+		text, final := u.live.next()
+		if err := live.update(text, final); err != nil {
+			if errors.Is(err, ble.ErrEditUnsupported) {
+				return d.injectRest(u, live.typed, text, final)
+			}
+			slog.Error("Text injection failed", "seq", u.seq, "error", err)
+			return false
+		}
+		if first == 0 && live.typed != "" {
+			first = time.Since(u.released).Round(time.Millisecond)
+		}
+		if final {
+			break
+		}
+	}
+
+	slog.Info("Text injected", "seq", u.seq, "first_latency", first,
+		"latency", time.Since(u.released).Round(time.Millisecond))
+	return true
+}
+
+// injectRest waits for the final text of a streaming rewrite and appends
+// what it adds to typed, which cannot be deleted.
+func (d *batchDictation) injectRest(u *utterance, typed, text string, final bool) bool {
+	slog.Warn("Device cannot apply streaming corrections, typing the rewrite when it completes", "seq", u.seq)
+	for !final {
+		text, final = u.live.next()
+	}
+	backspaces, appendText := transcribe.ComputeDelta(typed, text)
+	if backspaces > 0 {
+		slog.Warn("Streamed text diverged from the final rewrite", "seq", u.seq, "stale_chars", backspaces)
+	}
+	if err := d.injector.Inject(appendText); err != nil {
+		slog.Error("Text injection failed", "seq", u.seq, "error", err)
+		return false
+	}
+
+	slog.Info("Text injected", "seq", u.seq,
+		"latency", time.Since(u.released).Round(time.Millisecond))
+	return true
+}
+
+// liveRewrite hands the text of a streaming rewrite from the rewrite stage
+// to the inject stage. Only the latest text is kept, so an injector that
+// falls behind skips to it instead of typing every intermediate prefix, and
+// the rewrite never waits for typing.
+type liveRewrite struct {
+	mu      sync.Mutex
+	text    string
+	final   bool
+	changed chan struct{} // signalled, without blocking, on every set
+}
+
+func newLiveRewrite() *liveRewrite {
+	return &liveRewrite{changed: make(chan struct{}, 1)}
+}
+
+// set replaces the text; final marks the complete rewrite, after which set
+// must not be called again.
+func (l *liveRewrite) set(text string, final bool) {
+	l.mu.Lock()
+	l.text, l.final = text, final
+	l.mu.Unlock()
+	select {
+	case l.changed <- struct{}{}:
+	default:
+	}
+}
+
+// next waits for a set since the last call and returns the latest text.
+func (l *liveRewrite) next() (text string, final bool) {
+	<-l.changed
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	return l.text, l.final
+}
+
+// liveText is text typed while it is still being generated, edited with
+// streaming deltas as newer versions arrive.
+type liveText struct {
+	typed  string
+	inject func(backspaces int, text string) error
+	err    error
+}
+
+// update edits the typed text into text. Until final, text the typed text
+// already starts with is left alone, so a shorter version never deletes
+// what the next may need again. After a failed injection what is on screen
+// is unknown, so update only returns that error.
+func (l *liveText) update(text string, final bool) error {
+	if l.err != nil {
+		return l.err
+	}
+	if !final && strings.HasPrefix(l.typed, text) {
+		return nil
+	}
+	backspaces, appendText := transcribe.ComputeDelta(l.typed, text)
+	if backspaces == 0 && appendText == "" {
+		return nil
+	}
+	if err := l.inject(backspaces, appendText); err != nil {
+		l.err = err
+		return err
+	}
+	l.typed = text
+	return nil
+}
+
+// streamedText types the deltas of a streaming transcription as they arrive.
+// A device that cannot apply corrections (BLE firmware without edit support)
+// rejects the first one with ble.ErrEditUnsupported. The streamer has moved
+// on by then, so later deltas would garble the text: live typing stops, and
+// finish types what the final transcript adds to the text on screen, once.
+type streamedText struct {
+	inject func(backspaces int, text string) error
+
+	mu         sync.Mutex
+	typed      string // text the applied deltas left on screen
+	appendOnly bool   // a correction was rejected; live typing stopped
+}
+
+// delta applies one streamer delta. It is the streamer's DeltaFunc.
+func (s *streamedText) delta(backspaces int, text string) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if s.appendOnly {
+		return
+	}
+	if err := s.inject(backspaces, text); err != nil {
+		if errors.Is(err, ble.ErrEditUnsupported) {
+			slog.Warn("Device cannot apply streaming corrections, typing the transcript when recording stops")
+			s.appendOnly = true
+			return
+		}
+		slog.Error("Streaming injection failed", "error", err)
+		return
+	}
+	typed := []rune(s.typed)
+	s.typed = string(typed[:max(len(typed)-backspaces, 0)]) + text
+}
+
+// finish types the rest of final after live typing stopped, and returns the
+// text on screen. Text already typed cannot be deleted, so if it diverged
+// from final only the part after their common prefix is added.
+func (s *streamedText) finish(final string) string {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if !s.appendOnly {
+		return s.typed
+	}
+	backspaces, appendText := transcribe.ComputeDelta(s.typed, final)
+	if backspaces > 0 {
+		slog.Warn("Streamed text diverged from the final transcript", "stale_chars", backspaces)
+	}
+	if err := s.inject(0, appendText); err != nil {
+		slog.Error("Text injection failed", "error", err)
+		return s.typed
+	}
+	s.typed += appendText
+	return s.typed
+}
+
+// editable reports whether the device applied every correction, so the
+// typed text can still be edited, e.g. into an LLM rewrite.
+func (s *streamedText) editable() bool {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	return !s.appendOnly
+}
+
+// transcribeChunks transcribes each speech chunk and joins the non-empty texts.
+func transcribeChunks(t transcribe.Transcriber, chunks [][]float32) (string, error) {
+	var texts []string
+	for _, chunk := range chunks {
+		text, err := t.Process(chunk)
+		if err != nil {
+			return "", err
+		}
+		if text != "" {
+			texts = append(texts, text)
+		}
+	}
+	return strings.Join(texts, " "), nil
+}
+
+// truncateChunks keeps the first maxSamples samples across chunks.
+func truncateChunks(chunks [][]float32, maxSamples int) [][]float32 {
+	for i, chunk := range chunks {
+		if maxSamples == 0 {
+			return chunks[:i]
+		}
+		if len(chunk) >= maxSamples {
+			return append(chunks[:i:i], chunk[:maxSamples])
+		}
+		maxSamples -= len(chunk)
+	}
+	return chunks
+}
@@ -0,0 +1,611 @@
+package main
+
+import (
+	"encoding/json"
+	"errors"
+	"flag"
+	"fmt"
+	"io"
+	"io/fs"
+	"log/slog"
+	"net/http"
+	"net/http/httptest"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+	"time"
+
+	"github.com/chaz8081/gostt-writer/internal/audio"
+	"github.com/chaz8081/gostt-writer/internal/benchreport"
+	"github.com/chaz8081/gostt-writer/internal/ble"
+	"github.com/chaz8081/gostt-writer/internal/config"
+	"github.com/chaz8081/gostt-writer/internal/inject"
+	"github.com/chaz8081/gostt-writer/internal/rewrite"
+	"github.com/chaz8081/gostt-writer/internal/transcribe"
+)
+
+var benchReportPath = flag.String("bench-report", "", "write the end-to-end benchmark results as JSON to this file")
+
+// benchReport collects the end-to-end benchmark results for -bench-report.
+var benchReport = benchreport.New()
+
+func TestMain(m *testing.M) {
+	flag.Parse()
+	// The dictation path logs every utterance; keep benchmark output readable
+	slog.SetDefault(slog.New(slog.NewTextHandler(io.Discard, nil)))
+
+	code := m.Run()
+	if *benchReportPath != "" && benchReport.Len() > 0 {
+		if err := benchReport.WriteFile(*benchReportPath); err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			if code == 0 {
+				code = 1
+			}
+		}
+	}
+	os.Exit(code)
+}
+
+// fakeTranscriber returns the length of each chunk as its text, and reports
+// each call on processed when set.
+type fakeTranscriber struct {
+	processed chan int
+}
+
+func (f *fakeTranscriber) Process(samples []float32) (string, error) {
+	if f.processed != nil {
+		f.processed <- len(samples)
+	}
+	if len(samples) == 0 {
+		return "", nil
+	}
+	return fmt.Sprint(len(samples)), nil
+}
+
+func (f *fakeTranscriber) Close() error { return nil }
+
+// recordingInjector is a DeltaInjector that reports each text it is sent, and
+// when. With release set, each injection blocks until release receives.
+type recordingInjector struct {
+	injected chan injection
+	release  chan struct{}
+}
+
+type injection struct {
+	backspaces int // InjectDelta only
+	text       string
+	at         time.Time
+}
+
+func newRecordingInjector() *recordingInjector {
+	return &recordingInjector{injected: make(chan injection, 16)}
+}
+
+func (r *recordingInjector) Inject(text string) error {
+	r.injected <- injection{text: text, at: time.Now()}
+	if r.release != nil {
+		<-r.release
+	}
+	return nil
+}
+
+func (r *recordingInjector) InjectDelta(backspaces int, text string) error {
+	r.injected <- injection{backspaces: backspaces, text: text, at: time.Now()}
+	if r.release != nil {
+		<-r.release
+	}
+	return nil
+}
+
+func newTestDictation(vad bool, t transcribe.Transcriber, inj inject.DeltaInjector) *batchDictation {
+	cfg := config.Default()
+	cfg.Audio.VAD.Enabled = vad
+	return newBatchDictation(cfg, t, nil, inj)
+}
+
+func TestBatchDictationPrepare(t *testing.T) {
+	const rate = 16000
+	d := newTestDictation(false, &fakeTranscriber{}, newRecordingInjector())
+
+	if chunks := d.prepare(make([]float32, rate/4), nil); chunks != nil {
+		t.Errorf("prepare(250ms) = %d chunks, want nil (too short)", len(chunks))
+	}
+	if chunks := d.prepare(make([]float32, rate), nil); len(chunks) != 1 || len(chunks[0]) != rate {
+		t.Errorf("prepare(1s) without VAD = %d chunks, want the whole recording", len(chunks))
+	}
+
+	long := make([]float32, int(maxRecordingDuration+10)*rate)
+	chunks := d.prepare(long, nil)
+	if len(chunks) != 1 || len(chunks[0]) != int(maxRecordingDuration)*rate {
+		t.Errorf("prepare(%.0fs) did not truncate to %.0fs", maxRecordingDuration+10, maxRecordingDuration)
+	}
+}
+
+func TestBatchDictationPrepareVAD(t *testing.T) {
+	const rate = 16000
+	d := newTestDictation(true, &fakeTranscriber{}, newRecordingInjector())
+	samples := make([]float32, 10*rate)
+
+	if chunks := d.prepare(samples, nil); chunks != nil {
+		t.Errorf("prepare() with no speech = %d chunks, want nil", len(chunks))
+	}
+
+	speech := []audio.Segment{{Start: 1 * rate, End: 2 * rate}, {Start: 6 * rate, End: 7 * rate}}
+	chunks := d.prepare(samples, speech)
+	if len(chunks) != 2 {
+		t.Fatalf("prepare() = %d chunks, want one per segment", len(chunks))
+	}
+	if want := rate + 2*d.vadPadSamples; len(chunks[0]) != want {
+		t.Errorf("chunk 0 = %d samples, want %d (segment plus padding)", len(chunks[0]), want)
+	}
+}
+
+// utteranceChunks returns one chunk per length; the fake transcriber's text
+// for it is the length.
+func utteranceChunks(lengths ...int) [][]float32 {
+	chunks := make([][]float32, len(lengths))
+	for i, n := range lengths {
+		chunks[i] = make([]float32, n)
+	}
+	return chunks
+}
+
+func TestBatchDictationInOrder(t *testing.T) {
+	inj := newRecordingInjector()
+	d := newTestDictation(false, &fakeTranscriber{}, inj)
+	d.start()
+
+	d.submit(utteranceChunks(1, 2))
+	d.submit(utteranceChunks(0)) // no speech: dropped
+	d.submit(utteranceChunks(3))
+	d.submit(utteranceChunks(4))
+	d.close()
+	close(inj.injected)
+
+	var got []string
+	for in := range inj.injected {
+		got = append(got, in.text)
+	}
+	if want := []string{"1 2", "3", "4"}; fmt.Sprint(got) != fmt.Sprint(want) {
+		t.Errorf("injected %q, want %q", got, want)
+	}
+}
+
+func TestBatchDictationOverlapsInjection(t *testing.T) {
+	tr := &fakeTranscriber{processed: make(chan int, 16)}
+	inj := newRecordingInjector()
+	inj.release = make(chan struct{})
+	d := newTestDictation(false, tr, inj)
+	d.start()
+	defer d.close()
+
+	d.submit(utteranceChunks(1))
+	if in := <-inj.injected; in.text != "1" {
+		t.Fatalf("first injection = %q, want %q", in.text, "1")
+	}
+
+	// The injector is still busy with the first utterance; the second must
+	// be transcribed meanwhile
+	d.submit(utteranceChunks(2))
+	<-tr.processed // first utterance
+	select {
+	case <-tr.processed:
+	case <-time.After(5 * time.Second):
+		t.Fatal("second utterance not transcribed while the first was being injected")
+	}
+
+	inj.release <- struct{}{}
+	if in := <-inj.injected; in.text != "2" {
+		t.Errorf("second injection = %q, want %q", in.text, "2")
+	}
+	inj.release <- struct{}{}
+}
+
+func TestBatchDictationCloseDrains(t *testing.T) {
+	inj := newRecordingInjector()
+	d := newTestDictation(false, &fakeTranscriber{}, inj)
+	d.start()
+	for i := 1; i <= dictationQueueDepth*2; i++ {
+		d.submit(utteranceChunks(i))
+	}
+	d.close()
+	d.close() // idempotent
+
+	if got := len(inj.injected); got != dictationQueueDepth*2 {
+		t.Errorf("%d utterances injected before close returned, want %d", got, dictationQueueDepth*2)
+	}
+}
+
+// ollamaServer serves streaming Ollama chat responses: the rewrite of the
+// user message, one chunk per word, then done. Each chunk waits for next to
+// receive when it is set.
+func ollamaServer(t *testing.T, rewrite func(raw string) string, next chan struct{}) *httptest.Server {
+	t.Helper()
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		var req struct {
+			Messages []struct{ Content string }
+		}
+		if err := json.NewDecoder(r.Body).Decode(&req); err != nil || len(req.Messages) != 2 {
+			t.Errorf("bad chat request: %v", err)
+			return
+		}
+		enc := json.NewEncoder(w)
+		for i, word := range strings.Fields(rewrite(req.Messages[1].Content)) {
+			if next != nil {
+				<-next
+			}
+			if i > 0 {
+				word = " " + word
+			}
+			enc.Encode(map[string]any{"message": map[string]string{"role": "assistant", "content": word}})
+			w.(http.Flusher).Flush()
+		}
+		enc.Encode(map[string]any{"done": true})
+	}))
+	t.Cleanup(srv.Close)
+	return srv
+}
+
+func newRewriteDictation(url string, inj inject.DeltaInjector) *batchDictation {
+	cfg := config.Default()
+	cfg.Rewrite = config.RewriteConfig{Enabled: true, OllamaURL: url, Model: "test", Prompt: "Clean up.",
+		TimeoutSecs: 10, Stream: true}
+	return newBatchDictation(cfg, &fakeTranscriber{}, rewrite.New(&cfg.Rewrite), inj)
+}
+
+// screen returns the text the injections leave on screen, applied in order.
+func screen(injections []injection) string {
+	var typed []rune
+	for _, in := range injections {
+		typed = append(typed[:len(typed)-min(in.backspaces, len(typed))], []rune(in.text)...)
+	}
+	return string(typed)
+}
+
+// drain closes the dictation and returns what it injected.
+func drain(d *batchDictation, inj *recordingInjector) []injection {
+	d.close()
+	close(inj.injected)
+	var got []injection
+	for in := range inj.injected {
+		got = append(got, in)
+	}
+	return got
+}
+
+func TestBatchDictationStreamsRewrite(t *testing.T) {
+	next := make(chan struct{})
+	srv := ollamaServer(t, func(string) string { return "Hello there world." }, next)
+	inj := newRecordingInjector()
+	d := newRewriteDictation(srv.URL, inj)
+	d.start()
+
+	d.submit(utteranceChunks(1))
+	next <- struct{}{}
+	next <- struct{}{}
+	// The first word is typed while the rest is still being generated
+	var got []injection
+	select {
+	case in := <-inj.injected:
+		if in.backspaces != 0 || in.text != "Hello" {
+			t.Errorf("first injection = (%d, %q), want (0, %q)", in.backspaces, in.text, "Hello")
+		}
+		got = append(got, in)
+	case <-time.After(5 * time.Second):
+		t.Fatal("no text injected while the rewrite was generated")
+	}
+	next <- struct{}{}
+
+	got = append(got, drain(d, inj)...)
+	if s := screen(got); s != "Hello there world." {
+		t.Errorf("typed %q, want %q", s, "Hello there world.")
+	}
+	for _, in := range got {
+		if in.backspaces != 0 {
+			t.Errorf("injections %+v delete text, want appends only", got)
+			break
+		}
+	}
+}
+
+func TestBatchDictationStreamedRewriteFailure(t *testing.T) {
+	// The stream ends without done: whatever was typed of the rewrite is
+	// replaced by the raw transcription
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		json.NewEncoder(w).Encode(map[string]any{"message": map[string]string{"content": "Partial text"}})
+	}))
+	defer srv.Close()
+	inj := newRecordingInjector()
+	d := newRewriteDictation(srv.URL, inj)
+	d.start()
+	d.submit(utteranceChunks(12))
+
+	if s := screen(drain(d, inj)); s != "12" {
+		t.Errorf("typed %q, want the raw transcription %q", s, "12")
+	}
+}
+
+func TestBatchDictationStreamedRewriteInOrder(t *testing.T) {
+	srv := ollamaServer(t, func(raw string) string { return "Rewritten " + raw + "." }, nil)
+	inj := newRecordingInjector()
+	d := newRewriteDictation(srv.URL, inj)
+	d.start()
+
+	d.submit(utteranceChunks(1))
+	d.submit(utteranceChunks(2))
+	d.submit(utteranceChunks(3))
+	if s := screen(drain(d, inj)); s != "Rewritten 1.Rewritten 2.Rewritten 3." {
+		t.Errorf("typed %q, want %q", s, "Rewritten 1.Rewritten 2.Rewritten 3.")
+	}
+}
+
+// uneditableInjector is a recordingInjector for a device that cannot
+// delete: it rejects deltas with backspaces. With known unset it only finds
+// out on the first one, like firmware whose link params arrive late.
+type uneditableInjector struct {
+	*recordingInjector
+	known bool
+}
+
+func (u uneditableInjector) CanEdit() bool { return !u.known }
+
+func (u uneditableInjector) InjectDelta(backspaces int, text string) error {
+	if backspaces > 0 {
+		return ble.ErrEditUnsupported
+	}
+	return u.recordingInjector.InjectDelta(backspaces, text)
+}
+
+func TestBatchDictationRewriteWithoutEdits(t *testing.T) {
+	// An injector that cannot edit gets the whole rewrite at once
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		json.NewEncoder(w).Encode(map[string]any{"message": map[string]string{"content": "Hello there world."}})
+	}))
+	defer srv.Close()
+	inj := newRecordingInjector()
+	d := newRewriteDictation(srv.URL, uneditableInjector{inj, true})
+	d.start()
+	d.submit(utteranceChunks(1))
+
+	got := drain(d, inj)
+	if len(got) != 1 || got[0].text != "Hello there world." {
+		t.Errorf("injections %+v, want the rewrite once", got)
+	}
+}
+
+func TestBatchDictationStreamedRewriteLosesEdits(t *testing.T) {
+	// The device rejects the correction to the raw transcription: typing
+	// stops deleting, and only appends what the final text adds
+	typed := make(chan struct{})
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		json.NewEncoder(w).Encode(map[string]any{"message": map[string]string{"content": "1 partial text"}})
+		w.(http.Flusher).Flush()
+		<-typed
+	}))
+	defer srv.Close()
+	inj := newRecordingInjector()
+	d := newRewriteDictation(srv.URL, uneditableInjector{inj, false})
+	d.start()
+	d.submit(utteranceChunks(12))
+
+	got := []injection{<-inj.injected}
+	close(typed)
+	got = append(got, drain(d, inj)...)
+	if s := screen(got); s != "1 partial2" {
+		t.Errorf("typed %q, want %q", s, "1 partial2")
+	}
+	for _, in := range got {
+		if in.backspaces != 0 {
+			t.Errorf("injections %+v delete text, want appends only", got)
+			break
+		}
+	}
+}
+
+func TestLiveText(t *testing.T) {
+	var got []string
+	live := liveText{typed: "hello world", inject: func(backspaces int, text string) error {
+		got = append(got, fmt.Sprintf("%d:%s", backspaces, text))
+		return nil
+	}}
+	for _, u := range []struct {
+		text  string
+		final bool
+	}{
+		{"hello", false},        // already typed: left alone
+		{"Hello", false},        // diverges: edited
+		{"Hello,", false},       // appended
+		{"Hello, world.", true}, // final
+		{"Hello, world.", true}, // unchanged: nothing to inject
+	} {
+		if err := live.update(u.text, u.final); err != nil {
+			t.Fatalf("update(%q) error = %v", u.text, err)
+		}
+	}
+	if want := []string{"11:Hello", "0:,", "0: world."}; fmt.Sprint(got) != fmt.Sprint(want) {
+		t.Errorf("edits %q, want %q", got, want)
+	}
+
+	failed := errors.New("injector gone")
+	live = liveText{inject: func(int, string) error { return failed }}
+	if err := live.update("a", false); err != failed {
+		t.Fatalf("update() error = %v, want %v", err, failed)
+	}
+	live.inject = func(int, string) error { t.Error("injected after a failure"); return nil }
+	if err := live.update("a b", true); err != failed {
+		t.Errorf("update() after failure error = %v, want %v", err, failed)
+	}
+}
+
+func TestStreamedText(t *testing.T) {
+	var got []string
+	record := func(backspaces int, text string) error {
+		got = append(got, fmt.Sprintf("%d:%s", backspaces, text))
+		return nil
+	}
+	s := streamedText{inject: record}
+	s.delta(0, "hello wor")
+	s.delta(3, "world")
+	if text := s.finish("hello world"); text != "hello world" || !s.editable() {
+		t.Errorf("finish() = %q, editable %v; want %q, true", text, s.editable(), "hello world")
+	}
+	if want := []string{"0:hello wor", "3:world"}; fmt.Sprint(got) != fmt.Sprint(want) {
+		t.Errorf("edits %q, want %q", got, want)
+	}
+
+	// Firmware without edits rejects the first correction: nothing more is
+	// typed live, and finish appends the rest of the final text once
+	got = nil
+	s = streamedText{inject: func(backspaces int, text string) error {
+		if backspaces > 0 {
+			return fmt.Errorf("send: %w", ble.ErrEditUnsupported)
+		}
+		return record(backspaces, text)
+	}}
+	s.delta(0, "hello wor")
+	s.delta(3, "world")
+	s.delta(0, " and")
+	if s.editable() {
+		t.Error("editable() = true after a rejected correction")
+	}
+	if text := s.finish("hello world and more"); text != "hello world and more" {
+		t.Errorf("finish() = %q, want %q", text, "hello world and more")
+	}
+	if want := []string{"0:hello wor", "0:ld and more"}; fmt.Sprint(got) != fmt.Sprint(want) {
+		t.Errorf("edits %q, want %q", got, want)
+	}
+}
+
+func TestTruncateChunks(t *testing.T) {
+	chunks := [][]float32{make([]float32, 5), make([]float32, 5), make([]float32, 5)}
+	tests := []struct {
+		max  int
+		want []int
+	}{
+		{20, []int{5, 5, 5}},
+		{12, []int{5, 5, 2}},
+		{10, []int{5, 5}},
+		{3, []int{3}},
+	}
+	for _, tt := range tests {
+		got := truncateChunks(chunks, tt.max)
+		var lens []int
+		for _, c := range got {
+			lens = append(lens, len(c))
+		}
+		if fmt.Sprint(lens) != fmt.Sprint(tt.want) {
+			t.Errorf("truncateChunks(max=%d) lengths = %v, want %v", tt.max, lens, tt.want)
+		}
+	}
+}
+
+// stageTimed is a transcriber whose pipeline stages can be timed.
+type stageTimed interface {
+	SetStageTimer(t *transcribe.StageTimer)
+}
+
+// BenchmarkDictationEndToEnd measures batch dictation from hotkey release
+// (the recording is available) until the text reaches the injector, for each
+// backend whose models are installed. VAD segments are computed up front, as
+// the recorder does during capture.
+func BenchmarkDictationEndToEnd(b *testing.B) {
+	samples, err := benchreport.LoadSamples(filepath.Join("..", "..", "internal", "transcribe", "testdata"))
+	if errors.Is(err, fs.ErrNotExist) {
+		b.Skipf("benchmark audio not found: %v", err)
+	}
+	if err != nil {
+		b.Fatalf("load samples: %v", err)
+	}
+
+	backends := []struct {
+		name  string
+		cfg   config.TranscribeConfig
+		check string
+	}{
+		{"whisper", config.TranscribeConfig{Backend: "whisper", ModelPath: filepath.Join("..", "..", "models", "ggml-base.en.bin")},
+			filepath.Join("..", "..", "models", "ggml-base.en.bin")},
+		{"parakeet", config.TranscribeConfig{Backend: "parakeet", ParakeetModelDir: filepath.Join("..", "..", "models", "parakeet-tdt-v2")},
+			filepath.Join("..", "..", "models", "parakeet-tdt-v2", "Encoder.mlmodelc")},
+	}
+	for _, be := range backends {
+		be := be // capture
+		b.Run(be.name, func(b *testing.B) {
+			if _, err := os.Stat(be.check); err != nil {
+				b.Skipf("%s model not found at %s", be.name, be.check)
+			}
+			tr, err := transcribe.New(&be.cfg)
+			if err != nil {
+				b.Fatalf("transcribe.New: %v", err)
+			}
+			defer func() { _ = tr.Close() }()
+
+			for _, vad := range []bool{false, true} {
+				for _, s := range samples {
+					name := s.Label
+					if vad {
+						name += "-vad"
+					}
+					s := s // capture
+					b.Run(name, func(b *testing.B) {
+						benchmarkDictation(b, be.name+"/"+name, tr, vad, s)
+					})
+				}
+			}
+		})
+	}
+}
+
+func benchmarkDictation(b *testing.B, name string, tr transcribe.Transcriber, vad bool, s benchreport.Sample) {
+	inj := newRecordingInjector()
+	d := newTestDictation(vad, tr, inj)
+	d.start()
+	defer d.close()
+
+	var speech []audio.Segment
+	if vad {
+		v := audio.NewVAD(d.sampleRate, config.Default().Audio.VAD.ThresholdDB, config.Default().Audio.VAD.PauseMs)
+		v.Write(s.Audio)
+		speech = v.Segments()
+	}
+
+	timer := transcribe.NewStageTimer()
+	if st, ok := tr.(stageTimed); ok {
+		st.SetStageTimer(timer)
+		defer st.SetStageTimer(nil)
+	}
+
+	// Warm up: single run outside the loop
+	chunks := d.prepare(s.Audio, speech)
+	if chunks == nil {
+		b.Skipf("%s: no speech to transcribe", name)
+	}
+	d.submit(chunks)
+	<-inj.injected
+
+	rec := benchreport.NewRecorder(name, s.Duration())
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		b.StopTimer()
+		timer.Reset()
+		rec.Begin()
+		b.StartTimer()
+
+		release := time.Now()
+		d.submit(d.prepare(s.Audio, speech))
+		in := <-inj.injected
+
+		b.StopTimer()
+		rec.End(in.at.Sub(release), timer.Totals())
+		b.StartTimer()
+	}
+	b.StopTimer()
+
+	e := rec.Entry(nil)
+	benchReport.Add(e)
+	b.ReportMetric(s.DurationS*1000, "audio-ms")
+	b.ReportMetric(e.Total.P50, "p50-ms")
+	b.ReportMetric(e.Total.P99, "p99-ms")
+	b.ReportMetric(e.RTF, "rtf")
+	b.ReportMetric(e.AllocsPerOp, "allocs/run")
+}
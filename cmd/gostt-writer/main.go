@@ -88,20 +88,24 @@ func main() {
 	}
 	slog.Info("Model loaded", "backend", cfg.Transcribe.Backend, "elapsed", time.Since(modelStart).Round(time.Millisecond))
 
-	// Initialize streaming transcriber if enabled (whisper only)
-	var streamer *transcribe.StreamingTranscriber
+	// Initialize streaming transcriber if enabled
+	var streamer transcribe.Streamer
 	if cfg.Transcribe.Streaming.Enabled {
-		wt, ok := transcriber.(*transcribe.WhisperTranscriber)
-		if !ok {
-			slog.Error("Streaming requires whisper backend")
+		sc := cfg.Transcribe.Streaming
+		switch t := transcriber.(type) {
+		case *transcribe.WhisperTranscriber:
+			streamer = transcribe.NewStreamingTranscriber(t.Model(), sc.StepMs, sc.LengthMs, sc.KeepMs, sc.Incremental)
+		case *transcribe.ParakeetTranscriber:
+			streamer = transcribe.NewParakeetStreamingTranscriber(t, sc.StepMs, sc.LengthMs, sc.KeepMs)
+		default:
+			slog.Error("Streaming is not supported by this backend", "backend", cfg.Transcribe.Backend)
 			os.Exit(1)
 		}
-		sc := cfg.Transcribe.Streaming
-		streamer = transcribe.NewStreamingTranscriber(wt.Model(), sc.StepMs, sc.LengthMs, sc.KeepMs)
 		slog.Info("Streaming transcription enabled",
 			"step_ms", sc.StepMs,
 			"length_ms", sc.LengthMs,
-			"keep_ms", sc.KeepMs)
+			"keep_ms", sc.KeepMs,
+			"incremental", sc.Incremental)
 	}
 
 	// Initialize audio recorder
@@ -117,8 +121,21 @@ func main() {
 	}
 	slog.Info("Audio recorder ready")
 
-	// Initialize text injector
-	var injector inject.TextInjector
+	// Attach voice activity detection if enabled
+	if vc := cfg.Audio.VAD; vc.Enabled {
+		recorder.SetVAD(audio.NewVAD(int(cfg.Audio.SampleRate), vc.ThresholdDB, vc.PauseMs))
+		if streamer != nil {
+			streamer.SetActivity(recorder.SpeechSince)
+		}
+		slog.Info("Voice activity detection enabled",
+			"threshold_db", vc.ThresholdDB,
+			"pause_ms", vc.PauseMs,
+			"pad_ms", vc.PadMs)
+	}
+
+	// Initialize text injector. Every method also applies streaming
+	// corrections: locally as key taps, over BLE as edits the ESP32 types.
+	var injector inject.DeltaInjector
 	switch cfg.Inject.Method {
 	case "ble":
 		key, err := hex.DecodeString(cfg.Inject.BLE.SharedSecret)
@@ -152,9 +169,15 @@ func main() {
 	var rewriting atomic.Bool
 	if cfg.Rewrite.Enabled {
 		rewriter = rewrite.New(&cfg.Rewrite)
-		slog.Info("LLM rewrite enabled", "model", cfg.Rewrite.Model)
+		warmRewriter(rewriter)
+		slog.Info("LLM rewrite enabled", "model", cfg.Rewrite.Model, "stream", streamRewrite(cfg))
 	}
 
+	// Batch-mode pipeline: transcribe, rewrite and inject utterances in
+	// dictation order while the next one is recorded
+	dictation := newBatchDictation(cfg, transcriber, rewriter, injector)
+	dictation.start()
+
 	// Initialize hotkey listener
 	listener := hotkey.NewListener(cfg.Hotkey.Keys, cfg.Hotkey.Mode)
 	slog.Info("Hotkey listener ready",
@@ -178,6 +201,7 @@ func main() {
 	// inside hook_run(), which skips the dispatch_sync_f path entirely.
 	go func() {
 		events := listener.Events()
+		var streamTyping *streamedText // the recording's streamed typing in streaming mode
 		for {
 			select {
 			case ev, ok := <-events:
@@ -187,6 +211,7 @@ func main() {
 					if err := recorder.Close(); err != nil {
 						slog.Error("failed to close recorder", "error", err)
 					}
+					dictation.close()
 					if err := transcriber.Close(); err != nil {
 						slog.Error("failed to close transcriber", "error", err)
 					}
@@ -204,112 +229,74 @@ func main() {
 						continue
 					}
 					slog.Info("Recording...")
+					if rewriter != nil {
+						warmRewriter(rewriter)
+					}
 
 					// Start streaming transcription if enabled
 					if streamer != nil {
-						localInjector := injector.(*inject.Injector)
-						streamer.Start(
-							recorder.Snapshot,
-							func(backspaces int, newText string) {
-								if err := localInjector.InjectDelta(backspaces, newText); err != nil {
-									slog.Error("Streaming injection failed", "error", err)
-								}
-							},
-						)
+						streamTyping = &streamedText{inject: injector.InjectDelta}
+						streamer.Start(recorder.ReadFrom, streamTyping.delta)
 					}
 
 				case hotkey.EventStop:
 					if streamer != nil {
+						if streamTyping == nil {
+							continue // the recording never started
+						}
 						// Streaming mode: stop streamer first (does final transcription),
 						// then stop recording
 						streamer.Stop()
 						recorder.Stop()
+						finalText := streamTyping.finish(streamer.FinalText())
+						editable := streamTyping.editable()
+						streamTyping = nil
 						slog.Info("Streaming transcription complete")
 
-						// LLM rewrite: backspace raw text and replace with rewritten
-						if rewriter != nil {
-							finalText := streamer.FinalText()
+						// LLM rewrite: edit the raw text into the rewrite, as it
+						// is generated when streaming
+						if rewriter != nil && !editable {
+							slog.Warn("Device cannot apply edits, keeping raw text instead of the LLM rewrite")
+						} else if rewriter != nil {
 							if finalText != "" {
-								localInjector := injector.(*inject.Injector)
 								go func() {
 									rewriting.Store(true)
 									defer rewriting.Store(false)
-									rewritten, rwErr := rewriter.Rewrite(context.Background(), finalText)
+									live := liveText{typed: finalText, inject: injector.InjectDelta}
+									var rewritten string
+									var rwErr error
+									if streamRewrite(cfg) {
+										// A failed edit is reported by the final update
+										rewritten, rwErr = rewriter.RewriteStream(context.Background(), finalText, func(prefix string) {
+											_ = live.update(prefix, false)
+										})
+									} else {
+										rewritten, rwErr = rewriter.Rewrite(context.Background(), finalText)
+									}
 									if rwErr != nil {
+										// rewritten is the raw text, restoring what a
+										// streamed rewrite replaced
 										slog.Warn("LLM rewrite failed, keeping raw text", "error", rwErr)
-										return
 									}
-									// Backspace all raw text and type rewritten version
-									if err := localInjector.InjectDelta(len([]rune(finalText)), rewritten); err != nil {
+									if err := live.update(rewritten, true); err != nil {
 										slog.Error("Rewrite injection failed", "error", err)
 									}
 								}()
 							}
 						}
 					} else {
-						// Batch mode: stop recording, transcribe all audio, inject
+						// Batch mode: stop recording and queue the audio for
+						// transcription and injection
 						samples := recorder.Stop()
 						if samples == nil {
 							continue
 						}
 
-						duration := float64(len(samples)) / float64(cfg.Audio.SampleRate)
-
-						if duration < minRecordingDuration {
-							slog.Info("Recording too short, skipping",
-								"duration_s", fmt.Sprintf("%.1f", duration),
-								"min_s", minRecordingDuration)
+						chunks := dictation.prepare(samples, recorder.Speech())
+						if chunks == nil {
 							continue
 						}
-
-						if duration > maxRecordingDuration {
-							slog.Warn("Recording exceeds max duration, truncating",
-								"duration_s", fmt.Sprintf("%.1f", duration),
-								"max_s", maxRecordingDuration)
-							maxSamples := int(maxRecordingDuration * float64(cfg.Audio.SampleRate))
-							samples = samples[:maxSamples]
-							duration = maxRecordingDuration
-						}
-
-						slog.Info("Captured audio, transcribing...",
-							"duration_s", fmt.Sprintf("%.1f", duration))
-
-						// Async transcription and injection
-						go func(samples []float32) {
-							start := time.Now()
-							text, err := transcriber.Process(samples)
-							if err != nil {
-								slog.Error("Transcription failed", "error", err)
-								return
-							}
-
-							elapsed := time.Since(start).Round(time.Millisecond)
-
-							if text == "" {
-								slog.Info("No speech detected", "elapsed", elapsed)
-								return
-							}
-
-							slog.Info("Transcribed", "elapsed", elapsed, "text", text)
-
-							if rewriter != nil {
-								rewriting.Store(true)
-								rewritten, rwErr := rewriter.Rewrite(context.Background(), text)
-								rewriting.Store(false)
-								if rwErr != nil {
-									slog.Warn("LLM rewrite failed, using raw transcription", "error", rwErr)
-								} else {
-									text = rewritten
-								}
-							}
-
-							if err := injector.Inject(text); err != nil {
-								slog.Error("Text injection failed", "error", err)
-								return
-							}
-
-							slog.Info("Text injected")
-						}(samples)
+						dictation.submit(chunks)
 					}
 				}
 
@@ -318,6 +305,7 @@ func main() {
 				// Stop streaming if active
 				if streamer != nil && recorder.IsRecording() {
 					streamer.Stop()
+					streamTyping.finish(streamer.FinalText())
 				}
 				// Stop recording if active
 				if recorder.IsRecording() {
@@ -326,6 +314,8 @@ func main() {
 				if err := recorder.Close(); err != nil {
 					slog.Error("failed to close recorder", "error", err)
 				}
+				// Finish injecting queued utterances before the models go away
+				dictation.close()
 				if err := transcriber.Close(); err != nil {
 					slog.Error("failed to close transcriber", "error", err)
 				}
@@ -355,6 +345,16 @@ func main() {
 	listener.Start() // blocks until listener.Stop() is called
 }
 
+// warmRewriter loads the LLM rewrite model in the background, so the next
+// rewrite does not wait for Ollama to load it.
+func warmRewriter(r *rewrite.Rewriter) {
+	go func() {
+		if err := r.Warm(context.Background()); err != nil {
+			slog.Debug("LLM warm-up failed", "error", err)
+		}
+	}()
+}
+
 // loadConfig loads the config from the specified path, or falls back to
 // the default config path, or uses built-in defaults. On first run,
 // it writes a default config file.
@@ -397,13 +397,16 @@ func printBanner(cfg *config.Config) {
 	}
 	fmt.Printf("  Hotkey:  %s (%s mode)\n", strings.Join(cfg.Hotkey.Keys, "+"), cfg.Hotkey.Mode)
 	fmt.Printf("  Audio:   %dHz, %dch\n", cfg.Audio.SampleRate, cfg.Audio.Channels)
+	if cfg.Audio.VAD.Enabled {
+		fmt.Printf("  VAD:     on (threshold=%gdB, pause=%dms)\n", cfg.Audio.VAD.ThresholdDB, cfg.Audio.VAD.PauseMs)
+	}
 	fmt.Printf("  Inject:  %s\n", cfg.Inject.Method)
 	if cfg.Transcribe.Streaming.Enabled {
 		fmt.Printf("  Stream:  on (step=%dms, window=%dms)\n",
 			cfg.Transcribe.Streaming.StepMs, cfg.Transcribe.Streaming.LengthMs)
 	}
 	if cfg.Rewrite.Enabled {
-		fmt.Printf("  Rewrite: on (model=%s)\n", cfg.Rewrite.Model)
+		fmt.Printf("  Rewrite: on (model=%s, stream=%t)\n", cfg.Rewrite.Model, streamRewrite(cfg))
 	}
 	fmt.Printf("  Log:     %s\n", cfg.LogLevel)
 	fmt.Println("====================")
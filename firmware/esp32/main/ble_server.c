@@ -2,8 +2,14 @@
 #include "ble_server.h"
 #include "config.h"
 #include "proto.h"
+#include "pkt_pool.h"
+#include "textdict.h"
+#include "textedit.h"
+#include "telemetry.h"
 #include "led.h"
 #include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
 #include "esp_nimble_hci.h"
 #include "nimble/nimble_port.h"
 #include "nimble/nimble_port_freertos.h"
@@ -14,6 +20,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/timers.h"
+#include <stdatomic.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -24,8 +31,37 @@ static uint16_t s_conn_handle = BLE_HS_CONN_HANDLE_NONE;
 static uint16_t s_resp_attr_handle;
 static volatile bool s_connected = false;
 static TimerHandle_t s_keepalive_timer = NULL;
+
+// Negotiated parameters of the current connection. Only touched from GAP
+// events, which all run on the NimBLE host task.
+static gostt_link_params_t s_link;
 static portMUX_TYPE s_conn_lock = portMUX_INITIALIZER_UNLOCKED;
 
+// ── Receive pipeline ──
+// The TX write callback runs on the NimBLE host task, which also services
+// GATT and connection events, so it only copies the write into a pool slot and
+// queues the slot index. The crypto worker decodes, decrypts and dispatches.
+// Text slots move on to the typer task, which frees them after typing.
+//
+// Flow control: each freed slot makes the worker send a Credits response
+// (coalesced), so the app can pipeline writes up to the free slots instead of
+// pacing them with a fixed delay.
+
+#define CRYPTO_WORKER_STACK_SIZE 4096
+
+// Crypto worker notification bits
+#define WORKER_RX       (1u << 0)  // packets queued on s_rx_ring
+#define WORKER_CREDITS  (1u << 1)  // slots freed or client subscribed
+
+static gostt_pkt_ring_t s_rx_ring;      // NimBLE host task → crypto worker
+static TaskHandle_t     s_crypto_worker;
+
+// TX writes received on the current connection. Every write counts, including
+// oversize writes and writes rejected for want of a slot, because the client
+// counts every write it sends: skipping one would leak a credit. Sampled
+// before the free count, so a Credits report never overstates the window.
+static atomic_uint s_rx_received;
+
 // Pairing task context: used to pass data from GATT callback to dedicated task
 typedef struct {
     uint8_t peer_pubkey[GOSTT_COMPRESSED_PUBKEY_LEN];
@@ -70,93 +106,264 @@ static void start_advertising(void);
 
 // --- GATT Characteristic Handlers ---
 
-// TX characteristic write handler (app sends encrypted data or pairing key here)
-static int tx_char_write_cb(uint16_t conn_handle, uint16_t attr_handle,
-                             struct ble_gatt_access_ctxt *ctxt, void *arg)
+// Dispatch one EncryptedData record: run a command, or apply its edit to
+// the frame's, whose text is in the slot (see textedit.h). Returns false on a
+// record that cannot be decoded or text that does not fit, after which the
+// rest of the frame is dropped.
+static bool handle_record(const gostt_encrypted_data_t *rec, gostt_edit_t *edit)
 {
-    (void)conn_handle; (void)attr_handle; (void)arg;
-
-    struct os_mbuf *om = ctxt->om;
-    uint16_t len = OS_MBUF_PKTLEN(om);
-    if (len == 0) return 0;
-
-    uint8_t buf[512];
-    if (len > sizeof(buf)) {
-        ESP_LOGW(TAG, "TX write too large: %d", len);
-        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    if (rec->command_type > 0) {
+        if (s_config.on_command) {
+            s_config.on_command(rec->command_type, rec->command_data, rec->command_data_len);
+        }
+        return true;
     }
-    os_mbuf_copydata(om, 0, len, buf);
-
-    // Pairing detection: 33-byte compressed public key (not a DataPacket)
-    if (len == GOSTT_COMPRESSED_PUBKEY_LEN &&
-        (buf[0] == 0x02 || buf[0] == 0x03)) {
-        ESP_LOGI(TAG, "Pairing request received (33-byte pubkey)");
 
-        // Offload crypto to a dedicated task (ECDH needs ~8KB stack,
-        // far more than the NimBLE host task provides).
-        pairing_task_ctx_t *ctx = malloc(sizeof(pairing_task_ctx_t));
-        if (!ctx) {
-            ESP_LOGE(TAG, "Pairing: out of memory");
-            gostt_led_flash_error();
-            return 0;
-        }
-        memcpy(ctx->peer_pubkey, buf, GOSTT_COMPRESSED_PUBKEY_LEN);
-        if (xTaskCreate(pairing_task, "pair_crypto", 8192, ctx, 5, NULL) != pdPASS) {
-            ESP_LOGE(TAG, "Pairing: failed to create task");
-            free(ctx);
+    gostt_edit_delete(edit, rec->backspaces);
+    size_t room = edit->cap - edit->len;
+    if (rec->packed_text != NULL) {
+        int n = gostt_dict_expand(rec->packed_text, rec->packed_text_len,
+                                  edit->text + edit->len, room);
+        if (n < 0) {
+            ESP_LOGW(TAG, "Invalid packed text");
             gostt_led_flash_error();
+            return false;
         }
-        return 0;
+        edit->len += (size_t)n;
+        return true;
+    }
+    if (rec->keyboard_packet_data == NULL && rec->backspaces > 0) {
+        return true; // deletion only
+    }
+
+    gostt_keyboard_packet_t kbd;
+    if (rec->keyboard_packet_data == NULL ||
+        gostt_decode_keyboard_packet(rec->keyboard_packet_data,
+                                     rec->keyboard_packet_data_len, &kbd) != 0) {
+        ESP_LOGW(TAG, "Failed to decode KeyboardPacket");
+        gostt_led_flash_error();
+        return false;
     }
+    if (kbd.message_len > room) {
+        ESP_LOGW(TAG, "Frame text over %d bytes", GOSTT_PKT_TEXT_MAX);
+        gostt_led_flash_error();
+        return false;
+    }
+    memcpy(edit->text + edit->len, kbd.message, kbd.message_len);
+    edit->len += kbd.message_len;
+    return true;
+}
+
+// Decode, decrypt and dispatch one DataPacket. Returns true if the slot was
+// handed to the text callback, which then owns it.
+static bool process_packet(uint8_t slot)
+{
+    gostt_pkt_t *p = gostt_pkt_get(slot);
 
-    // Normal operation: decode DataPacket, decrypt, dispatch
     if (!s_config.crypto->has_key) {
         ESP_LOGW(TAG, "No key — ignoring encrypted packet");
-        return 0;
+        return false;
     }
 
     gostt_data_packet_t pkt;
-    if (gostt_decode_data_packet(buf, len, &pkt) != 0) {
+    if (gostt_decode_data_packet(p->data, p->len, &pkt) != 0) {
         ESP_LOGW(TAG, "Failed to decode DataPacket");
+        gostt_telemetry_count(GOSTT_CTR_DECRYPT_FAIL);
         gostt_led_flash_error();
-        return 0;
+        return false;
     }
 
     // Decrypt
-    uint8_t plaintext[512];
     int pt_len = gostt_crypto_decrypt(s_config.crypto,
                                        pkt.iv, pkt.tag,
                                        pkt.encrypted_data, pkt.encrypted_data_len,
-                                       plaintext);
+                                       p->plaintext, sizeof(p->plaintext));
     if (pt_len < 0) {
         ESP_LOGW(TAG, "Decrypt failed for packet %u", pkt.packet_num);
+        gostt_telemetry_count(GOSTT_CTR_DECRYPT_FAIL);
         gostt_led_flash_error();
-        return 0;
+        return false;
     }
+    p->decrypted_us = (uint32_t)esp_timer_get_time();
+    gostt_telemetry_stage(GOSTT_STAGE_DECRYPT, p->rx_us, p->decrypted_us);
 
     // Decode EncryptedData wrapper
     gostt_encrypted_data_t enc_data;
-    if (gostt_decode_encrypted_data(plaintext, (size_t)pt_len, &enc_data) != 0) {
+    if (gostt_decode_encrypted_data(p->plaintext, (size_t)pt_len, &enc_data) != 0) {
         ESP_LOGW(TAG, "Failed to decode EncryptedData");
+        gostt_telemetry_count(GOSTT_CTR_DECRYPT_FAIL);
         gostt_led_flash_error();
-        return 0;
+        return false;
     }
 
-    if (enc_data.command_type == 0 && enc_data.keyboard_packet_data != NULL) {
-        // Text command
+    // Legacy frame with one plain text record: type straight from plaintext
+    p->backspaces = 0;
+    if (enc_data.record_count == 0 && enc_data.command_type == 0 &&
+        enc_data.packed_text == NULL && enc_data.backspaces == 0) {
         gostt_keyboard_packet_t kbd;
-        if (gostt_decode_keyboard_packet(enc_data.keyboard_packet_data,
-                                          enc_data.keyboard_packet_data_len, &kbd) == 0) {
+        if (enc_data.keyboard_packet_data != NULL &&
+            gostt_decode_keyboard_packet(enc_data.keyboard_packet_data,
+                                         enc_data.keyboard_packet_data_len, &kbd) == 0) {
             gostt_led_flash_typing();
             if (s_config.on_text) {
-                s_config.on_text(kbd.message, kbd.message_len);
+                s_config.on_text(kbd.message, kbd.message_len, slot);
+                return true;
             }
         }
-    } else if (enc_data.command_type > 0 && s_config.on_command) {
-        s_config.on_command(enc_data.command_type,
-                           enc_data.command_data, enc_data.command_data_len);
+        return false;
+    }
+
+    // Otherwise text records are merged into one edit in the slot's text
+    // buffer and typed once; commands take effect as they are reached, ahead
+    // of the text, as they would for separate packets
+    gostt_edit_t edit = { .text = p->text, .cap = sizeof(p->text) };
+    if (enc_data.record_count == 0) {
+        if (!handle_record(&enc_data, &edit)) return false;
+    } else {
+        size_t pos = 0;
+        gostt_encrypted_data_t rec;
+        int rc;
+        while ((rc = gostt_next_record(p->plaintext, (size_t)pt_len, &pos, &rec)) == 1) {
+            if (!handle_record(&rec, &edit)) break;
+        }
+        if (rc < 0) {
+            ESP_LOGW(TAG, "Failed to decode record in packet %u", pkt.packet_num);
+            gostt_led_flash_error();
+        }
+    }
+
+    p->backspaces = edit.backspaces;
+    if (edit.len > 0 || edit.backspaces > 0) {
+        gostt_led_flash_typing();
+        if (s_config.on_text) {
+            s_config.on_text(p->text, edit.len, slot);
+            return true;
+        }
     }
+    return false;
+}
 
+// Advertise the receive window to the connected client.
+static void notify_credits(void)
+{
+    portENTER_CRITICAL(&s_conn_lock);
+    uint16_t conn = s_conn_handle;
+    portEXIT_CRITICAL(&s_conn_lock);
+    if (conn == BLE_HS_CONN_HANDLE_NONE) return;
+
+    gostt_credits_t credits = {
+        .received = atomic_load_explicit(&s_rx_received, memory_order_acquire),
+        .total_slots = GOSTT_PKT_SLOTS,
+    };
+    credits.free_slots = (uint8_t)gostt_pkt_free_count();
+
+    uint8_t data[GOSTT_CREDITS_LEN];
+    if (gostt_encode_credits(data, sizeof(data), &credits) < 0) return;
+
+    uint8_t buf[32];
+    int len = gostt_encode_response_packet(buf, sizeof(buf),
+                                            GOSTT_RESP_CREDITS,
+                                            s_config.crypto->has_key ? GOSTT_PEER_KNOWN
+                                                                     : GOSTT_PEER_UNKNOWN,
+                                            data, sizeof(data));
+    if (len > 0) {
+        struct os_mbuf *om = ble_hs_mbuf_from_flat(buf, len);
+        if (om) {
+            ble_gatts_notify_custom(conn, s_resp_attr_handle, om);
+        }
+    }
+}
+
+// Pool release hook: runs on whichever task freed the slot.
+static void on_slot_released(void)
+{
+    xTaskNotify(s_crypto_worker, WORKER_CREDITS, eSetBits);
+}
+
+// Crypto worker: drains the receive ring whenever the write callback signals,
+// and reports the receive window after slots are freed. Slots freed while
+// draining are reported once, on the next wake.
+static void crypto_worker_task(void *arg)
+{
+    (void)arg;
+    uint8_t slot;
+    uint32_t bits;
+    for (;;) {
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+        if (bits & WORKER_RX) {
+            while (gostt_pkt_ring_pop(&s_rx_ring, &slot)) {
+                if (!process_packet(slot)) {
+                    gostt_pkt_free(slot);
+                }
+            }
+        }
+        if (bits & WORKER_CREDITS) {
+            notify_credits();
+        }
+    }
+}
+
+// TX characteristic write handler (app sends encrypted data or pairing key here)
+static int tx_char_write_cb(uint16_t conn_handle, uint16_t attr_handle,
+                             struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    (void)conn_handle; (void)attr_handle; (void)arg;
+
+    struct os_mbuf *om = ctxt->om;
+    uint16_t len = OS_MBUF_PKTLEN(om);
+    if (len == 0) return 0;
+
+    if (len > GOSTT_PKT_MAX_LEN) {
+        ESP_LOGW(TAG, "TX write too large: %d", len);
+        atomic_fetch_add_explicit(&s_rx_received, 1, memory_order_release);
+        gostt_telemetry_count(GOSTT_CTR_RX);
+        gostt_telemetry_count(GOSTT_CTR_DROPPED);
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+
+    int slot = gostt_pkt_alloc();
+    atomic_fetch_add_explicit(&s_rx_received, 1, memory_order_release);
+    gostt_telemetry_count(GOSTT_CTR_RX);
+    if (slot < 0) {
+        // Every slot is queued behind the typer: push back on the sender
+        ESP_LOGW(TAG, "Receive pipeline full — rejecting %d-byte write", len);
+        gostt_telemetry_count(GOSTT_CTR_DROPPED);
+        gostt_led_flash_error();
+        return BLE_ATT_ERR_INSUFFICIENT_RES;
+    }
+    gostt_pkt_t *p = gostt_pkt_get((uint8_t)slot);
+    os_mbuf_copydata(om, 0, len, p->data);
+    p->len = len;
+    p->rx_us = (uint32_t)esp_timer_get_time();
+
+    // Pairing detection: 33-byte compressed public key (not a DataPacket)
+    if (len == GOSTT_COMPRESSED_PUBKEY_LEN &&
+        (p->data[0] == 0x02 || p->data[0] == 0x03)) {
+        ESP_LOGI(TAG, "Pairing request received (33-byte pubkey)");
+
+        // Offload crypto to a dedicated task (ECDH needs ~8KB stack,
+        // far more than the NimBLE host task provides).
+        pairing_task_ctx_t *ctx = malloc(sizeof(pairing_task_ctx_t));
+        if (!ctx) {
+            ESP_LOGE(TAG, "Pairing: out of memory");
+            gostt_led_flash_error();
+            gostt_pkt_free((uint8_t)slot);
+            return 0;
+        }
+        memcpy(ctx->peer_pubkey, p->data, GOSTT_COMPRESSED_PUBKEY_LEN);
+        gostt_pkt_free((uint8_t)slot);
+        if (xTaskCreate(pairing_task, "pair_crypto", 8192, ctx, 5, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Pairing: failed to create task");
+            free(ctx);
+            gostt_led_flash_error();
+        }
+        return 0;
+    }
+
+    // Normal operation: hand the packet to the crypto worker. The ring holds
+    // every slot, so the push of an allocated one cannot fail.
+    gostt_pkt_ring_push(&s_rx_ring, (uint8_t)slot);
+    xTaskNotify(s_crypto_worker, WORKER_RX, eSetBits);
     return 0;
 }
 
@@ -186,6 +393,22 @@ static int mac_char_read_cb(uint16_t conn_handle, uint16_t attr_handle,
     return 0;
 }
 
+// Stats characteristic read handler. Only read on the NimBLE host task, so
+// the encode buffer can be static rather than on its small stack.
+static int stats_char_read_cb(uint16_t conn_handle, uint16_t attr_handle,
+                              struct ble_gatt_access_ctxt *ctxt, void *arg)
+{
+    (void)conn_handle; (void)attr_handle; (void)arg;
+
+    static uint8_t stats[GOSTT_TELEMETRY_LEN];
+    int len = gostt_telemetry_encode(stats, sizeof(stats),
+                                     esp_get_free_heap_size(),
+                                     esp_get_minimum_free_heap_size());
+    if (len < 0) return BLE_ATT_ERR_UNLIKELY;
+    if (os_mbuf_append(ctxt->om, stats, len) != 0) return BLE_ATT_ERR_INSUFFICIENT_RES;
+    return 0;
+}
+
 // --- GATT Service Definition ---
 
 // UUIDs (128-bit, little-endian byte order for NimBLE)
@@ -198,6 +421,9 @@ static const ble_uuid128_t tx_char_uuid =
 static const ble_uuid128_t resp_char_uuid =
     BLE_UUID128_INIT(0x08, 0x59, 0x2c, 0xdd, 0x7d, 0xcf, 0x42, 0xbf,
                      0x5a, 0x45, 0x7b, 0x2c, 0x19, 0xe1, 0x56, 0x68);
+static const ble_uuid128_t stats_char_uuid =
+    BLE_UUID128_INIT(0x09, 0x59, 0x2c, 0xdd, 0x7d, 0xcf, 0x42, 0xbf,
+                     0x5a, 0x45, 0x7b, 0x2c, 0x19, 0xe1, 0x56, 0x68);
 static const ble_uuid128_t mac_char_uuid =
     BLE_UUID128_INIT(0x14, 0x12, 0x8a, 0x76, 0x04, 0xd1, 0x6c, 0x4f,
                      0x7e, 0x53, 0xf2, 0xe8, 0x02, 0x00, 0xb1, 0x19);
@@ -226,6 +452,12 @@ static const struct ble_gatt_svc_def gatt_svr_svcs[] = {
                 .access_cb = mac_char_read_cb,
                 .flags = BLE_GATT_CHR_F_READ,
             },
+            {
+                // Stats characteristic (read): pipeline telemetry
+                .uuid = &stats_char_uuid.u,
+                .access_cb = stats_char_read_cb,
+                .flags = BLE_GATT_CHR_F_READ,
+            },
             {0}, // sentinel
         },
     },
@@ -257,6 +489,63 @@ static void keepalive_timer_cb(TimerHandle_t timer)
     }
 }
 
+// --- Link Parameters ---
+
+// Defaults of a new connection before any negotiation (Core spec minimums).
+static void reset_link_params(void)
+{
+    s_link.mtu = BLE_ATT_MTU_DFLT;
+    s_link.tx_phy = BLE_GAP_LE_PHY_1M;
+    s_link.rx_phy = BLE_GAP_LE_PHY_1M;
+    s_link.max_tx_octets = 27;
+    s_link.features = GOSTT_FEATURE_BATCH | GOSTT_FEATURE_DICT | GOSTT_FEATURE_EDIT;
+}
+
+// Report the current link parameters so the app can size its writes.
+static void notify_link_params(uint16_t conn)
+{
+    uint8_t data[GOSTT_LINK_PARAMS_LEN];
+    if (gostt_encode_link_params(data, sizeof(data), &s_link) < 0) return;
+
+    uint8_t buf[32];
+    int len = gostt_encode_response_packet(buf, sizeof(buf),
+                                            GOSTT_RESP_LINK_PARAMS,
+                                            s_config.crypto->has_key ? GOSTT_PEER_KNOWN
+                                                                     : GOSTT_PEER_UNKNOWN,
+                                            data, sizeof(data));
+    if (len > 0) {
+        struct os_mbuf *om = ble_hs_mbuf_from_flat(buf, len);
+        if (om) {
+            ble_gatts_notify_custom(conn, s_resp_attr_handle, om);
+        }
+    }
+}
+
+// Ask for Data Length Extension and the 2M PHY on a new connection. The MTU
+// is negotiated by the client's exchange (central stacks start one on
+// connect); ble_att_set_preferred_mtu makes us answer with the largest.
+static void request_link_upgrade(uint16_t conn)
+{
+    reset_link_params();
+
+    int rc = ble_gap_set_data_len(conn, GOSTT_BLE_DLE_TX_OCTETS, GOSTT_BLE_DLE_TX_TIME_US);
+    if (rc != 0) {
+        ESP_LOGW(TAG, "Data length request failed: %d", rc);
+    }
+#ifndef BLE_GAP_EVENT_DATA_LEN_CHG
+    else {
+        // No change event to report the outcome: assume the request holds
+        s_link.max_tx_octets = GOSTT_BLE_DLE_TX_OCTETS;
+    }
+#endif
+
+    rc = ble_gap_set_prefered_le_phy(conn, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_2M_MASK,
+                                     BLE_GAP_LE_PHY_CODED_ANY);
+    if (rc != 0) {
+        ESP_LOGW(TAG, "2M PHY request failed: %d", rc);
+    }
+}
+
 // --- GAP Event Handler ---
 
 static void start_advertising(void)
@@ -313,6 +602,7 @@ static int ble_gap_event(struct ble_gap_event *event, void *arg)
                 portENTER_CRITICAL(&s_conn_lock);
                 s_conn_handle = event->connect.conn_handle;
                 portEXIT_CRITICAL(&s_conn_lock);
+                atomic_store(&s_rx_received, 0);
                 s_connected = true;
                 ESP_LOGI(TAG, "Client connected (handle=%d)", s_conn_handle);
 
@@ -322,6 +612,8 @@ static int ble_gap_event(struct ble_gap_event *event, void *arg)
                     gostt_led_set(GOSTT_LED_CONNECTED);
                 }
 
+                request_link_upgrade(event->connect.conn_handle);
+
                 // Start keepalive timer
                 if (s_keepalive_timer) {
                     xTimerStart(s_keepalive_timer, 0);
@@ -347,6 +639,37 @@ static int ble_gap_event(struct ble_gap_event *event, void *arg)
 
         case BLE_GAP_EVENT_MTU:
             ESP_LOGI(TAG, "MTU updated: %d", event->mtu.value);
+            s_link.mtu = event->mtu.value;
+            notify_link_params(event->mtu.conn_handle);
+            break;
+
+        case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+            if (event->phy_updated.status == 0) {
+                ESP_LOGI(TAG, "PHY updated: tx=%d rx=%d",
+                         event->phy_updated.tx_phy, event->phy_updated.rx_phy);
+                s_link.tx_phy = event->phy_updated.tx_phy;
+                s_link.rx_phy = event->phy_updated.rx_phy;
+                notify_link_params(event->phy_updated.conn_handle);
+            }
+            break;
+
+#ifdef BLE_GAP_EVENT_DATA_LEN_CHG
+        case BLE_GAP_EVENT_DATA_LEN_CHG:
+            ESP_LOGI(TAG, "Data length updated: tx=%d octets",
+                     event->data_len_chg.max_tx_octets);
+            s_link.max_tx_octets = event->data_len_chg.max_tx_octets;
+            notify_link_params(event->data_len_chg.conn_handle);
+            break;
+#endif
+
+        case BLE_GAP_EVENT_SUBSCRIBE:
+            // Parameters negotiated before the app subscribed were not seen,
+            // and it needs an initial window before it can send
+            if (event->subscribe.attr_handle == s_resp_attr_handle &&
+                event->subscribe.cur_notify) {
+                notify_link_params(event->subscribe.conn_handle);
+                xTaskNotify(s_crypto_worker, WORKER_CREDITS, eSetBits);
+            }
             break;
 
         default:
@@ -376,6 +699,17 @@ int gostt_ble_server_init(const gostt_ble_config_t *config)
 {
     s_config = *config;
 
+    // Receive pipeline, before NimBLE can deliver writes
+    gostt_pkt_pool_init();
+    gostt_pkt_ring_init(&s_rx_ring);
+    if (xTaskCreatePinnedToCore(crypto_worker_task, "gostt_crypto",
+                                CRYPTO_WORKER_STACK_SIZE, NULL, 5,
+                                &s_crypto_worker, GOSTT_CRYPTO_WORKER_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create crypto worker task");
+        return -1;
+    }
+    gostt_pkt_set_release_hook(on_slot_released);
+
     // Initialize NimBLE
     esp_err_t ret = nimble_port_init();
     if (ret != ESP_OK) {
@@ -383,11 +717,17 @@ int gostt_ble_server_init(const gostt_ble_config_t *config)
         return -1;
     }
 
+    // Answer the client's MTU exchange with the largest ATT MTU
+    int rc = ble_att_set_preferred_mtu(GOSTT_BLE_PREFERRED_MTU);
+    if (rc != 0) {
+        ESP_LOGW(TAG, "Set preferred MTU failed: %d", rc);
+    }
+
     // Register GATT services
     ble_svc_gap_init();
     ble_svc_gatt_init();
 
-    int rc = ble_gatts_count_cfg(gatt_svr_svcs);
+    rc = ble_gatts_count_cfg(gatt_svr_svcs);
     if (rc != 0) {
         ESP_LOGE(TAG, "GATT count cfg failed: %d", rc);
         return -1;
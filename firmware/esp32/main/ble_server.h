@@ -5,10 +5,15 @@
 #include <stdbool.h>
 #include "crypto.h"
 
-// Callback for when decrypted text is ready to type.
-typedef void (*gostt_text_callback_t)(const char *text, size_t len);
+// Callback for when decrypted text is ready to type. Called on the crypto
+// worker task; text points into packet slot (see pkt_pool.h), whose ownership
+// passes to the callback. It must gostt_pkt_free(slot) once done with text.
+// The slot's backspaces are deleted before text is typed; with backspaces set,
+// len may be 0.
+typedef void (*gostt_text_callback_t)(const char *text, size_t len, uint8_t slot);
 
-// Callback for commands (mute toggle, configure mute, etc.)
+// Callback for commands (mute toggle, configure mute, etc.), called on the
+// crypto worker task. data is only valid during the call.
 typedef void (*gostt_command_callback_t)(uint32_t command_type,
                                          const uint8_t *data, size_t data_len);
 
@@ -8,9 +8,25 @@
 #define GOSTT_BLE_RESP_CHAR_UUID    "6856e119-2c7b-455a-bf42-cf7ddd2c5908"
 #define GOSTT_BLE_MAC_CHAR_UUID     "19b10002-e8f2-537e-4f6c-d104768a1214"
 
+// Link parameters requested from each client: the largest ATT MTU, Data
+// Length Extension (max link layer payload and its 1M PHY airtime) and the
+// 2M PHY. The negotiated values are reported in a LinkParams ResponsePacket.
+#define GOSTT_BLE_PREFERRED_MTU     517
+#define GOSTT_BLE_DLE_TX_OCTETS     251
+#define GOSTT_BLE_DLE_TX_TIME_US    2120
+
 // Keepalive interval (ms)
 #define GOSTT_KEEPALIVE_INTERVAL_MS 5000
 
+// BLE receive pipeline: packet slots in flight between the NimBLE host task,
+// the crypto worker and the typer task (power of two, at most 32), the
+// largest TX characteristic write accepted, and the most text one write may
+// expand to once batched records are joined and packed text unpacked
+#define GOSTT_PKT_SLOTS             8
+#define GOSTT_PKT_MAX_LEN           512
+#define GOSTT_PKT_TEXT_MAX          1024
+#define GOSTT_CRYPTO_WORKER_CORE    1
+
 // USB HID typing cadence (ms)
 #define GOSTT_KEY_PRESS_MS          10
 #define GOSTT_KEY_GAP_MS            5
@@ -18,6 +34,9 @@
 #define GOSTT_CONSUMER_PRESS_MS     10
 #define GOSTT_HID_READY_TIMEOUT_MS  50
 
+// HID endpoint bInterval (ms); fast typing sends one report per host poll
+#define GOSTT_HID_POLL_INTERVAL_MS  1
+
 // LED GPIO (WS2812 on most ESP32-S3 dev boards)
 #define GOSTT_LED_GPIO              48
 
@@ -26,6 +45,7 @@
 #define GOSTT_NVS_KEY_AES           "aes_key"
 #define GOSTT_NVS_KEY_PEER_PUB      "peer_pub"
 #define GOSTT_NVS_KEY_MUTE_CFG      "mute_cfg"
+#define GOSTT_NVS_KEY_TYPING_CFG    "typing_cfg"
 
 // Factory reset: hold BOOT button for this many ms
 #define GOSTT_FACTORY_RESET_MS      5000
@@ -46,5 +66,6 @@
 // BLE command types (must match Go app)
 #define GOSTT_CMD_MUTE_TOGGLE    1
 #define GOSTT_CMD_MUTE_CONFIGURE 2
+#define GOSTT_CMD_TYPING_CONFIGURE 3
 
 #endif // GOSTT_KBD_CONFIG_H
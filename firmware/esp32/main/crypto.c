@@ -28,6 +28,47 @@ static const char *TAG = "gostt-crypto";
 // Uncompressed EC P-256 pubkey: 04 || x(32) || y(32) = 65 bytes
 #define UNCOMPRESSED_PUBKEY_LEN 65
 
+// gostt_crypto_ctx_t stores the key id as a plain integer (crypto.h cannot
+// include psa/crypto.h); this breaks if key ids start encoding an owner.
+_Static_assert(sizeof(mbedtls_svc_key_id_t) == sizeof(uint32_t),
+               "PSA key id does not fit gostt_crypto_ctx_t.aes_key_id");
+
+// --- AES key handle ---
+
+// Import ctx->aes_key into the PSA keystore for decryption. A previously
+// imported key is destroyed only after the new one is in place, so a decrypt
+// racing a re-pair never sees an empty id.
+static int import_aes_key(gostt_crypto_ctx_t *ctx)
+{
+    psa_key_attributes_t key_attr = PSA_KEY_ATTRIBUTES_INIT;
+    psa_set_key_usage_flags(&key_attr, PSA_KEY_USAGE_DECRYPT);
+    psa_set_key_algorithm(&key_attr, PSA_ALG_GCM);
+    psa_set_key_type(&key_attr, PSA_KEY_TYPE_AES);
+    psa_set_key_bits(&key_attr, GOSTT_AES_KEY_LEN * 8);
+
+    mbedtls_svc_key_id_t key_id = MBEDTLS_SVC_KEY_ID_INIT;
+    psa_status_t status = psa_import_key(&key_attr, ctx->aes_key, GOSTT_AES_KEY_LEN, &key_id);
+    if (status != PSA_SUCCESS) {
+        ESP_LOGE(TAG, "AES key import failed: %d", (int)status);
+        return -1;
+    }
+
+    mbedtls_svc_key_id_t old = (mbedtls_svc_key_id_t)ctx->aes_key_id;
+    ctx->aes_key_id = (uint32_t)key_id;
+    if (old != 0) {
+        psa_destroy_key(old);
+    }
+    return 0;
+}
+
+static void destroy_aes_key(gostt_crypto_ctx_t *ctx)
+{
+    if (ctx->aes_key_id != 0) {
+        psa_destroy_key((mbedtls_svc_key_id_t)ctx->aes_key_id);
+        ctx->aes_key_id = 0;
+    }
+}
+
 // --- NVS helpers ---
 
 static int load_key_from_nvs(gostt_crypto_ctx_t *ctx)
@@ -142,6 +183,10 @@ int gostt_crypto_init(gostt_crypto_ctx_t *ctx)
     }
 
     if (load_key_from_nvs(ctx) == 0) {
+        if (import_aes_key(ctx) != 0) {
+            ctx->has_key = false;
+            return -1;
+        }
         ESP_LOGI(TAG, "Loaded encryption key from NVS");
     } else {
         ESP_LOGI(TAG, "No stored key — pairing required");
@@ -269,6 +314,9 @@ int gostt_crypto_pair(gostt_crypto_ctx_t *ctx,
         }
     }
 
+    if (import_aes_key(ctx) != 0) {
+        goto cleanup;
+    }
     ctx->has_key = true;
     memcpy(ctx->peer_pubkey, peer_compressed_pubkey, GOSTT_COMPRESSED_PUBKEY_LEN);
 
@@ -293,59 +341,46 @@ int gostt_crypto_decrypt(const gostt_crypto_ctx_t *ctx,
                          const uint8_t *iv,
                          const uint8_t *tag,
                          const uint8_t *ciphertext, size_t ciphertext_len,
-                         uint8_t *plaintext_out)
+                         uint8_t *plaintext_out, size_t plaintext_size)
 {
-    if (!ctx->has_key) {
+    if (!ctx->has_key || ctx->aes_key_id == 0) {
         ESP_LOGE(TAG, "No encryption key — cannot decrypt");
         return -1;
     }
 
-    if (ciphertext_len == 0 || ciphertext_len > INT_MAX) {
+    if (ciphertext_len == 0 || ciphertext_len > INT_MAX ||
+        plaintext_size < GOSTT_PLAINTEXT_SIZE(ciphertext_len)) {
         return -1;
     }
 
-    // Import AES key into PSA
-    psa_key_attributes_t key_attr = PSA_KEY_ATTRIBUTES_INIT;
-    psa_set_key_usage_flags(&key_attr, PSA_KEY_USAGE_DECRYPT);
-    psa_set_key_algorithm(&key_attr, PSA_ALG_GCM);
-    psa_set_key_type(&key_attr, PSA_KEY_TYPE_AES);
-    psa_set_key_bits(&key_attr, GOSTT_AES_KEY_LEN * 8);
-
-    mbedtls_svc_key_id_t key_id = MBEDTLS_SVC_KEY_ID_INIT;
-    psa_status_t status = psa_import_key(&key_attr, ctx->aes_key, GOSTT_AES_KEY_LEN, &key_id);
-    if (status != PSA_SUCCESS) {
-        ESP_LOGE(TAG, "AES key import failed: %d", (int)status);
-        return -1;
+    // The multipart API takes the tag separately, so ciphertext and tag are
+    // never concatenated and nothing is allocated or imported per packet.
+    psa_aead_operation_t op = PSA_AEAD_OPERATION_INIT;
+    size_t out_len = 0;
+    size_t tail_len = 0;
+    psa_status_t status = psa_aead_decrypt_setup(&op, (mbedtls_svc_key_id_t)ctx->aes_key_id,
+                                                 PSA_ALG_GCM);
+    if (status == PSA_SUCCESS) {
+        status = psa_aead_set_nonce(&op, iv, GOSTT_IV_LEN);
     }
-
-    // PSA AEAD expects ciphertext || tag concatenated
-    // Build combined buffer: ciphertext + tag
-    size_t combined_len = ciphertext_len + GOSTT_TAG_LEN;
-    uint8_t *combined = (uint8_t *)malloc(combined_len);
-    if (!combined) {
-        ESP_LOGE(TAG, "Alloc failed for AEAD input");
-        psa_destroy_key(key_id);
-        return -1;
+    if (status == PSA_SUCCESS) {
+        status = psa_aead_update(&op, ciphertext, ciphertext_len,
+                                 plaintext_out, plaintext_size, &out_len);
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_aead_verify(&op, plaintext_out + out_len, plaintext_size - out_len,
+                                 &tail_len, tag, GOSTT_TAG_LEN);
     }
-    memcpy(combined, ciphertext, ciphertext_len);
-    memcpy(combined + ciphertext_len, tag, GOSTT_TAG_LEN);
-
-    size_t plaintext_len = 0;
-    status = psa_aead_decrypt(key_id, PSA_ALG_GCM,
-                               iv, GOSTT_IV_LEN,
-                               NULL, 0,  // no AAD
-                               combined, combined_len,
-                               plaintext_out, ciphertext_len,
-                               &plaintext_len);
-    free(combined);
-    psa_destroy_key(key_id);
 
     if (status != PSA_SUCCESS) {
+        psa_aead_abort(&op);
+        // update() already wrote plaintext that failed authentication
+        memset(plaintext_out, 0, out_len);
         ESP_LOGE(TAG, "AES-GCM decrypt failed: %d", (int)status);
         return -1;
     }
 
-    return (int)plaintext_len;
+    return (int)(out_len + tail_len);
 }
 
 int gostt_crypto_erase(gostt_crypto_ctx_t *ctx)
@@ -356,10 +391,12 @@ int gostt_crypto_erase(gostt_crypto_ctx_t *ctx)
         nvs_erase_key(handle, GOSTT_NVS_KEY_AES);
         nvs_erase_key(handle, GOSTT_NVS_KEY_PEER_PUB);
         nvs_erase_key(handle, GOSTT_NVS_KEY_MUTE_CFG);
+        nvs_erase_key(handle, GOSTT_NVS_KEY_TYPING_CFG);
         nvs_commit(handle);
         nvs_close(handle);
     }
 
+    destroy_aes_key(ctx);
     memset(ctx, 0, sizeof(*ctx));
     ESP_LOGI(TAG, "All keys erased");
     return 0;
@@ -7,11 +7,16 @@
 #include <stdbool.h>
 #include "config.h"
 
-// Crypto context — holds ECDH keypair during pairing and AES key for normal operation
+// Crypto context — holds ECDH keypair during pairing and AES key for normal operation.
+// The AES key is imported into the PSA keystore once (after NVS load or pairing)
+// and decrypts every packet through aes_key_id. The id is kept as its integer
+// value so this header does not pull in psa/crypto.h (see the include order
+// note in crypto.c).
 typedef struct {
-    uint8_t aes_key[GOSTT_AES_KEY_LEN];
-    bool    has_key;
-    uint8_t peer_pubkey[GOSTT_COMPRESSED_PUBKEY_LEN]; // stored for re-pairing detection
+    uint8_t  aes_key[GOSTT_AES_KEY_LEN];
+    bool     has_key;
+    uint32_t aes_key_id;                              // PSA key id of aes_key, 0 if not imported
+    uint8_t  peer_pubkey[GOSTT_COMPRESSED_PUBKEY_LEN]; // stored for re-pairing detection
 } gostt_crypto_ctx_t;
 
 // Initialize crypto context. Attempts to load AES key from NVS.
@@ -27,15 +32,20 @@ int gostt_crypto_pair(gostt_crypto_ctx_t *ctx,
                       const uint8_t *peer_compressed_pubkey,
                       uint8_t *own_pubkey_out);
 
-// Decrypt ciphertext with AES-256-GCM.
+// Decrypt ciphertext with AES-256-GCM using the imported key. Allocation-free.
 // iv: 12 bytes, tag: 16 bytes, ciphertext: variable length.
-// plaintext_out must be at least ciphertext_len bytes.
+// plaintext_size must be at least GOSTT_PLAINTEXT_SIZE(ciphertext_len) bytes.
+// On failure nothing unauthenticated is left in plaintext_out.
 // Returns plaintext length on success, -1 on error.
 int gostt_crypto_decrypt(const gostt_crypto_ctx_t *ctx,
                          const uint8_t *iv,
                          const uint8_t *tag,
                          const uint8_t *ciphertext, size_t ciphertext_len,
-                         uint8_t *plaintext_out);
+                         uint8_t *plaintext_out, size_t plaintext_size);
+
+// Plaintext buffer size gostt_crypto_decrypt needs for ciphertext_len bytes:
+// the multipart GCM API may write up to a whole 16-byte block at a time.
+#define GOSTT_PLAINTEXT_SIZE(ciphertext_len) ((((ciphertext_len) + 15) / 16) * 16)
 
 // Erase all stored keys from NVS and reset context.
 int gostt_crypto_erase(gostt_crypto_ctx_t *ctx);
@@ -0,0 +1,190 @@
+// firmware/esp32/main/hid_pack.c
+#include "hid_pack.h"
+#include <string.h>
+
+// ASCII to HID keycode mapping
+typedef struct {
+    uint8_t keycode;
+    bool    shift;
+} ascii_to_hid_t;
+
+// Lookup table for ASCII 0x20 (space) through 0x7E (~)
+// Index = ascii_code - 0x20
+static const ascii_to_hid_t ascii_map[95] = {
+    {0x2C, false}, // 0x20 space
+    {0x1E, true},  // 0x21 !
+    {0x34, true},  // 0x22 "
+    {0x20, true},  // 0x23 #
+    {0x21, true},  // 0x24 $
+    {0x22, true},  // 0x25 %
+    {0x24, true},  // 0x26 &
+    {0x34, false}, // 0x27 '
+    {0x26, true},  // 0x28 (
+    {0x27, true},  // 0x29 )
+    {0x25, true},  // 0x2A *
+    {0x2E, true},  // 0x2B +
+    {0x36, false}, // 0x2C ,
+    {0x2D, false}, // 0x2D -
+    {0x37, false}, // 0x2E .
+    {0x38, false}, // 0x2F /
+    {0x27, false}, // 0x30 0
+    {0x1E, false}, // 0x31 1
+    {0x1F, false}, // 0x32 2
+    {0x20, false}, // 0x33 3
+    {0x21, false}, // 0x34 4
+    {0x22, false}, // 0x35 5
+    {0x23, false}, // 0x36 6
+    {0x24, false}, // 0x37 7
+    {0x25, false}, // 0x38 8
+    {0x26, false}, // 0x39 9
+    {0x33, true},  // 0x3A :
+    {0x33, false}, // 0x3B ;
+    {0x36, true},  // 0x3C <
+    {0x2E, false}, // 0x3D =
+    {0x37, true},  // 0x3E >
+    {0x38, true},  // 0x3F ?
+    {0x1F, true},  // 0x40 @
+    {0x04, true},  // 0x41 A
+    {0x05, true},  // 0x42 B
+    {0x06, true},  // 0x43 C
+    {0x07, true},  // 0x44 D
+    {0x08, true},  // 0x45 E
+    {0x09, true},  // 0x46 F
+    {0x0A, true},  // 0x47 G
+    {0x0B, true},  // 0x48 H
+    {0x0C, true},  // 0x49 I
+    {0x0D, true},  // 0x4A J
+    {0x0E, true},  // 0x4B K
+    {0x0F, true},  // 0x4C L
+    {0x10, true},  // 0x4D M
+    {0x11, true},  // 0x4E N
+    {0x12, true},  // 0x4F O
+    {0x13, true},  // 0x50 P
+    {0x14, true},  // 0x51 Q
+    {0x15, true},  // 0x52 R
+    {0x16, true},  // 0x53 S
+    {0x17, true},  // 0x54 T
+    {0x18, true},  // 0x55 U
+    {0x19, true},  // 0x56 V
+    {0x1A, true},  // 0x57 W
+    {0x1B, true},  // 0x58 X
+    {0x1C, true},  // 0x59 Y
+    {0x1D, true},  // 0x5A Z
+    {0x2F, false}, // 0x5B [
+    {0x31, false}, // 0x5C backslash
+    {0x30, false}, // 0x5D ]
+    {0x23, true},  // 0x5E ^
+    {0x2D, true},  // 0x5F _
+    {0x35, false}, // 0x60 `
+    {0x04, false}, // 0x61 a
+    {0x05, false}, // 0x62 b
+    {0x06, false}, // 0x63 c
+    {0x07, false}, // 0x64 d
+    {0x08, false}, // 0x65 e
+    {0x09, false}, // 0x66 f
+    {0x0A, false}, // 0x67 g
+    {0x0B, false}, // 0x68 h
+    {0x0C, false}, // 0x69 i
+    {0x0D, false}, // 0x6A j
+    {0x0E, false}, // 0x6B k
+    {0x0F, false}, // 0x6C l
+    {0x10, false}, // 0x6D m
+    {0x11, false}, // 0x6E n
+    {0x12, false}, // 0x6F o
+    {0x13, false}, // 0x70 p
+    {0x14, false}, // 0x71 q
+    {0x15, false}, // 0x72 r
+    {0x16, false}, // 0x73 s
+    {0x17, false}, // 0x74 t
+    {0x18, false}, // 0x75 u
+    {0x19, false}, // 0x76 v
+    {0x1A, false}, // 0x77 w
+    {0x1B, false}, // 0x78 x
+    {0x1C, false}, // 0x79 y
+    {0x1D, false}, // 0x7A z
+    {0x2F, true},  // 0x7B {
+    {0x31, true},  // 0x7C |
+    {0x30, true},  // 0x7D }
+    {0x35, true},  // 0x7E ~
+};
+
+bool gostt_hid_map_char(char c, uint8_t *keycode, uint8_t *modifier)
+{
+    *modifier = 0;
+    if (c == '\n') {
+        *keycode = 0x28; // Enter
+    } else if (c == '\t') {
+        *keycode = 0x2B; // Tab
+    } else if (c == '\b') {
+        *keycode = 0x2A; // Backspace
+    } else if (c >= 0x20 && c <= 0x7E) {
+        int idx = c - 0x20;
+        *keycode = ascii_map[idx].keycode;
+        if (ascii_map[idx].shift) *modifier = GOSTT_HID_MOD_LSHIFT;
+    } else {
+        return false; // non-ASCII
+    }
+    return true;
+}
+
+static bool holds_key(const gostt_hid_keys_t *keys, uint8_t keycode)
+{
+    for (uint8_t i = 0; i < keys->nkeys; i++) {
+        if (keys->keycodes[i] == keycode) return true;
+    }
+    return false;
+}
+
+void gostt_hid_packer_init(gostt_hid_packer_t *p, const char *text, size_t len,
+                           uint8_t max_keys, bool release_each)
+{
+    memset(p, 0, sizeof(*p));
+    p->text = text;
+    p->len = len;
+    if (max_keys < 1) max_keys = 1;
+    if (max_keys > GOSTT_HID_MAX_KEYS) max_keys = GOSTT_HID_MAX_KEYS;
+    p->max_keys = max_keys;
+    p->release_each = release_each;
+}
+
+bool gostt_hid_packer_next(gostt_hid_packer_t *p, gostt_hid_keys_t *out)
+{
+    uint8_t keycode = 0;
+    uint8_t modifier = 0;
+    while (p->pos < p->len && !gostt_hid_map_char(p->text[p->pos], &keycode, &modifier)) {
+        p->pos++;
+    }
+
+    // Release before the end of the text, a repeated key (the host would see
+    // it as still held) or a modifier change (the order in which the host
+    // applies modifier and key changes within one report is not defined)
+    bool done = p->pos == p->len;
+    if (p->held.nkeys > 0 &&
+        (done || p->release_each || modifier != p->held.modifier ||
+         holds_key(&p->held, keycode))) {
+        memset(&p->held, 0, sizeof(p->held));
+        *out = p->held;
+        return true;
+    }
+    if (done) return false;
+
+    // Press the following characters together while they share the modifier
+    // and neither the previous report nor this one holds their key
+    gostt_hid_keys_t keys = { .modifier = modifier };
+    while (p->pos < p->len && keys.nkeys < p->max_keys) {
+        if (!gostt_hid_map_char(p->text[p->pos], &keycode, &modifier)) {
+            p->pos++;
+            continue;
+        }
+        if (modifier != keys.modifier || holds_key(&keys, keycode) ||
+            holds_key(&p->held, keycode)) {
+            break;
+        }
+        keys.keycodes[keys.nkeys++] = keycode;
+        p->pos++;
+    }
+
+    p->held = keys;
+    *out = keys;
+    return true;
+}
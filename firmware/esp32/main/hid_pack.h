@@ -0,0 +1,53 @@
+// firmware/esp32/main/hid_pack.h
+#ifndef GOSTT_KBD_HID_PACK_H
+#define GOSTT_KBD_HID_PACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Packs text into USB HID boot keyboard reports.
+
+// Keycode slots in a boot keyboard report
+#define GOSTT_HID_MAX_KEYS      6
+
+#define GOSTT_HID_MOD_LSHIFT    0x02
+
+// Keys held by one keyboard report
+typedef struct {
+    uint8_t modifier;
+    uint8_t nkeys;
+    uint8_t keycodes[GOSTT_HID_MAX_KEYS];
+} gostt_hid_keys_t;
+
+// Map a character to its HID keycode and modifier.
+// Only ASCII printable characters (0x20-0x7E), \n, \t and \b (Backspace) are
+// supported.
+// Returns false for any other character.
+bool gostt_hid_map_char(char c, uint8_t *keycode, uint8_t *modifier);
+
+// Packer state for one string. Each report presses only keys the previous
+// report did not hold, so the host registers every keycode in it as a new key
+// press, in slot order. A release (empty report) is only emitted where the
+// next character repeats a held key or needs a different modifier, and once at
+// the end of the text.
+typedef struct {
+    const char      *text;
+    size_t           len;
+    size_t           pos;
+    uint8_t          max_keys;      // keycodes per report, 1-6
+    bool             release_each;  // release after every report
+    gostt_hid_keys_t held;          // last report emitted
+} gostt_hid_packer_t;
+
+// Start packing text. max_keys is clamped to 1-6. With max_keys = 1 and
+// release_each set, the reports are one key press and one release per
+// character.
+void gostt_hid_packer_init(gostt_hid_packer_t *p, const char *text, size_t len,
+                           uint8_t max_keys, bool release_each);
+
+// Produce the next report into out. Unsupported characters are skipped.
+// Returns false once the text is typed and all keys are released.
+bool gostt_hid_packer_next(gostt_hid_packer_t *p, gostt_hid_keys_t *out);
+
+#endif // GOSTT_KBD_HID_PACK_H
@@ -14,18 +14,18 @@
 #include "usb_hid.h"
 #include "mute.h"
 #include "ble_server.h"
+#include "telemetry.h"
 
 static const char *TAG = "gostt-kbd";
 
 static gostt_crypto_ctx_t s_crypto;
 
-// Callback: text received from BLE, type it.
-// NOTE: This blocks the NimBLE host task while typing. Acceptable for typical
-// speech-to-text sentences; for long texts, consider a FreeRTOS queue in V2.
-static void on_text_received(const char *text, size_t len)
+// Callback: text received from BLE, type it. Runs on the BLE crypto worker;
+// the text is queued to the typer task along with its packet slot.
+static void on_text_received(const char *text, size_t len, uint8_t slot)
 {
     ESP_LOGI(TAG, "Typing %zu chars", len);
-    gostt_usb_hid_type_text(text, len);
+    gostt_usb_hid_type_text(text, len, slot);
 }
 
 // Callback: command received from BLE
@@ -41,6 +41,10 @@ static void on_command_received(uint32_t command_type,
             ESP_LOGI(TAG, "Configure mute command (%zu bytes)", data_len);
             gostt_mute_configure(data, data_len);
             break;
+        case GOSTT_CMD_TYPING_CONFIGURE:
+            ESP_LOGI(TAG, "Configure typing command (%zu bytes)", data_len);
+            gostt_usb_hid_configure_typing(data, data_len);
+            break;
         default:
             ESP_LOGW(TAG, "Unknown command type: %u", (unsigned)command_type);
             break;
@@ -103,6 +107,8 @@ void app_main(void)
         ESP_LOGW(TAG, "Crypto init failed — pairing will be required");
     }
 
+    gostt_telemetry_init();
+
     // Initialize USB HID (critical — device is useless without it)
     if (gostt_usb_hid_init() != 0) {
         ESP_LOGE(TAG, "USB HID init failed");
@@ -0,0 +1,78 @@
+// firmware/esp32/main/pkt_pool.c
+#include "pkt_pool.h"
+
+#define ALL_SLOTS ((uint32_t)(((uint64_t)1 << GOSTT_PKT_SLOTS) - 1))
+
+static gostt_pkt_t s_pkts[GOSTT_PKT_SLOTS];
+static atomic_uint_least32_t s_free_mask; // bit set = slot free
+static gostt_pkt_release_hook_t s_release_hook;
+
+void gostt_pkt_pool_init(void)
+{
+    atomic_store(&s_free_mask, ALL_SLOTS);
+}
+
+int gostt_pkt_alloc(void)
+{
+    uint32_t mask = atomic_load_explicit(&s_free_mask, memory_order_relaxed);
+    while (mask != 0) {
+        int slot = __builtin_ctz(mask);
+        // Acquire: the previous owner's writes to the slot happen before ours
+        if (atomic_compare_exchange_weak_explicit(&s_free_mask, &mask,
+                                                  mask & ~((uint32_t)1 << slot),
+                                                  memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+void gostt_pkt_set_release_hook(gostt_pkt_release_hook_t hook)
+{
+    s_release_hook = hook;
+}
+
+void gostt_pkt_free(uint8_t slot)
+{
+    atomic_fetch_or_explicit(&s_free_mask, (uint32_t)1 << slot, memory_order_release);
+    if (s_release_hook) s_release_hook();
+}
+
+gostt_pkt_t *gostt_pkt_get(uint8_t slot)
+{
+    return &s_pkts[slot];
+}
+
+unsigned gostt_pkt_free_count(void)
+{
+    return (unsigned)__builtin_popcount(atomic_load_explicit(&s_free_mask, memory_order_relaxed));
+}
+
+void gostt_pkt_ring_init(gostt_pkt_ring_t *r)
+{
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+}
+
+bool gostt_pkt_ring_push(gostt_pkt_ring_t *r, uint8_t slot)
+{
+    unsigned tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&r->head, memory_order_acquire);
+    if (tail - head == GOSTT_PKT_SLOTS) return false;
+
+    r->slots[tail % GOSTT_PKT_SLOTS] = slot;
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+bool gostt_pkt_ring_pop(gostt_pkt_ring_t *r, uint8_t *slot)
+{
+    unsigned head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    if (head == tail) return false;
+
+    *slot = r->slots[head % GOSTT_PKT_SLOTS];
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+    return true;
+}
@@ -0,0 +1,74 @@
+// firmware/esp32/main/pkt_pool.h
+#ifndef GOSTT_KBD_PKT_POOL_H
+#define GOSTT_KBD_PKT_POOL_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "crypto.h"
+
+// Static slab of received packet buffers, handed between tasks by slot index
+// so the receive path never touches the heap. A slot is owned by exactly one
+// task at a time: the NimBLE host task allocates it and fills data, the crypto
+// worker decrypts into plaintext, and whoever finishes with it (the worker on
+// commands and errors, the typer after typing) frees it.
+
+_Static_assert(GOSTT_PKT_SLOTS <= 32 && (GOSTT_PKT_SLOTS & (GOSTT_PKT_SLOTS - 1)) == 0,
+               "GOSTT_PKT_SLOTS must be a power of two, at most 32");
+
+// One received packet
+typedef struct {
+    uint16_t len;                                             // bytes in data
+    uint8_t  data[GOSTT_PKT_MAX_LEN];                         // DataPacket as written
+    uint8_t  plaintext[GOSTT_PLAINTEXT_SIZE(GOSTT_PKT_MAX_LEN)]; // decrypted EncryptedData
+    char     text[GOSTT_PKT_TEXT_MAX];                        // joined/unpacked text for the typer
+    uint32_t backspaces;                                      // characters to delete before the text
+    uint32_t rx_us;                                           // stage timestamps, see telemetry.h
+    uint32_t decrypted_us;
+    uint32_t enqueued_us;
+} gostt_pkt_t;
+
+// Reset the pool: every slot free. Not thread-safe; call during startup.
+void gostt_pkt_pool_init(void);
+
+// Called after every gostt_pkt_free, on the freeing task, so the receive
+// window can be re-advertised. Must not block.
+typedef void (*gostt_pkt_release_hook_t)(void);
+
+// Install the release hook (NULL to remove). Not thread-safe; call during
+// startup.
+void gostt_pkt_set_release_hook(gostt_pkt_release_hook_t hook);
+
+// Claim a free slot. Lock-free; safe from any task.
+// Returns the slot index, or -1 if all slots are in flight.
+int gostt_pkt_alloc(void);
+
+// Return a slot to the pool. Lock-free; safe from any task.
+void gostt_pkt_free(uint8_t slot);
+
+// Buffer of an allocated slot.
+gostt_pkt_t *gostt_pkt_get(uint8_t slot);
+
+// Number of free slots (a snapshot, for logging).
+unsigned gostt_pkt_free_count(void);
+
+// Single-producer single-consumer FIFO of slot indices. It holds every slot,
+// so a push of an allocated slot never fails. Push publishes the slot's
+// contents to the consumer (release/acquire on the indices).
+typedef struct {
+    atomic_uint head;  // next pop, written by the consumer
+    atomic_uint tail;  // next push, written by the producer
+    uint8_t     slots[GOSTT_PKT_SLOTS];
+} gostt_pkt_ring_t;
+
+void gostt_pkt_ring_init(gostt_pkt_ring_t *r);
+
+// Producer side. Returns false if the ring is full.
+bool gostt_pkt_ring_push(gostt_pkt_ring_t *r, uint8_t slot);
+
+// Consumer side. Returns false if the ring is empty.
+bool gostt_pkt_ring_pop(gostt_pkt_ring_t *r, uint8_t *slot);
+
+#endif // GOSTT_KBD_PKT_POOL_H
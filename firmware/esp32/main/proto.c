@@ -139,6 +139,7 @@ int gostt_decode_encrypted_data(const uint8_t *buf, size_t len, gostt_encrypted_
             if (n == 0) return -1;
             pos += n;
             if (field_num == 2) out->command_type = (uint32_t)val;
+            if (field_num == 6) out->backspaces = (uint32_t)val;
         } else if (wire_type == 2) {
             uint64_t field_len;
             n = read_varint(buf + pos, len - pos, &field_len);
@@ -155,6 +156,13 @@ int gostt_decode_encrypted_data(const uint8_t *buf, size_t len, gostt_encrypted_
                     out->command_data = (uint8_t *)(buf + pos);
                     out->command_data_len = (size_t)field_len;
                     break;
+                case 4:
+                    out->packed_text = (uint8_t *)(buf + pos);
+                    out->packed_text_len = (size_t)field_len;
+                    break;
+                case 5:
+                    out->record_count++;
+                    break;
             }
             pos += (size_t)field_len;
         } else {
@@ -164,6 +172,35 @@ int gostt_decode_encrypted_data(const uint8_t *buf, size_t len, gostt_encrypted_
     return 0;
 }
 
+int gostt_next_record(const uint8_t *buf, size_t len, size_t *pos, gostt_encrypted_data_t *out)
+{
+    while (*pos < len) {
+        uint64_t tag_val;
+        int n = read_varint(buf + *pos, len - *pos, &tag_val);
+        if (n == 0) return -1;
+        *pos += n;
+
+        uint32_t field_num = (uint32_t)(tag_val >> 3);
+        uint32_t wire_type = (uint32_t)(tag_val & 0x07);
+
+        uint64_t val;
+        n = read_varint(buf + *pos, len - *pos, &val);
+        if (n == 0) return -1;
+        *pos += n;
+        if (wire_type == 0) continue;
+        if (wire_type != 2) return -1;
+        if (val > len - *pos) return -1;
+
+        const uint8_t *field = buf + *pos;
+        *pos += (size_t)val;
+        if (field_num != 5) continue;
+        if (gostt_decode_encrypted_data(field, (size_t)val, out) != 0) return -1;
+        if (out->record_count > 0) return -1; // records do not nest
+        return 1;
+    }
+    return 0;
+}
+
 int gostt_encode_response_packet(uint8_t *buf, size_t buf_len,
                                   gostt_response_type_t type,
                                   gostt_peer_status_t peer_status,
@@ -199,3 +236,28 @@ int gostt_encode_response_packet(uint8_t *buf, size_t buf_len,
 
     return (int)pos;
 }
+
+int gostt_encode_link_params(uint8_t *buf, size_t buf_len, const gostt_link_params_t *params)
+{
+    if (buf_len < GOSTT_LINK_PARAMS_LEN) return -1;
+    buf[0] = (uint8_t)(params->mtu & 0xFF);
+    buf[1] = (uint8_t)(params->mtu >> 8);
+    buf[2] = params->tx_phy;
+    buf[3] = params->rx_phy;
+    buf[4] = (uint8_t)(params->max_tx_octets & 0xFF);
+    buf[5] = (uint8_t)(params->max_tx_octets >> 8);
+    buf[6] = params->features;
+    return GOSTT_LINK_PARAMS_LEN;
+}
+
+int gostt_encode_credits(uint8_t *buf, size_t buf_len, const gostt_credits_t *credits)
+{
+    if (buf_len < GOSTT_CREDITS_LEN) return -1;
+    buf[0] = (uint8_t)(credits->received & 0xFF);
+    buf[1] = (uint8_t)((credits->received >> 8) & 0xFF);
+    buf[2] = (uint8_t)((credits->received >> 16) & 0xFF);
+    buf[3] = (uint8_t)(credits->received >> 24);
+    buf[4] = credits->free_slots;
+    buf[5] = credits->total_slots;
+    return GOSTT_CREDITS_LEN;
+}
@@ -21,20 +21,31 @@ typedef struct {
     uint32_t length;       // redundant length field from protobuf
 } gostt_keyboard_packet_t;
 
-// EncryptedData (inner wrapper)
-// command_type: 0=text (keyboard_packet present), 1=mute_toggle, 2=configure_mute
+// EncryptedData (inner wrapper), also the layout of each batched record
+// command_type: 0=text (keyboard_packet or packed_text present), 1=mute_toggle,
+// 2=configure_mute, 3=typing_configure
+// A batched frame carries no fields of its own, only records (field 5, each an
+// EncryptedData without records), handled in order.
+// A text record may also delete characters before it (field 6, see
+// textedit.h); with backspaces set, the text may be absent.
 typedef struct {
     uint8_t *keyboard_packet_data;
     size_t   keyboard_packet_data_len;
     uint32_t command_type;
     uint8_t *command_data;
     size_t   command_data_len;
+    uint8_t *packed_text;          // field 4: dictionary-packed text, see textdict.h
+    size_t   packed_text_len;
+    size_t   record_count;         // field 5 occurrences
+    uint32_t backspaces;           // field 6: characters to delete before the text
 } gostt_encrypted_data_t;
 
 // ResponsePacket types
 typedef enum {
     GOSTT_RESP_KEEPALIVE   = 0,
     GOSTT_RESP_PEER_STATUS = 1,
+    GOSTT_RESP_LINK_PARAMS = 2,
+    GOSTT_RESP_CREDITS     = 3,
 } gostt_response_type_t;
 
 typedef enum {
@@ -42,6 +53,41 @@ typedef enum {
     GOSTT_PEER_KNOWN   = 1,
 } gostt_peer_status_t;
 
+// Negotiated link parameters, sent as the data of a GOSTT_RESP_LINK_PARAMS
+// ResponsePacket in a fixed little-endian layout:
+//   bytes 0-1: ATT MTU
+//   byte  2:   TX PHY (1 = 1M, 2 = 2M, 3 = Coded)
+//   byte  3:   RX PHY
+//   bytes 4-5: link layer max TX octets (27 without Data Length Extension)
+//   byte  6:   GOSTT_FEATURE_* bits, framing this firmware decodes
+typedef struct {
+    uint16_t mtu;
+    uint8_t  tx_phy;
+    uint8_t  rx_phy;
+    uint16_t max_tx_octets;
+    uint8_t  features;
+} gostt_link_params_t;
+
+#define GOSTT_LINK_PARAMS_LEN 7
+
+#define GOSTT_FEATURE_BATCH  (1 << 0) // EncryptedData records (field 5)
+#define GOSTT_FEATURE_DICT   (1 << 1) // packed_text (field 4)
+#define GOSTT_FEATURE_EDIT   (1 << 2) // backspaces (field 6)
+
+// Receive window, sent as the data of a GOSTT_RESP_CREDITS ResponsePacket in
+// a fixed little-endian layout:
+//   bytes 0-3: TX writes received on this connection (wraps)
+//   byte  4:   free packet slots, sampled after the count
+//   byte  5:   total packet slots
+// The app may have (free - (writes sent - writes received)) packets in flight.
+typedef struct {
+    uint32_t received;
+    uint8_t  free_slots;
+    uint8_t  total_slots;
+} gostt_credits_t;
+
+#define GOSTT_CREDITS_LEN 6
+
 // Decode a DataPacket from raw protobuf bytes.
 // encrypted_data pointer is into the input buffer (not copied) — caller must not free input while using result.
 // Returns 0 on success, -1 on error.
@@ -57,6 +103,12 @@ int gostt_decode_keyboard_packet(const uint8_t *buf, size_t len, gostt_keyboard_
 // Returns 0 on success, -1 on error.
 int gostt_decode_encrypted_data(const uint8_t *buf, size_t len, gostt_encrypted_data_t *out);
 
+// Decode the next record of a batched EncryptedData, scanning buf from *pos
+// (start at 0) and advancing it. Pointers are into the input buffer.
+// Returns 1 with the record in out, 0 when no records remain, -1 on error
+// (including a record that itself contains records).
+int gostt_next_record(const uint8_t *buf, size_t len, size_t *pos, gostt_encrypted_data_t *out);
+
 // Encode a ResponsePacket into buf. Returns number of bytes written, or -1 on error.
 // buf must be at least 64 + data_len bytes.
 int gostt_encode_response_packet(uint8_t *buf, size_t buf_len,
@@ -64,4 +116,12 @@ int gostt_encode_response_packet(uint8_t *buf, size_t buf_len,
                                   gostt_peer_status_t peer_status,
                                   const uint8_t *data, size_t data_len);
 
+// Encode link parameters into buf (GOSTT_LINK_PARAMS_LEN bytes).
+// Returns number of bytes written, or -1 if buf is too small.
+int gostt_encode_link_params(uint8_t *buf, size_t buf_len, const gostt_link_params_t *params);
+
+// Encode a receive window into buf (GOSTT_CREDITS_LEN bytes).
+// Returns number of bytes written, or -1 if buf is too small.
+int gostt_encode_credits(uint8_t *buf, size_t buf_len, const gostt_credits_t *credits);
+
 #endif // GOSTT_KBD_PROTO_H
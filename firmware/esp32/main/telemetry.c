@@ -0,0 +1,110 @@
+// firmware/esp32/main/telemetry.c
+#include "telemetry.h"
+#include <stdatomic.h>
+
+typedef struct {
+    atomic_uint_fast32_t count;
+    _Atomic uint64_t     sum_us;
+    atomic_uint_fast32_t max_us;
+    atomic_uint_fast32_t buckets[GOSTT_TELEMETRY_BUCKETS];
+} stage_hist_t;
+
+static atomic_uint_fast32_t s_counters[GOSTT_CTR_COUNT];
+static atomic_uint_fast32_t s_queue_hwm;
+static stage_hist_t s_stages[GOSTT_STAGE_COUNT];
+
+void gostt_telemetry_init(void)
+{
+    for (int i = 0; i < GOSTT_CTR_COUNT; i++) {
+        atomic_init(&s_counters[i], 0);
+    }
+    atomic_init(&s_queue_hwm, 0);
+    for (int s = 0; s < GOSTT_STAGE_COUNT; s++) {
+        atomic_init(&s_stages[s].count, 0);
+        atomic_init(&s_stages[s].sum_us, 0);
+        atomic_init(&s_stages[s].max_us, 0);
+        for (int b = 0; b < GOSTT_TELEMETRY_BUCKETS; b++) {
+            atomic_init(&s_stages[s].buckets[b], 0);
+        }
+    }
+}
+
+void gostt_telemetry_count(gostt_counter_t counter)
+{
+    if (counter >= GOSTT_CTR_COUNT) return;
+    atomic_fetch_add_explicit(&s_counters[counter], 1, memory_order_relaxed);
+}
+
+// Raise *max to value if it is lower.
+static void store_max(atomic_uint_fast32_t *max, uint32_t value)
+{
+    uint_fast32_t cur = atomic_load_explicit(max, memory_order_relaxed);
+    while (cur < value &&
+           !atomic_compare_exchange_weak_explicit(max, &cur, value,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+void gostt_telemetry_queue_depth(uint32_t depth)
+{
+    store_max(&s_queue_hwm, depth);
+}
+
+void gostt_telemetry_stage(gostt_stage_t stage, uint32_t start_us, uint32_t end_us)
+{
+    if (stage >= GOSTT_STAGE_COUNT) return;
+    uint32_t d = end_us - start_us;
+
+    int b = 0;
+    while (b < GOSTT_TELEMETRY_BUCKETS - 1 &&
+           d >= ((uint32_t)GOSTT_TELEMETRY_BUCKET0_US << b)) {
+        b++;
+    }
+
+    stage_hist_t *h = &s_stages[stage];
+    atomic_fetch_add_explicit(&h->buckets[b], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum_us, d, memory_order_relaxed);
+    store_max(&h->max_us, d);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((v >> 8) & 0xFF);
+    p[2] = (uint8_t)((v >> 16) & 0xFF);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+int gostt_telemetry_encode(uint8_t *buf, size_t buf_len,
+                           uint32_t free_heap, uint32_t min_free_heap)
+{
+    if (buf_len < GOSTT_TELEMETRY_LEN) return -1;
+
+    uint8_t *p = buf;
+    *p++ = GOSTT_TELEMETRY_VERSION;
+    *p++ = GOSTT_STAGE_COUNT;
+    *p++ = GOSTT_TELEMETRY_BUCKETS;
+    *p++ = 0;
+    for (int i = 0; i < GOSTT_CTR_COUNT; i++) {
+        p = put_u32(p, (uint32_t)atomic_load_explicit(&s_counters[i], memory_order_relaxed));
+    }
+    p = put_u32(p, (uint32_t)atomic_load_explicit(&s_queue_hwm, memory_order_relaxed));
+    p = put_u32(p, free_heap);
+    p = put_u32(p, min_free_heap);
+
+    for (int s = 0; s < GOSTT_STAGE_COUNT; s++) {
+        const stage_hist_t *h = &s_stages[s];
+        uint64_t sum = atomic_load_explicit(&h->sum_us, memory_order_relaxed);
+        p = put_u32(p, (uint32_t)atomic_load_explicit(&h->count, memory_order_relaxed));
+        p = put_u32(p, (uint32_t)(sum & 0xFFFFFFFF));
+        p = put_u32(p, (uint32_t)(sum >> 32));
+        p = put_u32(p, (uint32_t)atomic_load_explicit(&h->max_us, memory_order_relaxed));
+        for (int b = 0; b < GOSTT_TELEMETRY_BUCKETS; b++) {
+            p = put_u32(p, (uint32_t)atomic_load_explicit(&h->buckets[b], memory_order_relaxed));
+        }
+    }
+    return (int)(p - buf);
+}
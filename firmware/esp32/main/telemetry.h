@@ -0,0 +1,70 @@
+// firmware/esp32/main/telemetry.h
+#ifndef GOSTT_KBD_TELEMETRY_H
+#define GOSTT_KBD_TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Runtime counters and per-stage latency histograms for the receive pipeline,
+// read by the app from the stats characteristic. Recording is lock-free and
+// safe from any task; a read may see a stage's count and buckets a few
+// samples apart.
+//
+// Timestamps are microseconds of a free-running clock (esp_timer_get_time()
+// on the device) truncated to 32 bits; stage deltas wrap correctly up to ~71
+// minutes.
+
+typedef enum {
+    GOSTT_CTR_RX = 0,           // TX writes received
+    GOSTT_CTR_DROPPED,          // writes dropped: too large, no free slot, typer queue full
+    GOSTT_CTR_DECRYPT_FAIL,     // packets that failed to decode or authenticate
+    GOSTT_CTR_COUNT,
+} gostt_counter_t;
+
+// Stages of a text packet, each from the end of the previous one
+typedef enum {
+    GOSTT_STAGE_DECRYPT = 0,    // received -> decrypted (includes worker wait)
+    GOSTT_STAGE_ENQUEUE,        // decrypted -> in the typer queue
+    GOSTT_STAGE_FIRST_KEY,      // queued -> first HID report sent
+    GOSTT_STAGE_TYPING,         // first -> last HID report
+    GOSTT_STAGE_TOTAL,          // received -> last HID report
+    GOSTT_STAGE_COUNT,
+} gostt_stage_t;
+
+// Histogram buckets: bucket i counts latencies below
+// GOSTT_TELEMETRY_BUCKET0_US << i; the last also counts everything longer
+#define GOSTT_TELEMETRY_BUCKETS     16
+#define GOSTT_TELEMETRY_BUCKET0_US  64
+
+#define GOSTT_TELEMETRY_VERSION     1
+
+// Encoded size, in a fixed little-endian layout:
+//   byte  0:     GOSTT_TELEMETRY_VERSION
+//   byte  1:     GOSTT_STAGE_COUNT
+//   byte  2:     GOSTT_TELEMETRY_BUCKETS
+//   byte  3:     reserved (0)
+//   bytes 4-27:  u32 writes received, dropped, decrypt failures,
+//                typer queue high-water mark, free heap, minimum free heap
+//   then per stage: u32 count, u64 sum (us), u32 max (us), u32 buckets[]
+#define GOSTT_TELEMETRY_STAGE_LEN   (16 + 4 * GOSTT_TELEMETRY_BUCKETS)
+#define GOSTT_TELEMETRY_LEN         (28 + GOSTT_STAGE_COUNT * GOSTT_TELEMETRY_STAGE_LEN)
+
+// Reset every counter. Not thread-safe; call during startup.
+void gostt_telemetry_init(void);
+
+// Count one event.
+void gostt_telemetry_count(gostt_counter_t counter);
+
+// Record the typer queue depth after an enqueue; keeps the high-water mark.
+void gostt_telemetry_queue_depth(uint32_t depth);
+
+// Record one stage that ran from start_us to end_us.
+void gostt_telemetry_stage(gostt_stage_t stage, uint32_t start_us, uint32_t end_us);
+
+// Encode the counters with the given heap figures into buf
+// (GOSTT_TELEMETRY_LEN bytes). Returns bytes written, or -1 if buf is too
+// small.
+int gostt_telemetry_encode(uint8_t *buf, size_t buf_len,
+                           uint32_t free_heap, uint32_t min_free_heap);
+
+#endif // GOSTT_KBD_TELEMETRY_H
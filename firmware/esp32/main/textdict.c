@@ -0,0 +1,45 @@
+// firmware/esp32/main/textdict.c
+#include "textdict.h"
+#include <string.h>
+
+// Common English words, most frequent first. A code expands to a space and
+// the word. Must match internal/ble/protocol/dict.go; the app only packs text
+// for firmware advertising GOSTT_FEATURE_DICT, so changing the table needs a
+// new feature bit.
+static const char *const dict_words[GOSTT_DICT_WORDS] = {
+    "the", "of", "and", "to", "in", "is", "you", "that", "it", "he", "was",
+    "for", "on", "are", "as", "with", "his", "they", "at", "be", "this",
+    "have", "from", "or", "one", "had", "by", "word", "but", "not", "what",
+    "all", "were", "we", "when", "your", "can", "said", "there", "use", "an",
+    "each", "which", "she", "do", "how", "their", "if", "will", "up", "other",
+    "about", "out", "many", "then", "them", "these", "so", "some", "her",
+    "would", "make", "like", "him", "into", "time", "has", "look", "two",
+    "more", "write", "go", "see", "number", "no", "way", "could", "people",
+    "my", "than", "first", "water", "been", "call", "who", "its", "now",
+    "find", "long", "down", "day", "did", "get", "come", "made", "may", "part",
+    "just", "know", "think", "should", "because", "also", "after", "well",
+    "want", "need", "here", "very", "through", "where", "work", "new", "good",
+    "over", "only", "year", "back", "any", "most", "thing", "those", "even",
+    "give", "take", "our", "really", "something",
+};
+
+int gostt_dict_expand(const uint8_t *src, size_t len, char *dst, size_t dst_len)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (src[i] != GOSTT_DICT_ESCAPE) {
+            if (out >= dst_len) return -1;
+            dst[out++] = (char)src[i];
+            continue;
+        }
+        if (++i >= len) return -1;       // truncated code
+        if (src[i] >= GOSTT_DICT_WORDS) return -1;
+        const char *word = dict_words[src[i]];
+        size_t wlen = strlen(word);
+        if (out + 1 + wlen > dst_len) return -1;
+        dst[out++] = ' ';
+        memcpy(dst + out, word, wlen);
+        out += wlen;
+    }
+    return (int)out;
+}
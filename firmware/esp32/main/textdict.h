@@ -0,0 +1,21 @@
+// firmware/esp32/main/textdict.h
+#ifndef GOSTT_KBD_TEXTDICT_H
+#define GOSTT_KBD_TEXTDICT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Static word dictionary for packed text (EncryptedData field 4). Packed text
+// is the UTF-8 text with some " word" runs replaced by a two-byte code:
+// GOSTT_DICT_ESCAPE followed by the word's index. Text never contains NUL, so
+// every other byte is literal.
+
+#define GOSTT_DICT_ESCAPE 0x00
+#define GOSTT_DICT_WORDS  128
+
+// Expand packed text into dst (not NUL-terminated).
+// Returns the expanded length, or -1 on a truncated or unknown code, or if
+// dst is too small.
+int gostt_dict_expand(const uint8_t *src, size_t len, char *dst, size_t dst_len);
+
+#endif // GOSTT_KBD_TEXTDICT_H
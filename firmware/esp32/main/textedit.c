@@ -0,0 +1,33 @@
+// firmware/esp32/main/textedit.c
+#include "textedit.h"
+#include "hid_pack.h"
+#include <string.h>
+
+static bool typeable(char c)
+{
+    uint8_t keycode, modifier;
+    return gostt_hid_map_char(c, &keycode, &modifier);
+}
+
+void gostt_edit_delete(gostt_edit_t *e, uint32_t n)
+{
+    while (n > 0) {
+        // Untypeable bytes at the end never reached the host
+        while (e->len > 0 && !typeable(e->text[e->len - 1])) e->len--;
+        if (e->len == 0) break;
+        e->len--;
+        n--;
+    }
+    e->backspaces += n;
+}
+
+bool gostt_edit_merge(gostt_edit_t *e, uint32_t backspaces, const char *text, size_t len)
+{
+    gostt_edit_t merged = *e;
+    gostt_edit_delete(&merged, backspaces);
+    if (len > merged.cap - merged.len) return false;
+    memmove(merged.text + merged.len, text, len);
+    merged.len += len;
+    *e = merged;
+    return true;
+}
@@ -0,0 +1,33 @@
+// firmware/esp32/main/textedit.h
+#ifndef GOSTT_KBD_TEXTEDIT_H
+#define GOSTT_KBD_TEXTEDIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+// Streaming corrections. An edit deletes some characters before the cursor
+// (HID backspaces), then types its text. Edits that have not been typed yet
+// can be merged: a later edit's backspaces first remove the earlier edit's
+// untyped text, so superseded text is never typed and deleted again.
+
+// A pending edit over a caller-owned text buffer
+typedef struct {
+    char    *text;
+    size_t   len;
+    size_t   cap;
+    uint32_t backspaces;  // characters to delete before typing text
+} gostt_edit_t;
+
+// Delete n characters from the end of the edit, as n backspaces typed after
+// it would. Each removes the last typeable character of text (see
+// gostt_hid_map_char) along with any untypeable bytes after it, which would
+// not have appeared on the host; once text is empty the rest are added to
+// backspaces.
+void gostt_edit_delete(gostt_edit_t *e, uint32_t n);
+
+// Merge a later edit (delete backspaces, then type text) into e.
+// Returns false, leaving e unchanged, if the merged text would not fit cap.
+bool gostt_edit_merge(gostt_edit_t *e, uint32_t backspaces, const char *text, size_t len);
+
+#endif // GOSTT_KBD_TEXTEDIT_H
@@ -1,10 +1,15 @@
 // firmware/esp32/main/usb_hid.c
 #include "usb_hid.h"
+#include "hid_pack.h"
+#include "pkt_pool.h"
+#include "textedit.h"
+#include "telemetry.h"
 #include "config.h"
 #include <stdbool.h>
-#include <stdlib.h>
 #include <string.h>
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
 #include "tinyusb.h"
 #include "tinyusb_default_config.h"
 #include "tusb.h"
@@ -13,6 +18,8 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/portmacro.h"
 
 static const char *TAG = "gostt-usb";
 
@@ -22,17 +29,25 @@ static const char *TAG = "gostt-usb";
 // can cause reports to be queued but never flushed. Running the typer on
 // Core 1 alongside the TinyUSB task avoids this.
 
-#define TYPER_QUEUE_DEPTH   4
+// Every packet slot can be waiting here, so the crypto worker never blocks
+#define TYPER_QUEUE_DEPTH   GOSTT_PKT_SLOTS
 #define TYPER_STACK_SIZE    4096
 
 typedef struct {
-    char   *text;   // heap-allocated, freed by typer task
-    size_t  len;
+    const char *text;   // in the packet slot's plaintext
+    size_t      len;
+    uint8_t     slot;   // freed by typer task once typed
 } typer_msg_t;
 
 static QueueHandle_t s_typer_queue;
 static TaskHandle_t  s_typer_task;
 
+// Given by TinyUSB each time the host has read a report from the HID endpoint
+static SemaphoreHandle_t s_hid_report_done;
+
+static gostt_typing_config_t s_typing_cfg;
+static portMUX_TYPE s_typing_lock = portMUX_INITIALIZER_UNLOCKED;
+
 // Forward declarations
 static void typer_task(void *arg);
 
@@ -76,7 +91,7 @@ static const uint8_t desc_configuration[] = {
                           TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
     TUD_HID_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_NONE,
                        sizeof(hid_report_descriptor), EPNUM_HID,
-                       CFG_TUD_HID_EP_BUFSIZE, 5),
+                       CFG_TUD_HID_EP_BUFSIZE, GOSTT_HID_POLL_INTERVAL_MS),
 };
 
 // String descriptors
@@ -94,112 +109,6 @@ typedef struct __attribute__((packed)) {
     uint8_t keycodes[6];
 } keyboard_report_t;
 
-// ASCII to HID keycode mapping
-typedef struct {
-    uint8_t keycode;
-    bool    shift;
-} ascii_to_hid_t;
-
-// Lookup table for ASCII 0x20 (space) through 0x7E (~)
-// Index = ascii_code - 0x20
-static const ascii_to_hid_t ascii_map[95] = {
-    {0x2C, false}, // 0x20 space
-    {0x1E, true},  // 0x21 !
-    {0x34, true},  // 0x22 "
-    {0x20, true},  // 0x23 #
-    {0x21, true},  // 0x24 $
-    {0x22, true},  // 0x25 %
-    {0x24, true},  // 0x26 &
-    {0x34, false}, // 0x27 '
-    {0x26, true},  // 0x28 (
-    {0x27, true},  // 0x29 )
-    {0x25, true},  // 0x2A *
-    {0x2E, true},  // 0x2B +
-    {0x36, false}, // 0x2C ,
-    {0x2D, false}, // 0x2D -
-    {0x37, false}, // 0x2E .
-    {0x38, false}, // 0x2F /
-    {0x27, false}, // 0x30 0
-    {0x1E, false}, // 0x31 1
-    {0x1F, false}, // 0x32 2
-    {0x20, false}, // 0x33 3
-    {0x21, false}, // 0x34 4
-    {0x22, false}, // 0x35 5
-    {0x23, false}, // 0x36 6
-    {0x24, false}, // 0x37 7
-    {0x25, false}, // 0x38 8
-    {0x26, false}, // 0x39 9
-    {0x33, true},  // 0x3A :
-    {0x33, false}, // 0x3B ;
-    {0x36, true},  // 0x3C <
-    {0x2E, false}, // 0x3D =
-    {0x37, true},  // 0x3E >
-    {0x38, true},  // 0x3F ?
-    {0x1F, true},  // 0x40 @
-    {0x04, true},  // 0x41 A
-    {0x05, true},  // 0x42 B
-    {0x06, true},  // 0x43 C
-    {0x07, true},  // 0x44 D
-    {0x08, true},  // 0x45 E
-    {0x09, true},  // 0x46 F
-    {0x0A, true},  // 0x47 G
-    {0x0B, true},  // 0x48 H
-    {0x0C, true},  // 0x49 I
-    {0x0D, true},  // 0x4A J
-    {0x0E, true},  // 0x4B K
-    {0x0F, true},  // 0x4C L
-    {0x10, true},  // 0x4D M
-    {0x11, true},  // 0x4E N
-    {0x12, true},  // 0x4F O
-    {0x13, true},  // 0x50 P
-    {0x14, true},  // 0x51 Q
-    {0x15, true},  // 0x52 R
-    {0x16, true},  // 0x53 S
-    {0x17, true},  // 0x54 T
-    {0x18, true},  // 0x55 U
-    {0x19, true},  // 0x56 V
-    {0x1A, true},  // 0x57 W
-    {0x1B, true},  // 0x58 X
-    {0x1C, true},  // 0x59 Y
-    {0x1D, true},  // 0x5A Z
-    {0x2F, false}, // 0x5B [
-    {0x31, false}, // 0x5C backslash
-    {0x30, false}, // 0x5D ]
-    {0x23, true},  // 0x5E ^
-    {0x2D, true},  // 0x5F _
-    {0x35, false}, // 0x60 `
-    {0x04, false}, // 0x61 a
-    {0x05, false}, // 0x62 b
-    {0x06, false}, // 0x63 c
-    {0x07, false}, // 0x64 d
-    {0x08, false}, // 0x65 e
-    {0x09, false}, // 0x66 f
-    {0x0A, false}, // 0x67 g
-    {0x0B, false}, // 0x68 h
-    {0x0C, false}, // 0x69 i
-    {0x0D, false}, // 0x6A j
-    {0x0E, false}, // 0x6B k
-    {0x0F, false}, // 0x6C l
-    {0x10, false}, // 0x6D m
-    {0x11, false}, // 0x6E n
-    {0x12, false}, // 0x6F o
-    {0x13, false}, // 0x70 p
-    {0x14, false}, // 0x71 q
-    {0x15, false}, // 0x72 r
-    {0x16, false}, // 0x73 s
-    {0x17, false}, // 0x74 t
-    {0x18, false}, // 0x75 u
-    {0x19, false}, // 0x76 v
-    {0x1A, false}, // 0x77 w
-    {0x1B, false}, // 0x78 x
-    {0x1C, false}, // 0x79 y
-    {0x1D, false}, // 0x7A z
-    {0x2F, true},  // 0x7B {
-    {0x31, true},  // 0x7C |
-    {0x30, true},  // 0x7D }
-    {0x35, true},  // 0x7E ~
-};
-
 // USB event callback (called by esp_tinyusb on mount/unmount/suspend/resume)
 static void usb_event_cb(tinyusb_event_t *event, void *arg)
 {
@@ -217,8 +126,56 @@ static void usb_event_cb(tinyusb_event_t *event, void *arg)
     }
 }
 
+static void set_default_typing_config(void)
+{
+    s_typing_cfg.mode = GOSTT_TYPING_FAST;
+    s_typing_cfg.max_keys = GOSTT_HID_MAX_KEYS;
+}
+
+static bool typing_config_valid(const gostt_typing_config_t *cfg)
+{
+    return (cfg->mode == GOSTT_TYPING_FAST || cfg->mode == GOSTT_TYPING_CONSERVATIVE) &&
+           cfg->max_keys >= 1 && cfg->max_keys <= GOSTT_HID_MAX_KEYS;
+}
+
+static void load_typing_config(void)
+{
+    set_default_typing_config();
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(GOSTT_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGI(TAG, "No NVS typing config — using default (fast)");
+        return;
+    }
+
+    // Read into a local copy: a blob written by another firmware build may
+    // have a different layout or out-of-range fields
+    gostt_typing_config_t cfg;
+    size_t cfg_len = sizeof(cfg);
+    err = nvs_get_blob(handle, GOSTT_NVS_KEY_TYPING_CFG, &cfg, &cfg_len);
+    if (err != ESP_OK || cfg_len != sizeof(cfg) || !typing_config_valid(&cfg)) {
+        ESP_LOGI(TAG, "NVS typing config invalid — using default");
+    } else {
+        s_typing_cfg = cfg;
+        ESP_LOGI(TAG, "Loaded typing config from NVS (mode=%d, max_keys=%u)",
+                 s_typing_cfg.mode, s_typing_cfg.max_keys);
+    }
+
+    nvs_close(handle);
+}
+
 int gostt_usb_hid_init(void)
 {
+    load_typing_config();
+
+    // Created before the driver so the report-complete callback can use it
+    s_hid_report_done = xSemaphoreCreateBinary();
+    if (!s_hid_report_done) {
+        ESP_LOGE(TAG, "Failed to create HID report semaphore");
+        return -1;
+    }
+
     const tinyusb_config_t tusb_cfg = {
         .port = TINYUSB_PORT_FULL_SPEED_0,
         .task = TINYUSB_TASK_DEFAULT(),
@@ -279,17 +236,30 @@ void tud_hid_set_report_cb(uint8_t instance, uint8_t report_id,
     (void)instance; (void)report_id; (void)report_type; (void)buffer; (void)bufsize;
 }
 
+// Runs in the TinyUSB task once the host has polled the last report
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const *report, uint16_t len)
+{
+    (void)instance; (void)report; (void)len;
+    xSemaphoreGive(s_hid_report_done);
+}
+
 // Wait for HID endpoint to be ready before sending a report.
+// Blocks on the report-complete callback rather than polling, so the wait
+// ends as soon as the host has read the previous report (one polling interval
+// at most) instead of on the next scheduler tick. A give left over from an
+// earlier report only costs one extra check of tud_hid_ready().
 // Returns true if ready, false on timeout.
 static bool wait_hid_ready(uint32_t timeout_ms)
 {
     TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
     while (!tud_hid_ready()) {
-        if ((xTaskGetTickCount() - start) > pdMS_TO_TICKS(timeout_ms)) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed > timeout) {
             ESP_LOGW(TAG, "HID endpoint not ready (timeout %lu ms)", (unsigned long)timeout_ms);
             return false;
         }
-        vTaskDelay(1);
+        xSemaphoreTake(s_hid_report_done, timeout - elapsed + 1);
     }
     return true;
 }
@@ -318,35 +288,128 @@ static void release_keyboard(void)
     vTaskDelay(pdMS_TO_TICKS(GOSTT_KEY_GAP_MS));
 }
 
+// Send one packed keyboard report. Returns false if the endpoint stayed busy
+// or the report was rejected.
+static bool send_keys(const gostt_hid_keys_t *keys)
+{
+    keyboard_report_t report = {0};
+    report.modifier = keys->modifier;
+    memcpy(report.keycodes, keys->keycodes, keys->nkeys);
+    if (!wait_hid_ready(GOSTT_HID_READY_TIMEOUT_MS)) {
+        ESP_LOGW(TAG, "HID not ready for %u keys", keys->nkeys);
+        return false;
+    }
+    if (!tud_hid_report(REPORT_ID_KEYBOARD, &report, sizeof(report))) {
+        ESP_LOGW(TAG, "tud_hid_report failed for %u keys", keys->nkeys);
+        return false;
+    }
+    return true;
+}
+
 // Internal: type text synchronously (must be called from typer task context).
-static void type_text_sync(const char *text, size_t len)
+// Fast mode packs up to max_keys distinct keys per report and sends the next
+// report as soon as the host has read the last one. Conservative mode sends
+// one key and one release per character at the fixed legacy cadence, for
+// hosts that drop keys at full speed. Returns false if nothing was typed;
+// otherwise *first_us is when the first report was sent.
+static bool type_text_sync(const char *text, size_t len, uint32_t *first_us)
 {
     if (!tud_mounted()) {
         ESP_LOGW(TAG, "USB not mounted — cannot type");
-        return;
+        return false;
     }
 
-    ESP_LOGI(TAG, "Typing %zu chars", len);
-
-    for (size_t i = 0; i < len; i++) {
-        char c = text[i];
-        uint8_t modifier = 0;
-        uint8_t keycode = 0;
-
-        if (c == '\n') {
-            keycode = 0x28; // Enter
-        } else if (c == '\t') {
-            keycode = 0x2B; // Tab
-        } else if (c >= 0x20 && c <= 0x7E) {
-            int idx = c - 0x20;
-            keycode = ascii_map[idx].keycode;
-            if (ascii_map[idx].shift) modifier = 0x02; // Left Shift
-        } else {
-            continue; // skip non-ASCII
+    gostt_typing_config_t cfg;
+    portENTER_CRITICAL(&s_typing_lock);
+    cfg = s_typing_cfg;
+    portEXIT_CRITICAL(&s_typing_lock);
+    bool conservative = cfg.mode == GOSTT_TYPING_CONSERVATIVE;
+
+    gostt_hid_packer_t packer;
+    gostt_hid_packer_init(&packer, text, len, conservative ? 1 : cfg.max_keys, conservative);
+
+    ESP_LOGI(TAG, "Typing %zu chars (%s)", len, conservative ? "conservative" : "fast");
+
+    gostt_hid_keys_t keys;
+    unsigned reports = 0;
+    while (gostt_hid_packer_next(&packer, &keys)) {
+        if (!send_keys(&keys) && keys.nkeys == 0) {
+            // Never leave keys held: retry the release once
+            send_keys(&keys);
+        }
+        if (reports == 0) {
+            *first_us = (uint32_t)esp_timer_get_time();
+        }
+        reports++;
+        if (conservative) {
+            vTaskDelay(pdMS_TO_TICKS(keys.nkeys ? GOSTT_KEY_PRESS_MS : GOSTT_KEY_GAP_MS));
+        }
+    }
+    ESP_LOGD(TAG, "Typed %zu chars in %u reports", len, reports);
+    return reports > 0;
+}
+
+// Backspaces are typed from this run, a chunk at a time
+static const char s_backspaces[] = "\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b";
+
+// Type an edit: delete backspaces characters, then type text. Returns false
+// if nothing was typed; otherwise *first_us is when the first report was
+// sent.
+static bool type_edit_sync(uint32_t backspaces, const char *text, size_t len, uint32_t *first_us)
+{
+    bool typed = false;
+    uint32_t t;
+    while (backspaces > 0) {
+        size_t n = backspaces < sizeof(s_backspaces) - 1 ? backspaces : sizeof(s_backspaces) - 1;
+        if (type_text_sync(s_backspaces, n, &t) && !typed) {
+            *first_us = t;
+            typed = true;
         }
+        backspaces -= n;
+    }
+    if (len > 0 && type_text_sync(text, len, &t) && !typed) {
+        *first_us = t;
+        typed = true;
+    }
+    return typed;
+}
 
-        send_keyboard_report(modifier, keycode);
-        release_keyboard();
+// Merge the queued edits that revise msg's text into it before it is typed,
+// so text a streaming correction replaces is never typed at all. Stops at
+// the first plain text, or once the merged text no longer fits msg's slot.
+// Merged slots are freed.
+static void merge_pending_edits(typer_msg_t *msg)
+{
+    gostt_pkt_t *p = gostt_pkt_get(msg->slot);
+    typer_msg_t next;
+    if (xQueuePeek(s_typer_queue, &next, 0) != pdTRUE ||
+        gostt_pkt_get(next.slot)->backspaces == 0) {
+        return;
+    }
+
+    // Legacy frames are typed from the plaintext; merge in the text buffer
+    if (msg->text != p->text) {
+        if (msg->len > sizeof(p->text)) return;
+        memcpy(p->text, msg->text, msg->len);
+        msg->text = p->text;
+    }
+    gostt_edit_t edit = {
+        .text = p->text, .len = msg->len, .cap = sizeof(p->text), .backspaces = p->backspaces,
+    };
+    unsigned merged = 0;
+    do {
+        const gostt_pkt_t *np = gostt_pkt_get(next.slot);
+        if (!gostt_edit_merge(&edit, np->backspaces, next.text, next.len)) break;
+        xQueueReceive(s_typer_queue, &next, 0);
+        gostt_pkt_free(next.slot);
+        merged++;
+    } while (xQueuePeek(s_typer_queue, &next, 0) == pdTRUE &&
+             gostt_pkt_get(next.slot)->backspaces > 0);
+
+    msg->len = edit.len;
+    p->backspaces = edit.backspaces;
+    if (merged) {
+        ESP_LOGD(TAG, "Merged %u pending edits", merged);
     }
 }
 
@@ -358,30 +421,84 @@ static void typer_task(void *arg)
     typer_msg_t msg;
     for (;;) {
         if (xQueueReceive(s_typer_queue, &msg, portMAX_DELAY) == pdTRUE) {
-            type_text_sync(msg.text, msg.len);
-            free(msg.text);
+            merge_pending_edits(&msg);
+            const gostt_pkt_t *p = gostt_pkt_get(msg.slot);
+            uint32_t first_us;
+            if (type_edit_sync(p->backspaces, msg.text, msg.len, &first_us)) {
+                uint32_t last_us = (uint32_t)esp_timer_get_time();
+                gostt_telemetry_stage(GOSTT_STAGE_FIRST_KEY, p->enqueued_us, first_us);
+                gostt_telemetry_stage(GOSTT_STAGE_TYPING, first_us, last_us);
+                gostt_telemetry_stage(GOSTT_STAGE_TOTAL, p->rx_us, last_us);
+            }
+            gostt_pkt_free(msg.slot);
         }
     }
 }
 
-int gostt_usb_hid_type_text(const char *text, size_t len)
+int gostt_usb_hid_type_text(const char *text, size_t len, uint8_t slot)
 {
-    if (!text || len == 0) return -1;
-
-    // Copy text to heap for the typer task
-    char *buf = malloc(len);
-    if (!buf) {
-        ESP_LOGE(TAG, "Failed to allocate %zu bytes for text", len);
+    gostt_pkt_t *p = gostt_pkt_get(slot);
+    if (!text || (len == 0 && p->backspaces == 0)) {
+        gostt_pkt_free(slot);
         return -1;
     }
-    memcpy(buf, text, len);
 
-    typer_msg_t msg = { .text = buf, .len = len };
+    // Stamped before the send: the typer may dequeue it at once
+    p->enqueued_us = (uint32_t)esp_timer_get_time();
+
+    typer_msg_t msg = { .text = text, .len = len, .slot = slot };
     if (xQueueSend(s_typer_queue, &msg, pdMS_TO_TICKS(1000)) != pdTRUE) {
         ESP_LOGW(TAG, "Typer queue full — dropping %zu chars", len);
-        free(buf);
+        gostt_telemetry_count(GOSTT_CTR_DROPPED);
+        gostt_pkt_free(slot);
+        return -1;
+    }
+    gostt_telemetry_stage(GOSTT_STAGE_ENQUEUE, p->decrypted_us, p->enqueued_us);
+    gostt_telemetry_queue_depth((uint32_t)uxQueueMessagesWaiting(s_typer_queue));
+    return 0;
+}
+
+int gostt_usb_hid_configure_typing(const uint8_t *data, size_t len)
+{
+    if (!data || len < 1) return -1;
+
+    gostt_typing_config_t new_cfg = {
+        .mode = (gostt_typing_mode_t)data[0],
+        .max_keys = GOSTT_HID_MAX_KEYS,
+    };
+    if (new_cfg.mode != GOSTT_TYPING_FAST && new_cfg.mode != GOSTT_TYPING_CONSERVATIVE) {
+        ESP_LOGE(TAG, "Unknown typing mode in config: %d", data[0]);
         return -1;
     }
+    if (len >= 2) {
+        if (data[1] < 1 || data[1] > GOSTT_HID_MAX_KEYS) {
+            ESP_LOGE(TAG, "Invalid keys per report in config: %u", data[1]);
+            return -1;
+        }
+        new_cfg.max_keys = data[1];
+    }
+
+    // Persist to NVS
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(GOSTT_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, GOSTT_NVS_KEY_TYPING_CFG, &new_cfg, sizeof(new_cfg));
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "NVS write failed: %s", esp_err_to_name(err));
+        }
+        err = nvs_commit(handle);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "NVS commit failed: %s", esp_err_to_name(err));
+        }
+        nvs_close(handle);
+    } else {
+        ESP_LOGE(TAG, "NVS open failed: %s", esp_err_to_name(err));
+    }
+
+    portENTER_CRITICAL(&s_typing_lock);
+    s_typing_cfg = new_cfg;
+    portEXIT_CRITICAL(&s_typing_lock);
+    ESP_LOGI(TAG, "Typing config updated (mode=%d, max_keys=%u)", new_cfg.mode, new_cfg.max_keys);
     return 0;
 }
 
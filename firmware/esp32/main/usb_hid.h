@@ -5,15 +5,37 @@
 #include <stdint.h>
 #include <stddef.h>
 
+// Typing throughput modes
+typedef enum {
+    GOSTT_TYPING_FAST = 0,         // Packed reports, paced by the host's polling
+    GOSTT_TYPING_CONSERVATIVE = 1, // One key per report at fixed press/gap delays
+} gostt_typing_mode_t;
+
+// Typing configuration
+typedef struct {
+    gostt_typing_mode_t mode;
+    uint8_t max_keys;  // keycodes per report in fast mode, 1-6
+} gostt_typing_config_t;
+
 // Initialize USB HID composite device (keyboard + consumer control).
-// Must be called once during startup.
+// Must be called once during startup, after NVS is initialized.
+// Loads the typing config from NVS or uses the default (fast, 6 keys).
 int gostt_usb_hid_init(void);
 
 // Type a string as USB HID keystrokes.
 // Only ASCII printable characters (0x20-0x7E), \n, and \t are supported.
-// Text is queued to a dedicated typer task and typed asynchronously.
+// text lives in packet slot (see pkt_pool.h) and is typed in place by a
+// dedicated typer task, which frees the slot afterwards; on error the slot is
+// freed immediately. The slot's backspaces are typed first, and len may be 0
+// when there are some. Queued edits with backspaces are merged into the text
+// ahead of them before it is typed (see textedit.h).
 // Returns 0 on success (queued), -1 on error.
-int gostt_usb_hid_type_text(const char *text, size_t len);
+int gostt_usb_hid_type_text(const char *text, size_t len, uint8_t slot);
+
+// Update typing configuration from BLE command data and persist to NVS.
+// Format: byte 0 = mode, byte 1 (optional) = keycodes per report in fast mode.
+// Applies from the next queued text. Returns 0 on success, -1 on invalid data.
+int gostt_usb_hid_configure_typing(const uint8_t *data, size_t len);
 
 // Send a USB HID Consumer Control usage code (e.g., 0x00E2 for Mute).
 // Sends press and release.
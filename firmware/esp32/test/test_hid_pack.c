@@ -0,0 +1,237 @@
+// firmware/esp32/test/test_hid_pack.c
+// Host-compilable test (not ESP-IDF) — validates HID report packing.
+// Compile: gcc -I../main -o test_hid_pack test_hid_pack.c ../main/hid_pack.c
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "hid_pack.h"
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) do { printf("  %-50s ", #name); tests_run++; } while(0)
+#define PASS() do { printf("PASS\n"); tests_passed++; } while(0)
+
+#define MAX_REPORTS 256
+
+// Keycodes from the HID usage tables
+#define KEY_A     0x04
+#define KEY_B     0x05
+#define KEY_C     0x06
+#define KEY_L     0x0F
+#define KEY_SPACE 0x2C
+#define KEY_ENTER 0x28
+#define KEY_BKSP  0x2A
+
+static int pack(const char *text, uint8_t max_keys, bool release_each,
+                gostt_hid_keys_t *reports)
+{
+    gostt_hid_packer_t p;
+    gostt_hid_packer_init(&p, text, strlen(text), max_keys, release_each);
+    int n = 0;
+    while (gostt_hid_packer_next(&p, &reports[n])) {
+        assert(++n < MAX_REPORTS);
+    }
+    return n;
+}
+
+static void assert_keys(const gostt_hid_keys_t *r, uint8_t modifier,
+                        const uint8_t *keys, uint8_t nkeys)
+{
+    assert(r->modifier == modifier);
+    assert(r->nkeys == nkeys);
+    assert(memcmp(r->keycodes, keys, nkeys) == 0);
+}
+
+static void assert_release(const gostt_hid_keys_t *r)
+{
+    assert(r->modifier == 0);
+    assert(r->nkeys == 0);
+}
+
+// Returns the character typed by keycode with modifier.
+static char char_for(uint8_t keycode, uint8_t modifier)
+{
+    for (int c = 1; c <= 0x7E; c++) {
+        uint8_t k, m;
+        if (gostt_hid_map_char((char)c, &k, &m) && k == keycode && m == modifier) {
+            return (char)c;
+        }
+    }
+    assert(!"no character for keycode");
+    return 0;
+}
+
+// Replays reports the way a host does (a key in a report that the previous
+// report did not hold is a press, in slot order) and returns the text typed.
+static void replay(const gostt_hid_keys_t *reports, int n, char *out, size_t cap)
+{
+    size_t len = 0;
+    gostt_hid_keys_t held = {0};
+    for (int i = 0; i < n; i++) {
+        for (uint8_t k = 0; k < reports[i].nkeys; k++) {
+            uint8_t key = reports[i].keycodes[k];
+            bool was_held = false;
+            for (uint8_t h = 0; h < held.nkeys; h++) {
+                if (held.keycodes[h] == key) was_held = true;
+            }
+            // A key still held or a modifier changing under a held key is
+            // exactly what the packer must never produce
+            assert(!was_held);
+            assert(held.nkeys == 0 || held.modifier == reports[i].modifier);
+            assert(len + 1 < cap);
+            out[len++] = char_for(key, reports[i].modifier);
+        }
+        held = reports[i];
+    }
+    out[len] = '\0';
+    assert(held.nkeys == 0);
+}
+
+void test_map_char(void)
+{
+    TEST(map_char);
+    uint8_t keycode, modifier;
+    assert(gostt_hid_map_char('a', &keycode, &modifier));
+    assert(keycode == KEY_A && modifier == 0);
+    assert(gostt_hid_map_char('A', &keycode, &modifier));
+    assert(keycode == KEY_A && modifier == GOSTT_HID_MOD_LSHIFT);
+    assert(gostt_hid_map_char('\n', &keycode, &modifier));
+    assert(keycode == KEY_ENTER && modifier == 0);
+    assert(gostt_hid_map_char('\b', &keycode, &modifier));
+    assert(keycode == KEY_BKSP && modifier == 0);
+    assert(!gostt_hid_map_char('\x7f', &keycode, &modifier));
+    assert(!gostt_hid_map_char((char)0xC3, &keycode, &modifier));
+    PASS();
+}
+
+void test_pack_distinct_keys(void)
+{
+    TEST(pack_distinct_keys);
+    gostt_hid_keys_t r[MAX_REPORTS];
+    int n = pack("abc", 6, false, r);
+    assert(n == 2);
+    assert_keys(&r[0], 0, (const uint8_t[]){KEY_A, KEY_B, KEY_C}, 3);
+    assert_release(&r[1]);
+    PASS();
+}
+
+void test_pack_full_report(void)
+{
+    TEST(pack_full_report);
+    gostt_hid_keys_t r[MAX_REPORTS];
+    // 7 distinct keys: the 7th starts a new report without a release
+    int n = pack("abcdefg", 6, false, r);
+    assert(n == 3);
+    assert(r[0].nkeys == 6);
+    assert_keys(&r[1], 0, (const uint8_t[]){0x0A}, 1);
+    assert_release(&r[2]);
+    PASS();
+}
+
+void test_pack_repeated_key(void)
+{
+    TEST(pack_repeated_key);
+    gostt_hid_keys_t r[MAX_REPORTS];
+    // "ll" needs a release between the two presses of the same key
+    int n = pack("ll", 6, false, r);
+    assert(n == 4);
+    assert_keys(&r[0], 0, (const uint8_t[]){KEY_L}, 1);
+    assert_release(&r[1]);
+    assert_keys(&r[2], 0, (const uint8_t[]){KEY_L}, 1);
+    assert_release(&r[3]);
+    PASS();
+}
+
+void test_pack_key_held_by_previous_report(void)
+{
+    TEST(pack_key_held_by_previous_report);
+    gostt_hid_keys_t r[MAX_REPORTS];
+    // "ab" fills a 2-key report. "a" cannot join "c" while the first report
+    // still holds it, but follows the "c" report without a release
+    int n = pack("abca", 2, false, r);
+    assert(n == 4);
+    assert_keys(&r[0], 0, (const uint8_t[]){KEY_A, KEY_B}, 2);
+    assert_keys(&r[1], 0, (const uint8_t[]){KEY_C}, 1);
+    assert_keys(&r[2], 0, (const uint8_t[]){KEY_A}, 1);
+    assert_release(&r[3]);
+    PASS();
+}
+
+void test_pack_modifier_change(void)
+{
+    TEST(pack_modifier_change);
+    gostt_hid_keys_t r[MAX_REPORTS];
+    int n = pack("Ab c", 6, false, r);
+    assert(n == 4);
+    assert_keys(&r[0], GOSTT_HID_MOD_LSHIFT, (const uint8_t[]){KEY_A}, 1);
+    assert_release(&r[1]);
+    assert_keys(&r[2], 0, (const uint8_t[]){KEY_B, KEY_SPACE, KEY_C}, 3);
+    assert_release(&r[3]);
+    PASS();
+}
+
+void test_pack_skips_unsupported(void)
+{
+    TEST(pack_skips_unsupported);
+    gostt_hid_keys_t r[MAX_REPORTS];
+    int n = pack("a\xc3\xa9" "b", 6, false, r);
+    assert(n == 2);
+    assert_keys(&r[0], 0, (const uint8_t[]){KEY_A, KEY_B}, 2);
+    assert_release(&r[1]);
+
+    assert(pack("", 6, false, r) == 0);
+    assert(pack("\xc3\xa9", 6, false, r) == 0);
+    PASS();
+}
+
+void test_pack_conservative(void)
+{
+    TEST(pack_conservative);
+    gostt_hid_keys_t r[MAX_REPORTS];
+    // One press and one release per character, as typed before packing
+    int n = pack("aB", 1, true, r);
+    assert(n == 4);
+    assert_keys(&r[0], 0, (const uint8_t[]){KEY_A}, 1);
+    assert_release(&r[1]);
+    assert_keys(&r[2], GOSTT_HID_MOD_LSHIFT, (const uint8_t[]){KEY_B}, 1);
+    assert_release(&r[3]);
+    PASS();
+}
+
+void test_pack_replays_text(void)
+{
+    TEST(pack_replays_text);
+    const char *text = "Hello, World!\nHow's it going?  Fine -- see you at 10:30.";
+    gostt_hid_keys_t r[MAX_REPORTS];
+    char typed[MAX_REPORTS];
+    int packed = 0;
+    for (uint8_t max_keys = 1; max_keys <= GOSTT_HID_MAX_KEYS; max_keys++) {
+        int n = pack(text, max_keys, false, r);
+        replay(r, n, typed, sizeof(typed));
+        assert(strcmp(typed, text) == 0);
+        if (max_keys == GOSTT_HID_MAX_KEYS) packed = n;
+    }
+    // Packing must beat two reports per character by a wide margin
+    assert(packed < (int)strlen(text));
+    PASS();
+}
+
+int main(void)
+{
+    printf("GOSTT-KBD HID Report Packing Tests\n");
+    printf("==================================\n");
+
+    test_map_char();
+    test_pack_distinct_keys();
+    test_pack_full_report();
+    test_pack_repeated_key();
+    test_pack_key_held_by_previous_report();
+    test_pack_modifier_change();
+    test_pack_skips_unsupported();
+    test_pack_conservative();
+    test_pack_replays_text();
+
+    printf("\n%d/%d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
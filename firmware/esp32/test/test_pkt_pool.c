@@ -0,0 +1,178 @@
+// firmware/esp32/test/test_pkt_pool.c
+// Host-compilable test (not ESP-IDF) — validates the receive pipeline slab and ring.
+// Compile: gcc -I../main -pthread -o test_pkt_pool test_pkt_pool.c ../main/pkt_pool.c
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include "pkt_pool.h"
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) do { printf("  %-50s ", #name); tests_run++; } while(0)
+#define PASS() do { printf("PASS\n"); tests_passed++; } while(0)
+
+void test_alloc_all_slots(void)
+{
+    TEST(alloc_all_slots);
+    gostt_pkt_pool_init();
+    assert(gostt_pkt_free_count() == GOSTT_PKT_SLOTS);
+
+    unsigned seen = 0;
+    for (int i = 0; i < GOSTT_PKT_SLOTS; i++) {
+        int slot = gostt_pkt_alloc();
+        assert(slot >= 0 && slot < GOSTT_PKT_SLOTS);
+        assert(!(seen & (1u << slot)));
+        seen |= 1u << slot;
+    }
+    assert(gostt_pkt_alloc() == -1);
+    assert(gostt_pkt_free_count() == 0);
+
+    gostt_pkt_free(3);
+    assert(gostt_pkt_free_count() == 1);
+    assert(gostt_pkt_alloc() == 3);
+    PASS();
+}
+
+void test_slots_do_not_overlap(void)
+{
+    TEST(slots_do_not_overlap);
+    gostt_pkt_pool_init();
+    for (int i = 0; i < GOSTT_PKT_SLOTS; i++) {
+        gostt_pkt_t *p = gostt_pkt_get((uint8_t)gostt_pkt_alloc());
+        memset(p->data, i, sizeof(p->data));
+        memset(p->plaintext, i, sizeof(p->plaintext));
+        p->len = (uint16_t)i;
+    }
+    for (int i = 0; i < GOSTT_PKT_SLOTS; i++) {
+        gostt_pkt_t *p = gostt_pkt_get((uint8_t)i);
+        assert(p->len == i);
+        assert(p->data[0] == i && p->data[GOSTT_PKT_MAX_LEN - 1] == i);
+        assert(p->plaintext[sizeof(p->plaintext) - 1] == i);
+    }
+    assert(sizeof(((gostt_pkt_t *)0)->plaintext) >= GOSTT_PKT_MAX_LEN);
+    PASS();
+}
+
+void test_ring_fifo(void)
+{
+    TEST(ring_fifo);
+    gostt_pkt_ring_t r;
+    gostt_pkt_ring_init(&r);
+    uint8_t slot;
+    assert(!gostt_pkt_ring_pop(&r, &slot));
+
+    // Wrap the indices around several times
+    for (int round = 0; round < 5; round++) {
+        for (uint8_t i = 0; i < GOSTT_PKT_SLOTS; i++) {
+            assert(gostt_pkt_ring_push(&r, (uint8_t)(GOSTT_PKT_SLOTS - 1 - i)));
+        }
+        assert(!gostt_pkt_ring_push(&r, 0));
+        for (uint8_t i = 0; i < GOSTT_PKT_SLOTS; i++) {
+            assert(gostt_pkt_ring_pop(&r, &slot));
+            assert(slot == GOSTT_PKT_SLOTS - 1 - i);
+        }
+        assert(!gostt_pkt_ring_pop(&r, &slot));
+    }
+    PASS();
+}
+
+static int s_releases;
+
+static void count_release(void)
+{
+    s_releases++;
+}
+
+void test_release_hook(void)
+{
+    TEST(release_hook);
+    gostt_pkt_pool_init();
+    gostt_pkt_set_release_hook(count_release);
+    int a = gostt_pkt_alloc();
+    int b = gostt_pkt_alloc();
+    assert(s_releases == 0);
+    gostt_pkt_free((uint8_t)a);
+    gostt_pkt_free((uint8_t)b);
+    assert(s_releases == 2);
+    gostt_pkt_set_release_hook(NULL);
+    PASS();
+}
+
+// Stress: a producer allocates slots, writes a sequence number into each and
+// pushes it; the consumer checks the sequence and frees the slot, as the NimBLE
+// callback and the crypto worker do.
+#define STRESS_PACKETS 100000
+
+static gostt_pkt_ring_t s_ring;
+
+static void *stress_producer(void *arg)
+{
+    (void)arg;
+    for (uint32_t seq = 0; seq < STRESS_PACKETS; ) {
+        int slot = gostt_pkt_alloc();
+        if (slot < 0) {
+            sched_yield();
+            continue;
+        }
+        gostt_pkt_t *p = gostt_pkt_get((uint8_t)slot);
+        memcpy(p->data, &seq, sizeof(seq));
+        p->len = sizeof(seq);
+        assert(gostt_pkt_ring_push(&s_ring, (uint8_t)slot));
+        seq++;
+    }
+    return NULL;
+}
+
+static void *stress_consumer(void *arg)
+{
+    (void)arg;
+    for (uint32_t want = 0; want < STRESS_PACKETS; ) {
+        uint8_t slot;
+        if (!gostt_pkt_ring_pop(&s_ring, &slot)) {
+            sched_yield();
+            continue;
+        }
+        gostt_pkt_t *p = gostt_pkt_get(slot);
+        uint32_t seq;
+        assert(p->len == sizeof(seq));
+        memcpy(&seq, p->data, sizeof(seq));
+        assert(seq == want);
+        gostt_pkt_free(slot);
+        want++;
+    }
+    return NULL;
+}
+
+void test_spsc_stress(void)
+{
+    TEST(spsc_stress);
+    gostt_pkt_pool_init();
+    gostt_pkt_ring_init(&s_ring);
+
+    pthread_t producer, consumer;
+    assert(pthread_create(&consumer, NULL, stress_consumer, NULL) == 0);
+    assert(pthread_create(&producer, NULL, stress_producer, NULL) == 0);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    assert(gostt_pkt_free_count() == GOSTT_PKT_SLOTS);
+    PASS();
+}
+
+int main(void)
+{
+    printf("GOSTT-KBD Packet Pool Tests\n");
+    printf("===========================\n");
+
+    test_alloc_all_slots();
+    test_slots_do_not_overlap();
+    test_ring_fifo();
+    test_release_hook();
+    test_spsc_stress();
+
+    printf("\n%d/%d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
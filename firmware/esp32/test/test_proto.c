@@ -1,10 +1,11 @@
 // firmware/esp32/test/test_proto.c
 // Host-compilable test (not ESP-IDF) — validates protobuf wire compatibility with Go app.
-// Compile: gcc -I../main -o test_proto test_proto.c ../main/proto.c
+// Compile: gcc -I../main -o test_proto test_proto.c ../main/proto.c ../main/textdict.c
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include "proto.h"
+#include "textdict.h"
 
 static int tests_run = 0;
 static int tests_passed = 0;
@@ -111,6 +112,154 @@ void test_decode_encrypted_data(void)
     PASS();
 }
 
+void test_decode_batched_records(void)
+{
+    TEST(decode_batched_records);
+    // Go MarshalFrame([{Text: "hi"}, {Command: 1}], false):
+    // record 1 = EncryptedData(KeyboardPacket("hi")), record 2 = mute toggle
+    uint8_t data[] = {
+        0x2a, 0x08, 0x0a, 0x06, 0x0a, 0x02, 'h', 'i', 0x10, 0x02,
+        0x2a, 0x02, 0x10, 0x01,
+    };
+
+    gostt_encrypted_data_t enc;
+    assert(gostt_decode_encrypted_data(data, sizeof(data), &enc) == 0);
+    assert(enc.record_count == 2);
+    assert(enc.keyboard_packet_data == NULL);
+
+    size_t pos = 0;
+    gostt_encrypted_data_t rec;
+    assert(gostt_next_record(data, sizeof(data), &pos, &rec) == 1);
+    assert(rec.command_type == 0);
+    assert(rec.keyboard_packet_data_len == 6);
+    gostt_keyboard_packet_t kbd;
+    assert(gostt_decode_keyboard_packet(rec.keyboard_packet_data,
+                                        rec.keyboard_packet_data_len, &kbd) == 0);
+    assert(kbd.message_len == 2 && memcmp(kbd.message, "hi", 2) == 0);
+
+    assert(gostt_next_record(data, sizeof(data), &pos, &rec) == 1);
+    assert(rec.command_type == 1);
+    assert(rec.command_data == NULL);
+
+    assert(gostt_next_record(data, sizeof(data), &pos, &rec) == 0);
+
+    // A legacy single-record frame has no records to iterate
+    uint8_t legacy[] = {0x0a, 0x06, 0x0a, 0x02, 'h', 'i', 0x10, 0x02};
+    pos = 0;
+    assert(gostt_next_record(legacy, sizeof(legacy), &pos, &rec) == 0);
+
+    // Records do not nest
+    uint8_t nested[] = {0x2a, 0x04, 0x2a, 0x02, 0x10, 0x01};
+    pos = 0;
+    assert(gostt_next_record(nested, sizeof(nested), &pos, &rec) == -1);
+
+    // Truncated record
+    pos = 0;
+    assert(gostt_next_record(data, 5, &pos, &rec) == -1);
+    PASS();
+}
+
+void test_dict_expand(void)
+{
+    TEST(dict_expand);
+    // Go DictEncode("hello the world and you")
+    uint8_t packed[] = {'h', 'e', 'l', 'l', 'o', 0x00, 0x00,
+                        ' ', 'w', 'o', 'r', 'l', 'd', 0x00, 0x02, 0x00, 0x06};
+    const char *want = "hello the world and you";
+    char out[64];
+    int n = gostt_dict_expand(packed, sizeof(packed), out, sizeof(out));
+    assert(n == (int)strlen(want));
+    assert(memcmp(out, want, n) == 0);
+
+    // Exactly enough room, then one byte short
+    assert(gostt_dict_expand(packed, sizeof(packed), out, strlen(want)) == n);
+    assert(gostt_dict_expand(packed, sizeof(packed), out, strlen(want) - 1) == -1);
+
+    uint8_t truncated[] = {'a', 0x00};
+    assert(gostt_dict_expand(truncated, sizeof(truncated), out, sizeof(out)) == -1);
+    uint8_t unknown[] = {0x00, GOSTT_DICT_WORDS};
+    assert(gostt_dict_expand(unknown, sizeof(unknown), out, sizeof(out)) == -1);
+
+    // Packed text is field 4 of a record
+    uint8_t rec[] = {0x22, 0x03, 'a', 0x00, 0x00};
+    gostt_encrypted_data_t enc;
+    assert(gostt_decode_encrypted_data(rec, sizeof(rec), &enc) == 0);
+    assert(enc.packed_text_len == 3);
+    n = gostt_dict_expand(enc.packed_text, enc.packed_text_len, out, sizeof(out));
+    assert(n == 5 && memcmp(out, "a the", 5) == 0);
+    PASS();
+}
+
+void test_decode_backspaces(void)
+{
+    TEST(decode_backspaces);
+    // Expected from Go test: Record{Backspaces: 3, Text: "hi"}, then a
+    // deletion-only Record{Backspaces: 5}
+    uint8_t edit[] = {0x0a, 0x06, 0x0a, 0x02, 'h', 'i', 0x10, 0x02, 0x30, 0x03};
+    gostt_encrypted_data_t enc;
+    assert(gostt_decode_encrypted_data(edit, sizeof(edit), &enc) == 0);
+    assert(enc.backspaces == 3);
+    assert(enc.command_type == 0);
+    gostt_keyboard_packet_t kbd;
+    assert(gostt_decode_keyboard_packet(enc.keyboard_packet_data, enc.keyboard_packet_data_len, &kbd) == 0);
+    assert(kbd.message_len == 2 && memcmp(kbd.message, "hi", 2) == 0);
+
+    uint8_t deletion[] = {0x30, 0x05};
+    assert(gostt_decode_encrypted_data(deletion, sizeof(deletion), &enc) == 0);
+    assert(enc.backspaces == 5);
+    assert(enc.keyboard_packet_data == NULL && enc.packed_text == NULL);
+    PASS();
+}
+
+void test_encode_link_params(void)
+{
+    TEST(encode_link_params);
+    // Expected from Go test: MTU 517, 2M PHY both ways, 251-octet DLE,
+    // batched and packed framing, in ResponsePacket(type=LinkParams, status=Known)
+    uint8_t expected[] = {0x08, 0x02, 0x10, 0x01, 0x1a, 0x07,
+                          0x05, 0x02, 0x02, 0x02, 0xFB, 0x00, 0x03};
+    gostt_link_params_t params = {
+        .mtu = 517, .tx_phy = 2, .rx_phy = 2, .max_tx_octets = 251,
+        .features = GOSTT_FEATURE_BATCH | GOSTT_FEATURE_DICT,
+    };
+
+    uint8_t data[GOSTT_LINK_PARAMS_LEN];
+    assert(gostt_encode_link_params(data, sizeof(data), &params) == GOSTT_LINK_PARAMS_LEN);
+    assert(gostt_encode_link_params(data, sizeof(data) - 1, &params) == -1);
+
+    uint8_t buf[64];
+    int len = gostt_encode_response_packet(buf, sizeof(buf),
+                                            GOSTT_RESP_LINK_PARAMS,
+                                            GOSTT_PEER_KNOWN,
+                                            data, sizeof(data));
+    assert(len == (int)sizeof(expected));
+    assert(memcmp(buf, expected, len) == 0);
+    PASS();
+}
+
+void test_encode_credits(void)
+{
+    TEST(encode_credits);
+    // Expected from Go test: 300 writes received, 5 of 8 slots free,
+    // in ResponsePacket(type=Credits, status=Known)
+    uint8_t expected[] = {0x08, 0x03, 0x10, 0x01, 0x1a, 0x06,
+                          0x2C, 0x01, 0x00, 0x00, 0x05, 0x08};
+    gostt_credits_t credits = { .received = 300, .free_slots = 5, .total_slots = 8 };
+
+    uint8_t data[GOSTT_CREDITS_LEN];
+    assert(gostt_encode_credits(data, sizeof(data), &credits) == GOSTT_CREDITS_LEN);
+    assert(gostt_encode_credits(data, sizeof(data) - 1, &credits) == -1);
+
+    uint8_t buf[64];
+    int len = gostt_encode_response_packet(buf, sizeof(buf),
+                                            GOSTT_RESP_CREDITS,
+                                            GOSTT_PEER_KNOWN,
+                                            data, sizeof(data));
+    assert(len == (int)sizeof(expected));
+    assert(memcmp(buf, expected, len) == 0);
+    PASS();
+}
+
 int main(void)
 {
     printf("GOSTT-KBD Protocol Cross-Validation Tests\n");
@@ -121,6 +270,11 @@ int main(void)
     test_encode_response_packet();
     test_decode_data_packet();
     test_decode_encrypted_data();
+    test_decode_batched_records();
+    test_dict_expand();
+    test_decode_backspaces();
+    test_encode_link_params();
+    test_encode_credits();
 
     printf("\n%d/%d tests passed\n", tests_passed, tests_run);
     return (tests_passed == tests_run) ? 0 : 1;
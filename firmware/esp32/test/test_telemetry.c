@@ -0,0 +1,116 @@
+// firmware/esp32/test/test_telemetry.c
+// Host-compilable test (not ESP-IDF) — validates telemetry recording and the
+// stats characteristic layout parsed by the Go app.
+// Compile: gcc -I../main -o test_telemetry test_telemetry.c ../main/telemetry.c
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "telemetry.h"
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) do { printf("  %-50s ", #name); tests_run++; } while(0)
+#define PASS() do { printf("PASS\n"); tests_passed++; } while(0)
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Offset of stage s in the encoded stats
+static size_t stage_off(int s)
+{
+    return 28 + (size_t)s * GOSTT_TELEMETRY_STAGE_LEN;
+}
+
+void test_encode_header_and_counters(void)
+{
+    TEST(encode_header_and_counters);
+    gostt_telemetry_init();
+    for (int i = 0; i < 3; i++) gostt_telemetry_count(GOSTT_CTR_RX);
+    gostt_telemetry_count(GOSTT_CTR_DROPPED);
+    gostt_telemetry_count(GOSTT_CTR_DECRYPT_FAIL);
+    gostt_telemetry_count(GOSTT_CTR_DECRYPT_FAIL);
+    gostt_telemetry_queue_depth(5);
+    gostt_telemetry_queue_depth(2);
+
+    uint8_t buf[GOSTT_TELEMETRY_LEN];
+    assert(gostt_telemetry_encode(buf, sizeof(buf) - 1, 0, 0) == -1);
+    assert(gostt_telemetry_encode(buf, sizeof(buf), 100000, 90000) == GOSTT_TELEMETRY_LEN);
+
+    uint8_t header[] = {GOSTT_TELEMETRY_VERSION, GOSTT_STAGE_COUNT, GOSTT_TELEMETRY_BUCKETS, 0};
+    assert(memcmp(buf, header, sizeof(header)) == 0);
+    assert(get_u32(buf + 4) == 3);        // received
+    assert(get_u32(buf + 8) == 1);        // dropped
+    assert(get_u32(buf + 12) == 2);       // decrypt failures
+    assert(get_u32(buf + 16) == 5);       // typer queue high-water mark
+    assert(get_u32(buf + 20) == 100000);  // free heap
+    assert(get_u32(buf + 24) == 90000);   // minimum free heap
+    for (int s = 0; s < GOSTT_STAGE_COUNT; s++) {
+        assert(get_u32(buf + stage_off(s)) == 0);
+    }
+    PASS();
+}
+
+void test_stage_buckets(void)
+{
+    TEST(stage_buckets);
+    gostt_telemetry_init();
+    gostt_telemetry_stage(GOSTT_STAGE_DECRYPT, 1000, 1050);          // 50 us: bucket 0
+    gostt_telemetry_stage(GOSTT_STAGE_DECRYPT, 1000, 1064);          // 64 us: bucket 1
+    gostt_telemetry_stage(GOSTT_STAGE_DECRYPT, 0xFFFFFF00u, 0x40);   // 320 us across wrap: bucket 3
+    gostt_telemetry_stage(GOSTT_STAGE_DECRYPT, 0, 10000000);         // 10 s: last bucket
+    gostt_telemetry_stage(GOSTT_STAGE_TOTAL, 0, 2000);
+
+    uint8_t buf[GOSTT_TELEMETRY_LEN];
+    assert(gostt_telemetry_encode(buf, sizeof(buf), 0, 0) == GOSTT_TELEMETRY_LEN);
+
+    const uint8_t *d = buf + stage_off(GOSTT_STAGE_DECRYPT);
+    assert(get_u32(d) == 4);                                // count
+    assert(get_u32(d + 4) == 50 + 64 + 320 + 10000000);     // sum, low word
+    assert(get_u32(d + 8) == 0);                            // sum, high word
+    assert(get_u32(d + 12) == 10000000);                    // max
+    const uint8_t *b = d + 16;
+    assert(get_u32(b + 0 * 4) == 1);
+    assert(get_u32(b + 1 * 4) == 1);
+    assert(get_u32(b + 2 * 4) == 0);
+    assert(get_u32(b + 3 * 4) == 1);
+    assert(get_u32(b + (GOSTT_TELEMETRY_BUCKETS - 1) * 4) == 1);
+
+    const uint8_t *t = buf + stage_off(GOSTT_STAGE_TOTAL);
+    assert(get_u32(t) == 1);
+    assert(get_u32(t + 12) == 2000);
+    // 2000 us: 1024 <= d < 2048, bucket 5
+    assert(get_u32(t + 16 + 5 * 4) == 1);
+    assert(get_u32(buf + stage_off(GOSTT_STAGE_TYPING)) == 0);
+    PASS();
+}
+
+void test_sum_carries_to_high_word(void)
+{
+    TEST(sum_carries_to_high_word);
+    gostt_telemetry_init();
+    for (int i = 0; i < 3; i++) {
+        gostt_telemetry_stage(GOSTT_STAGE_TYPING, 0, 0x80000000u);
+    }
+    uint8_t buf[GOSTT_TELEMETRY_LEN];
+    assert(gostt_telemetry_encode(buf, sizeof(buf), 0, 0) == GOSTT_TELEMETRY_LEN);
+    const uint8_t *d = buf + stage_off(GOSTT_STAGE_TYPING);
+    assert(get_u32(d + 4) == 0x80000000u);
+    assert(get_u32(d + 8) == 1);
+    PASS();
+}
+
+int main(void)
+{
+    printf("GOSTT-KBD Telemetry Tests\n");
+    printf("=========================\n");
+
+    test_encode_header_and_counters();
+    test_stage_buckets();
+    test_sum_carries_to_high_word();
+
+    printf("\n%d/%d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+// firmware/esp32/test/test_textedit.c
+// Host-compilable test (not ESP-IDF) — validates merging of streaming edits.
+// Compile: gcc -I../main -o test_textedit test_textedit.c ../main/textedit.c ../main/hid_pack.c
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "textedit.h"
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define TEST(name) do { printf("  %-50s ", #name); tests_run++; } while(0)
+#define PASS() do { printf("PASS\n"); tests_passed++; } while(0)
+
+static gostt_edit_t edit_of(char *buf, size_t cap, uint32_t backspaces, const char *text)
+{
+    gostt_edit_t e = { .text = buf, .cap = cap, .backspaces = backspaces };
+    assert(gostt_edit_merge(&e, 0, text, strlen(text)));
+    return e;
+}
+
+static void assert_edit(const gostt_edit_t *e, uint32_t backspaces, const char *text)
+{
+    assert(e->backspaces == backspaces);
+    assert(e->len == strlen(text));
+    assert(memcmp(e->text, text, e->len) == 0);
+}
+
+void test_merge_append(void)
+{
+    TEST(merge_append);
+    char buf[32];
+    gostt_edit_t e = edit_of(buf, sizeof(buf), 2, "hello");
+    assert(gostt_edit_merge(&e, 0, " world", 6));
+    assert_edit(&e, 2, "hello world");
+    PASS();
+}
+
+void test_merge_revises_pending_text(void)
+{
+    TEST(merge_revises_pending_text);
+    char buf[32];
+    // "the cat" typed as "the cap" then corrected: only "the cat" is typed
+    gostt_edit_t e = edit_of(buf, sizeof(buf), 0, "the cap");
+    assert(gostt_edit_merge(&e, 1, "t", 1));
+    assert_edit(&e, 0, "the cat");
+    PASS();
+}
+
+void test_merge_deletes_past_pending_text(void)
+{
+    TEST(merge_deletes_past_pending_text);
+    char buf[32];
+    gostt_edit_t e = edit_of(buf, sizeof(buf), 1, "ab");
+    assert(gostt_edit_merge(&e, 5, "xyz", 3));
+    assert_edit(&e, 4, "xyz");
+
+    // Deletion only
+    assert(gostt_edit_merge(&e, 2, "", 0));
+    assert_edit(&e, 4, "x");
+    PASS();
+}
+
+void test_delete_skips_untypeable(void)
+{
+    TEST(delete_skips_untypeable);
+    char buf[32];
+    // "é" is not typed, so the host never saw it: one backspace removes "b"
+    gostt_edit_t e = edit_of(buf, sizeof(buf), 0, "ab\xc3\xa9");
+    gostt_edit_delete(&e, 1);
+    assert_edit(&e, 0, "a");
+    PASS();
+}
+
+void test_merge_full(void)
+{
+    TEST(merge_full);
+    char buf[8];
+    gostt_edit_t e = edit_of(buf, sizeof(buf), 0, "abcdef");
+    assert(!gostt_edit_merge(&e, 0, "ghi", 3));
+    assert_edit(&e, 0, "abcdef");
+    // Backspaces make room first
+    assert(gostt_edit_merge(&e, 2, "ghij", 4));
+    assert_edit(&e, 0, "abcdghij");
+    PASS();
+}
+
+int main(void)
+{
+    printf("GOSTT-KBD Text Edit Tests\n");
+    printf("=========================\n");
+
+    test_merge_append();
+    test_merge_revises_pending_text();
+    test_merge_deletes_past_pending_text();
+    test_delete_skips_untypeable();
+    test_merge_full();
+
+    printf("\n%d/%d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
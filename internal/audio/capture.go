@@ -0,0 +1,185 @@
+package audio
+
+import (
+	"encoding/binary"
+	"math"
+	"sync"
+	"sync/atomic"
+	"unsafe"
+)
+
+// captureBlockSeconds is the audio held by one capture buffer block.
+const captureBlockSeconds = 30
+
+// captureInitialBlocks is how many blocks a capture buffer keeps between
+// recordings: enough for a dictation up to the 120s batch limit, so the
+// common case never grows the buffer.
+const captureInitialBlocks = 5
+
+// nativeLittleEndian reports whether float32 bytes from the device can be
+// copied into a []float32 without reordering.
+var nativeLittleEndian = func() bool {
+	x := uint16(1)
+	return *(*byte)(unsafe.Pointer(&x)) == 1
+}()
+
+// captureBuffer is a single-producer, multi-reader sample buffer holding one
+// recording at a time, of any length. Samples live in fixed-size blocks that
+// are allocated ahead of the producer: the capture callback appends without
+// locking or allocating and publishes the write position atomically, and a
+// background goroutine keeps a spare block ahead of it. Samples before the
+// published position are never rewritten during a recording, so readers need
+// no lock and may alias a block until the next reset.
+type captureBuffer struct {
+	blockSize int
+	blocks    atomic.Pointer[[][]float32] // replaced, never modified, when grown
+	written   atomic.Int64                // samples published
+	dropped   atomic.Int64                // samples discarded because no block was ready
+	want      atomic.Int64                // blocks the producer last asked the provisioner for
+
+	growMu sync.Mutex    // serializes replacing blocks
+	grow   chan struct{} // wakes the provisioner; closed by close
+}
+
+// newCaptureBuffer returns a buffer of blocks of blockSize samples. Call close
+// when done with it.
+func newCaptureBuffer(blockSize int) *captureBuffer {
+	b := &captureBuffer{blockSize: blockSize, grow: make(chan struct{}, 1)}
+	blocks := make([][]float32, captureInitialBlocks)
+	for i := range blocks {
+		blocks[i] = make([]float32, blockSize)
+	}
+	b.blocks.Store(&blocks)
+	go b.provision()
+	return b
+}
+
+// close stops the provisioner. The buffer must not be written afterwards.
+func (b *captureBuffer) close() {
+	close(b.grow)
+}
+
+// provision appends a block whenever the producer has entered the last one,
+// so it always has a full block of headroom.
+func (b *captureBuffer) provision() {
+	for range b.grow {
+		b.growMu.Lock()
+		blocks := *b.blocks.Load()
+		if want := int(b.want.Load()); want > len(blocks) {
+			grown := make([][]float32, len(blocks), want)
+			copy(grown, blocks)
+			for len(grown) < want {
+				grown = append(grown, make([]float32, b.blockSize))
+			}
+			b.blocks.Store(&grown)
+		}
+		b.growMu.Unlock()
+	}
+}
+
+// reset empties the buffer, releasing the blocks a long recording added. It
+// must not run concurrently with write.
+func (b *captureBuffer) reset() {
+	b.growMu.Lock()
+	defer b.growMu.Unlock()
+	if blocks := *b.blocks.Load(); len(blocks) > captureInitialBlocks {
+		kept := blocks[:captureInitialBlocks:captureInitialBlocks]
+		b.blocks.Store(&kept)
+	}
+	b.written.Store(0)
+	b.dropped.Store(0)
+	b.want.Store(0)
+}
+
+// write decodes little-endian float32 samples from data into the buffer and
+// publishes them. It returns the samples written, split in two where they
+// cross into a new block. Only the single producer calls write; it never
+// allocates or blocks.
+func (b *captureBuffer) write(data []byte) (first, second []float32) {
+	n := int(b.written.Load())
+	blocks := *b.blocks.Load()
+	for len(data) >= 4 {
+		i, off := n/b.blockSize, n%b.blockSize
+		if i >= len(blocks) {
+			// The provisioner fell a whole block behind
+			b.dropped.Add(int64(len(data) / 4))
+			break
+		}
+		if off == 0 && i+1 >= len(blocks) {
+			// Name the spare block wanted: written is only published once
+			// the call returns, so the provisioner cannot go by it
+			b.want.Store(int64(i + 2))
+			select {
+			case b.grow <- struct{}{}:
+			default:
+			}
+		}
+		dst := blocks[i][off:]
+		k := decodeFloat32(dst, data)
+		if first == nil {
+			first = dst[:k]
+		} else {
+			second = dst[:k]
+		}
+		data = data[k*4:]
+		n += k
+	}
+	b.written.Store(int64(n))
+	return first, second
+}
+
+// from returns the samples published from offset onward. When they lie in one
+// block it aliases the buffer; across blocks it returns a copy. Returns nil if
+// no samples follow offset.
+func (b *captureBuffer) from(offset int) []float32 {
+	n := int(b.written.Load())
+	if offset < 0 || offset >= n {
+		return nil
+	}
+	if i := offset / b.blockSize; i == (n-1)/b.blockSize {
+		base := i * b.blockSize
+		return (*b.blocks.Load())[i][offset-base : n-base : n-base]
+	}
+	return b.appendFrom(make([]float32, 0, n-offset), offset, n)
+}
+
+// copyFrom returns a copy of the samples published from offset onward.
+func (b *captureBuffer) copyFrom(offset int) []float32 {
+	n := int(b.written.Load())
+	if offset < 0 || offset >= n {
+		return nil
+	}
+	return b.appendFrom(make([]float32, 0, n-offset), offset, n)
+}
+
+// appendFrom appends samples [offset, n) to dst.
+func (b *captureBuffer) appendFrom(dst []float32, offset, n int) []float32 {
+	blocks := *b.blocks.Load()
+	for offset < n {
+		i, off := offset/b.blockSize, offset%b.blockSize
+		end := min(b.blockSize, n-i*b.blockSize)
+		dst = append(dst, blocks[i][off:end]...)
+		offset += end - off
+	}
+	return dst
+}
+
+// decodeFloat32 fills dst with little-endian float32 samples from data and
+// returns how many were decoded. On little-endian hosts this is one memmove.
+func decodeFloat32(dst []float32, data []byte) int {
+	n := len(data) / 4
+	if n > len(dst) {
+		n = len(dst)
+	}
+	if n == 0 {
+		return 0
+	}
+	if nativeLittleEndian {
+		copy(unsafe.Slice((*byte)(unsafe.Pointer(&dst[0])), n*4), data[:n*4])
+		return n
+	}
+	for i := range dst[:n] {
+		dst[i] = math.Float32frombits(binary.LittleEndian.Uint32(data[i*4:]))
+	}
+	return n
+}
@@ -0,0 +1,190 @@
+package audio
+
+import (
+	"math"
+	"sync"
+	"testing"
+	"time"
+)
+
+// float32Bytes encodes samples as little-endian float32, as the device delivers them.
+func float32Bytes(samples ...float32) []byte {
+	data := make([]byte, 0, 4*len(samples))
+	for _, s := range samples {
+		bits := math.Float32bits(s)
+		data = append(data, byte(bits), byte(bits>>8), byte(bits>>16), byte(bits>>24))
+	}
+	return data
+}
+
+func TestDecodeFloat32(t *testing.T) {
+	// 1.0 = 0x3F800000, 0.0, -1.0 = 0xBF800000 in little-endian bytes
+	data := []byte{
+		0x00, 0x00, 0x80, 0x3F,
+		0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x80, 0xBF,
+	}
+	dst := make([]float32, 3)
+	if n := decodeFloat32(dst, data); n != 3 {
+		t.Fatalf("decodeFloat32() = %d, want 3", n)
+	}
+	if dst[0] != 1.0 || dst[1] != 0.0 || dst[2] != -1.0 {
+		t.Errorf("decodeFloat32() = %v, want [1 0 -1]", dst)
+	}
+
+	// A trailing partial sample is ignored; a short dst bounds the decode
+	if n := decodeFloat32(dst, data[:6]); n != 1 {
+		t.Errorf("decodeFloat32() with a partial sample = %d, want 1", n)
+	}
+	if n := decodeFloat32(dst[:2], data); n != 2 {
+		t.Errorf("decodeFloat32() into 2 slots = %d, want 2", n)
+	}
+}
+
+// waitBlocks waits for b to have at least n blocks.
+func waitBlocks(t *testing.T, b *captureBuffer, n int) {
+	t.Helper()
+	deadline := time.Now().Add(5 * time.Second)
+	for len(*b.blocks.Load()) < n {
+		if time.Now().After(deadline) {
+			t.Fatalf("capture buffer has %d blocks, want %d", len(*b.blocks.Load()), n)
+		}
+		time.Sleep(time.Millisecond)
+	}
+}
+
+func TestCaptureBufferWriteAndRead(t *testing.T) {
+	b := newCaptureBuffer(4)
+	defer b.close()
+	if got, _ := b.write(float32Bytes(1, 2)); len(got) != 2 || got[1] != 2 {
+		t.Errorf("write() = %v, want [1 2]", got)
+	}
+	if got := b.from(1); len(got) != 1 || got[0] != 2 {
+		t.Errorf("from(1) = %v, want [2]", got)
+	}
+	if got := b.from(2); got != nil {
+		t.Errorf("from(2) at the write position = %v, want nil", got)
+	}
+
+	// A write crossing into the next block is split there
+	first, second := b.write(float32Bytes(3, 4, 5))
+	if len(first) != 2 || first[1] != 4 || len(second) != 1 || second[0] != 5 {
+		t.Errorf("write() across blocks = %v, %v, want [3 4], [5]", first, second)
+	}
+	if got := b.from(0); len(got) != 5 || got[4] != 5 {
+		t.Errorf("from(0) = %v, want [1 2 3 4 5]", got)
+	}
+	if got := b.from(4); len(got) != 1 || &got[0] != &second[0] {
+		t.Errorf("from(4) within a block = %v, want an alias of [5]", got)
+	}
+
+	b.reset()
+	if got := b.from(0); got != nil {
+		t.Errorf("from(0) after reset = %v, want nil", got)
+	}
+}
+
+func TestCaptureBufferGrows(t *testing.T) {
+	b := newCaptureBuffer(2)
+	defer b.close()
+
+	// Record well past the initial blocks; nothing is dropped
+	const total = (captureInitialBlocks + 3) * 2
+	for i := 1; i <= total; i++ {
+		b.write(float32Bytes(float32(i)))
+		waitBlocks(t, b, int(b.written.Load())/2+1)
+	}
+	if d := b.dropped.Load(); d != 0 {
+		t.Errorf("dropped = %d, want 0", d)
+	}
+	got := b.copyFrom(0)
+	if len(got) != total {
+		t.Fatalf("copyFrom(0) = %d samples, want %d", len(got), total)
+	}
+	for i, s := range got {
+		if s != float32(i+1) {
+			t.Fatalf("sample %d = %v, want %v", i, s, float32(i+1))
+		}
+	}
+	if got := b.from(3); len(got) != total-3 || got[0] != 4 {
+		t.Errorf("from(3) across blocks = %v, want [4 ... %d]", got, total)
+	}
+
+	// The blocks a long recording added are released by reset
+	b.reset()
+	if n := len(*b.blocks.Load()); n != captureInitialBlocks {
+		t.Errorf("%d blocks after reset, want %d", n, captureInitialBlocks)
+	}
+}
+
+func TestCaptureBufferGrowsMidWrite(t *testing.T) {
+	b := newCaptureBuffer(4)
+	defer b.close()
+
+	// Writes of 3 samples cross most block boundaries partway through a
+	// call; each must still leave a spare block past the last one written
+	const total = (captureInitialBlocks + 3) * 4
+	var next float32 = 1
+	for int(b.written.Load())+3 <= total {
+		b.write(float32Bytes(next, next+1, next+2))
+		next += 3
+		waitBlocks(t, b, (int(b.written.Load())-1)/4+2)
+	}
+	if d := b.dropped.Load(); d != 0 {
+		t.Errorf("dropped = %d, want 0", d)
+	}
+	got := b.copyFrom(0)
+	for i, s := range got {
+		if s != float32(i+1) {
+			t.Fatalf("sample %d = %v, want %v", i, s, float32(i+1))
+		}
+	}
+	if len(got) != int(next)-1 {
+		t.Errorf("copyFrom(0) = %d samples, want %d", len(got), int(next)-1)
+	}
+}
+
+func TestCaptureBufferWriteDoesNotAllocate(t *testing.T) {
+	b := newCaptureBuffer(1 << 20)
+	defer b.close()
+	data := float32Bytes(make([]float32, 512)...)
+	allocs := testing.AllocsPerRun(100, func() {
+		b.write(data)
+	})
+	if allocs != 0 {
+		t.Errorf("write() allocated %.1f times per call, want 0", allocs)
+	}
+}
+
+func TestCaptureBufferConcurrentReaders(t *testing.T) {
+	const total = 1 << 14
+	b := newCaptureBuffer(total / 4) // readers cross blocks
+	defer b.close()
+	chunk := make([]float32, 64)
+	for i := range chunk {
+		chunk[i] = 1
+	}
+	data := float32Bytes(chunk...)
+
+	var wg sync.WaitGroup
+	for r := 0; r < 4; r++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			cursor := 0
+			for cursor < total {
+				for _, s := range b.from(cursor) {
+					if s != 1 {
+						t.Errorf("reader saw unpublished sample %v at %d", s, cursor)
+						return
+					}
+					cursor++
+				}
+			}
+		}()
+	}
+	for i := 0; i < total/len(chunk); i++ {
+		b.write(data)
+	}
+	wg.Wait()
+}
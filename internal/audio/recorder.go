@@ -1,24 +1,29 @@
 package audio
 
 import (
-	"encoding/binary"
 	"fmt"
-	"math"
+	"log/slog"
 	"sync"
+	"sync/atomic"
 
 	"github.com/gen2brain/malgo"
 )
 
 // Recorder captures audio from the default microphone into a float32 buffer.
+// The capture callback never takes a lock or allocates: samples are decoded
+// straight into blocks allocated ahead of it and published atomically, and
+// readers follow the recording by sample offset. Recordings have no length
+// limit.
 type Recorder struct {
 	ctx        *malgo.AllocatedContext
 	device     *malgo.Device
 	sampleRate uint32
 	channels   uint32
 
-	mu        sync.Mutex
-	buf       []float32
-	recording bool
+	mu        sync.Mutex // guards device and recording transitions; not taken by onData
+	buf       *captureBuffer
+	recording atomic.Bool
+	vad       *VAD // optional; fed from onData
 }
 
 // NewRecorder creates a new audio recorder. Call Close() when done.
@@ -41,12 +46,18 @@ func NewRecorder(sampleRate, channels uint32) (*Recorder, error) {
 // Audio samples are accumulated in an internal buffer as float32 values.
 func (r *Recorder) Start() error {
 	r.mu.Lock()
-	if r.recording {
+	if r.recording.Load() {
 		r.mu.Unlock()
 		return fmt.Errorf("already recording")
 	}
-	r.buf = r.buf[:0] // reset buffer but keep capacity
-	r.recording = true
+	if r.buf == nil {
+		r.buf = newCaptureBuffer(int(r.sampleRate*r.channels) * captureBlockSeconds)
+	}
+	r.buf.reset() // no device is running, so the producer is idle
+	if r.vad != nil {
+		r.vad.Reset()
+	}
+	r.recording.Store(true)
 	r.mu.Unlock()
 
 	deviceCfg := malgo.DefaultDeviceConfig(malgo.Capture)
@@ -60,17 +71,13 @@ func (r *Recorder) Start() error {
 
 	device, err := malgo.InitDevice(r.ctx.Context, deviceCfg, callbacks)
 	if err != nil {
-		r.mu.Lock()
-		r.recording = false
-		r.mu.Unlock()
+		r.recording.Store(false)
 		return fmt.Errorf("initializing capture device: %w", err)
 	}
 
 	if err := device.Start(); err != nil {
 		device.Uninit()
-		r.mu.Lock()
-		r.recording = false
-		r.mu.Unlock()
+		r.recording.Store(false)
 		return fmt.Errorf("starting capture device: %w", err)
 	}
 
@@ -87,7 +94,7 @@ func (r *Recorder) Stop() []float32 {
 	r.mu.Lock()
 	defer r.mu.Unlock()
 
-	if !r.recording {
+	if !r.recording.Load() {
 		return nil
 	}
 
@@ -95,33 +102,80 @@ func (r *Recorder) Stop() []float32 {
 		r.device.Uninit()
 		r.device = nil
 	}
-	r.recording = false
+	r.recording.Store(false)
 
-	// Return a copy of the buffer
-	result := make([]float32, len(r.buf))
-	copy(result, r.buf)
+	if dropped := r.buf.dropped.Load(); dropped > 0 {
+		slog.Warn("audio: capture buffer did not grow in time, samples dropped",
+			"dropped_s", float64(dropped)/float64(r.sampleRate*r.channels))
+	}
 
-	return result
+	// Return a copy: the buffer is reused by the next recording
+	return r.buf.copyFrom(0)
 }
 
 // Snapshot returns a copy of the accumulated audio buffer without stopping
 // recording. Returns nil if not recording or buffer is empty. Thread-safe.
 func (r *Recorder) Snapshot() []float32 {
+	return r.SnapshotFrom(0)
+}
+
+// SnapshotFrom returns a copy of the audio recorded from sample offset onward
+// without stopping recording, so a caller that has consumed the start of the
+// recording copies only what it still needs. Returns nil if not recording or
+// no audio follows offset. Thread-safe.
+func (r *Recorder) SnapshotFrom(offset int) []float32 {
+	if !r.recording.Load() {
+		return nil
+	}
+	return r.buf.copyFrom(offset)
+}
+
+// ReadFrom returns the audio recorded from sample offset onward, without
+// copying it unless it spans buffer blocks. A reader that keeps offset+len as
+// its cursor sees only new samples on its next call. The slice may alias the
+// capture buffer: it must not be modified, and is valid only until the next
+// Start. Returns nil if not recording or no audio follows offset. Safe for
+// any number of readers.
+func (r *Recorder) ReadFrom(offset int) []float32 {
+	if !r.recording.Load() {
+		return nil
+	}
+	return r.buf.from(offset)
+}
+
+// SetVAD attaches a voice activity detector that analyzes audio as it is
+// captured. Call before Start; nil detaches it.
+func (r *Recorder) SetVAD(v *VAD) {
 	r.mu.Lock()
 	defer r.mu.Unlock()
-	if !r.recording || len(r.buf) == 0 {
+	r.vad = v
+}
+
+// Speech returns the speech segments detected in the current (or, after
+// Stop, the last) recording. Returns nil without a VAD. Thread-safe.
+func (r *Recorder) Speech() []Segment {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	if r.vad == nil {
 		return nil
 	}
-	result := make([]float32, len(r.buf))
-	copy(result, r.buf)
-	return result
+	return r.vad.Segments()
 }
 
-// IsRecording returns whether the recorder is currently capturing audio.
-func (r *Recorder) IsRecording() bool {
+// SpeechSince reports whether speech was detected in the audio recorded from
+// sample offset onward. Always true without a VAD. Thread-safe.
+func (r *Recorder) SpeechSince(offset int) bool {
 	r.mu.Lock()
 	defer r.mu.Unlock()
-	return r.recording
+	if r.vad == nil {
+		return true
+	}
+	return r.vad.SpeechSince(offset)
+}
+
+// IsRecording returns whether the recorder is currently capturing audio.
+func (r *Recorder) IsRecording() bool {
+	return r.recording.Load()
 }
 
 // Close releases all audio resources.
@@ -131,7 +185,11 @@ func (r *Recorder) Close() error {
 		r.device.Uninit()
 		r.device = nil
 	}
-	r.recording = false
+	r.recording.Store(false)
+	if r.buf != nil {
+		r.buf.close()
+		r.buf = nil
+	}
 	r.mu.Unlock()
 
 	if r.ctx != nil {
@@ -146,25 +204,17 @@ func (r *Recorder) Close() error {
 
 // onData is the malgo callback invoked when audio data is available.
 // pSample contains the captured audio frames as raw bytes (float32 format).
+// It runs on the audio thread: no locks, no allocation.
 func (r *Recorder) onData(_, pSample []byte, frameCount uint32) {
-	sampleCount := frameCount * r.channels
-	samples := bytesToFloat32(pSample, sampleCount)
-
-	r.mu.Lock()
-	r.buf = append(r.buf, samples...)
-	r.mu.Unlock()
-}
-
-// bytesToFloat32 converts raw bytes (little-endian float32) to a float32 slice.
-func bytesToFloat32(data []byte, sampleCount uint32) []float32 {
-	samples := make([]float32, 0, sampleCount)
-	for i := uint32(0); i < sampleCount; i++ {
-		offset := i * 4
-		if offset+4 > uint32(len(data)) {
-			break
+	sampleCount := int(frameCount * r.channels)
+	if len(pSample) > sampleCount*4 {
+		pSample = pSample[:sampleCount*4]
+	}
+	first, second := r.buf.write(pSample)
+	if r.vad != nil {
+		r.vad.Write(first)
+		if second != nil {
+			r.vad.Write(second)
 		}
-		bits := binary.LittleEndian.Uint32(data[offset : offset+4])
-		samples = append(samples, math.Float32frombits(bits))
 	}
-	return samples
 }
@@ -85,10 +85,9 @@ func TestSnapshotReturnsCopy(t *testing.T) {
 	}()
 
 	// Simulate recording state with data in the buffer
-	r.mu.Lock()
-	r.recording = true
-	r.buf = []float32{1.0, 2.0, 3.0}
-	r.mu.Unlock()
+	r.buf = newCaptureBuffer(16)
+	r.buf.write(float32Bytes(1.0, 2.0, 3.0))
+	r.recording.Store(true)
 
 	snap := r.Snapshot()
 	if snap == nil {
@@ -103,11 +102,9 @@ func TestSnapshotReturnsCopy(t *testing.T) {
 
 	// Verify it's a copy by mutating the snapshot
 	snap[0] = 999.0
-	r.mu.Lock()
-	if r.buf[0] != 1.0 {
+	if r.buf.from(0)[0] != 1.0 {
 		t.Error("Snapshot() should return a copy, but original buffer was modified")
 	}
-	r.mu.Unlock()
 }
 
 func TestSnapshotEmptyBuffer(t *testing.T) {
@@ -122,10 +119,8 @@ func TestSnapshotEmptyBuffer(t *testing.T) {
 	}()
 
 	// Recording but empty buffer
-	r.mu.Lock()
-	r.recording = true
-	r.buf = []float32{}
-	r.mu.Unlock()
+	r.buf = newCaptureBuffer(16)
+	r.recording.Store(true)
 
 	snap := r.Snapshot()
 	if snap != nil {
@@ -133,35 +128,57 @@ func TestSnapshotEmptyBuffer(t *testing.T) {
 	}
 }
 
-func TestBytesToFloat32(t *testing.T) {
-	// Test with known float32 value: 1.0 = 0x3F800000
-	data := []byte{0x00, 0x00, 0x80, 0x3F} // 1.0 in little-endian float32
-	samples := bytesToFloat32(data, 1)
+func TestSnapshotFromOffset(t *testing.T) {
+	r, err := NewRecorder(16000, 1)
+	if err != nil {
+		t.Fatalf("NewRecorder() error = %v", err)
+	}
+	defer func() {
+		if err := r.Close(); err != nil {
+			t.Errorf("Close() error = %v", err)
+		}
+	}()
 
-	if len(samples) != 1 {
-		t.Fatalf("bytesToFloat32() returned %d samples, want 1", len(samples))
+	r.buf = newCaptureBuffer(16)
+	r.buf.write(float32Bytes(1.0, 2.0, 3.0, 4.0))
+	r.recording.Store(true)
+
+	snap := r.SnapshotFrom(2)
+	if len(snap) != 2 || snap[0] != 3.0 || snap[1] != 4.0 {
+		t.Errorf("SnapshotFrom(2) = %v, want [3.0 4.0]", snap)
+	}
+	if snap := r.SnapshotFrom(4); snap != nil {
+		t.Errorf("SnapshotFrom(4) at end of buffer should return nil, got %v", snap)
 	}
-	if samples[0] != 1.0 {
-		t.Errorf("bytesToFloat32() = %f, want 1.0", samples[0])
+	if snap := r.SnapshotFrom(-1); snap != nil {
+		t.Errorf("SnapshotFrom(-1) should return nil, got %v", snap)
 	}
 }
 
-func TestBytesToFloat32Multiple(t *testing.T) {
-	// Two samples: 0.0 and -1.0
-	// 0.0 = 0x00000000, -1.0 = 0xBF800000
-	data := []byte{
-		0x00, 0x00, 0x00, 0x00, // 0.0
-		0x00, 0x00, 0x80, 0xBF, // -1.0
+func TestReadFromAliasesBuffer(t *testing.T) {
+	r, err := NewRecorder(16000, 1)
+	if err != nil {
+		t.Fatalf("NewRecorder() error = %v", err)
 	}
-	samples := bytesToFloat32(data, 2)
+	defer func() {
+		if err := r.Close(); err != nil {
+			t.Errorf("Close() error = %v", err)
+		}
+	}()
 
-	if len(samples) != 2 {
-		t.Fatalf("bytesToFloat32() returned %d samples, want 2", len(samples))
-	}
-	if samples[0] != 0.0 {
-		t.Errorf("samples[0] = %f, want 0.0", samples[0])
+	r.buf = newCaptureBuffer(16)
+	r.buf.write(float32Bytes(1.0, 2.0))
+	r.recording.Store(true)
+
+	// A cursor at the end sees only samples captured after it
+	first := r.ReadFrom(0)
+	cursor := len(first)
+	r.buf.write(float32Bytes(3.0))
+	next := r.ReadFrom(cursor)
+	if len(next) != 1 || next[0] != 3.0 {
+		t.Errorf("ReadFrom(%d) = %v, want [3.0]", cursor, next)
 	}
-	if samples[1] != -1.0 {
-		t.Errorf("samples[1] = %f, want -1.0", samples[1])
+	if &first[0] != &(*r.buf.blocks.Load())[0][0] {
+		t.Error("ReadFrom() should alias the capture buffer, not copy")
 	}
 }
@@ -0,0 +1,249 @@
+package audio
+
+import (
+	"math"
+	"sync/atomic"
+)
+
+const (
+	// vadFrameMs is the analysis frame length.
+	vadFrameMs = 20
+
+	// vadMinSpeechMs is the shortest burst kept as speech; shorter ones
+	// (clicks, key presses) are dropped.
+	vadMinSpeechMs = 100
+
+	// vadMinEnergy is the mean-square level (about -60 dBFS) below which a
+	// frame is never speech, whatever the noise floor.
+	vadMinEnergy = 1e-6
+
+	// vadInitialFloor caps the first noise floor estimate (about -50 dBFS),
+	// so a recording that starts mid-word still detects that word.
+	vadInitialFloor = 1e-5
+
+	// vadMaxSegments bounds the closed segments kept per recording; once full,
+	// further speech extends the last one.
+	vadMaxSegments = 256
+)
+
+// Segment is a range of speech in a recording, in samples [Start, End).
+type Segment struct {
+	Start, End int
+}
+
+// VAD is an energy-based voice activity detector. It classifies 20ms frames
+// by their mean-square level against an adaptive noise floor and groups speech
+// frames into segments; a segment is closed once pauseMs of silence follows
+// it. Input is mono float32 audio, written in capture order by a single
+// producer (the capture callback) without locking or allocating. Segments and
+// SpeechSince may be called concurrently from any number of readers.
+type VAD struct {
+	frameSamples     int
+	minSpeechSamples int
+	pauseFrames      int
+	ratio            float64 // speech threshold as a multiple of the noise floor
+
+	frame  []float32 // partial frame carried between writes
+	pos    int       // absolute sample position of the next frame
+	floor  float64   // noise floor energy; 0 until the first frame
+	open   bool      // inside a speech segment
+	start  int       // start of the open segment
+	end    int       // end of the last speech frame in the open segment
+	silent int       // consecutive non-speech frames in the open segment
+
+	// Published to readers: closed segments below nsegs are immutable, and
+	// openSeg packs the open segment as start<<32 | end (0 when none).
+	segments []Segment
+	nsegs    atomic.Int32
+	openSeg  atomic.Uint64
+}
+
+// NewVAD creates a detector for audio at sampleRate. A frame is speech when its
+// energy is thresholdDB above the noise floor; speech separated by at least
+// pauseMs of silence forms separate segments.
+func NewVAD(sampleRate int, thresholdDB float64, pauseMs int) *VAD {
+	frameSamples := sampleRate * vadFrameMs / 1000
+	pauseFrames := pauseMs / vadFrameMs
+	if pauseFrames < 1 {
+		pauseFrames = 1
+	}
+	return &VAD{
+		frameSamples:     frameSamples,
+		minSpeechSamples: sampleRate * vadMinSpeechMs / 1000,
+		pauseFrames:      pauseFrames,
+		ratio:            math.Pow(10, thresholdDB/10),
+		frame:            make([]float32, 0, frameSamples),
+		segments:         make([]Segment, vadMaxSegments),
+	}
+}
+
+// Reset clears all state for a new recording. It must not run concurrently
+// with Write.
+func (v *VAD) Reset() {
+	v.frame = v.frame[:0]
+	v.pos = 0
+	v.floor = 0
+	v.open = false
+	v.silent = 0
+	v.nsegs.Store(0)
+	v.openSeg.Store(0)
+}
+
+// Write analyzes the next samples of the recording.
+func (v *VAD) Write(samples []float32) {
+	// Complete a partial frame from the previous write
+	if len(v.frame) > 0 {
+		n := v.frameSamples - len(v.frame)
+		if n > len(samples) {
+			v.frame = append(v.frame, samples...)
+			return
+		}
+		v.frame = append(v.frame, samples[:n]...)
+		samples = samples[n:]
+		v.analyze(v.frame)
+		v.frame = v.frame[:0]
+	}
+
+	for len(samples) >= v.frameSamples {
+		v.analyze(samples[:v.frameSamples])
+		samples = samples[v.frameSamples:]
+	}
+	v.frame = append(v.frame, samples...)
+}
+
+// analyze classifies one full frame and updates the segments.
+func (v *VAD) analyze(frame []float32) {
+	var sum float64
+	for _, s := range frame {
+		sum += float64(s) * float64(s)
+	}
+	energy := sum / float64(len(frame))
+	start := v.pos
+	v.pos += len(frame)
+
+	if v.floor == 0 {
+		v.floor = math.Min(energy, vadInitialFloor)
+	}
+	speech := energy > vadMinEnergy && energy > v.floor*v.ratio
+
+	// Track the floor quickly through silence and slowly through speech, so
+	// a lasting rise in background noise is eventually treated as noise.
+	switch {
+	case energy < v.floor:
+		v.floor = energy
+	case speech:
+		v.floor += (energy - v.floor) * 0.001
+	default:
+		v.floor += (energy - v.floor) * 0.05
+	}
+	if v.floor < vadMinEnergy/100 {
+		v.floor = vadMinEnergy / 100
+	}
+
+	switch {
+	case speech && !v.open:
+		v.open, v.start, v.end, v.silent = true, start, v.pos, 0
+		v.openSeg.Store(packSegment(v.start, v.end))
+	case speech:
+		v.end, v.silent = v.pos, 0
+		v.openSeg.Store(packSegment(v.start, v.end))
+	case v.open:
+		v.silent++
+		if v.silent >= v.pauseFrames {
+			v.close()
+		}
+	}
+}
+
+// close ends the open segment, dropping it if it is too short to be speech.
+// The closed segment is published before the open one is withdrawn, so a
+// reader never misses it.
+func (v *VAD) close() {
+	if v.end-v.start >= v.minSpeechSamples {
+		n := int(v.nsegs.Load())
+		if n < len(v.segments) {
+			v.segments[n] = Segment{Start: v.start, End: v.end}
+			v.nsegs.Store(int32(n + 1))
+		} else {
+			// Full: readers may be copying the last slot, so a merged
+			// segment stays open instead of rewriting it
+			v.start = v.segments[n-1].Start
+			return
+		}
+	}
+	v.open = false
+	v.openSeg.Store(0)
+}
+
+// Segments returns the speech found so far, including a segment that is still
+// open (trailing silence shorter than the pause, or speech in progress).
+func (v *VAD) Segments() []Segment {
+	open := v.openSeg.Load()
+	n := int(v.nsegs.Load())
+	segs := make([]Segment, n, n+1)
+	copy(segs, v.segments[:n])
+	if open != 0 {
+		seg := unpackSegment(open)
+		switch {
+		case n > 0 && segs[n-1].Start == seg.Start:
+			// Closed between the two loads, or extending a full list's last
+			// segment
+			segs[n-1].End = max(segs[n-1].End, seg.End)
+		case seg.End-seg.Start >= v.minSpeechSamples:
+			segs = append(segs, seg)
+		}
+	}
+	return segs
+}
+
+// SpeechSince reports whether any speech frame ends after sample offset.
+func (v *VAD) SpeechSince(offset int) bool {
+	if open := v.openSeg.Load(); open != 0 && unpackSegment(open).End > offset {
+		return true
+	}
+	n := int(v.nsegs.Load())
+	return n > 0 && v.segments[n-1].End > offset
+}
+
+// packSegment packs a segment into one word for atomic publication. Sample
+// positions fit in 32 bits for recordings up to 74 hours of 16kHz audio.
+func packSegment(start, end int) uint64 {
+	return uint64(uint32(start))<<32 | uint64(uint32(end))
+}
+
+func unpackSegment(p uint64) Segment {
+	return Segment{Start: int(p >> 32), End: int(uint32(p))}
+}
+
+// SplitSpeech returns the parts of samples covered by segs, each widened by
+// padSamples on both sides and merged where the padding overlaps. The parts
+// alias samples. Leading and trailing silence is dropped, and the recording is
+// split wherever segments are further apart than the padding.
+func SplitSpeech(samples []float32, segs []Segment, padSamples int) [][]float32 {
+	var parts [][]float32
+	start, end := -1, -1
+	for _, seg := range segs {
+		s, e := seg.Start-padSamples, seg.End+padSamples
+		if s < 0 {
+			s = 0
+		}
+		if e > len(samples) {
+			e = len(samples)
+		}
+		if s >= e {
+			continue
+		}
+		if start >= 0 && s <= end {
+			end = e
+			continue
+		}
+		if start >= 0 {
+			parts = append(parts, samples[start:end])
+		}
+		start, end = s, e
+	}
+	if start >= 0 {
+		parts = append(parts, samples[start:end])
+	}
+	return parts
+}
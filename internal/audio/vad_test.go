@@ -0,0 +1,202 @@
+package audio
+
+import (
+	"math"
+	"sync"
+	"testing"
+)
+
+const vadTestRate = 16000
+
+// tone returns ms milliseconds of a 440Hz sine at amplitude amp.
+func tone(ms int, amp float64) []float32 {
+	n := vadTestRate * ms / 1000
+	out := make([]float32, n)
+	for i := range out {
+		out[i] = float32(amp * math.Sin(2*math.Pi*440*float64(i)/vadTestRate))
+	}
+	return out
+}
+
+// speechAndPauses builds 300ms of background noise, then speech/silence
+// pieces alternating, starting with speech, at -46 dBFS noise.
+func speechAndPauses(pieces ...int) []float32 {
+	audio := tone(300, 0.005)
+	for i, ms := range pieces {
+		if i%2 == 0 {
+			audio = append(audio, tone(ms, 0.2)...)
+		} else {
+			audio = append(audio, tone(ms, 0.005)...)
+		}
+	}
+	return audio
+}
+
+func TestVADDetectsSpeech(t *testing.T) {
+	v := NewVAD(vadTestRate, 9, 500)
+	v.Write(speechAndPauses(1000, 1000))
+
+	segs := v.Segments()
+	if len(segs) != 1 {
+		t.Fatalf("Segments() = %v, want 1 segment", segs)
+	}
+	start, end := 300*vadTestRate/1000, 1300*vadTestRate/1000
+	if segs[0].Start != start || segs[0].End != end {
+		t.Errorf("segment = %+v, want {%d %d}", segs[0], start, end)
+	}
+}
+
+func TestVADSplitsAtPauses(t *testing.T) {
+	// A 300ms gap stays inside one segment with a 500ms pause; 800ms splits
+	v := NewVAD(vadTestRate, 9, 500)
+	v.Write(speechAndPauses(600, 300, 600, 800, 600, 600))
+	if segs := v.Segments(); len(segs) != 2 {
+		t.Errorf("Segments() = %v, want 2 segments", segs)
+	}
+}
+
+func TestVADChunkedWritesMatch(t *testing.T) {
+	audio := speechAndPauses(600, 800, 600, 600)
+
+	whole := NewVAD(vadTestRate, 9, 500)
+	whole.Write(audio)
+
+	// Callback-sized writes that do not align with frames
+	chunked := NewVAD(vadTestRate, 9, 500)
+	for len(audio) > 0 {
+		n := 147
+		if n > len(audio) {
+			n = len(audio)
+		}
+		chunked.Write(audio[:n])
+		audio = audio[n:]
+	}
+
+	a, b := whole.Segments(), chunked.Segments()
+	if len(a) != len(b) {
+		t.Fatalf("chunked Segments() = %v, want %v", b, a)
+	}
+	for i := range a {
+		if a[i] != b[i] {
+			t.Errorf("segment %d = %+v, want %+v", i, b[i], a[i])
+		}
+	}
+}
+
+func TestVADDropsClicks(t *testing.T) {
+	v := NewVAD(vadTestRate, 9, 500)
+	v.Write(speechAndPauses(40, 1000))
+	if segs := v.Segments(); len(segs) != 0 {
+		t.Errorf("Segments() = %v, want a 40ms click dropped", segs)
+	}
+}
+
+func TestVADSilenceOnly(t *testing.T) {
+	v := NewVAD(vadTestRate, 9, 500)
+	v.Write(tone(2000, 0.005))
+	if segs := v.Segments(); len(segs) != 0 {
+		t.Errorf("Segments() = %v, want none for background noise", segs)
+	}
+	if v.SpeechSince(0) {
+		t.Error("SpeechSince(0) = true for background noise")
+	}
+}
+
+func TestVADSpeechSince(t *testing.T) {
+	v := NewVAD(vadTestRate, 9, 500)
+	v.Write(speechAndPauses(1000, 1000))
+	if !v.SpeechSince(0) {
+		t.Error("SpeechSince(0) = false, want true")
+	}
+	if v.SpeechSince(1500 * vadTestRate / 1000) {
+		t.Error("SpeechSince after the speech ended = true, want false")
+	}
+}
+
+func TestVADReset(t *testing.T) {
+	v := NewVAD(vadTestRate, 9, 500)
+	v.Write(speechAndPauses(1000, 1000))
+	v.Reset()
+	if segs := v.Segments(); len(segs) != 0 {
+		t.Errorf("Segments() after Reset = %v, want none", segs)
+	}
+}
+
+func TestVADFullSegmentListExtendsLast(t *testing.T) {
+	v := NewVAD(vadTestRate, 9, 100)
+	var pieces []int
+	for i := 0; i < vadMaxSegments+10; i++ {
+		pieces = append(pieces, 200, 200)
+	}
+	audio := speechAndPauses(pieces...)
+	v.Write(audio)
+
+	segs := v.Segments()
+	if len(segs) != vadMaxSegments {
+		t.Fatalf("Segments() returned %d segments, want %d", len(segs), vadMaxSegments)
+	}
+	lastSpeech := len(audio) - 200*vadTestRate/1000
+	if end := segs[len(segs)-1].End; end != lastSpeech {
+		t.Errorf("last segment ends at %d, want it extended to %d", end, lastSpeech)
+	}
+}
+
+func TestVADConcurrentReaders(t *testing.T) {
+	v := NewVAD(vadTestRate, 9, 100)
+	audio := speechAndPauses(300, 200, 300, 200, 300, 200)
+
+	done := make(chan struct{})
+	var wg sync.WaitGroup
+	wg.Add(1)
+	go func() {
+		defer wg.Done()
+		for {
+			select {
+			case <-done:
+				return
+			default:
+			}
+			segs := v.Segments()
+			for i := 1; i < len(segs); i++ {
+				if segs[i].Start < segs[i-1].End {
+					t.Errorf("overlapping segments %v", segs)
+					return
+				}
+			}
+			v.SpeechSince(0)
+		}
+	}()
+	for len(audio) > 0 {
+		n := min(256, len(audio))
+		v.Write(audio[:n])
+		audio = audio[n:]
+	}
+	close(done)
+	wg.Wait()
+
+	if segs := v.Segments(); len(segs) != 3 {
+		t.Errorf("Segments() = %v, want 3 segments", segs)
+	}
+}
+
+func TestSplitSpeech(t *testing.T) {
+	samples := make([]float32, 100)
+	for i := range samples {
+		samples[i] = float32(i)
+	}
+
+	parts := SplitSpeech(samples, []Segment{{5, 20}, {24, 30}, {60, 98}}, 3)
+	if len(parts) != 2 {
+		t.Fatalf("SplitSpeech returned %d parts, want 2 (first two merged)", len(parts))
+	}
+	if parts[0][0] != 2 || len(parts[0]) != 31 {
+		t.Errorf("part 0 = [%v, +%d), want [2, +31)", parts[0][0], len(parts[0]))
+	}
+	if parts[1][0] != 57 || len(parts[1]) != 43 {
+		t.Errorf("part 1 = [%v, +%d), want [57, +43) clamped to the end", parts[1][0], len(parts[1]))
+	}
+
+	if parts := SplitSpeech(samples, nil, 3); parts != nil {
+		t.Errorf("SplitSpeech with no speech = %v, want nil", parts)
+	}
+}
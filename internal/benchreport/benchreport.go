@@ -0,0 +1,235 @@
+// Package benchreport collects repeated latency measurements from the
+// transcription benchmarks into a JSON report, so runs on two commits can be
+// diffed stage by stage.
+package benchreport
+
+import (
+	"encoding/json"
+	"fmt"
+	"math"
+	"os"
+	"runtime"
+	"slices"
+	"sort"
+	"sync"
+	"time"
+)
+
+// Summary describes the distribution of one latency over repeated runs, in
+// milliseconds. Percentiles use the nearest-rank method.
+type Summary struct {
+	N    int     `json:"n"`
+	Mean float64 `json:"mean_ms"`
+	P50  float64 `json:"p50_ms"`
+	P95  float64 `json:"p95_ms"`
+	P99  float64 `json:"p99_ms"`
+	Min  float64 `json:"min_ms"`
+	Max  float64 `json:"max_ms"`
+}
+
+// Summarize returns the distribution of samples. An empty input gives a zero
+// Summary.
+func Summarize(samples []time.Duration) Summary {
+	if len(samples) == 0 {
+		return Summary{}
+	}
+	sorted := slices.Clone(samples)
+	slices.Sort(sorted)
+
+	var total time.Duration
+	for _, d := range sorted {
+		total += d
+	}
+	return Summary{
+		N:    len(sorted),
+		Mean: ms(total / time.Duration(len(sorted))),
+		P50:  ms(percentile(sorted, 50)),
+		P95:  ms(percentile(sorted, 95)),
+		P99:  ms(percentile(sorted, 99)),
+		Min:  ms(sorted[0]),
+		Max:  ms(sorted[len(sorted)-1]),
+	}
+}
+
+// percentile returns the nearest-rank p-th percentile of sorted samples.
+func percentile(sorted []time.Duration, p float64) time.Duration {
+	rank := int(math.Ceil(p / 100 * float64(len(sorted))))
+	if rank < 1 {
+		rank = 1
+	}
+	return sorted[rank-1]
+}
+
+func ms(d time.Duration) float64 {
+	return float64(d) / float64(time.Millisecond)
+}
+
+// ModelCost is the average per-run cost of one CoreML model, split the way
+// the bridge accounts for it: marshal (inputs and output backings), predict
+// (CoreML execution) and copy-out (results into Go tensors).
+type ModelCost struct {
+	Predictions float64 `json:"predictions"`
+	MarshalMs   float64 `json:"marshal_ms"`
+	PredictMs   float64 `json:"predict_ms"`
+	CopyOutMs   float64 `json:"copy_out_ms"`
+	BytesCopied float64 `json:"bytes_copied"`
+}
+
+// Entry is the result of one benchmark over one audio sample.
+type Entry struct {
+	Name        string               `json:"name"`
+	AudioMs     float64              `json:"audio_ms,omitempty"`
+	Runs        int                  `json:"runs"`
+	RTF         float64              `json:"rtf,omitempty"` // median total time over audio duration
+	AllocsPerOp float64              `json:"allocs_per_op"`
+	BytesPerOp  float64              `json:"bytes_per_op"`
+	Total       Summary              `json:"total"`
+	Stages      map[string]Summary   `json:"stages,omitempty"`
+	Models      map[string]ModelCost `json:"models,omitempty"`
+}
+
+// Recorder accumulates the measurements of one benchmark as it runs.
+type Recorder struct {
+	name    string
+	audio   time.Duration
+	totals  []time.Duration
+	stages  map[string][]time.Duration
+	mallocs uint64
+	bytes   uint64
+	mem     runtime.MemStats
+}
+
+// NewRecorder starts recording a benchmark named name over audio of the given
+// duration (zero when the benchmark has no audio input).
+func NewRecorder(name string, audio time.Duration) *Recorder {
+	return &Recorder{name: name, audio: audio, stages: make(map[string][]time.Duration)}
+}
+
+// Begin snapshots the allocation counters before a run. Call it outside the
+// timed region: reading them stops the world. The counters are unsigned, so
+// subtracting here and adding in End leaves the per-run delta.
+func (r *Recorder) Begin() {
+	runtime.ReadMemStats(&r.mem)
+	r.mallocs -= r.mem.Mallocs
+	r.bytes -= r.mem.TotalAlloc
+}
+
+// End records one run that took total, with the given time per stage, and
+// adds its allocations since Begin.
+func (r *Recorder) End(total time.Duration, stages map[string]time.Duration) {
+	runtime.ReadMemStats(&r.mem)
+	r.mallocs += r.mem.Mallocs
+	r.bytes += r.mem.TotalAlloc
+	r.totals = append(r.totals, total)
+	for stage, d := range stages {
+		r.stages[stage] = append(r.stages[stage], d)
+	}
+}
+
+// Entry returns the summary of the runs recorded so far, with models (the
+// summed per-model costs over all runs) averaged per run.
+func (r *Recorder) Entry(models map[string]ModelCost) Entry {
+	runs := len(r.totals)
+	e := Entry{
+		Name:    r.name,
+		AudioMs: ms(r.audio),
+		Runs:    runs,
+		Total:   Summarize(r.totals),
+	}
+	if runs == 0 {
+		return e
+	}
+	e.AllocsPerOp = float64(r.mallocs) / float64(runs)
+	e.BytesPerOp = float64(r.bytes) / float64(runs)
+	if r.audio > 0 {
+		e.RTF = e.Total.P50 / e.AudioMs
+	}
+	if len(r.stages) > 0 {
+		e.Stages = make(map[string]Summary, len(r.stages))
+		for stage, samples := range r.stages {
+			e.Stages[stage] = Summarize(samples)
+		}
+	}
+	if len(models) > 0 {
+		e.Models = make(map[string]ModelCost, len(models))
+		for name, c := range models {
+			n := float64(runs)
+			e.Models[name] = ModelCost{
+				Predictions: c.Predictions / n,
+				MarshalMs:   c.MarshalMs / n,
+				PredictMs:   c.PredictMs / n,
+				CopyOutMs:   c.CopyOutMs / n,
+				BytesCopied: c.BytesCopied / n,
+			}
+		}
+	}
+	return e
+}
+
+// Report is a set of benchmark entries plus the environment they ran in.
+// Safe for concurrent use.
+type Report struct {
+	mu      sync.Mutex
+	entries map[string]Entry
+}
+
+// New returns an empty report.
+func New() *Report {
+	return &Report{entries: make(map[string]Entry)}
+}
+
+// Add records e, replacing any earlier entry with the same name. The testing
+// package reruns a benchmark with growing b.N, so the last (longest) run wins.
+func (r *Report) Add(e Entry) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	r.entries[e.Name] = e
+}
+
+// Len returns the number of entries.
+func (r *Report) Len() int {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	return len(r.entries)
+}
+
+// reportFile is the JSON layout of a report. Entries are sorted by name and
+// no timestamps are included, so two reports diff line by line.
+type reportFile struct {
+	GoVersion string  `json:"go_version"`
+	OS        string  `json:"os"`
+	Arch      string  `json:"arch"`
+	CPUs      int     `json:"cpus"`
+	Entries   []Entry `json:"entries"`
+}
+
+// MarshalJSON implements json.Marshaler.
+func (r *Report) MarshalJSON() ([]byte, error) {
+	r.mu.Lock()
+	entries := make([]Entry, 0, len(r.entries))
+	for _, e := range r.entries {
+		entries = append(entries, e)
+	}
+	r.mu.Unlock()
+	sort.Slice(entries, func(i, j int) bool { return entries[i].Name < entries[j].Name })
+
+	return json.Marshal(reportFile{
+		GoVersion: runtime.Version(),
+		OS:        runtime.GOOS,
+		Arch:      runtime.GOARCH,
+		CPUs:      runtime.NumCPU(),
+		Entries:   entries,
+	})
+}
+
+// WriteFile writes the report to path as indented JSON.
+func (r *Report) WriteFile(path string) error {
+	data, err := json.MarshalIndent(r, "", "  ")
+	if err != nil {
+		return fmt.Errorf("benchreport: encode: %w", err)
+	}
+	if err := os.WriteFile(path, append(data, '\n'), 0644); err != nil {
+		return fmt.Errorf("benchreport: write %s: %w", path, err)
+	}
+	return nil
+}
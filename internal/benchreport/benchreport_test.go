@@ -0,0 +1,118 @@
+package benchreport
+
+import (
+	"encoding/json"
+	"errors"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+)
+
+func TestSummarize(t *testing.T) {
+	var samples []time.Duration
+	for i := 100; i >= 1; i-- {
+		samples = append(samples, time.Duration(i)*time.Millisecond)
+	}
+
+	got := Summarize(samples)
+	want := Summary{N: 100, Mean: 50.5, P50: 50, P95: 95, P99: 99, Min: 1, Max: 100}
+	if got != want {
+		t.Errorf("Summarize() = %+v, want %+v", got, want)
+	}
+	if samples[0] != 100*time.Millisecond {
+		t.Error("Summarize() reordered its input")
+	}
+}
+
+func TestSummarizeSmall(t *testing.T) {
+	tests := []struct {
+		name    string
+		samples []time.Duration
+		want    Summary
+	}{
+		{"empty", nil, Summary{}},
+		{"one", []time.Duration{3 * time.Millisecond}, Summary{N: 1, Mean: 3, P50: 3, P95: 3, P99: 3, Min: 3, Max: 3}},
+		{"three", []time.Duration{time.Millisecond, 5 * time.Millisecond, 3 * time.Millisecond},
+			Summary{N: 3, Mean: 3, P50: 3, P95: 5, P99: 5, Min: 1, Max: 5}},
+	}
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			if got := Summarize(tt.samples); got != tt.want {
+				t.Errorf("Summarize() = %+v, want %+v", got, tt.want)
+			}
+		})
+	}
+}
+
+func TestRecorderEntry(t *testing.T) {
+	r := NewRecorder("parakeet/short", 2*time.Second)
+	for _, total := range []time.Duration{100 * time.Millisecond, 300 * time.Millisecond, 200 * time.Millisecond} {
+		r.Begin()
+		r.End(total, map[string]time.Duration{"encode": total / 2, "decode": total / 4})
+	}
+
+	e := r.Entry(map[string]ModelCost{"encoder": {Predictions: 3, PredictMs: 150}})
+	if e.Runs != 3 || e.AudioMs != 2000 {
+		t.Errorf("Runs, AudioMs = %d, %v, want 3, 2000", e.Runs, e.AudioMs)
+	}
+	if e.RTF != 0.1 {
+		t.Errorf("RTF = %v, want 0.1 (p50 200ms over 2s)", e.RTF)
+	}
+	if got := e.Stages["encode"].P50; got != 100 {
+		t.Errorf("encode p50 = %v, want 100", got)
+	}
+	if got := e.Models["encoder"]; got.Predictions != 1 || got.PredictMs != 50 {
+		t.Errorf("encoder cost = %+v, want per-run averages", got)
+	}
+}
+
+func TestReportWriteFile(t *testing.T) {
+	r := New()
+	r.Add(Entry{Name: "whisper/short", Runs: 1})
+	r.Add(Entry{Name: "parakeet/short", Runs: 1})
+	r.Add(Entry{Name: "whisper/short", Runs: 5}) // rerun with a larger b.N
+	if r.Len() != 2 {
+		t.Fatalf("Len() = %d, want 2", r.Len())
+	}
+
+	path := filepath.Join(t.TempDir(), "report.json")
+	if err := r.WriteFile(path); err != nil {
+		t.Fatalf("WriteFile: %v", err)
+	}
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	var got reportFile
+	if err := json.Unmarshal(data, &got); err != nil {
+		t.Fatalf("parse report: %v", err)
+	}
+	if len(got.Entries) != 2 || got.Entries[0].Name != "parakeet/short" || got.Entries[1].Name != "whisper/short" {
+		t.Fatalf("entries = %+v, want sorted by name", got.Entries)
+	}
+	if got.Entries[1].Runs != 5 {
+		t.Errorf("whisper/short runs = %d, want the last entry added", got.Entries[1].Runs)
+	}
+}
+
+func TestLoadSamples(t *testing.T) {
+	samples, err := LoadSamples(filepath.Join("..", "transcribe", "testdata"))
+	if errors.Is(err, fs.ErrNotExist) {
+		t.Skipf("benchmark audio missing (whisper.cpp submodule not checked out?): %v", err)
+	}
+	if err != nil {
+		t.Fatalf("LoadSamples: %v", err)
+	}
+	if len(samples) == 0 {
+		t.Fatal("LoadSamples returned no samples")
+	}
+	for _, s := range samples {
+		want := int(s.DurationS * 16000)
+		if d := len(s.Audio) - want; d < -1600 || d > 1600 {
+			t.Errorf("%s: %d samples, want about %d", s.Label, len(s.Audio), want)
+		}
+	}
+}
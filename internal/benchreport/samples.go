@@ -0,0 +1,70 @@
+package benchreport
+
+import (
+	"encoding/json"
+	"fmt"
+	"os"
+	"path/filepath"
+	"time"
+
+	"github.com/go-audio/wav"
+)
+
+// Sample is one benchmark recording and its reference transcript, as listed
+// in a testdata references.json.
+type Sample struct {
+	Label      string  `json:"label"`
+	File       string  `json:"file"`
+	Transcript string  `json:"transcript"`
+	DurationS  float64 `json:"duration_sec"`
+
+	Audio []float32 `json:"-"` // mono samples normalized to [-1.0, 1.0]
+}
+
+// Duration returns the length of the recording.
+func (s Sample) Duration() time.Duration {
+	return time.Duration(s.DurationS * float64(time.Second))
+}
+
+// LoadSamples reads dir/references.json and decodes every WAV file it lists.
+// A missing file is reported as an error wrapping fs.ErrNotExist.
+func LoadSamples(dir string) ([]Sample, error) {
+	data, err := os.ReadFile(filepath.Join(dir, "references.json"))
+	if err != nil {
+		return nil, fmt.Errorf("benchreport: %w", err)
+	}
+	var refs struct {
+		Samples []Sample `json:"samples"`
+	}
+	if err := json.Unmarshal(data, &refs); err != nil {
+		return nil, fmt.Errorf("benchreport: parse references.json: %w", err)
+	}
+
+	for i := range refs.Samples {
+		s := &refs.Samples[i]
+		if s.Audio, err = DecodeWAV(filepath.Join(dir, s.File)); err != nil {
+			return nil, err
+		}
+	}
+	return refs.Samples, nil
+}
+
+// DecodeWAV decodes a 16-bit PCM WAV file to float32 samples normalized to
+// [-1.0, 1.0].
+func DecodeWAV(path string) ([]float32, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return nil, fmt.Errorf("benchreport: %w", err)
+	}
+	defer func() { _ = f.Close() }()
+
+	buf, err := wav.NewDecoder(f).FullPCMBuffer()
+	if err != nil {
+		return nil, fmt.Errorf("benchreport: decode %s: %w", path, err)
+	}
+	samples := make([]float32, len(buf.Data))
+	for i, s := range buf.Data {
+		samples[i] = float32(s) / 32768.0
+	}
+	return samples, nil
+}
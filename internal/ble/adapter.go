@@ -10,15 +10,19 @@ const (
 	ServiceUUID      = "19b10000-e8f2-537e-4f6c-d104768a1214"
 	TXCharUUID       = "6856e119-2c7b-455a-bf42-cf7ddd2c5907"
 	ResponseCharUUID = "6856e119-2c7b-455a-bf42-cf7ddd2c5908"
+	StatsCharUUID    = "6856e119-2c7b-455a-bf42-cf7ddd2c5909"
 	MACCharUUID      = "19b10002-e8f2-537e-4f6c-d104768a1214"
 )
 
 // Characteristic represents a BLE GATT characteristic.
 type Characteristic interface {
-	// Write sends data to the characteristic.
+	// Write sends data to the characteristic. data is only valid during the
+	// call.
 	Write(data []byte) error
 	// Subscribe registers a callback for notifications on this characteristic.
 	Subscribe(callback func(data []byte)) error
+	// Read returns the characteristic's current value.
+	Read() ([]byte, error)
 }
 
 // Device represents a discovered BLE peripheral.
@@ -2,6 +2,7 @@ package ble
 
 import (
 	"context"
+	"errors"
 	"fmt"
 	"log/slog"
 	"sync"
@@ -16,7 +17,8 @@ import (
 type ClientOptions struct {
 	QueueSize       int           // max queued messages during disconnect
 	ReconnectMax    int           // max reconnect backoff in seconds (used by reconnection loop in Task 7)
-	InterChunkDelay time.Duration // delay between BLE write chunks (default 20ms)
+	InterChunkDelay time.Duration // delay between BLE write chunks when the device reports no credits (default 20ms)
+	CreditTimeout   time.Duration // max wait for a credit before sending anyway (default 5s)
 }
 
 // DefaultClientOptions returns sensible defaults.
@@ -25,6 +27,7 @@ func DefaultClientOptions() ClientOptions {
 		QueueSize:       64,
 		ReconnectMax:    30,
 		InterChunkDelay: 20 * time.Millisecond,
+		CreditTimeout:   5 * time.Second,
 	}
 }
 
@@ -32,7 +35,8 @@ func DefaultClientOptions() ClientOptions {
 type Client struct {
 	adapter   Adapter
 	deviceMAC string
-	key       []byte // 32-byte AES encryption key
+	cipher    *blecrypto.Cipher // AES-256-GCM with the paired key
+	packets   sync.Pool         // *[]byte DataPacket buffers, see sendFrame
 
 	mu        sync.Mutex
 	conn      Connection
@@ -40,10 +44,13 @@ type Client struct {
 	connected bool
 
 	packetNum    atomic.Uint32
-	reconnecting atomic.Bool // guards against stacked reconnect goroutines
+	chunkSize    atomic.Int32  // text bytes per packet at the negotiated MTU; 0 until reported
+	features     atomic.Uint32 // protocol.Features the device reported; 0 until then
+	reconnecting atomic.Bool   // guards against stacked reconnect goroutines
+	credits      *creditWindow
 
 	done  chan struct{} // closed by Close() to stop reconnectLoop
-	queue []string
+	queue []protocol.Edit
 	opts  ClientOptions
 }
 
@@ -62,79 +69,186 @@ func NewClient(adapter Adapter, deviceMAC string, key []byte, opts ClientOptions
 	if opts.InterChunkDelay <= 0 {
 		opts.InterChunkDelay = 20 * time.Millisecond
 	}
-	return &Client{
+	if opts.CreditTimeout <= 0 {
+		opts.CreditTimeout = 5 * time.Second
+	}
+	aead, err := blecrypto.NewCipher(key)
+	if err != nil {
+		return nil, fmt.Errorf("ble: %w", err)
+	}
+	c := &Client{
 		adapter:   adapter,
 		deviceMAC: deviceMAC,
-		key:       key,
+		cipher:    aead,
+		credits:   newCreditWindow(),
 		done:      make(chan struct{}),
 		opts:      opts,
-	}, nil
+	}
+	c.packets.New = func() any {
+		buf := make([]byte, 0, protocol.DataPacketLen(protocol.MaxWriteBytes))
+		return &buf
+	}
+	return c, nil
 }
 
+// ErrEditUnsupported is returned by SendEdit when the device reported that
+// its firmware cannot apply backspaces.
+var ErrEditUnsupported = errors.New("ble: device firmware does not support edits")
+
 // Send encrypts and transmits text to the ESP32. If disconnected, the text
 // is queued for delivery on reconnect. Safe for concurrent use.
 func (c *Client) Send(text string) error {
 	if text == "" {
 		return nil
 	}
+	return c.send(protocol.Edit{Text: text})
+}
+
+// SendEdit has the ESP32 delete backspaces characters before the cursor,
+// then type text: a streaming correction. The typer merges edits still
+// waiting to be typed, so superseded text is never typed. Queued like Send
+// while disconnected. Safe for concurrent use.
+func (c *Client) SendEdit(backspaces int, text string) error {
+	if backspaces <= 0 {
+		return c.Send(text)
+	}
+	// Firmware that predates edits would type the text without deleting
+	if !c.CanEdit() {
+		return ErrEditUnsupported
+	}
+	return c.send(protocol.Edit{Backspaces: backspaces, Text: text})
+}
+
+// CanEdit reports whether the device firmware applies backspaces. Until
+// link params arrive it reports true, as the device may support them.
+func (c *Client) CanEdit() bool {
+	return c.chunkSize.Load() == 0 || protocol.Features(c.features.Load())&protocol.FeatureEdit != 0
+}
 
+// send transmits edit, or queues it while disconnected.
+func (c *Client) send(edit protocol.Edit) error {
 	c.mu.Lock()
 	if !c.connected {
-		c.enqueue(text)
+		c.enqueue(edit)
 		c.mu.Unlock()
 		return nil
 	}
 	txChar := c.txChar
 	c.mu.Unlock()
 
-	return c.sendChunked(txChar, text)
+	return c.sendChunked(txChar, edit)
 }
 
-// sendChunked splits text into BLE-MTU-safe chunks, encrypts each, and writes.
-func (c *Client) sendChunked(txChar Characteristic, text string) error {
-	chunks := protocol.ChunkText(text, protocol.MaxPayloadBytes)
-	for i, chunk := range chunks {
-		if err := c.sendOne(txChar, chunk); err != nil {
-			return err
-		}
-		// Small delay between chunks to avoid overwhelming the ESP32
-		if i < len(chunks)-1 {
+// sendChunked splits edits into BLE-MTU-safe frames, encrypts each, and
+// writes. Frames are batched and packed as far as the device supports, and
+// pipelined up to its credit window; firmware that reports no credits gets a
+// fixed delay between frames instead.
+func (c *Client) sendChunked(txChar Characteristic, edits ...protocol.Edit) error {
+	frames := protocol.Frames(edits, c.chunkBytes(), protocol.Features(c.features.Load()))
+	for i, frame := range frames {
+		if !c.credits.acquire(c.opts.CreditTimeout) && i > 0 {
+			// Small delay between chunks to avoid overwhelming the ESP32
 			time.Sleep(c.opts.InterChunkDelay)
 		}
+		if err := c.sendFrame(txChar, frame); err != nil {
+			return err
+		}
 	}
 	return nil
 }
 
-// sendOne encrypts and sends a single chunk.
-func (c *Client) sendOne(txChar Characteristic, text string) error {
-	// Build inner protobuf
-	kbPacket := protocol.MarshalKeyboardPacket(text)
-	encData := protocol.MarshalEncryptedData(kbPacket)
+// chunkBytes returns the text bytes per packet for the current connection:
+// sized from the MTU the device reported, or protocol.MaxPayloadBytes before
+// it has.
+func (c *Client) chunkBytes() int {
+	if n := c.chunkSize.Load(); n > 0 {
+		return int(n)
+	}
+	return protocol.MaxPayloadBytes
+}
 
-	// Encrypt
-	iv, ciphertext, tag, err := blecrypto.Encrypt(c.key, encData)
+// handleResponse processes a notification from the response characteristic.
+func (c *Client) handleResponse(data []byte) {
+	resp, err := protocol.UnmarshalResponsePacket(data)
 	if err != nil {
-		return fmt.Errorf("ble: encrypt: %w", err)
+		slog.Warn("[BLE] invalid response packet", "error", err)
+		return
 	}
+	switch resp.Type {
+	case protocol.ResponseTypeLinkParams:
+		c.handleLinkParams(resp.Data)
+	case protocol.ResponseTypeCredits:
+		cr, err := protocol.UnmarshalCredits(resp.Data)
+		if err != nil {
+			slog.Warn("[BLE] invalid credits", "error", err)
+			return
+		}
+		c.credits.update(cr)
+	}
+}
 
-	// Build outer DataPacket
-	pktNum := c.packetNum.Add(1)
-	dataPacket, err := protocol.MarshalDataPacket(iv, tag, ciphertext, pktNum)
+// handleLinkParams sizes chunks from the link parameters the device reported.
+func (c *Client) handleLinkParams(data []byte) {
+	link, err := protocol.UnmarshalLinkParams(data)
 	if err != nil {
-		return fmt.Errorf("ble: marshal data packet: %w", err)
+		slog.Warn("[BLE] invalid link params", "error", err)
+		return
 	}
+	n := protocol.MaxPayloadForMTU(link.MTU)
+	if n > 0 {
+		c.chunkSize.Store(int32(n))
+	}
+	c.features.Store(uint32(link.Features))
+	slog.Info("[BLE] link parameters", "mtu", link.MTU, "tx_phy", link.TxPHY, "rx_phy", link.RxPHY,
+		"max_tx_octets", link.MaxTxOctets, "chunk_bytes", c.chunkBytes(), "features", link.Features)
+}
+
+// sendFrame encodes, encrypts and sends a single frame. The DataPacket is
+// built in one pass in a pooled buffer (protocol.AppendDataPacket), so
+// sending allocates nothing once the pool is warm; Write must not keep the
+// buffer after it returns.
+func (c *Client) sendFrame(txChar Characteristic, frame protocol.Frame) error {
+	bufp := c.packets.Get().(*[]byte)
+	defer c.packets.Put(bufp)
 
-	return txChar.Write(dataPacket)
+	pkt, err := protocol.AppendDataPacket((*bufp)[:0], frame, c.packetNum.Add(1), c.cipher)
+	*bufp = pkt[:0] // keep the buffer if it grew
+	if err != nil {
+		return fmt.Errorf("ble: encrypt: %w", err)
+	}
+	return txChar.Write(pkt)
 }
 
-// enqueue adds text to the send queue (caller must hold mu).
-func (c *Client) enqueue(text string) {
+// Stats reads the device's pipeline telemetry: packet counters, typer queue
+// high-water mark, free heap, and per-stage latency histograms from receipt
+// to the last keystroke.
+func (c *Client) Stats() (*protocol.Stats, error) {
+	c.mu.Lock()
+	conn, connected := c.conn, c.connected
+	c.mu.Unlock()
+	if !connected {
+		return nil, errors.New("ble: not connected")
+	}
+
+	statsChar, err := conn.DiscoverCharacteristic(ServiceUUID, StatsCharUUID)
+	if err != nil {
+		return nil, fmt.Errorf("ble: discover stats characteristic: %w", err)
+	}
+	data, err := statsChar.Read()
+	if err != nil {
+		return nil, fmt.Errorf("ble: read stats: %w", err)
+	}
+	return protocol.UnmarshalStats(data)
+}
+
+// enqueue adds an edit to the send queue (caller must hold mu).
+func (c *Client) enqueue(edit protocol.Edit) {
 	if len(c.queue) >= c.opts.QueueSize {
 		// Drop oldest
 		slog.Warn("[BLE] queue full, dropping oldest message")
 		c.queue = c.queue[1:]
 	}
-	c.queue = append(c.queue, text)
+	c.queue = append(c.queue, edit)
 }
 
 // QueueLen returns the number of queued messages.
@@ -156,6 +270,19 @@ func (c *Client) setConnected(conn Connection) error {
 	}
 	c.txChar = txChar
 	c.connected = true
+	c.chunkSize.Store(0)
+	c.features.Store(0)
+	c.credits.reset()
+
+	// The device reports its negotiated link parameters and credits on this
+	// characteristic. Without it, chunks keep the default size and pace.
+	respChar, err := conn.DiscoverCharacteristic(ServiceUUID, ResponseCharUUID)
+	if err == nil {
+		err = respChar.Subscribe(c.handleResponse)
+	}
+	if err != nil {
+		slog.Warn("[BLE] response notifications unavailable, using default chunk size", "error", err)
+	}
 	return nil
 }
 
@@ -177,16 +304,15 @@ func (c *Client) flushQueue() {
 		c.mu.Unlock()
 		return
 	}
-	queued := make([]string, len(c.queue))
+	queued := make([]protocol.Edit, len(c.queue))
 	copy(queued, c.queue)
 	c.queue = c.queue[:0]
 	txChar := c.txChar
 	c.mu.Unlock()
 
-	for _, text := range queued {
-		if err := c.sendChunked(txChar, text); err != nil {
-			slog.Error("[BLE] failed to flush queued message", "error", err)
-		}
+	// Batched frames let short queued messages share writes
+	if err := c.sendChunked(txChar, queued...); err != nil {
+		slog.Error("[BLE] failed to flush queued messages", "error", err)
 	}
 }
 
@@ -4,6 +4,8 @@ import (
 	"encoding/binary"
 	"strings"
 	"testing"
+
+	"github.com/chaz8081/gostt-writer/internal/ble/protocol"
 )
 
 func makeTestKey() []byte {
@@ -74,6 +76,58 @@ func TestClientSendChunksLongText(t *testing.T) {
 	}
 }
 
+// linkParamsNotification returns the ResponsePacket the firmware sends after
+// negotiating mtu, advertising the given framing features.
+func linkParamsNotification(mtu uint16, features protocol.Features) []byte {
+	return []byte{0x08, 0x02, 0x10, 0x01, 0x1a, 0x07, byte(mtu), byte(mtu >> 8), 0x02, 0x02, 0xFB, 0x00, byte(features)}
+}
+
+func TestClientChunksFromReportedMTU(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), zeroDelayOpts())
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	if got := client.chunkBytes(); got != protocol.MaxPayloadBytes {
+		t.Fatalf("chunkBytes() before link report = %d, want default %d", got, protocol.MaxPayloadBytes)
+	}
+
+	// The default MTU fits no packet: keep the default size
+	conn.respChar.SimulateNotification(linkParamsNotification(23, 0))
+	if got := client.chunkBytes(); got != protocol.MaxPayloadBytes {
+		t.Errorf("chunkBytes() after MTU 23 = %d, want default %d", got, protocol.MaxPayloadBytes)
+	}
+
+	conn.respChar.SimulateNotification(linkParamsNotification(517, 0))
+	want := protocol.MaxPayloadForMTU(517)
+	if got := client.chunkBytes(); got != want {
+		t.Fatalf("chunkBytes() after MTU 517 = %d, want %d", got, want)
+	}
+
+	longText := strings.Repeat("word ", 200) // 1000 bytes
+	if err := client.Send(longText); err != nil {
+		t.Fatalf("Send() error = %v", err)
+	}
+	writes := conn.txChar.writes
+	if wantWrites := len(protocol.ChunkText(longText, want)); len(writes) != wantWrites {
+		t.Errorf("got %d writes, want %d", len(writes), wantWrites)
+	}
+	for i, w := range writes {
+		if len(w) > protocol.MaxWriteBytes {
+			t.Errorf("write %d is %d bytes, over the %d-byte limit", i, len(w), protocol.MaxWriteBytes)
+		}
+	}
+
+	// A new connection starts over from the default
+	if err := client.setConnected(adapter.latestConnection()); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	if got := client.chunkBytes(); got != protocol.MaxPayloadBytes {
+		t.Errorf("chunkBytes() after reconnect = %d, want default %d", got, protocol.MaxPayloadBytes)
+	}
+}
+
 func TestClientSendEmptyString(t *testing.T) {
 	adapter := newMockAdapter(nil)
 	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), zeroDelayOpts())
@@ -220,6 +274,112 @@ func TestClientFlushQueueOnReconnect(t *testing.T) {
 	}
 }
 
+func TestClientBatchesQueueWithFeatures(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), zeroDelayOpts())
+
+	_ = client.Send("msg1")
+	_ = client.Send("msg2")
+	_ = client.Send("msg3")
+
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	conn.respChar.SimulateNotification(linkParamsNotification(517, protocol.FeatureBatch|protocol.FeatureDict))
+	client.flushQueue()
+
+	// All three share one batched frame
+	if got := conn.txChar.writeCount(); got != 1 {
+		t.Errorf("expected 1 write after flush, got %d", got)
+	}
+
+	// A new connection forgets the features until the device reports again
+	if err := client.setConnected(adapter.latestConnection()); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	if got := protocol.Features(client.features.Load()); got != 0 {
+		t.Errorf("features after reconnect = %d, want 0", got)
+	}
+}
+
+func TestClientSendEdit(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), zeroDelayOpts())
+
+	// Disconnected: queued like text
+	if err := client.SendEdit(3, "cat"); err != nil {
+		t.Fatalf("SendEdit() while disconnected error = %v", err)
+	}
+	if got := client.QueueLen(); got != 1 {
+		t.Errorf("QueueLen() = %d, want 1", got)
+	}
+
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	// Before link params the device may support edits
+	if !client.CanEdit() {
+		t.Error("CanEdit() before link params = false, want true")
+	}
+	if err := client.SendEdit(2, ""); err != nil {
+		t.Fatalf("SendEdit() before link params error = %v", err)
+	}
+	if got := conn.txChar.writeCount(); got != 1 {
+		t.Errorf("%d writes, want 1", got)
+	}
+
+	conn.respChar.SimulateNotification(linkParamsNotification(517, protocol.FeatureBatch))
+	if client.CanEdit() {
+		t.Error("CanEdit() without FeatureEdit = true, want false")
+	}
+	if err := client.SendEdit(2, "at"); err != ErrEditUnsupported {
+		t.Errorf("SendEdit() without FeatureEdit error = %v, want ErrEditUnsupported", err)
+	}
+	if err := client.SendEdit(0, "text"); err != nil {
+		t.Errorf("SendEdit() without backspaces error = %v, want nil", err)
+	}
+	if got := conn.txChar.writeCount(); got != 2 {
+		t.Errorf("%d writes, want 2", got)
+	}
+
+	conn.respChar.SimulateNotification(linkParamsNotification(517, protocol.FeatureBatch|protocol.FeatureEdit))
+	if err := client.SendEdit(2, "at"); err != nil {
+		t.Errorf("SendEdit() with FeatureEdit error = %v", err)
+	}
+	if got := conn.txChar.writeCount(); got != 3 {
+		t.Errorf("%d writes, want 3", got)
+	}
+}
+
+func TestClientStats(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), zeroDelayOpts())
+	if _, err := client.Stats(); err == nil {
+		t.Error("Stats() while disconnected: expected error")
+	}
+
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	// Header and counters of a device with no stages
+	value := []byte{1, 0, 16, 0}
+	for _, v := range []uint32{7, 1, 0, 3, 200000, 150000} {
+		value = binary.LittleEndian.AppendUint32(value, v)
+	}
+	conn.statsChar.value = value
+
+	st, err := client.Stats()
+	if err != nil {
+		t.Fatalf("Stats() error = %v", err)
+	}
+	if st.Received != 7 || st.Dropped != 1 || st.TyperQueueHighWater != 3 || st.MinFreeHeap != 150000 {
+		t.Errorf("Stats() = %+v", st)
+	}
+}
+
 func TestNewClientRejectsInvalidKeyLength(t *testing.T) {
 	adapter := newMockAdapter(nil)
 	_, err := NewClient(adapter, "AA:BB:CC:DD:EE:FF", make([]byte, 16), DefaultClientOptions())
@@ -227,3 +387,45 @@ func TestNewClientRejectsInvalidKeyLength(t *testing.T) {
 		t.Error("NewClient() should reject 16-byte key")
 	}
 }
+
+// discardCharacteristic accepts writes without keeping them.
+type discardCharacteristic struct{ mockCharacteristic }
+
+func (*discardCharacteristic) Write([]byte) error { return nil }
+
+func TestClientSendFrameAllocs(t *testing.T) {
+	if raceEnabled {
+		t.Skip("sync.Pool drops buffers at random under the race detector")
+	}
+	client := mustNewClient(t, newMockAdapter(nil), "AA:BB:CC:DD:EE:FF", makeTestKey(), zeroDelayOpts())
+	frame := protocol.Frame{Records: []protocol.Record{{Text: "the quick brown fox ", Backspaces: 3}}, Packed: true}
+	tx := &discardCharacteristic{}
+	allocs := testing.AllocsPerRun(100, func() {
+		if err := client.sendFrame(tx, frame); err != nil {
+			t.Fatal(err)
+		}
+	})
+	if allocs != 0 {
+		t.Errorf("sendFrame() = %.1f allocs per chunk, want 0", allocs)
+	}
+}
+
+// BenchmarkClientSendFrame measures encoding, encrypting and writing one
+// chunk at the largest write size.
+func BenchmarkClientSendFrame(b *testing.B) {
+	client, err := NewClient(newMockAdapter(nil), "AA:BB:CC:DD:EE:FF", makeTestKey(), zeroDelayOpts())
+	if err != nil {
+		b.Fatal(err)
+	}
+	text := strings.Repeat("word ", 100)
+	frames := protocol.Frames([]protocol.Edit{{Text: text}}, protocol.MaxPayloadForMTU(517), protocol.FeatureBatch|protocol.FeatureDict)
+	tx := &discardCharacteristic{}
+	b.ReportAllocs()
+	b.SetBytes(int64(len(text) / len(frames)))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if err := client.sendFrame(tx, frames[i%len(frames)]); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
@@ -229,6 +229,19 @@ func (c *coreBluetoothCharacteristic) Write(data []byte) error {
 	return err
 }
 
+// maxAttributeLen is the longest GATT attribute value (Core spec Vol 3 Part F
+// 3.2.9); CoreBluetooth issues the long reads for it.
+const maxAttributeLen = 512
+
+func (c *coreBluetoothCharacteristic) Read() ([]byte, error) {
+	buf := make([]byte, maxAttributeLen)
+	n, err := c.char.Read(buf)
+	if err != nil {
+		return nil, err
+	}
+	return buf[:n], nil
+}
+
 func (c *coreBluetoothCharacteristic) Subscribe(cb func([]byte)) error {
 	return c.char.EnableNotifications(func(buf []byte) {
 		cb(buf)
@@ -135,35 +135,59 @@ func DeriveEncryptionKey(sharedSecret []byte) ([]byte, error) {
 	return key, nil
 }
 
-// Encrypt encrypts plaintext with AES-256-GCM, returning iv (12 bytes),
-// ciphertext, and tag (16 bytes) separately (as GOSTT-KBD expects them in
-// separate protobuf fields).
-func Encrypt(key, plaintext []byte) (iv, ciphertext, tag []byte, err error) {
+// Cipher is AES-256-GCM for one key, set up once and reused for every
+// packet. Safe for concurrent use: the AEAD keeps no per-call state.
+type Cipher struct {
+	aead cipher.AEAD
+}
+
+// NewCipher returns a Cipher for a 32-byte key.
+func NewCipher(key []byte) (*Cipher, error) {
 	block, err := aes.NewCipher(key)
 	if err != nil {
-		return nil, nil, nil, fmt.Errorf("ble/crypto: new cipher: %w", err)
+		return nil, fmt.Errorf("ble/crypto: new cipher: %w", err)
 	}
 	aead, err := cipher.NewGCM(block)
 	if err != nil {
-		return nil, nil, nil, fmt.Errorf("ble/crypto: new GCM: %w", err)
+		return nil, fmt.Errorf("ble/crypto: new GCM: %w", err)
 	}
+	return &Cipher{aead: aead}, nil
+}
 
-	iv = make([]byte, aead.NonceSize()) // 12 bytes
+// SealInPlace fills iv (12 bytes) with a random nonce, encrypts data in
+// place and writes the tag (16 bytes) to tag. It allocates nothing when data
+// has 16 bytes of spare capacity for GCM to append the tag to.
+func (c *Cipher) SealInPlace(iv, tag, data []byte) error {
+	if len(iv) != c.aead.NonceSize() || len(tag) != c.aead.Overhead() {
+		return fmt.Errorf("ble/crypto: IV and tag must be %d and %d bytes, got %d and %d",
+			c.aead.NonceSize(), c.aead.Overhead(), len(iv), len(tag))
+	}
 	if _, err := io.ReadFull(rand.Reader, iv); err != nil {
-		return nil, nil, nil, fmt.Errorf("ble/crypto: random IV: %w", err)
+		return fmt.Errorf("ble/crypto: random IV: %w", err)
 	}
-
 	// Go's GCM Seal appends the tag to the ciphertext
-	sealed := aead.Seal(nil, iv, plaintext, nil)
-
-	// Split: ciphertext is sealed[:len-tagSize], tag is sealed[len-tagSize:]
-	tagSize := aead.Overhead() // 16
-	ct := make([]byte, len(sealed)-tagSize)
-	copy(ct, sealed[:len(sealed)-tagSize])
-	t := make([]byte, tagSize)
-	copy(t, sealed[len(sealed)-tagSize:])
+	sealed := c.aead.Seal(data[:0], iv, data, nil)
+	copy(data, sealed[:len(data)]) // no-op unless Seal had to grow
+	copy(tag, sealed[len(data):])
+	return nil
+}
 
-	return iv, ct, t, nil
+// Encrypt encrypts plaintext with AES-256-GCM, returning iv (12 bytes),
+// ciphertext, and tag (16 bytes) separately (as GOSTT-KBD expects them in
+// separate protobuf fields).
+func Encrypt(key, plaintext []byte) (iv, ciphertext, tag []byte, err error) {
+	c, err := NewCipher(key)
+	if err != nil {
+		return nil, nil, nil, err
+	}
+	iv = make([]byte, c.aead.NonceSize())
+	tag = make([]byte, c.aead.Overhead())
+	ciphertext = make([]byte, len(plaintext), len(plaintext)+len(tag))
+	copy(ciphertext, plaintext)
+	if err := c.SealInPlace(iv, tag, ciphertext); err != nil {
+		return nil, nil, nil, err
+	}
+	return iv, ciphertext, tag, nil
 }
 
 // Decrypt decrypts ciphertext with AES-256-GCM using separate iv, ciphertext, and tag.
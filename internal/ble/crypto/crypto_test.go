@@ -94,6 +94,49 @@ func TestEncryptDecryptRoundTrip(t *testing.T) {
 	}
 }
 
+func TestCipherSealInPlace(t *testing.T) {
+	key := make([]byte, 32)
+	key[0] = 0x01
+	c, err := NewCipher(key)
+	if err != nil {
+		t.Fatalf("NewCipher() error = %v", err)
+	}
+
+	plaintext := []byte("hello from gostt-writer")
+	buf := make([]byte, len(plaintext), len(plaintext)+16)
+	copy(buf, plaintext)
+	iv, tag := make([]byte, 12), make([]byte, 16)
+	if err := c.SealInPlace(iv, tag, buf); err != nil {
+		t.Fatalf("SealInPlace() error = %v", err)
+	}
+	decrypted, err := Decrypt(key, iv, buf, tag)
+	if err != nil {
+		t.Fatalf("Decrypt() error = %v", err)
+	}
+	if !bytes.Equal(decrypted, plaintext) {
+		t.Errorf("Decrypt() = %q, want %q", decrypted, plaintext)
+	}
+
+	// Without spare capacity Seal grows, and the result is still in place
+	short := append([]byte(nil), plaintext...)[:len(plaintext):len(plaintext)]
+	if err := c.SealInPlace(iv, tag, short); err != nil {
+		t.Fatalf("SealInPlace() error = %v", err)
+	}
+	if decrypted, err := Decrypt(key, iv, short, tag); err != nil || !bytes.Equal(decrypted, plaintext) {
+		t.Errorf("Decrypt() without spare capacity = %q, %v", decrypted, err)
+	}
+
+	if err := c.SealInPlace(iv[:8], tag, buf); err == nil {
+		t.Error("SealInPlace() with an 8-byte IV: expected error")
+	}
+	allocs := testing.AllocsPerRun(100, func() {
+		_ = c.SealInPlace(iv, tag, buf)
+	})
+	if allocs != 0 {
+		t.Errorf("SealInPlace() = %.1f allocs, want 0", allocs)
+	}
+}
+
 func TestDecryptWrongKey(t *testing.T) {
 	key := make([]byte, 32)
 	plaintext := []byte("secret")
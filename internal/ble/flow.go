@@ -0,0 +1,100 @@
+package ble
+
+import (
+	"log/slog"
+	"sync"
+	"time"
+
+	"github.com/chaz8081/gostt-writer/internal/ble/protocol"
+)
+
+// creditWindow paces data writes by the receive window the ESP32 reports in
+// ResponseTypeCredits notifications. Writes are sent without response, so a
+// write the device has no free packet slot for is silently dropped; the
+// window keeps at most as many writes in flight as the device last reported
+// free slots. Safe for concurrent use.
+type creditWindow struct {
+	mu       sync.Mutex
+	known    bool   // a report has arrived on this connection
+	sent     uint32 // writes sent this connection; wraps like the device counter
+	received uint32 // writes the device had accepted at the last report
+	free     int    // slots free at the last report
+	changed  chan struct{}
+}
+
+func newCreditWindow() *creditWindow {
+	return &creditWindow{changed: make(chan struct{})}
+}
+
+// reset forgets the window on a new connection. The device's counters
+// restart too, and until it reports, acquire leaves pacing to the caller.
+func (w *creditWindow) reset() {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	w.known = false
+	w.sent = 0
+	w.received = 0
+	w.free = 0
+	w.signal()
+}
+
+// update records a credits report.
+func (w *creditWindow) update(cr protocol.Credits) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	// Reports arrive in order, but never step the counter backwards
+	if w.known && int32(cr.Received-w.received) < 0 {
+		return
+	}
+	w.known = true
+	w.received = cr.Received
+	w.free = cr.Free
+	w.signal()
+}
+
+// signal wakes acquire calls waiting for a change (caller must hold mu).
+func (w *creditWindow) signal() {
+	close(w.changed)
+	w.changed = make(chan struct{})
+}
+
+// inFlight returns the writes sent that the last report has not accounted
+// for (caller must hold mu).
+func (w *creditWindow) inFlight() int {
+	return int(int32(w.sent - w.received))
+}
+
+// acquire reserves a slot for one write, waiting while the window is full.
+// It returns false, without reserving, when the device has not reported a
+// window: it predates credits, and the caller should fall back to a fixed
+// delay. After waiting timeout for a report, it warns and reserves anyway,
+// so a lost notification cannot stall sending.
+func (w *creditWindow) acquire(timeout time.Duration) bool {
+	var deadline <-chan time.Time
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	for w.known && w.inFlight() >= w.free {
+		if deadline == nil {
+			t := time.NewTimer(timeout)
+			defer t.Stop()
+			deadline = t.C
+		}
+		changed := w.changed
+		w.mu.Unlock()
+		select {
+		case <-changed:
+			w.mu.Lock()
+		case <-deadline:
+			w.mu.Lock()
+			slog.Warn("[BLE] no credits from device, sending anyway",
+				"in_flight", w.inFlight(), "free", w.free, "timeout", timeout)
+			w.sent++
+			return true
+		}
+	}
+	if !w.known {
+		return false
+	}
+	w.sent++
+	return true
+}
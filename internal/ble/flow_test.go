@@ -0,0 +1,153 @@
+package ble
+
+import (
+	"strings"
+	"testing"
+	"time"
+
+	"github.com/chaz8081/gostt-writer/internal/ble/protocol"
+)
+
+// creditsNotification returns the ResponsePacket the firmware sends when
+// received writes have been accepted and free packet slots remain.
+func creditsNotification(received uint32, free byte) []byte {
+	return []byte{0x08, 0x03, 0x10, 0x01, 0x1a, 0x06,
+		byte(received), byte(received >> 8), byte(received >> 16), byte(received >> 24), free, 8}
+}
+
+// slowChunkOpts returns options whose fixed delay would stand out if used.
+func slowChunkOpts() ClientOptions {
+	opts := DefaultClientOptions()
+	opts.InterChunkDelay = time.Second
+	return opts
+}
+
+func TestClientPipelinesWithinCredits(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), slowChunkOpts())
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	conn.respChar.SimulateNotification(creditsNotification(0, 8))
+
+	longText := strings.Repeat("word ", 200) // 1000 bytes
+	chunks := len(protocol.ChunkText(longText, protocol.MaxPayloadBytes))
+	start := time.Now()
+	if err := client.Send(longText); err != nil {
+		t.Fatalf("Send() error = %v", err)
+	}
+	if elapsed := time.Since(start); elapsed >= client.opts.InterChunkDelay {
+		t.Errorf("Send() of %d chunks took %v, want no fixed delay within the window", chunks, elapsed)
+	}
+	if got := conn.txChar.writeCount(); got != chunks {
+		t.Errorf("got %d writes, want %d", got, chunks)
+	}
+}
+
+func TestClientWaitsForCredits(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), slowChunkOpts())
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	conn.respChar.SimulateNotification(creditsNotification(0, 2))
+
+	longText := strings.Repeat("word ", 200)
+	chunks := len(protocol.ChunkText(longText, protocol.MaxPayloadBytes))
+	if chunks < 4 {
+		t.Fatalf("test text makes %d chunks, need at least 4", chunks)
+	}
+	done := make(chan error, 1)
+	go func() { done <- client.Send(longText) }()
+
+	// Two writes fill the window; the rest wait for credit
+	time.Sleep(50 * time.Millisecond)
+	if got := conn.txChar.writeCount(); got != 2 {
+		t.Fatalf("%d writes before any credit returned, want 2", got)
+	}
+
+	// The device accepted both and typed one: one more slot
+	conn.respChar.SimulateNotification(creditsNotification(2, 1))
+	time.Sleep(50 * time.Millisecond)
+	if got := conn.txChar.writeCount(); got != 3 {
+		t.Fatalf("%d writes after one credit, want 3", got)
+	}
+
+	conn.respChar.SimulateNotification(creditsNotification(3, 8))
+	select {
+	case err := <-done:
+		if err != nil {
+			t.Fatalf("Send() error = %v", err)
+		}
+	case <-time.After(5 * time.Second):
+		t.Fatal("Send() still blocked after the window opened")
+	}
+	if got := conn.txChar.writeCount(); got != chunks {
+		t.Errorf("got %d writes, want %d", got, chunks)
+	}
+}
+
+func TestClientSendsAnywayAfterCreditTimeout(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	opts := slowChunkOpts()
+	opts.CreditTimeout = 20 * time.Millisecond
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), opts)
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	conn.respChar.SimulateNotification(creditsNotification(0, 0))
+
+	if err := client.Send("hello"); err != nil {
+		t.Fatalf("Send() error = %v", err)
+	}
+	if got := conn.txChar.writeCount(); got != 1 {
+		t.Errorf("got %d writes, want 1", got)
+	}
+}
+
+func TestClientFixedDelayWithoutCredits(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	opts := DefaultClientOptions()
+	opts.InterChunkDelay = 30 * time.Millisecond
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), opts)
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+
+	// Firmware that predates credits never reports a window
+	longText := strings.Repeat("word ", 100) // 500 bytes
+	chunks := len(protocol.ChunkText(longText, protocol.MaxPayloadBytes))
+	start := time.Now()
+	if err := client.Send(longText); err != nil {
+		t.Fatalf("Send() error = %v", err)
+	}
+	if want := time.Duration(chunks-1) * opts.InterChunkDelay; time.Since(start) < want {
+		t.Errorf("Send() of %d chunks took %v, want at least %v of fixed delay", chunks, time.Since(start), want)
+	}
+}
+
+func TestCreditWindowResetOnReconnect(t *testing.T) {
+	adapter := newMockAdapter(nil)
+	client := mustNewClient(t, adapter, "AA:BB:CC:DD:EE:FF", makeTestKey(), zeroDelayOpts())
+	conn := adapter.latestConnection()
+	if err := client.setConnected(conn); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	conn.respChar.SimulateNotification(creditsNotification(0, 1))
+	if !client.credits.acquire(time.Second) {
+		t.Fatal("acquire() = false after a credits report")
+	}
+
+	// The new connection's counters start over; until it reports, the
+	// window is unknown and does not block
+	if err := client.setConnected(adapter.latestConnection()); err != nil {
+		t.Fatalf("setConnected() error = %v", err)
+	}
+	if client.credits.acquire(time.Second) {
+		t.Error("acquire() = true before the new connection reported credits")
+	}
+}
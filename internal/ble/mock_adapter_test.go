@@ -7,11 +7,13 @@ import (
 	"testing"
 )
 
-// mockCharacteristic records writes and allows subscribing.
+// mockCharacteristic records writes, allows subscribing and returns value
+// on reads.
 type mockCharacteristic struct {
 	mu       sync.Mutex
 	writes   [][]byte
 	callback func([]byte)
+	value    []byte
 }
 
 func (c *mockCharacteristic) Write(data []byte) error {
@@ -23,6 +25,13 @@ func (c *mockCharacteristic) Write(data []byte) error {
 	return nil
 }
 
+// writeCount returns the number of writes so far.
+func (c *mockCharacteristic) writeCount() int {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return len(c.writes)
+}
+
 func (c *mockCharacteristic) Subscribe(cb func([]byte)) error {
 	c.mu.Lock()
 	defer c.mu.Unlock()
@@ -30,6 +39,12 @@ func (c *mockCharacteristic) Subscribe(cb func([]byte)) error {
 	return nil
 }
 
+func (c *mockCharacteristic) Read() ([]byte, error) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return append([]byte(nil), c.value...), nil
+}
+
 // SimulateNotification sends a notification to the subscriber.
 func (c *mockCharacteristic) SimulateNotification(data []byte) {
 	c.mu.Lock()
@@ -45,14 +60,16 @@ type mockConnection struct {
 	mu           sync.Mutex
 	txChar       *mockCharacteristic
 	respChar     *mockCharacteristic
+	statsChar    *mockCharacteristic
 	disconnectCb func()
 	disconnected bool
 }
 
 func newMockConnection() *mockConnection {
 	return &mockConnection{
-		txChar:   &mockCharacteristic{},
-		respChar: &mockCharacteristic{},
+		txChar:    &mockCharacteristic{},
+		respChar:  &mockCharacteristic{},
+		statsChar: &mockCharacteristic{},
 	}
 }
 
@@ -62,6 +79,8 @@ func (c *mockConnection) DiscoverCharacteristic(serviceUUID, charUUID string) (C
 		return c.txChar, nil
 	case ResponseCharUUID:
 		return c.respChar, nil
+	case StatsCharUUID:
+		return c.statsChar, nil
 	default:
 		return nil, fmt.Errorf("mock: unknown characteristic UUID %q", charUUID)
 	}
@@ -159,6 +159,10 @@ func (c *mockPairingCharacteristic) Subscribe(cb func([]byte)) error {
 	return c.inner.Subscribe(cb)
 }
 
+func (c *mockPairingCharacteristic) Read() ([]byte, error) {
+	return c.inner.Read()
+}
+
 // simulatePeerKeyExchange generates the ESP32's ECDH keypair and sends
 // back a ResponsePacket with the compressed public key.
 func (c *mockPairingCharacteristic) simulatePeerKeyExchange(_ []byte) {
@@ -1,12 +1,63 @@
 // internal/ble/protocol/chunk.go
 package protocol
 
-import "unicode/utf8"
+import (
+	"encoding/binary"
+	"strings"
+	"unicode/utf8"
+)
 
 // MaxPayloadBytes is the usable text bytes per BLE packet after
-// protobuf framing + AES-GCM overhead (253 - 40 bytes overhead).
+// protobuf framing + AES-GCM overhead (253 - 40 bytes overhead). Used until
+// the device reports its negotiated MTU; see MaxPayloadForMTU.
 const MaxPayloadBytes = 213
 
+// MaxWriteBytes is the largest TX write the firmware accepts
+// (GOSTT_PKT_MAX_LEN), whatever the MTU.
+const MaxWriteBytes = 512
+
+// attWriteHeader is the ATT opcode and handle in front of each write.
+const attWriteHeader = 3
+
+// MaxPayloadForMTU returns the most text bytes per chunk whose DataPacket
+// fits one ATT write at the given MTU, or 0 if not even one byte fits.
+func MaxPayloadForMTU(mtu int) int {
+	limit := mtu - attWriteHeader
+	if limit > MaxWriteBytes {
+		limit = MaxWriteBytes
+	}
+	for n := limit; n > 0; n-- {
+		if dataPacketLen(n) <= limit {
+			return n
+		}
+	}
+	return 0
+}
+
+// FrameBudget returns the EncryptedData size of a single-record frame
+// carrying n bytes of plain text. Any frame up to that size fits the same
+// write.
+func FrameBudget(n int) int {
+	keyboard := 1 + varintLen(n) + n + 1 + varintLen(n)
+	return 1 + varintLen(keyboard) + keyboard
+}
+
+// dataPacketLen returns the encoded size of a DataPacket carrying n bytes of
+// text, with the largest packet_num. AES-GCM ciphertext is as long as the
+// plaintext.
+func dataPacketLen(n int) int {
+	encrypted := FrameBudget(n)
+	return 2 + 12 + // iv
+		2 + 16 + // tag
+		1 + varintLen(encrypted) + encrypted +
+		1 + binary.MaxVarintLen32 // packet_num
+}
+
+func varintLen(n int) int {
+	var tmp [binary.MaxVarintLen64]byte
+	return binary.PutUvarint(tmp[:], uint64(n))
+}
+
 // ChunkText splits text into chunks that each fit within maxBytes.
 // It prefers splitting at word boundaries (spaces) and never splits
 // in the middle of a UTF-8 character. Returns nil for empty text.
@@ -23,47 +74,149 @@ func ChunkText(text string, maxBytes int) []string {
 
 	var chunks []string
 	for len(text) > 0 {
-		if len(text) <= maxBytes {
-			chunks = append(chunks, text)
-			break
-		}
+		n := firstChunk(text, maxBytes)
+		chunks = append(chunks, text[:n])
+		text = text[n:]
+	}
+	return chunks
+}
 
-		// Find the split point: start at maxBytes and walk back to find
-		// a space. If no space found, split at the last valid UTF-8 boundary.
-		split := maxBytes
+// ChunkPacked splits text into chunks whose DictEncode form each fit within
+// maxPacked bytes, and that are each at most maxText bytes long, with the
+// same boundaries as ChunkText. Returns nil for empty text.
+func ChunkPacked(text string, maxPacked, maxText int) []string {
+	if maxPacked <= 0 || maxText <= 0 || len(text) == 0 {
+		return nil
+	}
 
-		// Ensure we don't split in the middle of a UTF-8 character.
-		// Walk back until we're at the start of a rune.
-		for split > 0 && !utf8.RuneStart(text[split]) {
-			split--
+	var chunks []string
+	var packed []byte
+	for len(text) > 0 {
+		// Packing never grows text, so a chunk of maxPacked text bytes always
+		// fits; search for the longest that still does.
+		lo, hi := min(maxPacked, maxText), min(len(text), maxText)
+		best := firstChunk(text, lo)
+		for lo < hi {
+			mid := (lo + hi + 1) / 2
+			n := firstChunk(text, mid)
+			packed = AppendDictEncode(packed[:0], text[:n])
+			if len(packed) <= maxPacked {
+				lo, best = mid, n
+			} else {
+				hi = mid - 1
+			}
 		}
+		chunks = append(chunks, text[:best])
+		text = text[best:]
+	}
+	return chunks
+}
 
-		// If no valid split point within maxBytes (e.g. a rune wider than
-		// maxBytes), force forward progress by taking one complete rune.
-		if split == 0 {
-			_, size := utf8.DecodeRuneInString(text)
-			split = size // take one rune even if it exceeds maxBytes
-		}
+// Edit is one streaming update: delete Backspaces characters before the
+// cursor, then type Text. Plain text is an Edit without Backspaces.
+type Edit struct {
+	Backspaces int
+	Text       string
+}
+
+// editOverhead is the most a Backspaces field adds to a record.
+const editOverhead = 1 + binary.MaxVarintLen32
 
-		// Try to find a word boundary (space) by walking back from split.
-		bestSpace := -1
-		for i := split; i > 0; i-- {
-			if text[i-1] == ' ' {
-				bestSpace = i
-				break
+// Frames splits edits, applied in order one after another, into
+// EncryptedData frames (see MarshalFrame) for a link carrying textBytes of plain text per write
+// (see MaxPayloadForMTU), using the framing features the device reports.
+// Without features each frame is one chunk of ChunkText, which marshals as
+// MarshalEncryptedData.
+// With FeatureDict text is packed, so more of it fits per frame; with
+// FeatureBatch short texts share a frame, up to MaxFrameText per frame. An
+// edit's Backspaces go with its first chunk, whose text is shortened to fit
+// them; they are sent whatever the features, see MarshalFrame.
+func Frames(edits []Edit, textBytes int, features Features) []Frame {
+	budget := FrameBudget(textBytes)
+	dict := features&FeatureDict != 0
+	// A lone packed record is the packed text behind its tag and length
+	packedBytes := budget - 1 - varintLen(budget)
+
+	var frames []Frame
+	var batch []Record
+	var batchLen, batchText int
+	flush := func() {
+		if len(batch) > 0 {
+			frames = append(frames, Frame{Records: batch, Packed: dict})
+			batch, batchLen, batchText = nil, 0, 0
+		}
+	}
+	for _, edit := range edits {
+		text, reserve := edit.Text, 0
+		if edit.Backspaces > 0 {
+			reserve = editOverhead
+		}
+		var chunks []string
+		if dict && !strings.ContainsRune(text, 0) {
+			chunks = ChunkPacked(text, packedBytes-reserve, MaxFrameText)
+		} else {
+			chunks = ChunkText(text, textBytes-reserve)
+		}
+		if len(chunks) == 0 && edit.Backspaces > 0 {
+			chunks = []string{""} // deletion only
+		}
+		for i, chunk := range chunks {
+			rec := Record{Text: chunk}
+			if i == 0 {
+				rec.Backspaces = edit.Backspaces
+			}
+			if features&FeatureBatch == 0 {
+				frames = append(frames, Frame{Records: []Record{rec}, Packed: dict})
+				continue
+			}
+			// Every chunk fits a frame alone; start a new frame when it
+			// does not fit this one. batchLen is the batched encoding, with
+			// a tag and length per record.
+			n := recordLen(rec, dict)
+			n += 1 + varintLen(n)
+			if len(batch) > 0 && (batchText+len(chunk) > MaxFrameText || batchLen+n > budget) {
+				flush()
 			}
+			batch = append(batch, rec)
+			batchLen += n
+			batchText += len(chunk)
 		}
+	}
+	flush()
+	return frames
+}
+
+// firstChunk returns the length of the first ChunkText chunk of text.
+func firstChunk(text string, maxBytes int) int {
+	if len(text) <= maxBytes {
+		return len(text)
+	}
+
+	// Find the split point: start at maxBytes and walk back to find
+	// a space. If no space found, split at the last valid UTF-8 boundary.
+	split := maxBytes
 
-		if bestSpace > 0 {
+	// Ensure we don't split in the middle of a UTF-8 character.
+	// Walk back until we're at the start of a rune.
+	for split > 0 && !utf8.RuneStart(text[split]) {
+		split--
+	}
+
+	// If no valid split point within maxBytes (e.g. a rune wider than
+	// maxBytes), force forward progress by taking one complete rune.
+	if split == 0 {
+		_, size := utf8.DecodeRuneInString(text)
+		split = size // take one rune even if it exceeds maxBytes
+	}
+
+	// Try to find a word boundary (space) by walking back from split.
+	for i := split; i > 0; i-- {
+		if text[i-1] == ' ' {
 			// Split at word boundary — include the space in the first chunk
 			// so reassembly is exact.
-			chunks = append(chunks, text[:bestSpace])
-			text = text[bestSpace:]
-		} else {
-			// No space found — forced split at UTF-8 boundary
-			chunks = append(chunks, text[:split])
-			text = text[split:]
+			return i
 		}
 	}
-	return chunks
+	// No space found — forced split at UTF-8 boundary
+	return split
 }
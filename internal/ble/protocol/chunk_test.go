@@ -2,6 +2,8 @@
 package protocol
 
 import (
+	"bytes"
+	"math"
 	"strings"
 	"testing"
 )
@@ -117,3 +119,229 @@ func TestChunkTextMaxSmallerThanRune(t *testing.T) {
 		t.Errorf("chunk[0] = %q, want %q", chunks[0], text)
 	}
 }
+
+func TestMaxPayloadForMTU(t *testing.T) {
+	iv, tag := make([]byte, 12), make([]byte, 16)
+	encodedLen := func(n int) int {
+		text := strings.Repeat("a", n)
+		// AES-GCM ciphertext is as long as the plaintext
+		encrypted := MarshalEncryptedData(MarshalKeyboardPacket(text))
+		pkt, err := MarshalDataPacket(iv, tag, encrypted, math.MaxUint32)
+		if err != nil {
+			t.Fatalf("MarshalDataPacket() error = %v", err)
+		}
+		return len(pkt)
+	}
+
+	for _, mtu := range []int{80, 185, 247, 256, 517, 1024} {
+		n := MaxPayloadForMTU(mtu)
+		limit := min(mtu-3, MaxWriteBytes)
+		if n <= 0 {
+			t.Errorf("MaxPayloadForMTU(%d) = %d, want > 0", mtu, n)
+			continue
+		}
+		if got := encodedLen(n); got > limit {
+			t.Errorf("MTU %d: %d-byte chunk encodes to %d bytes, over the %d-byte write limit", mtu, n, got, limit)
+		}
+		if got := encodedLen(n + 1); got <= limit {
+			t.Errorf("MTU %d: %d-byte chunk still fits (%d bytes), MaxPayloadForMTU is not the largest", mtu, n+1, got)
+		}
+	}
+
+	if n := MaxPayloadForMTU(23); n != 0 {
+		t.Errorf("MaxPayloadForMTU(23) = %d, want 0 (default MTU fits no DataPacket)", n)
+	}
+}
+
+// englishText is dictated-style text the dictionary packs well.
+var englishText = strings.Repeat("so I think that we should go over the plan with them and see what they want to do about it, ", 12)
+
+func TestChunkPacked(t *testing.T) {
+	const maxPacked, maxText = 100, 1024
+	chunks := ChunkPacked(englishText, maxPacked, maxText)
+	if strings.Join(chunks, "") != englishText {
+		t.Fatal("chunks do not reassemble to the text")
+	}
+	for i, c := range chunks {
+		if n := len(DictEncode(c)); n > maxPacked {
+			t.Errorf("chunk %d packs to %d bytes, over %d", i, n, maxPacked)
+		}
+		if len(c) > maxText {
+			t.Errorf("chunk %d is %d bytes, over %d", i, len(c), maxText)
+		}
+	}
+	if plain := len(ChunkText(englishText, maxPacked)); len(chunks) >= plain {
+		t.Errorf("ChunkPacked() = %d chunks, want fewer than ChunkText's %d", len(chunks), plain)
+	}
+
+	// maxText still bounds chunks that would pack smaller
+	for i, c := range ChunkPacked(englishText, maxPacked, 120) {
+		if len(c) > 120 {
+			t.Errorf("chunk %d is %d bytes, over maxText 120", i, len(c))
+		}
+	}
+	if ChunkPacked("", maxPacked, maxText) != nil {
+		t.Error("ChunkPacked(\"\") != nil")
+	}
+}
+
+// frameText returns the text a frame types, joining its records.
+func frameText(t *testing.T, frame []byte) string {
+	t.Helper()
+	var sb strings.Builder
+	for len(frame) > 0 {
+		tag, n, err := readVarint(frame)
+		if err != nil {
+			t.Fatalf("frame tag: %v", err)
+		}
+		frame = frame[n:]
+		length, n, err := readVarint(frame)
+		if err != nil || tag&0x07 != 2 || uint64(len(frame)-n) < length {
+			t.Fatalf("frame field %d: bad length", tag>>3)
+		}
+		field := frame[n : n+int(length)]
+		frame = frame[n+int(length):]
+		switch tag >> 3 {
+		case 1: // KeyboardPacket: field 1 is the message
+			msgLen, n, _ := readVarint(field[1:])
+			sb.Write(field[1+n : 1+n+int(msgLen)])
+		case 4:
+			text, err := DictDecode(field)
+			if err != nil {
+				t.Fatalf("packed text: %v", err)
+			}
+			sb.WriteString(text)
+		case 5:
+			sb.WriteString(frameText(t, field))
+		}
+	}
+	return sb.String()
+}
+
+func TestFrames(t *testing.T) {
+	texts := []string{englishText, "ok", "thanks, that is all"}
+	want := strings.Join(texts, "")
+	budget := FrameBudget(MaxPayloadBytes)
+
+	legacy := Frames(textEdits(texts), MaxPayloadBytes, 0)
+	var n int
+	for _, text := range texts {
+		for _, chunk := range ChunkText(text, MaxPayloadBytes) {
+			if !bytes.Equal(legacy[n].Append(nil), MarshalEncryptedData(MarshalKeyboardPacket(chunk))) {
+				t.Fatalf("legacy frame %d differs from MarshalEncryptedData", n)
+			}
+			n++
+		}
+	}
+	if n != len(legacy) {
+		t.Fatalf("Frames() without features = %d frames, want %d", len(legacy), n)
+	}
+
+	for _, features := range []Features{FeatureBatch, FeatureDict, FeatureBatch | FeatureDict} {
+		frames := Frames(textEdits(texts), MaxPayloadBytes, features)
+		var sb strings.Builder
+		for i, frame := range frames {
+			f := frame.Append(nil)
+			if len(f) != frame.Len() {
+				t.Errorf("features %d: frame %d Len() = %d, encodes to %d bytes", features, i, frame.Len(), len(f))
+			}
+			if len(f) > budget {
+				t.Errorf("features %d: frame %d is %d bytes, over the %d-byte budget", features, i, len(f), budget)
+			}
+			text := frameText(t, f)
+			if len(text) > MaxFrameText {
+				t.Errorf("features %d: frame %d carries %d text bytes, over %d", features, i, len(text), MaxFrameText)
+			}
+			sb.WriteString(text)
+		}
+		if sb.String() != want {
+			t.Errorf("features %d: frames do not reassemble to the texts", features)
+		}
+		if len(frames) >= len(legacy) {
+			t.Errorf("features %d: %d frames, want fewer than the legacy %d", features, len(frames), len(legacy))
+		}
+	}
+}
+
+// textEdits returns texts as plain-text edits.
+func textEdits(texts []string) []Edit {
+	edits := make([]Edit, len(texts))
+	for i, text := range texts {
+		edits[i] = Edit{Text: text}
+	}
+	return edits
+}
+
+// typeFrame returns screen after the device applies frame: each record
+// deletes its backspaces in runes, then types its text.
+func typeFrame(t *testing.T, screen string, frame []byte) string {
+	t.Helper()
+	var text strings.Builder
+	var backspaces int
+	for len(frame) > 0 {
+		tag, n, err := readVarint(frame)
+		if err != nil {
+			t.Fatalf("frame tag: %v", err)
+		}
+		frame = frame[n:]
+		val, n, err := readVarint(frame)
+		if err != nil {
+			t.Fatalf("frame field %d: %v", tag>>3, err)
+		}
+		frame = frame[n:]
+		if tag&0x07 == 0 {
+			if tag>>3 == 6 {
+				backspaces = int(val)
+			}
+			continue
+		}
+		field := frame[:val]
+		frame = frame[val:]
+		switch tag >> 3 {
+		case 1: // KeyboardPacket: field 1 is the message
+			msgLen, n, _ := readVarint(field[1:])
+			text.Write(field[1+n : 1+n+int(msgLen)])
+		case 4:
+			packed, err := DictDecode(field)
+			if err != nil {
+				t.Fatalf("packed text: %v", err)
+			}
+			text.WriteString(packed)
+		case 5:
+			screen = typeFrame(t, screen, field)
+		}
+	}
+	runes := []rune(screen)
+	return string(runes[:max(len(runes)-backspaces, 0)]) + text.String()
+}
+
+func TestFramesEdits(t *testing.T) {
+	edits := []Edit{
+		{Text: "hello wrold"},
+		{Backspaces: 4, Text: "orld, "},
+		{Backspaces: 2},
+		{Text: " " + englishText},
+		{Backspaces: 9, Text: "the end."},
+	}
+	var want string
+	for _, e := range edits {
+		runes := []rune(want)
+		want = string(runes[:len(runes)-e.Backspaces]) + e.Text
+	}
+	budget := FrameBudget(MaxPayloadBytes)
+
+	for _, features := range []Features{0, FeatureBatch, FeatureDict, FeatureBatch | FeatureDict} {
+		features |= FeatureEdit
+		var screen string
+		for i, frame := range Frames(edits, MaxPayloadBytes, features) {
+			f := frame.Append(nil)
+			if len(f) > budget {
+				t.Errorf("features %d: frame %d is %d bytes, over the %d-byte budget", features, i, len(f), budget)
+			}
+			screen = typeFrame(t, screen, f)
+		}
+		if screen != want {
+			t.Errorf("features %d: edits type %q, want %q", features, screen, want)
+		}
+	}
+}
@@ -0,0 +1,120 @@
+package protocol
+
+import (
+	"errors"
+	"fmt"
+	"strings"
+)
+
+// Packed text (EncryptedData field 4) is UTF-8 text with some " word" runs
+// replaced by a two-byte code: dictEscape followed by the word's index in
+// dictWords. Text never contains NUL, so every other byte is literal.
+const dictEscape = 0x00
+
+// dictWords are common English words, most frequent first. A code expands to
+// a space and the word. Must match firmware/esp32/main/textdict.c; the client
+// only packs text for firmware advertising FeatureDict, so changing the table
+// needs a new feature bit.
+var dictWords = [...]string{
+	"the", "of", "and", "to", "in", "is", "you", "that", "it", "he", "was",
+	"for", "on", "are", "as", "with", "his", "they", "at", "be", "this",
+	"have", "from", "or", "one", "had", "by", "word", "but", "not", "what",
+	"all", "were", "we", "when", "your", "can", "said", "there", "use",
+	"an", "each", "which", "she", "do", "how", "their", "if", "will", "up",
+	"other", "about", "out", "many", "then", "them", "these", "so", "some",
+	"her", "would", "make", "like", "him", "into", "time", "has", "look",
+	"two", "more", "write", "go", "see", "number", "no", "way", "could",
+	"people", "my", "than", "first", "water", "been", "call", "who", "its",
+	"now", "find", "long", "down", "day", "did", "get", "come", "made",
+	"may", "part", "just", "know", "think", "should", "because", "also",
+	"after", "well", "want", "need", "here", "very", "through", "where",
+	"work", "new", "good", "over", "only", "year", "back", "any", "most",
+	"thing", "those", "even", "give", "take", "our", "really", "something",
+}
+
+// dictIndex maps each word to its code.
+var dictIndex = func() map[string]byte {
+	m := make(map[string]byte, len(dictWords))
+	for i, w := range dictWords {
+		m[w] = byte(i)
+	}
+	return m
+}()
+
+// DictEncode packs text with the static word dictionary. Only whole
+// lowercase words after a space are coded; everything else is copied. The
+// result is never longer than text. Text must not contain NUL.
+func DictEncode(text string) []byte {
+	return AppendDictEncode(make([]byte, 0, len(text)), text)
+}
+
+// AppendDictEncode appends the packed form of text to buf.
+func AppendDictEncode(buf []byte, text string) []byte {
+	for i := 0; i < len(text); {
+		if code, end, ok := dictWordAt(text, i); ok {
+			buf = append(buf, dictEscape, code)
+			i = end
+			continue
+		}
+		buf = append(buf, text[i])
+		i++
+	}
+	return buf
+}
+
+// dictEncodedLen returns len(DictEncode(text)) without encoding it.
+func dictEncodedLen(text string) int {
+	n := 0
+	for i := 0; i < len(text); {
+		if _, end, ok := dictWordAt(text, i); ok {
+			n += 2
+			i = end
+			continue
+		}
+		n++
+		i++
+	}
+	return n
+}
+
+// dictWordAt reports whether a coded " word" starts at text[i], returning its
+// code and the index after it.
+func dictWordAt(text string, i int) (code byte, end int, ok bool) {
+	if text[i] != ' ' {
+		return 0, 0, false
+	}
+	end = i + 1
+	for end < len(text) && text[end] >= 'a' && text[end] <= 'z' {
+		end++
+	}
+	if end == i+1 || end < len(text) && isLetter(text[end]) {
+		return 0, 0, false
+	}
+	code, ok = dictIndex[text[i+1:end]]
+	return code, end, ok
+}
+
+func isLetter(c byte) bool {
+	return c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z'
+}
+
+// DictDecode expands packed text.
+func DictDecode(packed []byte) (string, error) {
+	var sb strings.Builder
+	for i := 0; i < len(packed); i++ {
+		if packed[i] != dictEscape {
+			sb.WriteByte(packed[i])
+			continue
+		}
+		i++
+		if i >= len(packed) {
+			return "", errors.New("protocol: truncated dictionary code")
+		}
+		if int(packed[i]) >= len(dictWords) {
+			return "", fmt.Errorf("protocol: unknown dictionary code %d", packed[i])
+		}
+		sb.WriteByte(' ')
+		sb.WriteString(dictWords[packed[i]])
+	}
+	return sb.String(), nil
+}
@@ -0,0 +1,71 @@
+package protocol
+
+import (
+	"bytes"
+	"strings"
+	"testing"
+)
+
+func TestDictEncodeGolden(t *testing.T) {
+	// Golden bytes shared with firmware test_proto.c
+	got := DictEncode("hello the world and you")
+	want := []byte{'h', 'e', 'l', 'l', 'o', 0x00, 0x00,
+		' ', 'w', 'o', 'r', 'l', 'd', 0x00, 0x02, 0x00, 0x06}
+	if !bytes.Equal(got, want) {
+		t.Errorf("DictEncode() = %x, want %x", got, want)
+	}
+}
+
+func TestDictRoundTrip(t *testing.T) {
+	tests := []string{
+		"",
+		"the",                            // no leading space: literal
+		" the",                           // coded
+		" The other",                     // capitalised: literal
+		" them there",                    // "them" is a word, not "the" + "m"
+		" thesis",                        // prefix of no word
+		" it's what you want, isn't it?", // punctuation ends a word
+		"café and naïve — fine",          // UTF-8 passes through
+		strings.Repeat(" and the", 100),
+	}
+	for _, text := range tests {
+		packed := DictEncode(text)
+		if n := dictEncodedLen(text); n != len(packed) {
+			t.Errorf("dictEncodedLen(%q) = %d, want %d", text, n, len(packed))
+		}
+		if len(packed) > len(text) {
+			t.Errorf("DictEncode(%q) is %d bytes, longer than the text", text, len(packed))
+		}
+		got, err := DictDecode(packed)
+		if err != nil {
+			t.Errorf("DictDecode(DictEncode(%q)) error = %v", text, err)
+			continue
+		}
+		if got != text {
+			t.Errorf("DictDecode(DictEncode(%q)) = %q", text, got)
+		}
+	}
+}
+
+func TestDictDecodeInvalid(t *testing.T) {
+	for _, packed := range [][]byte{{'a', 0x00}, {0x00, byte(len(dictWords))}} {
+		if _, err := DictDecode(packed); err == nil {
+			t.Errorf("DictDecode(%x) expected error", packed)
+		}
+	}
+}
+
+func TestDictWords(t *testing.T) {
+	// The firmware table has exactly this many words
+	if len(dictWords) != 128 {
+		t.Errorf("%d dictionary words, want 128 (GOSTT_DICT_WORDS)", len(dictWords))
+	}
+	if len(dictIndex) != len(dictWords) {
+		t.Error("dictionary has duplicate words")
+	}
+	for _, w := range dictWords {
+		if strings.Trim(w, "abcdefghijklmnopqrstuvwxyz") != "" || len(w) < 2 {
+			t.Errorf("dictionary word %q: want two or more lowercase letters", w)
+		}
+	}
+}
@@ -5,6 +5,8 @@ import (
 	"encoding/binary"
 	"errors"
 	"fmt"
+	"slices"
+	"strings"
 )
 
 // ResponseType is the type field in a ResponsePacket.
@@ -13,6 +15,8 @@ type ResponseType uint32
 const (
 	ResponseTypeKeepalive  ResponseType = 0
 	ResponseTypePeerStatus ResponseType = 1
+	ResponseTypeLinkParams ResponseType = 2
+	ResponseTypeCredits    ResponseType = 3
 )
 
 // PeerStatus indicates whether the ESP32 recognizes us.
@@ -30,20 +34,105 @@ type ResponsePacket struct {
 	Data       []byte // challenge data during pairing
 }
 
+// LinkParams are the connection parameters the ESP32 negotiated with us,
+// reported in the Data of a ResponseTypeLinkParams packet.
+type LinkParams struct {
+	MTU         int // ATT MTU
+	TxPHY       int // 1 = 1M, 2 = 2M, 3 = Coded
+	RxPHY       int
+	MaxTxOctets int // link layer payload; 27 without Data Length Extension
+	Features    Features
+}
+
+// Features are the framing extensions the firmware decodes, reported in
+// LinkParams. Firmware that predates them reports none.
+type Features uint8
+
+const (
+	FeatureBatch Features = 1 << 0 // several records per frame (EncryptedData field 5)
+	FeatureDict  Features = 1 << 1 // dictionary-packed text (EncryptedData field 4)
+	FeatureEdit  Features = 1 << 2 // backspaces before text (EncryptedData field 6)
+)
+
+// linkParamsLen is the size of the LinkParams data:
+//
+//	bytes 0-1 (little-endian): ATT MTU
+//	byte 2: TX PHY
+//	byte 3: RX PHY
+//	bytes 4-5 (little-endian): max TX octets
+//	byte 6 (optional): Features
+const linkParamsLen = 6
+
+// UnmarshalLinkParams decodes the Data of a ResponseTypeLinkParams packet.
+// Trailing bytes are ignored so the layout can grow.
+func UnmarshalLinkParams(data []byte) (LinkParams, error) {
+	if len(data) < linkParamsLen {
+		return LinkParams{}, fmt.Errorf("protocol: link params need %d bytes, got %d", linkParamsLen, len(data))
+	}
+	link := LinkParams{
+		MTU:         int(binary.LittleEndian.Uint16(data[0:2])),
+		TxPHY:       int(data[2]),
+		RxPHY:       int(data[3]),
+		MaxTxOctets: int(binary.LittleEndian.Uint16(data[4:6])),
+	}
+	if len(data) > linkParamsLen {
+		link.Features = Features(data[linkParamsLen])
+	}
+	return link, nil
+}
+
+// Credits is the ESP32's receive window, reported in the Data of a
+// ResponseTypeCredits packet whenever a packet slot is released. A write
+// sent after Received writes had been accepted may use one of Free slots;
+// the client may have Free - (sent - Received) writes in flight.
+type Credits struct {
+	Received uint32 // data writes accepted this connection; wraps
+	Free     int    // packet slots free when Received was sampled
+	Total    int    // packet slots on the device
+}
+
+// creditsLen is the size of the Credits data:
+//
+//	bytes 0-3 (little-endian): writes received
+//	byte 4: free slots
+//	byte 5: total slots
+const creditsLen = 6
+
+// UnmarshalCredits decodes the Data of a ResponseTypeCredits packet.
+// Trailing bytes are ignored so the layout can grow.
+func UnmarshalCredits(data []byte) (Credits, error) {
+	if len(data) < creditsLen {
+		return Credits{}, fmt.Errorf("protocol: credits need %d bytes, got %d", creditsLen, len(data))
+	}
+	return Credits{
+		Received: binary.LittleEndian.Uint32(data[0:4]),
+		Free:     int(data[4]),
+		Total:    int(data[5]),
+	}, nil
+}
+
 // MarshalKeyboardPacket encodes a KeyboardPacket protobuf.
 //
 //	field 1 (string): message
 //	field 2 (uint32): length of message
 func MarshalKeyboardPacket(message string) []byte {
-	var buf []byte
+	return appendKeyboardPacket(make([]byte, 0, keyboardPacketLen(len(message))), message)
+}
+
+func appendKeyboardPacket(buf []byte, message string) []byte {
 	// Field 1: tag = (1 << 3) | 2 = 0x0a, length-delimited
 	buf = append(buf, 0x0a)
 	buf = appendVarint(buf, uint64(len(message)))
 	buf = append(buf, message...)
 	// Field 2: tag = (2 << 3) | 0 = 0x10, varint
 	buf = append(buf, 0x10)
-	buf = appendVarint(buf, uint64(len(message)))
-	return buf
+	return appendVarint(buf, uint64(len(message)))
+}
+
+// keyboardPacketLen returns the encoded size of a KeyboardPacket carrying n
+// bytes of message.
+func keyboardPacketLen(n int) int {
+	return 1 + varintLen(n) + n + 1 + varintLen(n)
 }
 
 // MarshalEncryptedData wraps a serialized KeyboardPacket in an EncryptedData envelope.
@@ -56,6 +145,134 @@ func MarshalEncryptedData(keyboardPacket []byte) []byte {
 	return buf
 }
 
+// MaxFrameText is the most text one frame may carry once its records are
+// joined and unpacked (GOSTT_PKT_TEXT_MAX on the firmware).
+const MaxFrameText = 1024
+
+// Record is one text or command in a frame.
+type Record struct {
+	Text        string // typed when Command is 0
+	Backspaces  int    // characters deleted before Text is typed
+	Command     uint32 // 0 for text, else a firmware command (GOSTT_CMD_*)
+	CommandData []byte
+}
+
+// Frame is the records of one EncryptedData, as planned by Frames.
+type Frame struct {
+	Records []Record
+	Packed  bool // send text dictionary-packed, see MarshalFrame
+}
+
+// MarshalFrame encodes records as one EncryptedData. A single record is
+// written as the EncryptedData itself, so an unpacked text record reads the
+// same as MarshalEncryptedData; several become repeated records (field 5),
+// which need FeatureBatch. With packed, text is sent dictionary-packed
+// (field 4, needs FeatureDict) unless it contains NUL. Backspaces are sent in
+// field 6, which needs FeatureEdit; firmware without it ignores them. A
+// record with Backspaces and no Text carries no text field.
+//
+//	field 1 (bytes): KeyboardPacket
+//	field 2 (uint32): command type
+//	field 3 (bytes): command data
+//	field 4 (bytes): packed text
+//	field 5 (bytes, repeated): record, an EncryptedData without records
+//	field 6 (uint32): backspaces
+func MarshalFrame(records []Record, packed bool) []byte {
+	f := Frame{Records: records, Packed: packed}
+	return f.Append(make([]byte, 0, f.Len()))
+}
+
+// Len returns the encoded size of the frame without encoding it.
+func (f Frame) Len() int {
+	if len(f.Records) == 1 {
+		return recordLen(f.Records[0], f.Packed)
+	}
+	n := 0
+	for _, rec := range f.Records {
+		body := recordLen(rec, f.Packed)
+		n += 1 + varintLen(body) + body
+	}
+	return n
+}
+
+// Append appends MarshalFrame(f.Records, f.Packed) to buf. It allocates
+// only if buf lacks room for Len more bytes.
+func (f Frame) Append(buf []byte) []byte {
+	if len(f.Records) == 1 {
+		return appendRecord(buf, f.Records[0], f.Packed)
+	}
+	for _, rec := range f.Records {
+		buf = append(buf, 0x2a)
+		buf = appendVarint(buf, uint64(recordLen(rec, f.Packed)))
+		buf = appendRecord(buf, rec, f.Packed)
+	}
+	return buf
+}
+
+// recordText reports how a text record's text is sent: none (a deletion
+// only), dictionary-packed, or in a KeyboardPacket.
+func recordText(rec Record, packed bool) (none, dict bool) {
+	if rec.Text == "" && rec.Backspaces > 0 {
+		return true, false
+	}
+	return false, packed && !strings.ContainsRune(rec.Text, 0)
+}
+
+// recordLen returns the encoded size of rec without encoding it.
+func recordLen(rec Record, packed bool) int {
+	if rec.Command != 0 {
+		n := 1 + varintLen(int(rec.Command))
+		if len(rec.CommandData) > 0 {
+			n += 1 + varintLen(len(rec.CommandData)) + len(rec.CommandData)
+		}
+		return n
+	}
+	var n int
+	switch none, dict := recordText(rec, packed); {
+	case none:
+	case dict:
+		text := dictEncodedLen(rec.Text)
+		n = 1 + varintLen(text) + text
+	default:
+		kb := keyboardPacketLen(len(rec.Text))
+		n = 1 + varintLen(kb) + kb
+	}
+	if rec.Backspaces > 0 {
+		n += 1 + varintLen(rec.Backspaces)
+	}
+	return n
+}
+
+// appendRecord appends the EncryptedData fields of rec to buf.
+func appendRecord(buf []byte, rec Record, packed bool) []byte {
+	if rec.Command != 0 {
+		buf = append(buf, 0x10)
+		buf = appendVarint(buf, uint64(rec.Command))
+		if len(rec.CommandData) > 0 {
+			buf = append(buf, 0x1a)
+			buf = appendVarint(buf, uint64(len(rec.CommandData)))
+			buf = append(buf, rec.CommandData...)
+		}
+		return buf
+	}
+	switch none, dict := recordText(rec, packed); {
+	case none:
+	case dict:
+		buf = append(buf, 0x22)
+		buf = appendVarint(buf, uint64(dictEncodedLen(rec.Text)))
+		buf = AppendDictEncode(buf, rec.Text)
+	default:
+		buf = append(buf, 0x0a)
+		buf = appendVarint(buf, uint64(keyboardPacketLen(len(rec.Text))))
+		buf = appendKeyboardPacket(buf, rec.Text)
+	}
+	if rec.Backspaces > 0 {
+		buf = append(buf, 0x30)
+		buf = appendVarint(buf, uint64(rec.Backspaces))
+	}
+	return buf
+}
+
 // MarshalDataPacket encodes a DataPacket protobuf (the outer encrypted wrapper).
 //
 //	field 1 (bytes): iv (12 bytes)
@@ -88,6 +305,51 @@ func MarshalDataPacket(iv, tag, encrypted []byte, packetNum uint32) ([]byte, err
 	return buf, nil
 }
 
+// Sealer encrypts a DataPacket's encrypted field in place.
+type Sealer interface {
+	// SealInPlace fills iv (12 bytes) with a fresh nonce, encrypts data in
+	// place and writes the authentication tag (16 bytes) to tag. It may use
+	// up to 16 bytes of capacity past the end of data.
+	SealInPlace(iv, tag, data []byte) error
+}
+
+// AppendDataPacket appends to buf the DataPacket that MarshalDataPacket
+// would build for frame, encrypted by s. All three layers are written in one
+// pass: the frame is encoded straight into the encrypted field and sealed
+// there, so apart from buf growing (see DataPacketLen) nothing is allocated
+// or copied.
+func AppendDataPacket(buf []byte, frame Frame, packetNum uint32, s Sealer) ([]byte, error) {
+	n := frame.Len()
+	buf = slices.Grow(buf, DataPacketLen(n))
+	start := len(buf)
+
+	// Fields 1 and 2, iv and tag, are filled in by the sealer
+	buf = append(buf, 0x0a, 12)
+	buf = append(buf, make([]byte, 12)...)
+	buf = append(buf, 0x12, 16)
+	buf = append(buf, make([]byte, 16)...)
+	// Field 3: encrypted
+	buf = append(buf, 0x1a)
+	buf = appendVarint(buf, uint64(n))
+	data := len(buf)
+	buf = frame.Append(buf)
+
+	if err := s.SealInPlace(buf[start+2:start+14], buf[start+16:start+32], buf[data:]); err != nil {
+		return buf[:start], err
+	}
+
+	// Field 4: packet_num
+	buf = append(buf, 0x20)
+	return appendVarint(buf, uint64(packetNum)), nil
+}
+
+// DataPacketLen returns the most capacity AppendDataPacket uses for a frame
+// of n bytes: the DataPacket with the largest packet_num, or the sealer's
+// tag past the frame if that is longer.
+func DataPacketLen(n int) int {
+	return 2 + 12 + 2 + 16 + 1 + varintLen(n) + n + max(1+binary.MaxVarintLen32, 16)
+}
+
 // UnmarshalResponsePacket decodes a ResponsePacket from raw protobuf bytes.
 func UnmarshalResponsePacket(data []byte) (*ResponsePacket, error) {
 	resp := &ResponsePacket{}
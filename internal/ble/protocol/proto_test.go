@@ -2,6 +2,7 @@ package protocol
 
 import (
 	"bytes"
+	"strings"
 	"testing"
 )
 
@@ -138,3 +139,159 @@ func TestUnmarshalResponsePacketNilAndEmpty(t *testing.T) {
 		t.Errorf("UnmarshalResponsePacket([]byte{}) = %+v, want zero-valued", resp)
 	}
 }
+
+func TestUnmarshalLinkParams(t *testing.T) {
+	// Golden bytes from firmware test_proto.c: ResponsePacket(type=LinkParams,
+	// status=Known) with MTU 517, 2M PHY both ways, 251-octet DLE, batched
+	// and packed framing
+	raw := []byte{0x08, 0x02, 0x10, 0x01, 0x1a, 0x07, 0x05, 0x02, 0x02, 0x02, 0xFB, 0x00, 0x03}
+	resp, err := UnmarshalResponsePacket(raw)
+	if err != nil {
+		t.Fatalf("UnmarshalResponsePacket() error = %v", err)
+	}
+	if resp.Type != ResponseTypeLinkParams {
+		t.Fatalf("Type = %d, want %d", resp.Type, ResponseTypeLinkParams)
+	}
+	got, err := UnmarshalLinkParams(resp.Data)
+	if err != nil {
+		t.Fatalf("UnmarshalLinkParams() error = %v", err)
+	}
+	want := LinkParams{MTU: 517, TxPHY: 2, RxPHY: 2, MaxTxOctets: 251, Features: FeatureBatch | FeatureDict}
+	if got != want {
+		t.Errorf("UnmarshalLinkParams() = %+v, want %+v", got, want)
+	}
+
+	// Firmware without framing features sends six bytes
+	if got, err := UnmarshalLinkParams(resp.Data[:6]); err != nil || got.Features != 0 {
+		t.Errorf("UnmarshalLinkParams(6 bytes) = %+v, %v; want no features", got, err)
+	}
+
+	if _, err := UnmarshalLinkParams(resp.Data[:5]); err == nil {
+		t.Error("expected error for truncated link params")
+	}
+}
+
+func TestUnmarshalCredits(t *testing.T) {
+	// Golden bytes from firmware test_proto.c: ResponsePacket(type=Credits,
+	// status=Known) with 300 writes received and 5 of 8 slots free
+	raw := []byte{0x08, 0x03, 0x10, 0x01, 0x1a, 0x06, 0x2C, 0x01, 0x00, 0x00, 0x05, 0x08}
+	resp, err := UnmarshalResponsePacket(raw)
+	if err != nil {
+		t.Fatalf("UnmarshalResponsePacket() error = %v", err)
+	}
+	if resp.Type != ResponseTypeCredits {
+		t.Fatalf("Type = %d, want %d", resp.Type, ResponseTypeCredits)
+	}
+	got, err := UnmarshalCredits(resp.Data)
+	if err != nil {
+		t.Fatalf("UnmarshalCredits() error = %v", err)
+	}
+	want := Credits{Received: 300, Free: 5, Total: 8}
+	if got != want {
+		t.Errorf("UnmarshalCredits() = %+v, want %+v", got, want)
+	}
+
+	if _, err := UnmarshalCredits(resp.Data[:5]); err == nil {
+		t.Error("expected error for truncated credits")
+	}
+}
+
+func TestMarshalFrameBatch(t *testing.T) {
+	// Golden bytes shared with firmware test_proto.c: a text record and a
+	// mute toggle in one frame
+	got := MarshalFrame([]Record{{Text: "hi"}, {Command: 1}}, false)
+	want := []byte{
+		0x2a, 0x08, 0x0a, 0x06, 0x0a, 0x02, 'h', 'i', 0x10, 0x02,
+		0x2a, 0x02, 0x10, 0x01,
+	}
+	if !bytes.Equal(got, want) {
+		t.Errorf("MarshalFrame() = %x, want %x", got, want)
+	}
+}
+
+func TestMarshalFrameSingleRecord(t *testing.T) {
+	// A lone unpacked text record is the legacy EncryptedData
+	got := MarshalFrame([]Record{{Text: "hello"}}, false)
+	if want := MarshalEncryptedData(MarshalKeyboardPacket("hello")); !bytes.Equal(got, want) {
+		t.Errorf("MarshalFrame() = %x, want %x", got, want)
+	}
+
+	got = MarshalFrame([]Record{{Text: "a the"}}, true)
+	if want := []byte{0x22, 0x03, 'a', 0x00, 0x00}; !bytes.Equal(got, want) {
+		t.Errorf("MarshalFrame(packed) = %x, want %x", got, want)
+	}
+
+	// Text with NUL cannot be packed and falls back to a KeyboardPacket
+	got = MarshalFrame([]Record{{Text: "a\x00b"}}, true)
+	if want := MarshalEncryptedData(MarshalKeyboardPacket("a\x00b")); !bytes.Equal(got, want) {
+		t.Errorf("MarshalFrame(packed, NUL) = %x, want %x", got, want)
+	}
+
+	// Golden bytes shared with firmware test_proto.c: an edit, and a
+	// deletion without text
+	got = MarshalFrame([]Record{{Backspaces: 3, Text: "hi"}}, false)
+	if want := []byte{0x0a, 0x06, 0x0a, 0x02, 'h', 'i', 0x10, 0x02, 0x30, 0x03}; !bytes.Equal(got, want) {
+		t.Errorf("MarshalFrame(edit) = %x, want %x", got, want)
+	}
+	got = MarshalFrame([]Record{{Backspaces: 5}}, true)
+	if want := []byte{0x30, 0x05}; !bytes.Equal(got, want) {
+		t.Errorf("MarshalFrame(deletion) = %x, want %x", got, want)
+	}
+
+	got = MarshalFrame([]Record{{Command: 3, CommandData: []byte{1, 6}}}, false)
+	if want := []byte{0x10, 0x03, 0x1a, 0x02, 0x01, 0x06}; !bytes.Equal(got, want) {
+		t.Errorf("MarshalFrame(command) = %x, want %x", got, want)
+	}
+}
+
+// fixedSealer fills iv and tag with fixed bytes and leaves data in clear, so
+// AppendDataPacket can be compared with MarshalDataPacket.
+type fixedSealer struct{}
+
+func (fixedSealer) SealInPlace(iv, tag, data []byte) error {
+	for i := range iv {
+		iv[i] = 0x11
+	}
+	for i := range tag {
+		tag[i] = 0x22
+	}
+	return nil
+}
+
+func TestAppendDataPacket(t *testing.T) {
+	iv, tag := bytes.Repeat([]byte{0x11}, 12), bytes.Repeat([]byte{0x22}, 16)
+	frames := []Frame{
+		{Records: []Record{{Text: "hello"}}},
+		{Records: []Record{{Text: "hello the world", Backspaces: 2}, {Command: 1}}, Packed: true},
+		{Records: []Record{{Text: strings.Repeat("word ", 60)}}},
+	}
+	for i, frame := range frames {
+		want, err := MarshalDataPacket(iv, tag, MarshalFrame(frame.Records, frame.Packed), 300)
+		if err != nil {
+			t.Fatal(err)
+		}
+		got, err := AppendDataPacket([]byte("prefix"), frame, 300, fixedSealer{})
+		if err != nil {
+			t.Fatalf("frame %d: AppendDataPacket() error = %v", i, err)
+		}
+		if !bytes.Equal(got[6:], want) || string(got[:6]) != "prefix" {
+			t.Errorf("frame %d: AppendDataPacket() = %x, want %x after the prefix", i, got, want)
+		}
+		if len(want) > DataPacketLen(frame.Len()) {
+			t.Errorf("frame %d: %d bytes, over DataPacketLen %d", i, len(want), DataPacketLen(frame.Len()))
+		}
+	}
+}
+
+func TestAppendDataPacketAllocs(t *testing.T) {
+	frame := Frame{Records: []Record{{Text: "hello the world", Backspaces: 2}}, Packed: true}
+	buf := make([]byte, 0, DataPacketLen(frame.Len()))
+	allocs := testing.AllocsPerRun(100, func() {
+		if _, err := AppendDataPacket(buf, frame, 1, fixedSealer{}); err != nil {
+			t.Fatal(err)
+		}
+	})
+	if allocs != 0 {
+		t.Errorf("AppendDataPacket() = %.1f allocs per packet, want 0", allocs)
+	}
+}
@@ -0,0 +1,159 @@
+package protocol
+
+import (
+	"encoding/binary"
+	"fmt"
+	"math"
+	"time"
+)
+
+// Stage is a step of the firmware receive pipeline, timed from the end of
+// the previous one.
+type Stage int
+
+const (
+	StageDecrypt  Stage = iota // write received -> decrypted, including the wait for the worker
+	StageEnqueue               // decrypted -> in the typer queue
+	StageFirstKey              // queued -> first HID report sent
+	StageTyping                // first -> last HID report
+	StageTotal                 // write received -> last HID report
+)
+
+var stageNames = [...]string{"decrypt", "enqueue", "first_key", "typing", "total"}
+
+func (s Stage) String() string {
+	if s >= 0 && int(s) < len(stageNames) {
+		return stageNames[s]
+	}
+	return fmt.Sprintf("stage%d", int(s))
+}
+
+// statsBucket0 is the upper bound of the first latency bucket; bucket i
+// counts latencies below statsBucket0 << i (GOSTT_TELEMETRY_BUCKET0_US).
+const statsBucket0 = 64 * time.Microsecond
+
+// BucketBound returns the upper bound of histogram bucket i. The last bucket
+// of a histogram also counts everything longer.
+func BucketBound(i int) time.Duration {
+	return statsBucket0 << i
+}
+
+// StageStats is the latency histogram of one pipeline stage.
+type StageStats struct {
+	Count   uint32
+	Sum     time.Duration
+	Max     time.Duration
+	Buckets []uint32 // see BucketBound
+}
+
+// Mean returns the average latency, or 0 with no samples.
+func (s StageStats) Mean() time.Duration {
+	if s.Count == 0 {
+		return 0
+	}
+	return s.Sum / time.Duration(s.Count)
+}
+
+// Percentile returns an upper bound of the nearest-rank p-th percentile:
+// the bound of the bucket it falls in, capped at Max. Returns 0 with no
+// samples.
+func (s StageStats) Percentile(p float64) time.Duration {
+	var total uint64
+	for _, n := range s.Buckets {
+		total += uint64(n)
+	}
+	if total == 0 {
+		return 0
+	}
+	rank := uint64(math.Ceil(p / 100 * float64(total)))
+	if rank < 1 {
+		rank = 1
+	}
+	var seen uint64
+	for i, n := range s.Buckets {
+		seen += uint64(n)
+		if seen >= rank && i < len(s.Buckets)-1 {
+			return min(BucketBound(i), s.Max)
+		}
+	}
+	return s.Max
+}
+
+// Stats is the firmware telemetry read from the stats characteristic.
+// Counters run from boot.
+type Stats struct {
+	Received            uint32       // TX writes received
+	Dropped             uint32       // writes dropped: too large, no free slot, typer queue full
+	DecryptFailures     uint32       // packets that failed to decode or authenticate
+	TyperQueueHighWater uint32       // most texts waiting for the typer at once
+	FreeHeap            uint32       // bytes
+	MinFreeHeap         uint32       // lowest free heap since boot, bytes
+	Stages              []StageStats // indexed by Stage
+}
+
+// statsVersion is the telemetry layout this package decodes
+// (GOSTT_TELEMETRY_VERSION).
+const statsVersion = 1
+
+// statsHeaderLen is the size of the fixed part of the stats value:
+//
+//	byte 0: version
+//	byte 1: stage count
+//	byte 2: buckets per stage
+//	byte 3: reserved
+//	bytes 4-27 (little-endian uint32): received, dropped, decrypt failures,
+//	typer queue high-water mark, free heap, minimum free heap
+//
+// Then per stage: uint32 count, uint64 sum (us), uint32 max (us) and the
+// uint32 bucket counts.
+const statsHeaderLen = 28
+
+// UnmarshalStats decodes the stats characteristic value. Stage and bucket
+// counts come from the header, so firmware may add either.
+func UnmarshalStats(data []byte) (*Stats, error) {
+	if len(data) < statsHeaderLen {
+		return nil, fmt.Errorf("protocol: stats need %d bytes, got %d", statsHeaderLen, len(data))
+	}
+	if data[0] != statsVersion {
+		return nil, fmt.Errorf("protocol: unsupported stats version %d", data[0])
+	}
+	stages, buckets := int(data[1]), int(data[2])
+	stageLen := 16 + 4*buckets
+	if want := statsHeaderLen + stages*stageLen; len(data) < want {
+		return nil, fmt.Errorf("protocol: stats with %d stages need %d bytes, got %d", stages, want, len(data))
+	}
+
+	u32 := func(off int) uint32 { return binary.LittleEndian.Uint32(data[off:]) }
+	st := &Stats{
+		Received:            u32(4),
+		Dropped:             u32(8),
+		DecryptFailures:     u32(12),
+		TyperQueueHighWater: u32(16),
+		FreeHeap:            u32(20),
+		MinFreeHeap:         u32(24),
+		Stages:              make([]StageStats, stages),
+	}
+	for s := range st.Stages {
+		off := statsHeaderLen + s*stageLen
+		stage := StageStats{
+			Count:   u32(off),
+			Sum:     time.Duration(binary.LittleEndian.Uint64(data[off+4:])) * time.Microsecond,
+			Max:     time.Duration(u32(off+12)) * time.Microsecond,
+			Buckets: make([]uint32, buckets),
+		}
+		for b := range stage.Buckets {
+			stage.Buckets[b] = u32(off + 16 + 4*b)
+		}
+		st.Stages[s] = stage
+	}
+	return st, nil
+}
+
+// Stage returns the histogram of stage s, or a zero StageStats if the
+// firmware does not report it.
+func (st *Stats) Stage(s Stage) StageStats {
+	if s < 0 || int(s) >= len(st.Stages) {
+		return StageStats{}
+	}
+	return st.Stages[s]
+}
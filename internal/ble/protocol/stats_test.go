@@ -0,0 +1,117 @@
+package protocol
+
+import (
+	"encoding/binary"
+	"testing"
+	"time"
+)
+
+// statsValue encodes stats the way the firmware's gostt_telemetry_encode
+// does, with 16 buckets per stage.
+func statsValue(counters [6]uint32, stages []StageStats) []byte {
+	const buckets = 16
+	data := []byte{statsVersion, byte(len(stages)), buckets, 0}
+	for _, c := range counters {
+		data = binary.LittleEndian.AppendUint32(data, c)
+	}
+	for _, s := range stages {
+		data = binary.LittleEndian.AppendUint32(data, s.Count)
+		data = binary.LittleEndian.AppendUint64(data, uint64(s.Sum/time.Microsecond))
+		data = binary.LittleEndian.AppendUint32(data, uint32(s.Max/time.Microsecond))
+		for b := 0; b < buckets; b++ {
+			var n uint32
+			if b < len(s.Buckets) {
+				n = s.Buckets[b]
+			}
+			data = binary.LittleEndian.AppendUint32(data, n)
+		}
+	}
+	return data
+}
+
+func TestUnmarshalStats(t *testing.T) {
+	// The firmware test_telemetry.c scenarios: counters, and four decrypt
+	// samples of 50us, 64us, 320us and 10s
+	decrypt := StageStats{
+		Count:   4,
+		Sum:     (50 + 64 + 320 + 10000000) * time.Microsecond,
+		Max:     10 * time.Second,
+		Buckets: []uint32{1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+	}
+	stages := []StageStats{decrypt, {}, {}, {}, {Count: 1, Sum: 2 * time.Millisecond, Max: 2 * time.Millisecond,
+		Buckets: []uint32{0, 0, 0, 0, 0, 1}}}
+	data := statsValue([6]uint32{3, 1, 2, 5, 100000, 90000}, stages)
+	if len(data) != 428 {
+		t.Fatalf("encoded %d bytes, want GOSTT_TELEMETRY_LEN 428", len(data))
+	}
+
+	st, err := UnmarshalStats(data)
+	if err != nil {
+		t.Fatalf("UnmarshalStats() error = %v", err)
+	}
+	if st.Received != 3 || st.Dropped != 1 || st.DecryptFailures != 2 ||
+		st.TyperQueueHighWater != 5 || st.FreeHeap != 100000 || st.MinFreeHeap != 90000 {
+		t.Errorf("counters = %+v", st)
+	}
+	if len(st.Stages) != 5 {
+		t.Fatalf("%d stages, want 5", len(st.Stages))
+	}
+	got := st.Stage(StageDecrypt)
+	if got.Count != 4 || got.Sum != decrypt.Sum || got.Max != decrypt.Max || got.Buckets[3] != 1 || got.Buckets[15] != 1 {
+		t.Errorf("decrypt stage = %+v, want %+v", got, decrypt)
+	}
+	if got := st.Stage(StageTotal).Max; got != 2*time.Millisecond {
+		t.Errorf("total max = %v, want 2ms", got)
+	}
+	if got := st.Stage(Stage(9)); got.Count != 0 {
+		t.Errorf("unreported stage = %+v, want zero", got)
+	}
+
+	if _, err := UnmarshalStats(data[:len(data)-1]); err == nil {
+		t.Error("expected error for truncated stats")
+	}
+	data[0] = 2
+	if _, err := UnmarshalStats(data); err == nil {
+		t.Error("expected error for unknown version")
+	}
+}
+
+func TestStageStatsPercentile(t *testing.T) {
+	s := StageStats{
+		Count:   10,
+		Sum:     10 * 100 * time.Microsecond,
+		Max:     3 * time.Second,
+		Buckets: []uint32{0, 8, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+	}
+	tests := []struct {
+		p    float64
+		want time.Duration
+	}{
+		{50, BucketBound(1)},  // 128us
+		{90, BucketBound(2)},  // 256us
+		{99, 3 * time.Second}, // overflow bucket: the max
+	}
+	for _, tt := range tests {
+		if got := s.Percentile(tt.p); got != tt.want {
+			t.Errorf("Percentile(%v) = %v, want %v", tt.p, got, tt.want)
+		}
+	}
+	if got := s.Mean(); got != 100*time.Microsecond {
+		t.Errorf("Mean() = %v, want 100us", got)
+	}
+	if got := (StageStats{}).Percentile(50); got != 0 {
+		t.Errorf("Percentile() with no samples = %v, want 0", got)
+	}
+
+	// Capped at the max when it is below the bucket bound
+	s = StageStats{Count: 1, Max: 70 * time.Microsecond, Buckets: []uint32{0, 1}}
+	if got := s.Percentile(50); got != 70*time.Microsecond {
+		t.Errorf("Percentile(50) = %v, want the 70us max", got)
+	}
+}
+
+func TestStageString(t *testing.T) {
+	if got := StageFirstKey.String(); got != "first_key" {
+		t.Errorf("StageFirstKey.String() = %q", got)
+	}
+}
@@ -0,0 +1,5 @@
+//go:build race
+
+package ble
+
+const raceEnabled = true
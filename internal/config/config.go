@@ -7,6 +7,7 @@ import (
 	"os"
 	"path/filepath"
 	"strings"
+	"time"
 
 	"gopkg.in/yaml.v3"
 )
@@ -29,6 +30,8 @@ type RewriteConfig struct {
 	Model       string `yaml:"model"`        // Ollama model name (e.g. "llama3.2")
 	Prompt      string `yaml:"prompt"`       // system prompt controlling rewrite style
 	TimeoutSecs int    `yaml:"timeout_secs"` // per-request timeout in seconds
+	Stream      bool   `yaml:"stream"`       // type the rewrite as it is generated (type and ble injection)
+	KeepAlive   string `yaml:"keep_alive"`   // how long Ollama keeps the model loaded after a request (e.g. "30m")
 }
 
 // TranscribeConfig holds transcription backend settings.
@@ -36,15 +39,17 @@ type TranscribeConfig struct {
 	Backend          string          `yaml:"backend"`            // "whisper" or "parakeet"
 	ModelPath        string          `yaml:"model_path"`         // whisper: path to ggml model file
 	ParakeetModelDir string          `yaml:"parakeet_model_dir"` // parakeet: dir with .mlmodelc files + vocab
-	Streaming        StreamingConfig `yaml:"streaming"`          // real-time streaming settings (whisper only)
+	Prewarm          bool            `yaml:"prewarm"`            // parakeet: run a dummy prediction at startup
+	Streaming        StreamingConfig `yaml:"streaming"`          // real-time streaming settings
 }
 
 // StreamingConfig holds streaming transcription settings.
 type StreamingConfig struct {
-	Enabled  bool `yaml:"enabled"`   // enable real-time streaming (default: false)
-	StepMs   int  `yaml:"step_ms"`   // transcribe interval in ms (default: 3000)
-	LengthMs int  `yaml:"length_ms"` // audio window size in ms (default: 10000)
-	KeepMs   int  `yaml:"keep_ms"`   // overlap between windows in ms (default: 200)
+	Enabled     bool `yaml:"enabled"`     // enable real-time streaming (default: false)
+	StepMs      int  `yaml:"step_ms"`     // transcribe interval in ms (default: 3000)
+	LengthMs    int  `yaml:"length_ms"`   // audio window size in ms (default: 10000)
+	KeepMs      int  `yaml:"keep_ms"`     // overlap between windows in ms (default: 200)
+	Incremental bool `yaml:"incremental"` // whisper: commit stable segments, transcribe only the tail (default: false)
 }
 
 // HotkeyConfig holds hotkey-related settings.
@@ -55,8 +60,17 @@ type HotkeyConfig struct {
 
 // AudioConfig holds audio capture settings.
 type AudioConfig struct {
-	SampleRate uint32 `yaml:"sample_rate"`
-	Channels   uint32 `yaml:"channels"`
+	SampleRate uint32    `yaml:"sample_rate"`
+	Channels   uint32    `yaml:"channels"`
+	VAD        VADConfig `yaml:"vad"` // voice activity detection
+}
+
+// VADConfig holds voice activity detection settings.
+type VADConfig struct {
+	Enabled     bool    `yaml:"enabled"`      // trim silence, split at pauses, skip idle streaming steps (default: false)
+	ThresholdDB float64 `yaml:"threshold_db"` // speech level above the noise floor in dB (default: 9)
+	PauseMs     int     `yaml:"pause_ms"`     // silence that splits a recording in ms (default: 800)
+	PadMs       int     `yaml:"pad_ms"`       // audio kept around each speech segment in ms (default: 200)
 }
 
 // InjectConfig holds text injection settings.
@@ -101,6 +115,12 @@ func DefaultModelsDir() string {
 	return filepath.Join(DefaultDataDir(), "models")
 }
 
+// DefaultCompiledModelsDir returns the default cache directory for compiled
+// CoreML models (.mlmodelc bundles built from .mlpackage sources).
+func DefaultCompiledModelsDir() string {
+	return filepath.Join(DefaultDataDir(), "compiled")
+}
+
 // Default returns a Config with sensible default values.
 func Default() *Config {
 	modelsDir := DefaultModelsDir()
@@ -110,6 +130,7 @@ func Default() *Config {
 			Backend:          "whisper",
 			ModelPath:        filepath.Join(modelsDir, "ggml-base.en.bin"),
 			ParakeetModelDir: filepath.Join(modelsDir, "parakeet-tdt-v2"),
+			Prewarm:          true,
 			Streaming: StreamingConfig{
 				Enabled:  false,
 				StepMs:   3000,
@@ -124,6 +145,12 @@ func Default() *Config {
 		Audio: AudioConfig{
 			SampleRate: 16000,
 			Channels:   1,
+			VAD: VADConfig{
+				Enabled:     false,
+				ThresholdDB: 9,
+				PauseMs:     800,
+				PadMs:       200,
+			},
 		},
 		Inject: InjectConfig{
 			Method: "type",
@@ -132,6 +159,8 @@ func Default() *Config {
 			Enabled:     false,
 			OllamaURL:   "http://localhost:11434",
 			TimeoutSecs: 10,
+			Stream:      true,
+			KeepAlive:   "30m",
 		},
 		LogLevel: "info",
 	}
@@ -204,11 +233,9 @@ func (c *Config) Validate() error {
 
 	// Validate streaming config
 	if c.Transcribe.Streaming.Enabled {
-		if c.Transcribe.Backend == "parakeet" {
-			return fmt.Errorf("streaming is not supported with the parakeet backend (fixed 15s CoreML input)")
-		}
-		if c.Inject.Method == "ble" {
-			return fmt.Errorf("streaming is not supported with BLE injection")
+		if c.Transcribe.Backend == "parakeet" && c.Transcribe.Streaming.LengthMs > 15000 {
+			return fmt.Errorf("transcribe.streaming.length_ms (%d) must not exceed 15000 with the parakeet backend (one CoreML encoder window)",
+				c.Transcribe.Streaming.LengthMs)
 		}
 		if c.Transcribe.Streaming.StepMs > c.Transcribe.Streaming.LengthMs {
 			return fmt.Errorf("transcribe.streaming.step_ms (%d) must not exceed length_ms (%d)",
@@ -243,6 +270,18 @@ func (c *Config) Validate() error {
 		return fmt.Errorf("audio.channels must be > 0")
 	}
 
+	if c.Audio.VAD.Enabled {
+		if c.Audio.VAD.ThresholdDB <= 0 {
+			return fmt.Errorf("audio.vad.threshold_db must be > 0")
+		}
+		if c.Audio.VAD.PauseMs <= 0 {
+			return fmt.Errorf("audio.vad.pause_ms must be > 0")
+		}
+		if c.Audio.VAD.PadMs < 0 {
+			return fmt.Errorf("audio.vad.pad_ms must be >= 0")
+		}
+	}
+
 	switch c.Inject.Method {
 	case "type", "paste":
 	case "ble":
@@ -272,8 +311,10 @@ func (c *Config) Validate() error {
 		if c.Rewrite.TimeoutSecs <= 0 {
 			return fmt.Errorf("rewrite.timeout_secs must be > 0, got %d", c.Rewrite.TimeoutSecs)
 		}
-		if c.Transcribe.Streaming.Enabled && c.Inject.Method == "ble" {
-			return fmt.Errorf("streaming + rewrite is not supported with BLE injection (BLE cannot backspace)")
+		if c.Rewrite.KeepAlive != "" {
+			if _, err := time.ParseDuration(c.Rewrite.KeepAlive); err != nil {
+				return fmt.Errorf("rewrite.keep_alive must be a duration (e.g. \"30m\"), got %q", c.Rewrite.KeepAlive)
+			}
 		}
 	}
 
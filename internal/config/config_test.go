@@ -152,6 +152,27 @@ func TestValidate(t *testing.T) {
 			modify:  func(c *Config) { c.Audio.Channels = 0 },
 			wantErr: true,
 		},
+		{
+			name: "vad with zero threshold",
+			modify: func(c *Config) {
+				c.Audio.VAD.Enabled = true
+				c.Audio.VAD.ThresholdDB = 0
+			},
+			wantErr: true,
+		},
+		{
+			name: "vad with zero pause",
+			modify: func(c *Config) {
+				c.Audio.VAD.Enabled = true
+				c.Audio.VAD.PauseMs = 0
+			},
+			wantErr: true,
+		},
+		{
+			name:    "vad enabled with defaults",
+			modify:  func(c *Config) { c.Audio.VAD.Enabled = true },
+			wantErr: false,
+		},
 		{
 			name:    "invalid log level",
 			modify:  func(c *Config) { c.LogLevel = "invalid" },
@@ -270,6 +291,9 @@ func TestDefaultTranscribeConfig(t *testing.T) {
 	if cfg.Transcribe.ParakeetModelDir != expectedParakeetDir {
 		t.Errorf("Transcribe.ParakeetModelDir = %q, want %q", cfg.Transcribe.ParakeetModelDir, expectedParakeetDir)
 	}
+	if !cfg.Transcribe.Prewarm {
+		t.Error("Transcribe.Prewarm = false, want true")
+	}
 }
 
 func TestLoadBackwardCompatModelPath(t *testing.T) {
@@ -495,26 +519,35 @@ inject:
 	}
 }
 
-func TestValidateStreamingWithParakeetFails(t *testing.T) {
+func TestValidateStreamingWithParakeet(t *testing.T) {
 	cfg := Default()
 	cfg.Transcribe.Backend = "parakeet"
 	cfg.Transcribe.ParakeetModelDir = "/some/dir"
 	cfg.Transcribe.Streaming.Enabled = true
-	err := cfg.Validate()
-	if err == nil {
-		t.Error("Validate() should fail when streaming enabled with parakeet backend")
+	if err := cfg.Validate(); err != nil {
+		t.Errorf("Validate() with parakeet streaming returned error: %v", err)
+	}
+}
+
+func TestValidateStreamingParakeetLengthExceedsWindow(t *testing.T) {
+	cfg := Default()
+	cfg.Transcribe.Backend = "parakeet"
+	cfg.Transcribe.ParakeetModelDir = "/some/dir"
+	cfg.Transcribe.Streaming.Enabled = true
+	cfg.Transcribe.Streaming.LengthMs = 20000
+	if err := cfg.Validate(); err == nil {
+		t.Error("Validate() should fail when parakeet streaming length_ms exceeds the 15s encoder window")
 	}
 }
 
-func TestValidateStreamingWithBLEFails(t *testing.T) {
+func TestValidateStreamingWithBLE(t *testing.T) {
 	cfg := Default()
 	cfg.Transcribe.Streaming.Enabled = true
 	cfg.Inject.Method = "ble"
 	cfg.Inject.BLE.DeviceMAC = "AA:BB:CC:DD:EE:FF"
 	cfg.Inject.BLE.SharedSecret = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-	err := cfg.Validate()
-	if err == nil {
-		t.Error("Validate() should fail when streaming enabled with BLE injection")
+	if err := cfg.Validate(); err != nil {
+		t.Errorf("Validate() unexpected error for streaming with BLE injection: %v", err)
 	}
 }
 
@@ -567,6 +600,9 @@ func TestDefaultStreamingConfig(t *testing.T) {
 	if sc.KeepMs != 200 {
 		t.Errorf("KeepMs = %d, want 200", sc.KeepMs)
 	}
+	if sc.Incremental {
+		t.Error("default streaming should use the sliding window")
+	}
 }
 
 func TestLoadStreamingConfig(t *testing.T) {
@@ -577,6 +613,7 @@ transcribe:
     step_ms: 2000
     length_ms: 8000
     keep_ms: 500
+    incremental: true
 `
 	tmpDir := t.TempDir()
 	cfgPath := filepath.Join(tmpDir, "config.yaml")
@@ -601,6 +638,9 @@ transcribe:
 	if cfg.Transcribe.Streaming.KeepMs != 500 {
 		t.Errorf("KeepMs = %d, want 500", cfg.Transcribe.Streaming.KeepMs)
 	}
+	if !cfg.Transcribe.Streaming.Incremental {
+		t.Error("Streaming.Incremental should be true")
+	}
 }
 
 func TestParseLogLevel(t *testing.T) {
@@ -646,6 +686,13 @@ func TestDefaultModelsDir(t *testing.T) {
 	}
 }
 
+func TestDefaultCompiledModelsDir(t *testing.T) {
+	dir := DefaultCompiledModelsDir()
+	if !strings.HasSuffix(dir, filepath.Join("gostt-writer", "compiled")) {
+		t.Errorf("DefaultCompiledModelsDir() = %q, want suffix %q", dir, filepath.Join("gostt-writer", "compiled"))
+	}
+}
+
 func TestDefaultRewriteConfig(t *testing.T) {
 	cfg := Default()
 	if cfg.Rewrite.Enabled {
@@ -657,6 +704,12 @@ func TestDefaultRewriteConfig(t *testing.T) {
 	if cfg.Rewrite.TimeoutSecs != 10 {
 		t.Errorf("Rewrite.TimeoutSecs = %d, want 10", cfg.Rewrite.TimeoutSecs)
 	}
+	if !cfg.Rewrite.Stream {
+		t.Error("Rewrite.Stream should default to true")
+	}
+	if cfg.Rewrite.KeepAlive != "30m" {
+		t.Errorf("Rewrite.KeepAlive = %q, want %q", cfg.Rewrite.KeepAlive, "30m")
+	}
 }
 
 func TestValidateRewriteDisabledNoError(t *testing.T) {
@@ -713,7 +766,7 @@ func TestValidateRewriteEnabledValid(t *testing.T) {
 	}
 }
 
-func TestValidateRewriteStreamingBLEFails(t *testing.T) {
+func TestValidateRewriteStreamingBLE(t *testing.T) {
 	cfg := Default()
 	cfg.Rewrite.Enabled = true
 	cfg.Rewrite.Model = "llama3.2"
@@ -722,9 +775,23 @@ func TestValidateRewriteStreamingBLEFails(t *testing.T) {
 	cfg.Inject.Method = "ble"
 	cfg.Inject.BLE.DeviceMAC = "AA:BB:CC:DD:EE:FF"
 	cfg.Inject.BLE.SharedSecret = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
-	err := cfg.Validate()
-	if err == nil {
-		t.Error("Validate() should fail for streaming + rewrite + BLE")
+	if err := cfg.Validate(); err != nil {
+		t.Errorf("Validate() unexpected error for streaming + rewrite + BLE: %v", err)
+	}
+}
+
+func TestValidateRewriteKeepAlive(t *testing.T) {
+	cfg := Default()
+	cfg.Rewrite.Enabled = true
+	cfg.Rewrite.Model = "llama3.2"
+	cfg.Rewrite.Prompt = "Fix grammar."
+	cfg.Rewrite.KeepAlive = "forever"
+	if err := cfg.Validate(); err == nil {
+		t.Error("Validate() should fail for rewrite.keep_alive \"forever\"")
+	}
+	cfg.Rewrite.KeepAlive = ""
+	if err := cfg.Validate(); err != nil {
+		t.Errorf("Validate() unexpected error for empty rewrite.keep_alive: %v", err)
 	}
 }
 
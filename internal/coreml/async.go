@@ -0,0 +1,93 @@
+package coreml
+
+/*
+#include "bridge.h"
+#include <stdlib.h>
+
+extern void coremlAsyncPredictDone(uintptr_t context, bool ok,
+                                   char** output_names, CoreMLTensor* outputs, int num_outputs,
+                                   CoreMLError error);
+*/
+import "C"
+import (
+	"fmt"
+	"runtime/cgo"
+	"unsafe"
+)
+
+// AsyncResult is the outcome of a PredictAsync call. On success the caller owns
+// Result and must Close it.
+type AsyncResult struct {
+	Result *PredictAllocResult
+	Err    error
+}
+
+// PredictAsync starts a prediction with bridge-allocated outputs and returns at
+// once. The returned channel receives exactly one AsyncResult; it is buffered,
+// so completion never blocks on the reader. The calling goroutine is free while
+// CoreML runs, which lets independent stages (e.g. the encoder on the next chunk
+// and the decoder on this one) overlap.
+//
+// The input tensors must not be closed, and the memory behind tensor views must
+// not be modified, until the result has been received.
+func (m *Model) PredictAsync(inputNames []string, inputs []*Tensor, opts PredictOptions) <-chan AsyncResult {
+	done := make(chan AsyncResult, 1)
+	if len(inputNames) != len(inputs) {
+		done <- AsyncResult{Err: fmt.Errorf("input names count (%d) != inputs count (%d)", len(inputNames), len(inputs))}
+		return done
+	}
+
+	// Input names are copied into the feature provider before the call returns
+	cInputNames := make([]*C.char, len(inputNames))
+	for i, name := range inputNames {
+		cInputNames[i] = C.CString(name)
+	}
+	defer func() {
+		for _, name := range cInputNames {
+			C.free(unsafe.Pointer(name))
+		}
+	}()
+
+	cInputs := make([]C.CoreMLTensor, len(inputs))
+	for i, t := range inputs {
+		cInputs[i] = t.handle
+	}
+
+	var cInputNamesPtr **C.char
+	var cInputsPtr *C.CoreMLTensor
+	if len(inputs) > 0 {
+		cInputNamesPtr = (**C.char)(unsafe.Pointer(&cInputNames[0]))
+		cInputsPtr = (*C.CoreMLTensor)(unsafe.Pointer(&cInputs[0]))
+	}
+
+	// The handle is released by coremlAsyncPredictDone
+	h := cgo.NewHandle(done)
+	C.coreml_model_predict_async(
+		m.handle,
+		cInputNamesPtr,
+		cInputsPtr,
+		C.int(len(inputs)),
+		C.int(opts),
+		C.CoreMLPredictDone(C.coremlAsyncPredictDone),
+		C.uintptr_t(h),
+	)
+	return done
+}
+
+//export coremlAsyncPredictDone
+func coremlAsyncPredictDone(context C.uintptr_t, ok C.bool, cOutputNames **C.char, cOutputs *C.CoreMLTensor, numOutputs C.int, err C.CoreMLError) {
+	h := cgo.Handle(context)
+	done := h.Value().(chan AsyncResult)
+	h.Delete()
+
+	if !ok {
+		msg := "unknown error"
+		if err.message != nil {
+			msg = C.GoString(err.message)
+			C.free(unsafe.Pointer(err.message))
+		}
+		done <- AsyncResult{Err: fmt.Errorf("async prediction failed: %s", msg)}
+		return
+	}
+	done <- AsyncResult{Result: allocResultFromC(cOutputNames, cOutputs, numOutputs)}
+}
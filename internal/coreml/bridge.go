@@ -10,13 +10,21 @@ package coreml
 
 /*
 #cgo darwin CFLAGS: -fobjc-arc
-#cgo darwin LDFLAGS: -framework Foundation -framework CoreML
+#cgo darwin LDFLAGS: -framework Foundation -framework CoreML -framework Accelerate -framework Metal
+// The prepared call is run once per decode step; it neither keeps its pointer
+// arguments nor calls back into Go, so its out-parameters stay on the stack.
+#cgo noescape coreml_prepared_call_run
+#cgo nocallback coreml_prepared_call_run
+// Likewise for a reused TDT decoder's decode, run once per window or stream chunk.
+#cgo noescape coreml_tdt_decoder_decode
+#cgo nocallback coreml_tdt_decoder_decode
 #include "bridge.h"
 #include <stdlib.h>
 */
 import "C"
 import (
 	"fmt"
+	"runtime"
 	"unsafe"
 )
 
@@ -41,6 +49,32 @@ const (
 	ComputeCPUAndANE ComputeUnits = C.COREML_COMPUTE_CPU_AND_ANE
 )
 
+func (u ComputeUnits) String() string {
+	switch u {
+	case ComputeAll:
+		return "all"
+	case ComputeCPUOnly:
+		return "cpu"
+	case ComputeCPUAndGPU:
+		return "cpu+gpu"
+	case ComputeCPUAndANE:
+		return "cpu+ane"
+	default:
+		return fmt.Sprintf("ComputeUnits(%d)", int(u))
+	}
+}
+
+// PredictOptions controls how PredictAllocWith materializes bridge-allocated outputs.
+// Outputs are always contiguous (row-major); options may be combined with |.
+type PredictOptions int
+
+const (
+	PredictDefault PredictOptions = C.COREML_PREDICT_DEFAULT
+	// PredictFloat32 converts float16 outputs to float32 inside the bridge, in the
+	// same pass as the strided copy, so callers never see DTypeFloat16 results.
+	PredictFloat32 PredictOptions = C.COREML_PREDICT_FLOAT32
+)
+
 // SetComputeUnits sets the global compute units for model loading.
 func SetComputeUnits(units ComputeUnits) {
 	C.coreml_set_compute_units(C.CoreMLComputeUnits(units))
@@ -80,6 +114,15 @@ func CompileModel(packagePath, outputDir string) (string, error) {
 	return result, nil
 }
 
+// RuntimeVersion describes the OS build hosting CoreML. Compiled models are
+// only valid for the CoreML version that produced them, so it is part of the
+// compiled-model cache key.
+func RuntimeVersion() string {
+	cVersion := C.coreml_runtime_version()
+	defer C.free(unsafe.Pointer(cVersion))
+	return C.GoString(cVersion)
+}
+
 // LoadModel loads a CoreML model from a .mlmodelc directory.
 func LoadModel(path string) (*Model, error) {
 	cPath := C.CString(path)
@@ -99,6 +142,47 @@ func LoadModel(path string) (*Model, error) {
 	return &Model{handle: handle}, nil
 }
 
+// LoadOptions configures how a single model is loaded.
+// The zero value loads on all compute units with default precision and device.
+type LoadOptions struct {
+	ComputeUnits         ComputeUnits
+	AllowLowPrecisionGPU bool   // allow fp16 accumulation on the GPU
+	MetalDevice          string // preferred Metal device name; empty for the system default
+}
+
+// LoadModelWithOptions loads a CoreML model from a .mlmodelc directory using
+// per-model options. Unlike SetComputeUnits + LoadModel it touches no global
+// state, so several models may be loaded concurrently.
+func LoadModelWithOptions(path string, opts LoadOptions) (*Model, error) {
+	cPath := C.CString(path)
+	defer C.free(unsafe.Pointer(cPath))
+
+	var cDevice *C.char
+	if opts.MetalDevice != "" {
+		cDevice = C.CString(opts.MetalDevice)
+		defer C.free(unsafe.Pointer(cDevice))
+	}
+
+	cOpts := C.CoreMLLoadOptions{
+		compute_units:           C.CoreMLComputeUnits(opts.ComputeUnits),
+		allow_low_precision_gpu: C.bool(opts.AllowLowPrecisionGPU),
+		metal_device:            cDevice,
+	}
+
+	var err C.CoreMLError
+	handle := C.coreml_load_model_with_options(cPath, &cOpts, &err)
+	if handle == nil {
+		msg := "unknown error"
+		if err.message != nil {
+			msg = C.GoString(err.message)
+			C.free(unsafe.Pointer(err.message))
+		}
+		return nil, fmt.Errorf("failed to load model: %s", msg)
+	}
+
+	return &Model{handle: handle}, nil
+}
+
 // Close releases the model resources.
 func (m *Model) Close() {
 	if m.handle != nil {
@@ -142,6 +226,10 @@ func (m *Model) OutputName(index int) string {
 // Tensor represents a multi-dimensional array for CoreML.
 type Tensor struct {
 	handle C.CoreMLTensor
+
+	// pinner keeps caller-owned Go memory in place for tensor views.
+	// nil for tensors whose storage is owned by CoreML.
+	pinner *runtime.Pinner
 }
 
 // NewTensor creates a new tensor with the given shape and data type.
@@ -195,12 +283,52 @@ func NewTensorWithData(shape []int64, dtype DType, data unsafe.Pointer) (*Tensor
 	return &Tensor{handle: handle}, nil
 }
 
+// NewTensorView creates a tensor that wraps caller-owned memory without copying.
+// data must point to a contiguous row-major buffer large enough for shape and dtype.
+// Go memory is pinned until Close, so the caller may keep reading and writing it
+// through its own slice; writes are visible to the next prediction.
+func NewTensorView(shape []int64, dtype DType, data unsafe.Pointer) (*Tensor, error) {
+	if data == nil {
+		return nil, fmt.Errorf("failed to create tensor view: nil data pointer")
+	}
+	pinner := &runtime.Pinner{}
+	pinner.Pin(data)
+
+	var err C.CoreMLError
+	var shapePtr *C.int64_t
+	if len(shape) > 0 {
+		shapePtr = (*C.int64_t)(unsafe.Pointer(&shape[0]))
+	}
+	handle := C.coreml_tensor_create_view(
+		shapePtr,
+		C.int(len(shape)),
+		C.int(dtype),
+		data,
+		&err,
+	)
+	if handle == nil {
+		pinner.Unpin()
+		msg := "unknown error"
+		if err.message != nil {
+			msg = C.GoString(err.message)
+			C.free(unsafe.Pointer(err.message))
+		}
+		return nil, fmt.Errorf("failed to create tensor view: %s", msg)
+	}
+	return &Tensor{handle: handle, pinner: pinner}, nil
+}
+
 // Close releases the tensor resources.
+// For tensor views, the wrapped memory is unpinned after CoreML drops its reference.
 func (t *Tensor) Close() {
 	if t.handle != nil {
 		C.coreml_tensor_free(t.handle)
 		t.handle = nil
 	}
+	if t.pinner != nil {
+		t.pinner.Unpin()
+		t.pinner = nil
+	}
 }
 
 // Rank returns the number of dimensions.
@@ -260,11 +388,28 @@ func (t *Tensor) SizeBytes() int64 {
 
 // Predict runs inference with the given inputs and outputs.
 func (m *Model) Predict(inputNames []string, inputs []*Tensor, outputNames []string, outputs []*Tensor) error {
+	_, err := m.predict(inputNames, inputs, outputNames, outputs, false)
+	return err
+}
+
+// PredictInto runs inference with the given outputs registered as CoreML output
+// backings, so results are written directly into the caller's tensors without a copy.
+// Output tensors must match the model's output shapes and data types.
+//
+// honored reports whether every backing was used in place. When it is false, CoreML
+// rejected at least one backing and the bridge fell back to copying results into
+// the outputs; the data is still valid, but callers may want to switch strategy.
+func (m *Model) PredictInto(inputNames []string, inputs []*Tensor, outputNames []string, outputs []*Tensor) (honored bool, err error) {
+	return m.predict(inputNames, inputs, outputNames, outputs, true)
+}
+
+// predict implements Predict and PredictInto.
+func (m *Model) predict(inputNames []string, inputs []*Tensor, outputNames []string, outputs []*Tensor, backed bool) (bool, error) {
 	if len(inputNames) != len(inputs) {
-		return fmt.Errorf("input names count (%d) != inputs count (%d)", len(inputNames), len(inputs))
+		return false, fmt.Errorf("input names count (%d) != inputs count (%d)", len(inputNames), len(inputs))
 	}
 	if len(outputNames) != len(outputs) {
-		return fmt.Errorf("output names count (%d) != outputs count (%d)", len(outputNames), len(outputs))
+		return false, fmt.Errorf("output names count (%d) != outputs count (%d)", len(outputNames), len(outputs))
 	}
 
 	// Convert input names
@@ -316,24 +461,125 @@ func (m *Model) Predict(inputNames []string, inputs []*Tensor, outputNames []str
 	}
 
 	var err C.CoreMLError
-	ok := C.coreml_model_predict(
+	var ok C.bool
+	honored := C.bool(false)
+	if backed {
+		ok = C.coreml_model_predict_backed(
+			m.handle,
+			cInputNamesPtr,
+			cInputsPtr,
+			C.int(len(inputs)),
+			cOutputNamesPtr,
+			cOutputsPtr,
+			C.int(len(outputs)),
+			&honored,
+			&err,
+		)
+	} else {
+		ok = C.coreml_model_predict(
+			m.handle,
+			cInputNamesPtr,
+			cInputsPtr,
+			C.int(len(inputs)),
+			cOutputNamesPtr,
+			cOutputsPtr,
+			C.int(len(outputs)),
+			&err,
+		)
+	}
+
+	if !ok {
+		msg := "unknown error"
+		if err.message != nil {
+			msg = C.GoString(err.message)
+			C.free(unsafe.Pointer(err.message))
+		}
+		return false, fmt.Errorf("prediction failed: %s", msg)
+	}
+
+	return bool(honored), nil
+}
+
+// PredictBatch runs inference on several samples in a single CoreML batch dispatch.
+// inputs[b] and outputs[b] hold sample b's tensors, ordered like inputNames and
+// outputNames. Results are copied into the caller-provided output tensors.
+func (m *Model) PredictBatch(inputNames []string, inputs [][]*Tensor, outputNames []string, outputs [][]*Tensor) error {
+	if len(inputs) != len(outputs) {
+		return fmt.Errorf("batch input count (%d) != batch output count (%d)", len(inputs), len(outputs))
+	}
+	if len(inputs) == 0 {
+		return nil
+	}
+
+	// Flatten sample-major tensor handles
+	cInputs := make([]C.CoreMLTensor, 0, len(inputs)*len(inputNames))
+	cOutputs := make([]C.CoreMLTensor, 0, len(outputs)*len(outputNames))
+	for b := range inputs {
+		if len(inputs[b]) != len(inputNames) {
+			return fmt.Errorf("sample %d: input names count (%d) != inputs count (%d)", b, len(inputNames), len(inputs[b]))
+		}
+		if len(outputs[b]) != len(outputNames) {
+			return fmt.Errorf("sample %d: output names count (%d) != outputs count (%d)", b, len(outputNames), len(outputs[b]))
+		}
+		for _, t := range inputs[b] {
+			cInputs = append(cInputs, t.handle)
+		}
+		for _, t := range outputs[b] {
+			cOutputs = append(cOutputs, t.handle)
+		}
+	}
+
+	// Convert names
+	cInputNames := make([]*C.char, len(inputNames))
+	for i, name := range inputNames {
+		cInputNames[i] = C.CString(name)
+	}
+	cOutputNames := make([]*C.char, len(outputNames))
+	for i, name := range outputNames {
+		cOutputNames[i] = C.CString(name)
+	}
+	defer func() {
+		for _, name := range cInputNames {
+			C.free(unsafe.Pointer(name))
+		}
+		for _, name := range cOutputNames {
+			C.free(unsafe.Pointer(name))
+		}
+	}()
+
+	var cInputNamesPtr **C.char
+	var cInputsPtr *C.CoreMLTensor
+	if len(inputNames) > 0 {
+		cInputNamesPtr = (**C.char)(unsafe.Pointer(&cInputNames[0]))
+		cInputsPtr = (*C.CoreMLTensor)(unsafe.Pointer(&cInputs[0]))
+	}
+
+	var cOutputNamesPtr **C.char
+	var cOutputsPtr *C.CoreMLTensor
+	if len(outputNames) > 0 {
+		cOutputNamesPtr = (**C.char)(unsafe.Pointer(&cOutputNames[0]))
+		cOutputsPtr = (*C.CoreMLTensor)(unsafe.Pointer(&cOutputs[0]))
+	}
+
+	var err C.CoreMLError
+	ok := C.coreml_model_predict_batch(
 		m.handle,
 		cInputNamesPtr,
 		cInputsPtr,
-		C.int(len(inputs)),
+		C.int(len(inputNames)),
 		cOutputNamesPtr,
 		cOutputsPtr,
-		C.int(len(outputs)),
+		C.int(len(outputNames)),
+		C.int(len(inputs)),
 		&err,
 	)
-
 	if !ok {
 		msg := "unknown error"
 		if err.message != nil {
 			msg = C.GoString(err.message)
 			C.free(unsafe.Pointer(err.message))
 		}
-		return fmt.Errorf("prediction failed: %s", msg)
+		return fmt.Errorf("batch prediction failed: %s", msg)
 	}
 
 	return nil
@@ -366,6 +612,11 @@ func (r *PredictAllocResult) Tensor(name string) *Tensor {
 // The caller must close the returned result to free resources.
 // Output tensors have the actual shapes from the model's prediction.
 func (m *Model) PredictAlloc(inputNames []string, inputs []*Tensor) (*PredictAllocResult, error) {
+	return m.PredictAllocWith(inputNames, inputs, PredictDefault)
+}
+
+// PredictAllocWith is PredictAlloc with output materialization options.
+func (m *Model) PredictAllocWith(inputNames []string, inputs []*Tensor, opts PredictOptions) (*PredictAllocResult, error) {
 	if len(inputNames) != len(inputs) {
 		return nil, fmt.Errorf("input names count (%d) != inputs count (%d)", len(inputNames), len(inputs))
 	}
@@ -404,6 +655,7 @@ func (m *Model) PredictAlloc(inputNames []string, inputs []*Tensor) (*PredictAll
 		cInputNamesPtr,
 		cInputsPtr,
 		C.int(len(inputs)),
+		C.int(opts),
 		&cOutputNames,
 		&cOutputs,
 		&numOutputs,
@@ -419,6 +671,11 @@ func (m *Model) PredictAlloc(inputNames []string, inputs []*Tensor) (*PredictAll
 		return nil, fmt.Errorf("prediction failed: %s", msg)
 	}
 
+	return allocResultFromC(cOutputNames, cOutputs, numOutputs), nil
+}
+
+// allocResultFromC takes ownership of bridge-allocated output names and tensors.
+func allocResultFromC(cOutputNames **C.char, cOutputs *C.CoreMLTensor, numOutputs C.int) *PredictAllocResult {
 	n := int(numOutputs)
 	result := &PredictAllocResult{
 		Names:   make([]string, n),
@@ -438,5 +695,395 @@ func (m *Model) PredictAlloc(inputNames []string, inputs []*Tensor) (*PredictAll
 	C.free(unsafe.Pointer(cOutputNames))
 	C.free(unsafe.Pointer(cOutputs))
 
-	return result, nil
+	return result
+}
+
+// TDTConfig describes the TDT (token-and-duration transducer) greedy decode loop.
+type TDTConfig struct {
+	EncoderHidden     int
+	DecoderHidden     int
+	LSTMLayers        int
+	BlankID           int32
+	MaxSymbolsPerStep int
+	DurationBins      []int32
+
+	// JointWindow is the most encoder frames scored against one decoder output
+	// in a single joint batch. Until a token is emitted the decoder output is
+	// fixed, so runs of blank frames cost one joint dispatch per window rather
+	// than one per frame. The window restarts at 1 after each token and doubles
+	// across blanks; values <= 1 score one frame per call.
+	JointWindow int
+}
+
+// TDTGreedyDecode runs the full TDT greedy decode loop natively in the bridge,
+// crossing cgo once per utterance instead of once per frame and emitted symbol.
+// encoderOut is frame-major ([frames, EncoderHidden] flattened). Returns the
+// emitted (non-blank) token IDs.
+func TDTGreedyDecode(decoder, joint *Model, encoderOut []float32, frames int, cfg TDTConfig) ([]int32, error) {
+	if frames > 0 && len(encoderOut) < frames*cfg.EncoderHidden {
+		return nil, fmt.Errorf("tdt decode: encoder output has %d values, need %d", len(encoderOut), frames*cfg.EncoderHidden)
+	}
+	return runTDTDecode(frames, cfg, nil, func(cCfg *C.CoreMLTDTConfig, cState *C.CoreMLTDTState,
+		tokens *C.int32_t, maxTokens C.int, numTokens *C.int, err *C.CoreMLError) C.bool {
+		return C.coreml_tdt_greedy_decode(decoder.handle, joint.handle, (*C.float)(unsafe.Pointer(&encoderOut[0])),
+			C.int(frames), cCfg, cState, tokens, maxTokens, numTokens, err)
+	})
+}
+
+// TDTState is the decoder state carried between TDTDecoder.DecodeTensor calls, so
+// a stream can be decoded chunk by chunk without resetting the LSTM.
+type TDTState struct {
+	DecoderOut []float32 // decoder output for the last emitted token [DecoderHidden]
+	H, C       []float32 // LSTM hidden and cell state [LSTMLayers * DecoderHidden]
+	Primed     bool      // false until the decoder has been run on the initial blank
+
+	// Frame is the next encoder frame to decode. A duration may jump past the
+	// end of a chunk, so after a call it can exceed the frames decoded; callers
+	// rebase it onto the next chunk's encoder output.
+	Frame int
+}
+
+// NewTDTState returns a zero decoder state sized for cfg.
+func NewTDTState(cfg TDTConfig) *TDTState {
+	stateLen := cfg.LSTMLayers * cfg.DecoderHidden
+	return &TDTState{
+		DecoderOut: make([]float32, cfg.DecoderHidden),
+		H:          make([]float32, stateLen),
+		C:          make([]float32, stateLen),
+	}
+}
+
+// Clone returns an independent copy of s, e.g. to decode a tentative tail
+// without disturbing the committed state.
+func (s *TDTState) Clone() *TDTState {
+	return &TDTState{
+		DecoderOut: append([]float32(nil), s.DecoderOut...),
+		H:          append([]float32(nil), s.H...),
+		C:          append([]float32(nil), s.C...),
+		Primed:     s.Primed,
+		Frame:      s.Frame,
+	}
+}
+
+// TDTGreedyDecodeTensor is TDTGreedyDecode over the encoder's output tensor in
+// its native [1, EncoderHidden, >= frames] layout, fp16 or fp32. The joint reads
+// each frame through a view into the tensor, so the output is never expanded to
+// fp32 or transposed frame-major.
+//
+// Every call sets up the decode loop's arrays and prepared calls afresh; a
+// TDTDecoder allocates them once, and is how a stream resumes decoding.
+func TDTGreedyDecodeTensor(decoder, joint *Model, encoder *Tensor, frames int, cfg TDTConfig) ([]int32, error) {
+	if err := checkTDTTensor(encoder, frames, cfg, nil); err != nil {
+		return nil, err
+	}
+	return runTDTDecode(frames, cfg, nil, func(cCfg *C.CoreMLTDTConfig, cState *C.CoreMLTDTState,
+		tokens *C.int32_t, maxTokens C.int, numTokens *C.int, err *C.CoreMLError) C.bool {
+		return C.coreml_tdt_greedy_decode_tensor(decoder.handle, joint.handle, encoder.handle, C.int(frames),
+			cCfg, cState, tokens, maxTokens, numTokens, err)
+	})
+}
+
+// runTDTDecode validates cfg, marshals it and state for the bridge, runs decode
+// and copies the resulting state back.
+func runTDTDecode(frames int, cfg TDTConfig, state *TDTState,
+	decode func(*C.CoreMLTDTConfig, *C.CoreMLTDTState, *C.int32_t, C.int, *C.int, *C.CoreMLError) C.bool) ([]int32, error) {
+	start := 0
+	if state != nil {
+		start = state.Frame
+	}
+	if frames <= start {
+		return nil, nil
+	}
+	if err := checkTDTConfig(cfg); err != nil {
+		return nil, err
+	}
+
+	// The config and state structs live in Go memory and point at Go slices, so pin them.
+	var pinner runtime.Pinner
+	defer pinner.Unpin()
+	cCfg := tdtConfigC(cfg, &pinner)
+
+	var cState *C.CoreMLTDTState
+	if state != nil {
+		s := tdtStateC(state, &pinner)
+		cState = &s
+	}
+
+	tokens := make([]int32, (frames-start)*cfg.MaxSymbolsPerStep)
+	var numTokens C.int
+	var err C.CoreMLError
+	ok := decode(&cCfg, cState, (*C.int32_t)(unsafe.Pointer(&tokens[0])), C.int(len(tokens)), &numTokens, &err)
+	if !ok {
+		return nil, tdtDecodeError(&err)
+	}
+
+	if state != nil {
+		state.Primed = bool(cState.primed)
+		state.Frame = int(cState.frame)
+	}
+	return tokens[:int(numTokens)], nil
+}
+
+// TDTDecoder is a native TDT greedy decoder bound to a decoder and joint model.
+// The decode loop's model inputs, output backings and prepared calls are
+// allocated once by NewTDTDecoder, and its token buffer is reused, so each
+// DecodeTensor only runs predictions. A TDTDecoder is not safe for concurrent use.
+type TDTDecoder struct {
+	handle C.CoreMLTDTDecoder
+	cfg    TDTConfig
+	tokens []int32        // reused token buffer; DecodeTensor results alias it
+	pinner runtime.Pinner // pins the carried state for each decode
+}
+
+// NewTDTDecoder creates a decoder for cfg over the decoder and joint models,
+// which must stay open until the TDTDecoder is closed.
+func NewTDTDecoder(decoder, joint *Model, cfg TDTConfig) (*TDTDecoder, error) {
+	if decoder == nil || joint == nil || decoder.handle == nil || joint.handle == nil {
+		return nil, fmt.Errorf("tdt decoder: requires decoder and joint models")
+	}
+	if err := checkTDTConfig(cfg); err != nil {
+		return nil, err
+	}
+
+	// The bridge copies the config, so its duration bins only need pinning here
+	var pinner runtime.Pinner
+	defer pinner.Unpin()
+	cCfg := tdtConfigC(cfg, &pinner)
+
+	var cErr C.CoreMLError
+	handle := C.coreml_tdt_decoder_create(decoder.handle, joint.handle, &cCfg, &cErr)
+	if handle == nil {
+		return nil, fmt.Errorf("tdt decoder: %w", tdtDecodeError(&cErr))
+	}
+	cfg.DurationBins = append([]int32(nil), cfg.DurationBins...)
+	return &TDTDecoder{handle: handle, cfg: cfg}, nil
+}
+
+// DecodeTensor is TDTGreedyDecodeTensor with the decoder's models and config,
+// resuming from state. A nil state decodes from a fresh state; otherwise
+// decoding starts at state.Frame with the carried decoder state, and state is
+// updated on success. The returned tokens alias the decoder's buffer and are
+// valid until the next DecodeTensor call.
+func (d *TDTDecoder) DecodeTensor(encoder *Tensor, frames int, state *TDTState) ([]int32, error) {
+	if d.handle == nil {
+		return nil, fmt.Errorf("tdt decode: decoder closed")
+	}
+	if err := checkTDTTensor(encoder, frames, d.cfg, state); err != nil {
+		return nil, err
+	}
+	start := 0
+	if state != nil {
+		start = state.Frame
+	}
+	if frames <= start {
+		return nil, nil
+	}
+	if need := (frames - start) * d.cfg.MaxSymbolsPerStep; cap(d.tokens) < need {
+		d.tokens = make([]int32, need)
+	}
+	tokens := d.tokens[:cap(d.tokens)]
+
+	// noescape keeps these on the stack; the state they point at is pinned
+	defer d.pinner.Unpin()
+	var cState C.CoreMLTDTState
+	var statePtr *C.CoreMLTDTState
+	if state != nil {
+		cState = tdtStateC(state, &d.pinner)
+		statePtr = &cState
+	}
+	var numTokens C.int
+	var cErr C.CoreMLError
+	ok := C.coreml_tdt_decoder_decode(d.handle, encoder.handle, C.int(frames), statePtr,
+		(*C.int32_t)(unsafe.Pointer(&tokens[0])), C.int(len(tokens)), &numTokens, &cErr)
+	if !ok {
+		return nil, tdtDecodeError(&cErr)
+	}
+
+	if state != nil {
+		state.Primed = bool(cState.primed)
+		state.Frame = int(cState.frame)
+	}
+	return tokens[:int(numTokens)], nil
+}
+
+// Close releases the decoder's arrays and prepared calls.
+func (d *TDTDecoder) Close() {
+	if d.handle != nil {
+		C.coreml_tdt_decoder_free(d.handle)
+		d.handle = nil
+	}
+}
+
+// checkTDTConfig rejects configs the bridge decode loop cannot run.
+func checkTDTConfig(cfg TDTConfig) error {
+	if len(cfg.DurationBins) == 0 {
+		return fmt.Errorf("tdt decode: no duration bins")
+	}
+	if cfg.MaxSymbolsPerStep <= 0 {
+		return fmt.Errorf("tdt decode: max symbols per step must be positive")
+	}
+	return nil
+}
+
+// checkTDTTensor checks an encoder output tensor and optional state against cfg.
+func checkTDTTensor(encoder *Tensor, frames int, cfg TDTConfig, state *TDTState) error {
+	if encoder.Rank() != 3 || encoder.Dim(1) != int64(cfg.EncoderHidden) || encoder.Dim(2) < int64(frames) {
+		return fmt.Errorf("tdt decode: encoder output shape %v, need [1 %d >=%d]", encoder.Shape(), cfg.EncoderHidden, frames)
+	}
+	if dt := encoder.DType(); dt != DTypeFloat16 && dt != DTypeFloat32 {
+		return fmt.Errorf("tdt decode: encoder output dtype %d, need float16 or float32", dt)
+	}
+	if state != nil {
+		stateLen := cfg.LSTMLayers * cfg.DecoderHidden
+		if len(state.DecoderOut) != cfg.DecoderHidden || len(state.H) != stateLen || len(state.C) != stateLen {
+			return fmt.Errorf("tdt decode: state not sized for config")
+		}
+	}
+	return nil
+}
+
+// tdtConfigC marshals cfg for the bridge, pinning its duration bins.
+func tdtConfigC(cfg TDTConfig, pinner *runtime.Pinner) C.CoreMLTDTConfig {
+	pinner.Pin(&cfg.DurationBins[0])
+	return C.CoreMLTDTConfig{
+		encoder_hidden:       C.int(cfg.EncoderHidden),
+		decoder_hidden:       C.int(cfg.DecoderHidden),
+		lstm_layers:          C.int(cfg.LSTMLayers),
+		blank_id:             C.int(cfg.BlankID),
+		max_symbols_per_step: C.int(cfg.MaxSymbolsPerStep),
+		duration_bins:        (*C.int32_t)(unsafe.Pointer(&cfg.DurationBins[0])),
+		num_duration_bins:    C.int(len(cfg.DurationBins)),
+		joint_window:         C.int(cfg.JointWindow),
+	}
+}
+
+// tdtStateC marshals state for the bridge, pinning its buffers.
+func tdtStateC(state *TDTState, pinner *runtime.Pinner) C.CoreMLTDTState {
+	pinner.Pin(&state.DecoderOut[0])
+	pinner.Pin(&state.H[0])
+	pinner.Pin(&state.C[0])
+	return C.CoreMLTDTState{
+		decoder_out: (*C.float)(unsafe.Pointer(&state.DecoderOut[0])),
+		h:           (*C.float)(unsafe.Pointer(&state.H[0])),
+		c:           (*C.float)(unsafe.Pointer(&state.C[0])),
+		primed:      C.bool(state.Primed),
+		frame:       C.int(state.Frame),
+	}
+}
+
+// tdtDecodeError converts and frees a bridge decode error.
+func tdtDecodeError(err *C.CoreMLError) error {
+	msg := "unknown error"
+	if err.message != nil {
+		msg = C.GoString(err.message)
+		C.free(unsafe.Pointer(err.message))
+	}
+	return fmt.Errorf("tdt decode failed: %s", msg)
+}
+
+// PreparedCall is a prediction whose input/output names, input tensors and
+// output backings are bound once. Each Run reads the current contents of the
+// bound input tensors and writes into the bound outputs, with no per-call
+// name conversion or feature-provider allocation. Bound tensors must stay open
+// until the call is closed.
+type PreparedCall struct {
+	handle C.CoreMLPreparedCall
+}
+
+// Prepare binds names and tensors for repeated predictions on m.
+// Output tensors should match the model's declared output shapes and dtypes to
+// be used as backings; otherwise results are copied into them on each Run.
+func (m *Model) Prepare(inputNames []string, inputs []*Tensor, outputNames []string, outputs []*Tensor) (*PreparedCall, error) {
+	if len(inputNames) != len(inputs) {
+		return nil, fmt.Errorf("input names count (%d) != inputs count (%d)", len(inputNames), len(inputs))
+	}
+	if len(outputNames) != len(outputs) {
+		return nil, fmt.Errorf("output names count (%d) != outputs count (%d)", len(outputNames), len(outputs))
+	}
+
+	// Names are only needed while binding; the bridge keeps its own NSStrings
+	cInputNames := make([]*C.char, len(inputNames))
+	for i, name := range inputNames {
+		cInputNames[i] = C.CString(name)
+	}
+	cOutputNames := make([]*C.char, len(outputNames))
+	for i, name := range outputNames {
+		cOutputNames[i] = C.CString(name)
+	}
+	defer func() {
+		for _, name := range cInputNames {
+			C.free(unsafe.Pointer(name))
+		}
+		for _, name := range cOutputNames {
+			C.free(unsafe.Pointer(name))
+		}
+	}()
+
+	cInputs := make([]C.CoreMLTensor, len(inputs))
+	for i, t := range inputs {
+		cInputs[i] = t.handle
+	}
+	cOutputs := make([]C.CoreMLTensor, len(outputs))
+	for i, t := range outputs {
+		cOutputs[i] = t.handle
+	}
+
+	var cInputNamesPtr **C.char
+	var cInputsPtr *C.CoreMLTensor
+	if len(inputs) > 0 {
+		cInputNamesPtr = (**C.char)(unsafe.Pointer(&cInputNames[0]))
+		cInputsPtr = (*C.CoreMLTensor)(unsafe.Pointer(&cInputs[0]))
+	}
+
+	var cOutputNamesPtr **C.char
+	var cOutputsPtr *C.CoreMLTensor
+	if len(outputs) > 0 {
+		cOutputNamesPtr = (**C.char)(unsafe.Pointer(&cOutputNames[0]))
+		cOutputsPtr = (*C.CoreMLTensor)(unsafe.Pointer(&cOutputs[0]))
+	}
+
+	var err C.CoreMLError
+	handle := C.coreml_prepared_call_create(
+		m.handle,
+		cInputNamesPtr,
+		cInputsPtr,
+		C.int(len(inputs)),
+		cOutputNamesPtr,
+		cOutputsPtr,
+		C.int(len(outputs)),
+		&err,
+	)
+	if handle == nil {
+		msg := "unknown error"
+		if err.message != nil {
+			msg = C.GoString(err.message)
+			C.free(unsafe.Pointer(err.message))
+		}
+		return nil, fmt.Errorf("failed to prepare call: %s", msg)
+	}
+
+	return &PreparedCall{handle: handle}, nil
+}
+
+// Run executes the prepared prediction. honored has the same meaning as for PredictInto.
+func (c *PreparedCall) Run() (honored bool, err error) {
+	var cErr C.CoreMLError
+	var cHonored C.bool
+	if !C.coreml_prepared_call_run(c.handle, &cHonored, &cErr) {
+		msg := "unknown error"
+		if cErr.message != nil {
+			msg = C.GoString(cErr.message)
+			C.free(unsafe.Pointer(cErr.message))
+		}
+		return false, fmt.Errorf("prediction failed: %s", msg)
+	}
+	return bool(cHonored), nil
+}
+
+// Close releases the prepared call. Bound tensors are not closed.
+func (c *PreparedCall) Close() {
+	if c.handle != nil {
+		C.coreml_prepared_call_free(c.handle)
+		c.handle = nil
+	}
 }
@@ -29,6 +29,10 @@ typedef struct {
 // Returns path to compiled model, caller must free with free()
 char* coreml_compile_model(const char* package_path, const char* output_dir, CoreMLError* error);
 
+// Runtime identification for compiled-model cache keys (OS build, which pins the CoreML version)
+// Returns a description string, caller must free with free()
+char* coreml_runtime_version(void);
+
 // Model loading
 CoreMLModel coreml_load_model(const char* path, CoreMLError* error);
 void coreml_free_model(CoreMLModel model);
@@ -42,6 +46,10 @@ const char* coreml_model_output_name(CoreMLModel model, int index);
 // Tensor creation
 CoreMLTensor coreml_tensor_create(int64_t* shape, int rank, int dtype, CoreMLError* error);
 CoreMLTensor coreml_tensor_create_with_data(int64_t* shape, int rank, int dtype, void* data, CoreMLError* error);
+
+// Tensor view — wraps caller-owned memory without copying (row-major, contiguous).
+// The caller must keep data alive and pinned until coreml_tensor_free() is called.
+CoreMLTensor coreml_tensor_create_view(int64_t* shape, int rank, int dtype, void* data, CoreMLError* error);
 void coreml_tensor_free(CoreMLTensor tensor);
 
 // Tensor access
@@ -59,14 +67,124 @@ bool coreml_model_predict(CoreMLModel model,
                           const char** output_names, CoreMLTensor* outputs, int num_outputs,
                           CoreMLError* error);
 
+// Model execution — output backings (CoreML writes results directly into the caller's tensors)
+// honored: set to true when every output was written in place; false when at least one
+// backing was rejected and the bridge fell back to copying into it.
+bool coreml_model_predict_backed(CoreMLModel model,
+                                 const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                 const char** output_names, CoreMLTensor* outputs, int num_outputs,
+                                 bool* honored, CoreMLError* error);
+
+// Model execution — batched (one MLArrayBatchProvider dispatch for batch_size samples)
+// inputs: batch_size * num_inputs tensors, sample-major (sample b's inputs start at b * num_inputs)
+// outputs: batch_size * num_outputs caller-provided tensors, sample-major; results are copied in
+bool coreml_model_predict_batch(CoreMLModel model,
+                                const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                const char** output_names, CoreMLTensor* outputs, int num_outputs,
+                                int batch_size, CoreMLError* error);
+
 // Model execution — bridge-allocated outputs (bridge creates output tensors from results)
+// options: bitwise OR of CoreMLPredictOptions
 // output_names_out: array of num_outputs_out char* pointers (caller must free each with free())
 // outputs_out: array of num_outputs_out CoreMLTensor handles (caller must free each with coreml_tensor_free())
 bool coreml_model_predict_alloc(CoreMLModel model,
                                 const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                int options,
                                 char*** output_names_out, CoreMLTensor** outputs_out, int* num_outputs_out,
                                 CoreMLError* error);
 
+// Model execution — asynchronous, bridge-allocated outputs. Returns immediately;
+// done is called exactly once, on a CoreML or dispatch thread, with outputs owned
+// as for coreml_model_predict_alloc. On failure error.message must be freed.
+// Input tensors are retained until done; memory behind tensor views must stay valid.
+typedef void (*CoreMLPredictDone)(uintptr_t context, bool ok,
+                                  char** output_names, CoreMLTensor* outputs, int num_outputs,
+                                  CoreMLError error);
+
+void coreml_model_predict_async(CoreMLModel model,
+                                const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                int options, CoreMLPredictDone done, uintptr_t context);
+
+// Prepared prediction — names, input tensors and output backings are bound once;
+// each run only reads the current tensor contents. Bound tensors must outlive the call.
+typedef void* CoreMLPreparedCall;
+
+CoreMLPreparedCall coreml_prepared_call_create(CoreMLModel model,
+                                               const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                               const char** output_names, CoreMLTensor* outputs, int num_outputs,
+                                               CoreMLError* error);
+// honored: as for coreml_model_predict_backed
+bool coreml_prepared_call_run(CoreMLPreparedCall call, bool* honored, CoreMLError* error);
+void coreml_prepared_call_free(CoreMLPreparedCall call);
+
+// Native TDT greedy decode — runs the whole decoder/joint loop in Objective-C so an
+// utterance costs one cgo crossing instead of one per frame and emitted symbol.
+// Model I/O names follow Parakeet TDT: decoder (targets, target_length, h_in, c_in) →
+// (decoder, h_out, c_out); joint (encoder_step, decoder_step) → (token_id, duration).
+typedef struct {
+    int encoder_hidden;
+    int decoder_hidden;
+    int lstm_layers;
+    int blank_id;
+    int max_symbols_per_step;
+    const int32_t* duration_bins;
+    int num_duration_bins;
+    // Max encoder frames scored against one decoder output per joint batch.
+    // The window starts at 1 after each emitted token and doubles across runs
+    // of blanks; <= 1 scores one frame per joint call.
+    int joint_window;
+} CoreMLTDTConfig;
+
+// Decoder state carried between coreml_tdt_greedy_decode calls, so a stream can
+// be decoded chunk by chunk. All buffers are caller-owned.
+typedef struct {
+    float* decoder_out; // [decoder_hidden]: decoder output for the last emitted token
+    float* h;           // [lstm_layers * decoder_hidden]: LSTM hidden state
+    float* c;           // [lstm_layers * decoder_hidden]: LSTM cell state
+    bool primed;        // false: start from zero state and run the decoder on blank
+    int frame;          // in: first frame to decode; out: next frame (may be >= num_frames)
+} CoreMLTDTState;
+
+// encoder_out: [num_frames, encoder_hidden] row-major fp32.
+// tokens_out: caller buffer of max_tokens entries; num_tokens_out receives the count.
+// state: NULL decodes from a fresh state starting at frame 0; otherwise decoding
+// resumes from *state, which is updated on success.
+bool coreml_tdt_greedy_decode(CoreMLModel decoder, CoreMLModel joint,
+                              const float* encoder_out, int num_frames, const CoreMLTDTConfig* cfg,
+                              CoreMLTDTState* state,
+                              int32_t* tokens_out, int max_tokens, int* num_tokens_out,
+                              CoreMLError* error);
+
+// As coreml_tdt_greedy_decode, over an encoder output tensor [1, encoder_hidden,
+// >= num_frames] in its native layout (fp16 or fp32, any strides). Joint inputs are
+// views into the tensor, so the encoder output is never expanded or transposed.
+bool coreml_tdt_greedy_decode_tensor(CoreMLModel decoder, CoreMLModel joint,
+                                     CoreMLTensor encoder, int num_frames, const CoreMLTDTConfig* cfg,
+                                     CoreMLTDTState* state,
+                                     int32_t* tokens_out, int max_tokens, int* num_tokens_out,
+                                     CoreMLError* error);
+
+// Reusable native TDT decoder — the decode loop's inputs, output backings and
+// prepared calls are allocated once at create, so each decode only runs predictions.
+// cfg is copied. A decoder must not be used by two decodes at once.
+typedef void* CoreMLTDTDecoder;
+
+CoreMLTDTDecoder coreml_tdt_decoder_create(CoreMLModel decoder, CoreMLModel joint, const CoreMLTDTConfig* cfg,
+                                           CoreMLError* error);
+// As coreml_tdt_greedy_decode_tensor, with the decoder's models and config
+bool coreml_tdt_decoder_decode(CoreMLTDTDecoder ctx, CoreMLTensor encoder, int num_frames, CoreMLTDTState* state,
+                               int32_t* tokens_out, int max_tokens, int* num_tokens_out, CoreMLError* error);
+void coreml_tdt_decoder_free(CoreMLTDTDecoder ctx);
+
+// Output materialization options for coreml_model_predict_alloc.
+// Outputs are always returned contiguous (row-major); non-contiguous results are
+// copied block-wise. Caller-provided outputs (predict/predict_backed) instead follow
+// the destination tensor's dtype: an fp32 destination for an fp16 result is converted.
+typedef enum {
+    COREML_PREDICT_DEFAULT = 0,
+    COREML_PREDICT_FLOAT32 = 1 << 0 // convert fp16 outputs to fp32 in the bridge
+} CoreMLPredictOptions;
+
 // Compute unit configuration
 typedef enum {
     COREML_COMPUTE_ALL = 0,
@@ -77,6 +195,52 @@ typedef enum {
 
 void coreml_set_compute_units(CoreMLComputeUnits units);
 
+// Per-model load options (do not touch the global compute units setting)
+typedef struct {
+    CoreMLComputeUnits compute_units;
+    bool allow_low_precision_gpu;  // allow fp16 accumulation on the GPU
+    const char* metal_device;      // preferred Metal device name; NULL or "" for the default
+} CoreMLLoadOptions;
+
+CoreMLModel coreml_load_model_with_options(const char* path, const CoreMLLoadOptions* opts, CoreMLError* error);
+
+// Per-model statistics — accumulated by every prediction entry point since load.
+// Latencies are split into marshal (building providers/backings), predict (CoreML
+// execution) and copy_out (materializing results into caller tensors).
+#define COREML_STATS_BUCKETS 20
+
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[COREML_STATS_BUCKETS]; // bucket 0: < 1µs; bucket i: [2^(i-1), 2^i) µs; last is open-ended
+} CoreMLLatencyHistogram;
+
+typedef struct {
+    uint64_t predictions;         // successful prediction dispatches (a batch counts once)
+    uint64_t failures;            // dispatches that returned an error
+    CoreMLLatencyHistogram marshal;
+    CoreMLLatencyHistogram predict;
+    CoreMLLatencyHistogram copy_out;
+    uint64_t bytes_copied;        // bytes written by result copies
+    uint64_t strided_copies;      // result copies that had to walk non-contiguous strides
+    uint64_t backings_rejected;   // backed predictions where CoreML did not write in place
+    int compute_units;            // CoreMLComputeUnits the model was loaded with
+} CoreMLModelStats;
+
+// Returns false when model carries no statistics (e.g. not loaded through this bridge)
+bool coreml_model_stats(CoreMLModel model, CoreMLModelStats* out);
+
+// Compute plan summary — where CoreML intends to run each top-level ML program
+// operation (macOS 14.4+). Loading a plan re-plans the model, so this is expensive.
+typedef struct {
+    int cpu_ops;
+    int gpu_ops;
+    int ane_ops;
+} CoreMLComputePlanSummary;
+
+bool coreml_model_compute_plan(CoreMLModel model, CoreMLComputePlanSummary* out, CoreMLError* error);
+
 // Data types
 typedef enum {
     COREML_DTYPE_FLOAT32 = 0,
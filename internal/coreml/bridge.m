@@ -7,30 +7,32 @@
 
 #import <Foundation/Foundation.h>
 #import <CoreML/CoreML.h>
+#import <Accelerate/Accelerate.h>
+#import <Metal/Metal.h>
+#import <objc/runtime.h>
 #include "bridge.h"
+#include <stdatomic.h>
 #include <string.h>
+#include <time.h>
 
 // Global compute units setting
 static MLComputeUnits g_computeUnits = MLComputeUnitsAll;
 
-void coreml_set_compute_units(CoreMLComputeUnits units) {
+// Helper to convert compute units enum to MLComputeUnits
+static MLComputeUnits units_to_ml(CoreMLComputeUnits units) {
     switch (units) {
-        case COREML_COMPUTE_CPU_ONLY:
-            g_computeUnits = MLComputeUnitsCPUOnly;
-            break;
-        case COREML_COMPUTE_CPU_AND_GPU:
-            g_computeUnits = MLComputeUnitsCPUAndGPU;
-            break;
-        case COREML_COMPUTE_CPU_AND_ANE:
-            g_computeUnits = MLComputeUnitsCPUAndNeuralEngine;
-            break;
+        case COREML_COMPUTE_CPU_ONLY: return MLComputeUnitsCPUOnly;
+        case COREML_COMPUTE_CPU_AND_GPU: return MLComputeUnitsCPUAndGPU;
+        case COREML_COMPUTE_CPU_AND_ANE: return MLComputeUnitsCPUAndNeuralEngine;
         case COREML_COMPUTE_ALL:
-        default:
-            g_computeUnits = MLComputeUnitsAll;
-            break;
+        default: return MLComputeUnitsAll;
     }
 }
 
+void coreml_set_compute_units(CoreMLComputeUnits units) {
+    g_computeUnits = units_to_ml(units);
+}
+
 static void set_error(CoreMLError* error, int code, NSError* nsError) {
     if (error == NULL) return;
     error->code = code;
@@ -49,6 +51,93 @@ static void set_error(CoreMLError* error, int code, NSError* nsError) {
     }
 }
 
+static void set_error_message(CoreMLError* error, int code, const char* message) {
+    if (error == NULL) return;
+    error->code = code;
+    error->message = strdup(message);
+}
+
+typedef enum {
+    STATS_MARSHAL = 0,
+    STATS_PREDICT = 1,
+    STATS_COPY_OUT = 2
+} StatsStage;
+
+// Lock-free latency histogram; models may be predicted from several threads.
+typedef struct {
+    _Atomic uint64_t count;
+    _Atomic uint64_t total_ns;
+    _Atomic uint64_t max_ns;
+    _Atomic uint64_t buckets[COREML_STATS_BUCKETS];
+} LatencyCounters;
+
+// CoreMLModelStatsObject holds a model's counters and other per-model bridge
+// state (load URL, async queue). It is attached to the MLModel as an associated
+// object at load time, so CoreMLModel handles stay plain models.
+@interface CoreMLModelStatsObject : NSObject {
+@public
+    _Atomic uint64_t predictions;
+    _Atomic uint64_t failures;
+    LatencyCounters stages[3]; // indexed by StatsStage
+    _Atomic uint64_t bytesCopied;
+    _Atomic uint64_t stridedCopies;
+    _Atomic uint64_t backingsRejected;
+}
+@property (nonatomic, strong) NSURL* url;
+@property (nonatomic, strong) MLModelConfiguration* configuration;
+@property (nonatomic, strong) dispatch_queue_t queue; // async predictions before macOS 14
+@end
+
+@implementation CoreMLModelStatsObject
+@end
+
+static const char kCoreMLStatsKey = 0;
+
+static void attach_stats(MLModel* model, NSURL* url, MLModelConfiguration* config) {
+    CoreMLModelStatsObject* stats = [[CoreMLModelStatsObject alloc] init];
+    stats.url = url;
+    stats.configuration = config;
+    stats.queue = dispatch_queue_create("coreml.predict", DISPATCH_QUEUE_SERIAL);
+    objc_setAssociatedObject(model, &kCoreMLStatsKey, stats, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+}
+
+static CoreMLModelStatsObject* model_stats(MLModel* model) {
+    if (model == nil) return nil;
+    return objc_getAssociatedObject(model, &kCoreMLStatsKey);
+}
+
+static uint64_t now_ns(void) {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+static void record_latency(LatencyCounters* c, uint64_t ns) {
+    uint64_t us = ns / 1000;
+    int bucket = (us == 0) ? 0 : 64 - __builtin_clzll(us);
+    if (bucket >= COREML_STATS_BUCKETS) bucket = COREML_STATS_BUCKETS - 1;
+
+    atomic_fetch_add_explicit(&c->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->total_ns, ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->buckets[bucket], 1, memory_order_relaxed);
+    uint64_t prev = atomic_load_explicit(&c->max_ns, memory_order_relaxed);
+    while (ns > prev && !atomic_compare_exchange_weak_explicit(&c->max_ns, &prev, ns,
+                                                               memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+// Helper to record the stage that ran since *mark, then restart the mark.
+// All stats helpers accept nil stats (models created outside this bridge).
+static void stats_stage(CoreMLModelStatsObject* stats, StatsStage stage, uint64_t* mark) {
+    uint64_t now = now_ns();
+    if (stats != nil) record_latency(&stats->stages[stage], now - *mark);
+    *mark = now;
+}
+
+// Helper to count a finished dispatch
+static void stats_dispatch(CoreMLModelStatsObject* stats, bool ok) {
+    if (stats == nil) return;
+    atomic_fetch_add_explicit(ok ? &stats->predictions : &stats->failures, 1, memory_order_relaxed);
+}
+
 char* coreml_compile_model(const char* package_path, const char* output_dir, CoreMLError* error) {
     @autoreleasepool {
         NSString* nsPackagePath = [NSString stringWithUTF8String:package_path];
@@ -88,6 +177,13 @@ char* coreml_compile_model(const char* package_path, const char* output_dir, Cor
     }
 }
 
+char* coreml_runtime_version(void) {
+    @autoreleasepool {
+        NSString* version = [[NSProcessInfo processInfo] operatingSystemVersionString];
+        return strdup([version UTF8String]);
+    }
+}
+
 CoreMLModel coreml_load_model(const char* path, CoreMLError* error) {
     @autoreleasepool {
         NSString* nsPath = [NSString stringWithUTF8String:path];
@@ -104,6 +200,49 @@ CoreMLModel coreml_load_model(const char* path, CoreMLError* error) {
             set_error(error, 1, nsError);
             return NULL;
         }
+        attach_stats(model, url, config);
+
+        // Return retained model
+        return (__bridge_retained void*)model;
+    }
+}
+
+CoreMLModel coreml_load_model_with_options(const char* path, const CoreMLLoadOptions* opts, CoreMLError* error) {
+    @autoreleasepool {
+        NSString* nsPath = [NSString stringWithUTF8String:path];
+        NSURL* url = [NSURL fileURLWithPath:nsPath];
+
+        NSError* nsError = nil;
+
+        // Configure model from per-model options (independent of g_computeUnits)
+        MLModelConfiguration* config = [[MLModelConfiguration alloc] init];
+        config.computeUnits = units_to_ml(opts->compute_units);
+        config.allowLowPrecisionAccumulationOnGPU = opts->allow_low_precision_gpu;
+
+        if (opts->metal_device != NULL && strlen(opts->metal_device) > 0) {
+            NSString* wanted = [NSString stringWithUTF8String:opts->metal_device];
+            for (id<MTLDevice> device in MTLCopyAllDevices()) {
+                if ([device.name isEqualToString:wanted]) {
+                    config.preferredMetalDevice = device;
+                    break;
+                }
+            }
+            if (config.preferredMetalDevice == nil) {
+                NSString* msg = [NSString stringWithFormat:@"metal device %@ not found", wanted];
+                if (error != NULL) {
+                    error->code = 2;
+                    error->message = strdup([msg UTF8String]);
+                }
+                return NULL;
+            }
+        }
+
+        MLModel* model = [MLModel modelWithContentsOfURL:url configuration:config error:&nsError];
+        if (model == nil) {
+            set_error(error, 1, nsError);
+            return NULL;
+        }
+        attach_stats(model, url, config);
 
         // Return retained model
         return (__bridge_retained void*)model;
@@ -159,6 +298,11 @@ static MLMultiArrayDataType dtype_to_ml(int dtype) {
     }
 }
 
+// Helper to get the element size in bytes for a dtype enum
+static size_t dtype_elem_size(int dtype) {
+    return (dtype == COREML_DTYPE_FLOAT16) ? 2 : 4;
+}
+
 CoreMLTensor coreml_tensor_create(int64_t* shape, int rank, int dtype, CoreMLError* error) {
     @autoreleasepool {
         NSMutableArray<NSNumber*>* dims = [NSMutableArray arrayWithCapacity:rank];
@@ -191,7 +335,7 @@ CoreMLTensor coreml_tensor_create_with_data(int64_t* shape, int rank, int dtype,
         }
 
         // Copy data
-        size_t elemSize = (dtype == COREML_DTYPE_FLOAT16) ? 2 : 4;
+        size_t elemSize = dtype_elem_size(dtype);
         if (total > 0) {
             memcpy(array.dataPointer, data, total * elemSize);
         }
@@ -200,6 +344,44 @@ CoreMLTensor coreml_tensor_create_with_data(int64_t* shape, int rank, int dtype,
     return tensor;
 }
 
+CoreMLTensor coreml_tensor_create_view(int64_t* shape, int rank, int dtype, void* data, CoreMLError* error) {
+    @autoreleasepool {
+        if (data == NULL) {
+            if (error != NULL) {
+                error->code = 1;
+                error->message = strdup("tensor view requires a non-nil data pointer");
+            }
+            return NULL;
+        }
+
+        // Row-major strides (in elements) for the caller's contiguous buffer
+        NSMutableArray<NSNumber*>* dims = [NSMutableArray arrayWithCapacity:rank];
+        NSMutableArray<NSNumber*>* strides = [NSMutableArray arrayWithCapacity:rank];
+        int64_t stride = 1;
+        for (int i = rank - 1; i >= 0; i--) {
+            [dims insertObject:@(shape[i]) atIndex:0];
+            [strides insertObject:@(stride) atIndex:0];
+            stride *= shape[i];
+        }
+
+        // No deallocator: the memory belongs to the caller, who releases it after
+        // coreml_tensor_free() drops the bridge's reference to the array.
+        NSError* nsError = nil;
+        MLMultiArray* array = [[MLMultiArray alloc] initWithDataPointer:data
+                                                                  shape:dims
+                                                               dataType:dtype_to_ml(dtype)
+                                                                strides:strides
+                                                            deallocator:nil
+                                                                  error:&nsError];
+        if (array == nil) {
+            set_error(error, 1, nsError);
+            return NULL;
+        }
+
+        return (__bridge_retained void*)array;
+    }
+}
+
 void coreml_tensor_free(CoreMLTensor tensor) {
     if (tensor != NULL) {
         MLMultiArray* a = (__bridge_transfer MLMultiArray*)tensor;
@@ -282,6 +464,115 @@ int64_t coreml_tensor_size_bytes(CoreMLTensor tensor) {
     }
 }
 
+// Helper to build a feature provider from parallel input name/tensor arrays
+static MLDictionaryFeatureProvider* make_input_provider(const char** input_names, CoreMLTensor* inputs,
+                                                        int num_inputs, NSError** nsError) {
+    NSMutableDictionary<NSString*, MLFeatureValue*>* inputDict = [NSMutableDictionary dictionary];
+    for (int i = 0; i < num_inputs; i++) {
+        NSString* name = [NSString stringWithUTF8String:input_names[i]];
+        MLMultiArray* array = (__bridge MLMultiArray*)inputs[i];
+        MLFeatureValue* value = [MLFeatureValue featureValueWithMultiArray:array];
+        inputDict[name] = value;
+    }
+    return [[MLDictionaryFeatureProvider alloc] initWithDictionary:inputDict error:nsError];
+}
+
+// Below this many elements per contiguous block, a scalar loop beats a vImage call.
+#define COREML_VIMAGE_MIN_BLOCK 64
+
+// Helper to copy n contiguous elements, converting fp16 → fp32 when convert is set.
+// Large blocks go through vImage (NEON-backed), small ones through hardware __fp16 casts.
+static void copy_block(const uint8_t* src, uint8_t* dst, int64_t n, size_t srcElem, bool convert) {
+    if (!convert) {
+        memcpy(dst, src, n * srcElem);
+        return;
+    }
+    if (n >= COREML_VIMAGE_MIN_BLOCK) {
+        vImage_Buffer srcBuf = { .data = (void*)src, .height = 1, .width = (vImagePixelCount)n, .rowBytes = (size_t)n * 2 };
+        vImage_Buffer dstBuf = { .data = dst, .height = 1, .width = (vImagePixelCount)n, .rowBytes = (size_t)n * 4 };
+        vImageConvert_Planar16FtoPlanarF(&srcBuf, &dstBuf, kvImageNoFlags);
+        return;
+    }
+    const __fp16* s16 = (const __fp16*)src;
+    float* d32 = (float*)dst;
+    for (int64_t i = 0; i < n; i++) {
+        d32[i] = (float)s16[i];
+    }
+}
+
+// Helper to copy a result array into a row-major destination buffer of dstDType.
+// CoreML/ANE may return arrays with non-trivial strides, so we can't always just memcpy.
+// The trailing dimensions that are already contiguous are copied as whole blocks, and
+// the source offset of each block is advanced incrementally rather than recomputed.
+// fp16 results are converted to fp32 in the same pass when dstDType is COREML_DTYPE_FLOAT32.
+// Bytes written and strided walks are counted in stats when non-nil.
+static void copy_multiarray(MLMultiArray* resultArray, void* dstPtr, int dstDType, CoreMLModelStatsObject* stats) {
+    int rank = (int)[resultArray.shape count];
+    int64_t total = 1;
+    int64_t shape[rank > 0 ? rank : 1];
+    int64_t srcStrides[rank > 0 ? rank : 1];
+    for (int d = 0; d < rank; d++) {
+        shape[d] = [resultArray.shape[d] longLongValue];
+        srcStrides[d] = [resultArray.strides[d] longLongValue];
+        total *= shape[d];
+    }
+    if (total <= 0) return;
+
+    bool srcF16 = (resultArray.dataType == MLMultiArrayDataTypeFloat16);
+    bool convert = srcF16 && dstDType == COREML_DTYPE_FLOAT32;
+    size_t srcElem = srcF16 ? 2 : 4;
+    size_t dstElem = convert ? 4 : srcElem;
+
+    const uint8_t* src = (const uint8_t*)resultArray.dataPointer;
+    uint8_t* dst = (uint8_t*)dstPtr;
+    if (stats != nil) {
+        atomic_fetch_add_explicit(&stats->bytesCopied, (uint64_t)(total * dstElem), memory_order_relaxed);
+    }
+
+    // Find the longest row-major contiguous suffix of dimensions: those form one block
+    int64_t blockLen = 1;
+    int outerRank = rank;
+    while (outerRank > 0 && srcStrides[outerRank - 1] == blockLen) {
+        blockLen *= shape[outerRank - 1];
+        outerRank--;
+    }
+
+    if (outerRank == 0) {
+        copy_block(src, dst, total, srcElem, convert);
+        return;
+    }
+
+    // Walk the outer dimensions, copying one contiguous block per index
+    if (stats != nil) atomic_fetch_add_explicit(&stats->stridedCopies, 1, memory_order_relaxed);
+    int64_t indices[outerRank];
+    memset(indices, 0, sizeof(indices));
+    int64_t blocks = total / blockLen;
+    int64_t srcOffset = 0;
+
+    for (int64_t blk = 0; blk < blocks; blk++) {
+        copy_block(src + srcOffset * srcElem, dst + blk * blockLen * dstElem, blockLen, srcElem, convert);
+
+        // Increment multi-dimensional index (last outer dimension first)
+        for (int d = outerRank - 1; d >= 0; d--) {
+            indices[d]++;
+            srcOffset += srcStrides[d];
+            if (indices[d] < shape[d]) break;
+            srcOffset -= indices[d] * srcStrides[d];
+            indices[d] = 0;
+        }
+    }
+}
+
+// Helper to convert MLMultiArrayDataType to our dtype enum
+static int ml_to_dtype(MLMultiArrayDataType dataType) {
+    switch (dataType) {
+        case MLMultiArrayDataTypeFloat16: return COREML_DTYPE_FLOAT16;
+        case MLMultiArrayDataTypeFloat32: return COREML_DTYPE_FLOAT32;
+        case MLMultiArrayDataTypeInt32:   return COREML_DTYPE_INT32;
+        default: return COREML_DTYPE_FLOAT32;
+    }
+}
+
 bool coreml_model_predict(CoreMLModel model,
                           const char** input_names, CoreMLTensor* inputs, int num_inputs,
                           const char** output_names, CoreMLTensor* outputs, int num_outputs,
@@ -289,29 +580,28 @@ bool coreml_model_predict(CoreMLModel model,
     @autoreleasepool {
         MLModel* m = (__bridge MLModel*)model;
 
-        // Build input dictionary
-        NSMutableDictionary<NSString*, MLFeatureValue*>* inputDict = [NSMutableDictionary dictionary];
-        for (int i = 0; i < num_inputs; i++) {
-            NSString* name = [NSString stringWithUTF8String:input_names[i]];
-            MLMultiArray* array = (__bridge MLMultiArray*)inputs[i];
-            MLFeatureValue* value = [MLFeatureValue featureValueWithMultiArray:array];
-            inputDict[name] = value;
-        }
+        CoreMLModelStatsObject* stats = model_stats(m);
+        uint64_t mark = now_ns();
 
         // Create input provider
         NSError* nsError = nil;
-        MLDictionaryFeatureProvider* provider = [[MLDictionaryFeatureProvider alloc] initWithDictionary:inputDict error:&nsError];
+        MLDictionaryFeatureProvider* provider = make_input_provider(input_names, inputs, num_inputs, &nsError);
         if (provider == nil) {
             set_error(error, 1, nsError);
+            stats_dispatch(stats, false);
             return false;
         }
 
+        stats_stage(stats, STATS_MARSHAL, &mark);
+
         // Run prediction
         id<MLFeatureProvider> result = [m predictionFromFeatures:provider error:&nsError];
         if (result == nil) {
             set_error(error, 2, nsError);
+            stats_dispatch(stats, false);
             return false;
         }
+        stats_stage(stats, STATS_PREDICT, &mark);
 
         // Extract outputs
         for (int i = 0; i < num_outputs; i++) {
@@ -319,231 +609,1050 @@ bool coreml_model_predict(CoreMLModel model,
             MLFeatureValue* value = [result featureValueForName:name];
             if (value == nil || value.multiArrayValue == nil) {
                 set_error(error, 3, nil);
+                stats_dispatch(stats, false);
                 return false;
             }
 
             // Copy output data to provided tensor — stride-aware for non-contiguous MLMultiArray outputs
             MLMultiArray* outArray = (__bridge MLMultiArray*)outputs[i];
-            MLMultiArray* resultArray = value.multiArrayValue;
-
-            int rank = (int)[resultArray.shape count];
-            int64_t total = 1;
-            int64_t shape[rank > 0 ? rank : 1];
-            for (int d = 0; d < rank; d++) {
-                shape[d] = [resultArray.shape[d] longLongValue];
-                total *= shape[d];
-            }
+            copy_multiarray(value.multiArrayValue, outArray.dataPointer, ml_to_dtype(outArray.dataType), stats);
+        }
+        stats_stage(stats, STATS_COPY_OUT, &mark);
+        stats_dispatch(stats, true);
 
-            size_t elemSize = (resultArray.dataType == MLMultiArrayDataTypeFloat16) ? 2 : 4;
-            if (total > 0) {
-                // Check if result array is contiguous (row-major)
-                bool contiguous = true;
-                int64_t expected = 1;
-                for (int d = rank - 1; d >= 0; d--) {
-                    int64_t stride = [resultArray.strides[d] longLongValue];
-                    if (stride != expected) {
-                        contiguous = false;
-                        break;
-                    }
-                    expected *= shape[d];
-                }
+        return true;
+    }
+}
 
-                if (contiguous) {
-                    memcpy(outArray.dataPointer, resultArray.dataPointer, total * elemSize);
-                } else {
-                    // Stride-aware element-by-element copy
-                    const uint8_t* src = (const uint8_t*)resultArray.dataPointer;
-                    uint8_t* dst = (uint8_t*)outArray.dataPointer;
+// Helper to build the output backings dictionary for names/outputs.
+// Only backings whose dtype and declared shape match the model output are registered;
+// the rest (e.g. fp32 buffers for fp16 outputs) are filled by a converting copy.
+static NSDictionary<NSString*, id>* make_backings(MLModel* m, NSArray<NSString*>* names, NSArray<MLMultiArray*>* outputs) {
+    NSDictionary<NSString*, MLFeatureDescription*>* outputDescs = [m modelDescription].outputDescriptionsByName;
+    NSMutableDictionary<NSString*, id>* backings = [NSMutableDictionary dictionaryWithCapacity:[names count]];
+    for (NSUInteger i = 0; i < [names count]; i++) {
+        MLMultiArrayConstraint* constraint = outputDescs[names[i]].multiArrayConstraint;
+        if (constraint == nil || constraint.dataType != outputs[i].dataType) continue;
+        if ([constraint.shape count] > 0 && ![constraint.shape isEqualToArray:outputs[i].shape]) continue;
+        backings[names[i]] = outputs[i];
+    }
+    return backings;
+}
 
-                    int64_t srcStrides[rank];
-                    for (int d = 0; d < rank; d++) {
-                        srcStrides[d] = [resultArray.strides[d] longLongValue];
-                    }
+// Helper to run a prediction with outputs bound to caller arrays.
+// Runs with options carrying backings when available; if CoreML rejects them
+// (shape/dtype mismatch, unsupported OS), retries without them. Any output that
+// did not land in its backing is copied in, and *honored reports whether all did.
+// Predict and copy-out time are recorded here; callers record their own marshal stage
+// ending at *mark.
+static bool run_with_backings(MLModel* m, id<MLFeatureProvider> provider, MLPredictionOptions* options,
+                              NSArray<NSString*>* names, NSArray<MLMultiArray*>* outputs,
+                              uint64_t* mark, bool* honored, CoreMLError* error) {
+    CoreMLModelStatsObject* stats = model_stats(m);
+    NSError* nsError = nil;
+    id<MLFeatureProvider> result = nil;
+    if (options != nil) {
+        result = [m predictionFromFeatures:provider options:options error:&nsError];
+    }
+    if (result == nil) {
+        nsError = nil;
+        result = [m predictionFromFeatures:provider error:&nsError];
+    }
+    if (result == nil) {
+        set_error(error, 2, nsError);
+        stats_dispatch(stats, false);
+        return false;
+    }
+    stats_stage(stats, STATS_PREDICT, mark);
+
+    // Verify each output landed in its backing; copy any that did not
+    bool allHonored = (options != nil);
+    for (NSUInteger i = 0; i < [names count]; i++) {
+        MLFeatureValue* value = [result featureValueForName:names[i]];
+        if (value == nil || value.multiArrayValue == nil) {
+            set_error(error, 3, nil);
+            stats_dispatch(stats, false);
+            return false;
+        }
 
-                    int64_t indices[rank > 0 ? rank : 1];
-                    memset(indices, 0, sizeof(indices));
+        MLMultiArray* outArray = outputs[i];
+        MLMultiArray* resultArray = value.multiArrayValue;
+        if (resultArray.dataPointer != outArray.dataPointer) {
+            allHonored = false;
+            copy_multiarray(resultArray, outArray.dataPointer, ml_to_dtype(outArray.dataType), stats);
+        }
+    }
+    stats_stage(stats, STATS_COPY_OUT, mark);
+    stats_dispatch(stats, true);
+    if (!allHonored && stats != nil) {
+        atomic_fetch_add_explicit(&stats->backingsRejected, 1, memory_order_relaxed);
+    }
 
-                    for (int64_t flat = 0; flat < total; flat++) {
-                        int64_t srcOffset = 0;
-                        for (int d = 0; d < rank; d++) {
-                            srcOffset += indices[d] * srcStrides[d];
-                        }
+    if (honored != NULL) *honored = allHonored;
+    return true;
+}
 
-                        memcpy(dst + flat * elemSize, src + srcOffset * elemSize, elemSize);
+bool coreml_model_predict_backed(CoreMLModel model,
+                                 const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                 const char** output_names, CoreMLTensor* outputs, int num_outputs,
+                                 bool* honored, CoreMLError* error) {
+    @autoreleasepool {
+        MLModel* m = (__bridge MLModel*)model;
+        if (honored != NULL) *honored = false;
 
-                        for (int d = rank - 1; d >= 0; d--) {
-                            indices[d]++;
-                            if (indices[d] < shape[d]) break;
-                            indices[d] = 0;
-                        }
-                    }
+        CoreMLModelStatsObject* stats = model_stats(m);
+        uint64_t mark = now_ns();
+
+        // Create input provider
+        NSError* nsError = nil;
+        MLDictionaryFeatureProvider* provider = make_input_provider(input_names, inputs, num_inputs, &nsError);
+        if (provider == nil) {
+            set_error(error, 1, nsError);
+            stats_dispatch(stats, false);
+            return false;
+        }
+
+        NSMutableArray<NSString*>* names = [NSMutableArray arrayWithCapacity:num_outputs];
+        NSMutableArray<MLMultiArray*>* arrays = [NSMutableArray arrayWithCapacity:num_outputs];
+        for (int i = 0; i < num_outputs; i++) {
+            [names addObject:[NSString stringWithUTF8String:output_names[i]]];
+            [arrays addObject:(__bridge MLMultiArray*)outputs[i]];
+        }
+
+        // Register our tensors as output backings, so CoreML writes results
+        // straight into caller memory.
+        MLPredictionOptions* options = nil;
+        if (@available(macOS 13.0, *)) {
+            options = [[MLPredictionOptions alloc] init];
+            options.outputBackings = make_backings(m, names, arrays);
+        }
+
+        stats_stage(stats, STATS_MARSHAL, &mark);
+
+        return run_with_backings(m, provider, options, names, arrays, &mark, honored, error);
+    }
+}
+
+bool coreml_model_predict_batch(CoreMLModel model,
+                                const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                const char** output_names, CoreMLTensor* outputs, int num_outputs,
+                                int batch_size, CoreMLError* error) {
+    @autoreleasepool {
+        MLModel* m = (__bridge MLModel*)model;
+        CoreMLModelStatsObject* stats = model_stats(m);
+        uint64_t mark = now_ns();
+
+        // One feature provider per sample; inputs are sample-major
+        NSError* nsError = nil;
+        NSMutableArray<id<MLFeatureProvider>>* providers = [NSMutableArray arrayWithCapacity:batch_size];
+        for (int b = 0; b < batch_size; b++) {
+            MLDictionaryFeatureProvider* provider =
+                make_input_provider(input_names, inputs + (int64_t)b * num_inputs, num_inputs, &nsError);
+            if (provider == nil) {
+                set_error(error, 1, nsError);
+                stats_dispatch(stats, false);
+                return false;
+            }
+            [providers addObject:provider];
+        }
+
+        MLArrayBatchProvider* batch = [[MLArrayBatchProvider alloc] initWithFeatureProviderArray:providers];
+        stats_stage(stats, STATS_MARSHAL, &mark);
+
+        // Run all samples in one dispatch
+        id<MLBatchProvider> results = [m predictionsFromBatch:batch error:&nsError];
+        if (results == nil) {
+            set_error(error, 2, nsError);
+            stats_dispatch(stats, false);
+            return false;
+        }
+        if (results.count != batch_size) {
+            set_error(error, 3, nil);
+            stats_dispatch(stats, false);
+            return false;
+        }
+        stats_stage(stats, STATS_PREDICT, &mark);
+
+        NSMutableArray<NSString*>* names = [NSMutableArray arrayWithCapacity:num_outputs];
+        for (int i = 0; i < num_outputs; i++) {
+            [names addObject:[NSString stringWithUTF8String:output_names[i]]];
+        }
+
+        // Extract outputs — stride-aware copy into the caller's sample-major tensors
+        for (int b = 0; b < batch_size; b++) {
+            id<MLFeatureProvider> result = [results featuresAtIndex:b];
+            for (int i = 0; i < num_outputs; i++) {
+                MLFeatureValue* value = [result featureValueForName:names[i]];
+                if (value == nil || value.multiArrayValue == nil) {
+                    set_error(error, 3, nil);
+                    stats_dispatch(stats, false);
+                    return false;
                 }
+                MLMultiArray* outArray = (__bridge MLMultiArray*)outputs[(int64_t)b * num_outputs + i];
+                copy_multiarray(value.multiArrayValue, outArray.dataPointer, ml_to_dtype(outArray.dataType), stats);
             }
         }
+        stats_stage(stats, STATS_COPY_OUT, &mark);
+        stats_dispatch(stats, true);
 
         return true;
     }
 }
 
+// Helper to materialize every result feature as a new contiguous bridge-allocated
+// tensor, sorted by name. On failure nothing is left allocated.
+static bool materialize_outputs(id<MLFeatureProvider> result, int options, CoreMLModelStatsObject* stats,
+                                char*** output_names_out, CoreMLTensor** outputs_out, int* num_outputs_out,
+                                CoreMLError* error) {
+    // Collect output names sorted for deterministic order
+    NSArray<NSString*>* names = [[[result featureNames] allObjects] sortedArrayUsingSelector:@selector(compare:)];
+    int numOutputs = (int)[names count];
+    *num_outputs_out = numOutputs;
+
+    // Allocate arrays for output names and tensors
+    *output_names_out = (char**)malloc(numOutputs * sizeof(char*));
+    *outputs_out = (CoreMLTensor*)malloc(numOutputs * sizeof(CoreMLTensor));
+
+    for (int i = 0; i < numOutputs; i++) {
+        NSString* name = names[i];
+        (*output_names_out)[i] = strdup([name UTF8String]);
+
+        MLFeatureValue* value = [result featureValueForName:name];
+        if (value == nil || value.multiArrayValue == nil) {
+            // Clean up already allocated entries
+            for (int j = 0; j < i; j++) {
+                free((*output_names_out)[j]);
+                coreml_tensor_free((*outputs_out)[j]);
+            }
+            free(*output_names_out);
+            free(*outputs_out);
+            *output_names_out = NULL;
+            *outputs_out = NULL;
+            *num_outputs_out = 0;
+            set_error(error, 3, nil);
+            return false;
+        }
+
+        MLMultiArray* resultArray = value.multiArrayValue;
+
+        // Create a new tensor with the result's actual shape
+        int rank = (int)[resultArray.shape count];
+        int64_t shape[rank];
+        for (int d = 0; d < rank; d++) {
+            shape[d] = [resultArray.shape[d] longLongValue];
+        }
+
+        // Convert MLMultiArrayDataType to our dtype enum; fp16 is widened on request
+        int dtype = ml_to_dtype(resultArray.dataType);
+        if (dtype == COREML_DTYPE_FLOAT16 && (options & COREML_PREDICT_FLOAT32)) {
+            dtype = COREML_DTYPE_FLOAT32;
+        }
+
+        CoreMLError tensorError = {0, NULL};
+        CoreMLTensor tensor = coreml_tensor_create(shape, rank, dtype, &tensorError);
+        if (tensor == NULL) {
+            for (int j = 0; j < i; j++) {
+                free((*output_names_out)[j]);
+                coreml_tensor_free((*outputs_out)[j]);
+            }
+            free((*output_names_out)[i]);
+            free(*output_names_out);
+            free(*outputs_out);
+            *output_names_out = NULL;
+            *outputs_out = NULL;
+            *num_outputs_out = 0;
+            if (tensorError.message) {
+                set_error(error, 4, nil);
+                error->message = tensorError.message;
+            } else {
+                set_error(error, 4, nil);
+            }
+            return false;
+        }
+
+        // Copy data — stride-aware for non-contiguous MLMultiArray outputs.
+        MLMultiArray* outArray = (__bridge MLMultiArray*)tensor;
+        copy_multiarray(resultArray, outArray.dataPointer, dtype, stats);
+
+        (*outputs_out)[i] = tensor;
+    }
+
+    return true;
+}
+
 bool coreml_model_predict_alloc(CoreMLModel model,
                                 const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                int options,
                                 char*** output_names_out, CoreMLTensor** outputs_out, int* num_outputs_out,
                                 CoreMLError* error) {
     @autoreleasepool {
         MLModel* m = (__bridge MLModel*)model;
 
-        // Build input dictionary
-        NSMutableDictionary<NSString*, MLFeatureValue*>* inputDict = [NSMutableDictionary dictionary];
-        for (int i = 0; i < num_inputs; i++) {
-            NSString* name = [NSString stringWithUTF8String:input_names[i]];
-            MLMultiArray* array = (__bridge MLMultiArray*)inputs[i];
-            MLFeatureValue* value = [MLFeatureValue featureValueWithMultiArray:array];
-            inputDict[name] = value;
-        }
+        CoreMLModelStatsObject* stats = model_stats(m);
+        uint64_t mark = now_ns();
 
         // Create input provider
         NSError* nsError = nil;
-        MLDictionaryFeatureProvider* provider = [[MLDictionaryFeatureProvider alloc] initWithDictionary:inputDict error:&nsError];
+        MLDictionaryFeatureProvider* provider = make_input_provider(input_names, inputs, num_inputs, &nsError);
         if (provider == nil) {
             set_error(error, 1, nsError);
+            stats_dispatch(stats, false);
             return false;
         }
 
+        stats_stage(stats, STATS_MARSHAL, &mark);
+
         // Run prediction
         id<MLFeatureProvider> result = [m predictionFromFeatures:provider error:&nsError];
         if (result == nil) {
             set_error(error, 2, nsError);
+            stats_dispatch(stats, false);
             return false;
         }
+        stats_stage(stats, STATS_PREDICT, &mark);
 
-        // Collect output names sorted for deterministic order
-        NSArray<NSString*>* names = [[[result featureNames] allObjects] sortedArrayUsingSelector:@selector(compare:)];
-        int numOutputs = (int)[names count];
-        *num_outputs_out = numOutputs;
+        if (!materialize_outputs(result, options, stats, output_names_out, outputs_out, num_outputs_out, error)) {
+            stats_dispatch(stats, false);
+            return false;
+        }
+        stats_stage(stats, STATS_COPY_OUT, &mark);
+        stats_dispatch(stats, true);
 
-        // Allocate arrays for output names and tensors
-        *output_names_out = (char**)malloc(numOutputs * sizeof(char*));
-        *outputs_out = (CoreMLTensor*)malloc(numOutputs * sizeof(CoreMLTensor));
+        return true;
+    }
+}
 
-        for (int i = 0; i < numOutputs; i++) {
-            NSString* name = names[i];
-            (*output_names_out)[i] = strdup([name UTF8String]);
+void coreml_model_predict_async(CoreMLModel model,
+                                const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                int options, CoreMLPredictDone done, uintptr_t context) {
+    @autoreleasepool {
+        MLModel* m = (__bridge MLModel*)model;
+        CoreMLModelStatsObject* stats = model_stats(m);
+        __block uint64_t mark = now_ns();
+        if (m == nil) {
+            CoreMLError error = {0, NULL};
+            set_error_message(&error, 1, "async prediction requires a model");
+            done(context, false, NULL, NULL, 0, error);
+            return;
+        }
 
-            MLFeatureValue* value = [result featureValueForName:name];
-            if (value == nil || value.multiArrayValue == nil) {
-                // Clean up already allocated entries
-                for (int j = 0; j < i; j++) {
-                    free((*output_names_out)[j]);
-                    coreml_tensor_free((*outputs_out)[j]);
+        // Build the provider now; it retains the input arrays until completion
+        NSError* nsError = nil;
+        MLDictionaryFeatureProvider* provider = make_input_provider(input_names, inputs, num_inputs, &nsError);
+        if (provider == nil) {
+            CoreMLError error = {0, NULL};
+            set_error(&error, 1, nsError);
+            stats_dispatch(stats, false);
+            done(context, false, NULL, NULL, 0, error);
+            return;
+        }
+        stats_stage(stats, STATS_MARSHAL, &mark);
+
+        // Materializes the result and hands it to done; predict time includes queueing
+        void (^finish)(id<MLFeatureProvider>, NSError*) = ^(id<MLFeatureProvider> result, NSError* resultError) {
+            @autoreleasepool {
+                CoreMLError error = {0, NULL};
+                char** names = NULL;
+                CoreMLTensor* outputs = NULL;
+                int numOutputs = 0;
+                bool ok = false;
+                if (result == nil) {
+                    set_error(&error, 2, resultError);
+                } else {
+                    stats_stage(stats, STATS_PREDICT, &mark);
+                    ok = materialize_outputs(result, options, stats, &names, &outputs, &numOutputs, &error);
+                    if (ok) stats_stage(stats, STATS_COPY_OUT, &mark);
                 }
-                free(*output_names_out);
-                free(*outputs_out);
-                *output_names_out = NULL;
-                *outputs_out = NULL;
-                *num_outputs_out = 0;
-                set_error(error, 3, nil);
-                return false;
+                stats_dispatch(stats, ok);
+                done(context, ok, names, outputs, numOutputs, error);
             }
+        };
+
+        if (@available(macOS 14.0, *)) {
+            [m predictionFromFeatures:provider
+                              options:[[MLPredictionOptions alloc] init]
+                    completionHandler:finish];
+        } else {
+            // Serial per model: older CoreML does not promise concurrent predictions are safe
+            dispatch_async(stats != nil ? stats.queue : dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+                NSError* predictError = nil;
+                id<MLFeatureProvider> result = [m predictionFromFeatures:provider error:&predictError];
+                finish(result, predictError);
+            });
+        }
+    }
+}
+
+// CoreMLBoundFeatureProvider serves a fixed set of feature values. The wrapped
+// arrays are bound once; callers rewrite their contents between predictions,
+// so no dictionary, NSString or MLFeatureValue is created per call.
+@interface CoreMLBoundFeatureProvider : NSObject <MLFeatureProvider>
+- (instancetype)initWithValues:(NSDictionary<NSString*, MLFeatureValue*>*)values;
+@end
+
+@implementation CoreMLBoundFeatureProvider {
+    NSDictionary<NSString*, MLFeatureValue*>* _values;
+    NSSet<NSString*>* _names;
+}
+
+- (instancetype)initWithValues:(NSDictionary<NSString*, MLFeatureValue*>*)values {
+    self = [super init];
+    if (self) {
+        _values = [values copy];
+        _names = [NSSet setWithArray:[_values allKeys]];
+    }
+    return self;
+}
+
+- (NSSet<NSString*>*)featureNames {
+    return _names;
+}
+
+- (MLFeatureValue*)featureValueForName:(NSString*)featureName {
+    return _values[featureName];
+}
+@end
+
+// CoreMLPreparedCallObject is the object behind a CoreMLPreparedCall handle:
+// a model plus bound inputs, output names and output backings.
+@interface CoreMLPreparedCallObject : NSObject
+@property (nonatomic, strong) MLModel* model;
+@property (nonatomic, strong) CoreMLBoundFeatureProvider* provider;
+@property (nonatomic, strong) NSArray<NSString*>* outputNames;
+@property (nonatomic, strong) NSArray<MLMultiArray*>* outputs;
+@property (nonatomic, strong) NSDictionary<NSString*, id>* backings;
+@property (nonatomic, strong) MLPredictionOptions* options;
+@end
+
+@implementation CoreMLPreparedCallObject
+@end
+
+static CoreMLPreparedCallObject* make_prepared_call(MLModel* m,
+                                                    NSArray<NSString*>* inputNames, NSArray<MLMultiArray*>* inputs,
+                                                    NSArray<NSString*>* outputNames, NSArray<MLMultiArray*>* outputs) {
+    NSMutableDictionary<NSString*, MLFeatureValue*>* values = [NSMutableDictionary dictionaryWithCapacity:[inputNames count]];
+    for (NSUInteger i = 0; i < [inputNames count]; i++) {
+        values[inputNames[i]] = [MLFeatureValue featureValueWithMultiArray:inputs[i]];
+    }
+
+    CoreMLPreparedCallObject* call = [[CoreMLPreparedCallObject alloc] init];
+    call.model = m;
+    call.provider = [[CoreMLBoundFeatureProvider alloc] initWithValues:values];
+    call.outputNames = outputNames;
+    call.outputs = outputs;
+    if (@available(macOS 13.0, *)) {
+        call.backings = make_backings(m, outputNames, outputs);
+        call.options = [[MLPredictionOptions alloc] init];
+    }
+    return call;
+}
+
+// Helper to run a prepared call's model, names and backings on another provider
+static bool run_prepared_call_with(CoreMLPreparedCallObject* call, id<MLFeatureProvider> provider,
+                                   bool* honored, CoreMLError* error) {
+    @autoreleasepool {
+        uint64_t mark = now_ns();
+        if (@available(macOS 13.0, *)) {
+            // Re-arm the backings each run; a prediction consumes them
+            call.options.outputBackings = call.backings;
+        }
+        stats_stage(model_stats(call.model), STATS_MARSHAL, &mark);
+        return run_with_backings(call.model, provider, call.options,
+                                 call.outputNames, call.outputs, &mark, honored, error);
+    }
+}
+
+static bool run_prepared_call(CoreMLPreparedCallObject* call, bool* honored, CoreMLError* error) {
+    return run_prepared_call_with(call, call.provider, honored, error);
+}
+
+CoreMLPreparedCall coreml_prepared_call_create(CoreMLModel model,
+                                               const char** input_names, CoreMLTensor* inputs, int num_inputs,
+                                               const char** output_names, CoreMLTensor* outputs, int num_outputs,
+                                               CoreMLError* error) {
+    @autoreleasepool {
+        MLModel* m = (__bridge MLModel*)model;
+        if (m == nil) {
+            set_error_message(error, 1, "prepared call requires a model");
+            return NULL;
+        }
+
+        NSMutableArray<NSString*>* inNames = [NSMutableArray arrayWithCapacity:num_inputs];
+        NSMutableArray<MLMultiArray*>* inArrays = [NSMutableArray arrayWithCapacity:num_inputs];
+        for (int i = 0; i < num_inputs; i++) {
+            [inNames addObject:[NSString stringWithUTF8String:input_names[i]]];
+            [inArrays addObject:(__bridge MLMultiArray*)inputs[i]];
+        }
+        NSMutableArray<NSString*>* outNames = [NSMutableArray arrayWithCapacity:num_outputs];
+        NSMutableArray<MLMultiArray*>* outArrays = [NSMutableArray arrayWithCapacity:num_outputs];
+        for (int i = 0; i < num_outputs; i++) {
+            [outNames addObject:[NSString stringWithUTF8String:output_names[i]]];
+            [outArrays addObject:(__bridge MLMultiArray*)outputs[i]];
+        }
+
+        CoreMLPreparedCallObject* call = make_prepared_call(m, inNames, inArrays, outNames, outArrays);
+        return (__bridge_retained void*)call;
+    }
+}
+
+bool coreml_prepared_call_run(CoreMLPreparedCall call, bool* honored, CoreMLError* error) {
+    if (honored != NULL) *honored = false;
+    return run_prepared_call((__bridge CoreMLPreparedCallObject*)call, honored, error);
+}
+
+void coreml_prepared_call_free(CoreMLPreparedCall call) {
+    if (call != NULL) {
+        CoreMLPreparedCallObject* c = (__bridge_transfer CoreMLPreparedCallObject*)call;
+        (void)c; // ARC will release
+    }
+}
+
+// Helper to allocate an array matching a model output's declared shape and dtype
+static MLMultiArray* make_output_array(MLModel* m, NSString* name, NSError** nsError) {
+    MLMultiArrayConstraint* constraint = [m modelDescription].outputDescriptionsByName[name].multiArrayConstraint;
+    if (constraint == nil) return nil;
+    return [[MLMultiArray alloc] initWithShape:constraint.shape dataType:constraint.dataType error:nsError];
+}
+
+// Helper to copy one array into a caller-owned fp32 array, checking the element count
+static bool copy_array_f32(MLMultiArray* src, MLMultiArray* dst, CoreMLModelStatsObject* stats) {
+    if (src.count != dst.count) return false;
+    copy_multiarray(src, dst.dataPointer, COREML_DTYPE_FLOAT32, stats);
+    return true;
+}
+
+// CoreMLTDTDecoderObject is the object behind a CoreMLTDTDecoder handle: the
+// decoder and joint models plus every input, output backing and prepared call
+// of the decode loop. They are allocated once; each decode rewrites their contents.
+@interface CoreMLTDTDecoderObject : NSObject
+@property (nonatomic) CoreMLTDTConfig cfg; // duration_bins points into durationBins
+@property (nonatomic, strong) NSData* durationBins;
+@property (nonatomic, strong) MLModel* decoder;
+@property (nonatomic, strong) MLModel* joint;
+@property (nonatomic, strong) MLMultiArrayConstraint* encConstraint; // joint encoder_step
+@property (nonatomic, strong) MLMultiArray* targets;
+@property (nonatomic, strong) MLMultiArray* hIn;
+@property (nonatomic, strong) MLMultiArray* cIn;
+@property (nonatomic, strong) MLMultiArray* encStep;
+@property (nonatomic, strong) MLMultiArray* decStep;
+@property (nonatomic, strong) MLMultiArray* decOut;
+@property (nonatomic, strong) MLMultiArray* hOut;
+@property (nonatomic, strong) MLMultiArray* cOut;
+@property (nonatomic, strong) MLMultiArray* tokenOut;
+@property (nonatomic, strong) MLMultiArray* durOut;
+@property (nonatomic, strong) CoreMLPreparedCallObject* decCall;
+@property (nonatomic, strong) CoreMLPreparedCallObject* jointCall;
+@property (nonatomic, strong) MLFeatureValue* decValue;
+// fp32 joint window slots for encoders whose dtype the joint does not take; created on first use
+@property (nonatomic, strong) NSArray<MLMultiArray*>* slotEnc;
+@property (nonatomic, strong) NSArray<CoreMLBoundFeatureProvider*>* slots;
+@property (nonatomic, strong) NSMutableData* windowData; // window tokens then durations
+@end
+
+@implementation CoreMLTDTDecoderObject
+@end
+
+static CoreMLTDTDecoderObject* make_tdt_decoder(MLModel* dec, MLModel* jnt, const CoreMLTDTConfig* cfg,
+                                                CoreMLError* error) {
+    if (dec == nil || jnt == nil) {
+        set_error_message(error, 1, "tdt decoder requires decoder and joint models");
+        return nil;
+    }
+
+    CoreMLTDTDecoderObject* ctx = [[CoreMLTDTDecoderObject alloc] init];
+    ctx.decoder = dec;
+    ctx.joint = jnt;
+    ctx.durationBins = [NSData dataWithBytes:cfg->duration_bins length:cfg->num_duration_bins * sizeof(int32_t)];
+    CoreMLTDTConfig own = *cfg;
+    own.duration_bins = (const int32_t*)ctx.durationBins.bytes;
+    ctx.cfg = own;
+
+    NSError* nsError = nil;
+    MLMultiArray* targetLen = [[MLMultiArray alloc] initWithShape:@[@1] dataType:MLMultiArrayDataTypeInt32 error:&nsError];
+    ctx.targets = [[MLMultiArray alloc] initWithShape:@[@1, @1] dataType:MLMultiArrayDataTypeInt32 error:&nsError];
+    ctx.hIn = [[MLMultiArray alloc] initWithShape:@[@(cfg->lstm_layers), @1, @(cfg->decoder_hidden)]
+                                         dataType:MLMultiArrayDataTypeFloat32 error:&nsError];
+    ctx.cIn = [[MLMultiArray alloc] initWithShape:@[@(cfg->lstm_layers), @1, @(cfg->decoder_hidden)]
+                                         dataType:MLMultiArrayDataTypeFloat32 error:&nsError];
+    ctx.encStep = [[MLMultiArray alloc] initWithShape:@[@1, @(cfg->encoder_hidden), @1]
+                                             dataType:MLMultiArrayDataTypeFloat32 error:&nsError];
+    ctx.decStep = [[MLMultiArray alloc] initWithShape:@[@1, @(cfg->decoder_hidden), @1]
+                                             dataType:MLMultiArrayDataTypeFloat32 error:&nsError];
+
+    // Outputs follow the models' declared shapes so they can serve as backings
+    ctx.decOut = make_output_array(dec, @"decoder", &nsError);
+    ctx.hOut = make_output_array(dec, @"h_out", &nsError);
+    ctx.cOut = make_output_array(dec, @"c_out", &nsError);
+    ctx.tokenOut = make_output_array(jnt, @"token_id", &nsError);
+    ctx.durOut = make_output_array(jnt, @"duration", &nsError);
+
+    if (targetLen == nil || ctx.targets == nil || ctx.hIn == nil || ctx.cIn == nil || ctx.encStep == nil ||
+        ctx.decStep == nil || ctx.decOut == nil || ctx.hOut == nil || ctx.cOut == nil || ctx.tokenOut == nil ||
+        ctx.durOut == nil) {
+        if (nsError != nil) {
+            set_error(error, 1, nsError);
+        } else {
+            set_error_message(error, 1, "decoder/joint outputs not described by models");
+        }
+        return nil;
+    }
+    ((int32_t*)targetLen.dataPointer)[0] = 1;
+
+    // Bind names, inputs and backings once for every decode
+    ctx.decCall = make_prepared_call(dec,
+        @[@"targets", @"target_length", @"h_in", @"c_in"], @[ctx.targets, targetLen, ctx.hIn, ctx.cIn],
+        @[@"decoder", @"h_out", @"c_out"], @[ctx.decOut, ctx.hOut, ctx.cOut]);
+    ctx.jointCall = make_prepared_call(jnt,
+        @[@"encoder_step", @"decoder_step"], @[ctx.encStep, ctx.decStep],
+        @[@"token_id", @"duration"], @[ctx.tokenOut, ctx.durOut]);
+    ctx.decValue = [MLFeatureValue featureValueWithMultiArray:ctx.decStep];
+    ctx.encConstraint = [jnt modelDescription].inputDescriptionsByName[@"encoder_step"].multiArrayConstraint;
+
+    int window = cfg->joint_window > 1 ? cfg->joint_window : 1;
+    ctx.windowData = [NSMutableData dataWithLength:2 * window * sizeof(int32_t)];
+    return ctx;
+}
+
+// TDT greedy decode over encoder, a [1, encoder_hidden, >= num_frames] fp16 or fp32
+// array with any strides, reusing ctx's arrays and prepared calls. Callers provide
+// the autorelease pool.
+static bool tdt_decode(CoreMLTDTDecoderObject* ctx, MLMultiArray* encoder, int num_frames, CoreMLTDTState* state,
+                       int32_t* tokens_out, int max_tokens, int* num_tokens_out, CoreMLError* error) {
+    *num_tokens_out = 0;
+    CoreMLTDTConfig config = ctx.cfg;
+    const CoreMLTDTConfig* cfg = &config;
+    if ([encoder.shape count] != 3 || [encoder.shape[1] intValue] != cfg->encoder_hidden ||
+        [encoder.shape[2] intValue] < num_frames) {
+        set_error_message(error, 1, "encoder output must be [1, encoder_hidden, frames]");
+        return false;
+    }
+    if (encoder.dataType != MLMultiArrayDataTypeFloat16 && encoder.dataType != MLMultiArrayDataTypeFloat32) {
+        set_error_message(error, 1, "encoder output must be float16 or float32");
+        return false;
+    }
 
-            MLMultiArray* resultArray = value.multiArrayValue;
+    MLModel* jnt = ctx.joint;
+    MLMultiArray* targets = ctx.targets;
+    MLMultiArray* hIn = ctx.hIn;
+    MLMultiArray* cIn = ctx.cIn;
+    MLMultiArray* encStep = ctx.encStep;
+    MLMultiArray* decStep = ctx.decStep;
+    MLMultiArray* decOut = ctx.decOut;
+    MLMultiArray* hOut = ctx.hOut;
+    MLMultiArray* cOut = ctx.cOut;
+    MLMultiArray* tokenOut = ctx.tokenOut;
+    MLMultiArray* durOut = ctx.durOut;
+    CoreMLPreparedCallObject* decCall = ctx.decCall;
+    CoreMLPreparedCallObject* jointCall = ctx.jointCall;
+
+    int64_t stateLen = (int64_t)cfg->lstm_layers * cfg->decoder_hidden;
+    bool primed = state != NULL && state->primed;
+    if (primed) {
+        memcpy(hIn.dataPointer, state->h, stateLen * sizeof(float));
+        memcpy(cIn.dataPointer, state->c, stateLen * sizeof(float));
+        memcpy(decStep.dataPointer, state->decoder_out, cfg->decoder_hidden * sizeof(float));
+    } else {
+        memset(hIn.dataPointer, 0, stateLen * sizeof(float));
+        memset(cIn.dataPointer, 0, stateLen * sizeof(float));
+    }
 
-            // Create a new tensor with the result's actual shape
-            int rank = (int)[resultArray.shape count];
-            int64_t shape[rank];
-            int64_t total = 1;
-            for (int d = 0; d < rank; d++) {
-                shape[d] = [resultArray.shape[d] longLongValue];
-                total *= shape[d];
+    // Runs one decoder step for token, leaving decoder output and LSTM state in place.
+    // Feeding outputs back as inputs is accounted as decoder copy-out.
+    CoreMLModelStatsObject* decStats = model_stats(ctx.decoder);
+    bool (^runDecoder)(int32_t) = ^bool(int32_t token) {
+        ((int32_t*)targets.dataPointer)[0] = token;
+        if (!run_prepared_call(decCall, NULL, error)) return false;
+        uint64_t mark = now_ns();
+        bool sized = copy_array_f32(decOut, decStep, decStats) && copy_array_f32(hOut, hIn, decStats) &&
+                     copy_array_f32(cOut, cIn, decStats);
+        stats_stage(decStats, STATS_COPY_OUT, &mark);
+        if (!sized) {
+            set_error_message(error, 3, "decoder outputs mis-sized");
+            return false;
+        }
+        return true;
+    };
+
+    // Each frame is a [1, encoder_hidden, 1] view into the encoder output, so
+    // frames are never copied out of it. When the joint takes encoder_step in
+    // the encoder's dtype, the views are its inputs directly; otherwise frames
+    // are converted into fp32 inputs as they are scored.
+    NSError* nsError = nil;
+    int64_t hStride = [encoder.strides[1] longLongValue];
+    int64_t tStride = [encoder.strides[2] longLongValue];
+    size_t elemSize = encoder.dataType == MLMultiArrayDataTypeFloat16 ? 2 : 4;
+    bool viewInputs = ctx.encConstraint != nil && ctx.encConstraint.dataType == encoder.dataType;
+
+    // The decoder output only changes when a token is emitted, so the joint can
+    // score a window of upcoming frames against it in one batch. With view
+    // inputs every frame has a bound provider over its view and the shared
+    // decoder output; otherwise each window slot has one over its own fp32 frame.
+    int window = cfg->joint_window > 1 ? cfg->joint_window : 1;
+    MLFeatureValue* decValue = ctx.decValue;
+    if (!viewInputs && window > 1 && ctx.slots == nil) {
+        NSMutableArray<MLMultiArray*>* slotEnc = [NSMutableArray arrayWithCapacity:window];
+        NSMutableArray<CoreMLBoundFeatureProvider*>* slots = [NSMutableArray arrayWithCapacity:window];
+        for (int k = 0; k < window; k++) {
+            MLMultiArray* enc = [[MLMultiArray alloc] initWithShape:@[@1, @(cfg->encoder_hidden), @1]
+                                                           dataType:MLMultiArrayDataTypeFloat32 error:&nsError];
+            if (enc == nil) {
+                set_error(error, 1, nsError);
+                return false;
+            }
+            [slotEnc addObject:enc];
+            [slots addObject:[[CoreMLBoundFeatureProvider alloc] initWithValues:@{
+                @"encoder_step": [MLFeatureValue featureValueWithMultiArray:enc],
+                @"decoder_step": decValue,
+            }]];
+        }
+        ctx.slotEnc = slotEnc;
+        ctx.slots = slots;
+    }
+    NSArray<MLMultiArray*>* slotEnc = ctx.slotEnc;
+    NSArray<CoreMLBoundFeatureProvider*>* slots = ctx.slots;
+    int32_t* winTokens = (int32_t*)ctx.windowData.mutableBytes;
+    int32_t* winDurs = winTokens + window;
+    CoreMLModelStatsObject* jointStats = model_stats(jnt);
+
+    // Views and providers are made as frames are first scored, indexed from
+    // the resume frame: a stream chunk resumed near its end, or frames a
+    // duration skips, cost nothing. NSNull marks a frame not yet scored.
+    int first = state != NULL && state->frame > 0 ? state->frame : 0;
+    NSUInteger span = num_frames > first ? (NSUInteger)(num_frames - first) : 0;
+    NSMutableArray* frameViews = [NSMutableArray arrayWithCapacity:span];
+    NSMutableArray* frameProviders = [NSMutableArray arrayWithCapacity:viewInputs ? span : 0];
+
+    // Returns the view of frame f, creating it on first use
+    MLMultiArray* (^frameView)(int) = ^MLMultiArray*(int f) {
+        NSUInteger i = (NSUInteger)(f - first);
+        while ([frameViews count] <= i) [frameViews addObject:[NSNull null]];
+        id view = frameViews[i];
+        if (view == [NSNull null]) {
+            NSError* viewError = nil;
+            view = [[MLMultiArray alloc]
+                initWithDataPointer:(uint8_t*)encoder.dataPointer + (int64_t)f * tStride * elemSize
+                              shape:@[@1, @(cfg->encoder_hidden), @1]
+                           dataType:encoder.dataType
+                            strides:@[@(cfg->encoder_hidden * hStride), @(hStride), @1]
+                        deallocator:nil
+                              error:&viewError];
+            if (view == nil) {
+                set_error(error, 1, viewError);
+                return nil;
+            }
+            frameViews[i] = view;
+        }
+        return (MLMultiArray*)view;
+    };
+
+    // Returns the bound provider of frame f's view, creating it on first use
+    CoreMLBoundFeatureProvider* (^frameProvider)(int) = ^CoreMLBoundFeatureProvider*(int f) {
+        NSUInteger i = (NSUInteger)(f - first);
+        while ([frameProviders count] <= i) [frameProviders addObject:[NSNull null]];
+        id provider = frameProviders[i];
+        if (provider == [NSNull null]) {
+            MLMultiArray* view = frameView(f);
+            if (view == nil) return nil;
+            provider = [[CoreMLBoundFeatureProvider alloc] initWithValues:@{
+                @"encoder_step": [MLFeatureValue featureValueWithMultiArray:view],
+                @"decoder_step": decValue,
+            }];
+            frameProviders[i] = provider;
+        }
+        return (CoreMLBoundFeatureProvider*)provider;
+    };
+
+    // Scores frames [start, start+n) into winTokens/winDurs. A single frame
+    // goes through the prepared call and its output backings instead.
+    bool (^scoreWindow)(int, int) = ^bool(int start, int n) {
+        if (n == 1) {
+            bool ok;
+            if (viewInputs) {
+                CoreMLBoundFeatureProvider* provider = frameProvider(start);
+                if (provider == nil) return false;
+                ok = run_prepared_call_with(jointCall, provider, NULL, error);
+            } else {
+                MLMultiArray* view = frameView(start);
+                if (view == nil) return false;
+                copy_multiarray(view, encStep.dataPointer, COREML_DTYPE_FLOAT32, jointStats);
+                ok = run_prepared_call(jointCall, NULL, error);
             }
+            if (!ok) return false;
+            winTokens[0] = [tokenOut[0] intValue];
+            winDurs[0] = [durOut[0] intValue];
+            return true;
+        }
 
-            // Convert MLMultiArrayDataType to our dtype enum
-            int dtype;
-            switch (resultArray.dataType) {
-                case MLMultiArrayDataTypeFloat16: dtype = COREML_DTYPE_FLOAT16; break;
-                case MLMultiArrayDataTypeFloat32: dtype = COREML_DTYPE_FLOAT32; break;
-                case MLMultiArrayDataTypeInt32:   dtype = COREML_DTYPE_INT32; break;
-                default: dtype = COREML_DTYPE_FLOAT32; break;
+        uint64_t mark = now_ns();
+        NSArray<CoreMLBoundFeatureProvider*>* providers;
+        if (viewInputs) {
+            for (int k = 0; k < n; k++) {
+                if (frameProvider(start + k) == nil) return false;
+            }
+            providers = [frameProviders subarrayWithRange:NSMakeRange(start - first, n)];
+        } else {
+            for (int k = 0; k < n; k++) {
+                MLMultiArray* view = frameView(start + k);
+                if (view == nil) return false;
+                copy_multiarray(view, slotEnc[k].dataPointer, COREML_DTYPE_FLOAT32, jointStats);
+            }
+            providers = [slots subarrayWithRange:NSMakeRange(0, n)];
+        }
+        MLArrayBatchProvider* batch = [[MLArrayBatchProvider alloc] initWithFeatureProviderArray:providers];
+        stats_stage(jointStats, STATS_MARSHAL, &mark);
+
+        NSError* batchError = nil;
+        id<MLBatchProvider> results = [jnt predictionsFromBatch:batch error:&batchError];
+        if (results == nil || results.count != n) {
+            set_error(error, 2, batchError);
+            stats_dispatch(jointStats, false);
+            return false;
+        }
+        stats_stage(jointStats, STATS_PREDICT, &mark);
+
+        for (int k = 0; k < n; k++) {
+            id<MLFeatureProvider> result = [results featuresAtIndex:k];
+            MLMultiArray* token = [result featureValueForName:@"token_id"].multiArrayValue;
+            MLMultiArray* dur = [result featureValueForName:@"duration"].multiArrayValue;
+            if (token == nil || dur == nil) {
+                set_error_message(error, 3, "joint batch result missing token_id/duration");
+                stats_dispatch(jointStats, false);
+                return false;
+            }
+            winTokens[k] = [token[0] intValue];
+            winDurs[k] = [dur[0] intValue];
+        }
+        stats_stage(jointStats, STATS_COPY_OUT, &mark);
+        stats_dispatch(jointStats, true);
+        return true;
+    };
+
+    // Initial decoder run with blank token, unless resuming a stream
+    if (!primed && !runDecoder(cfg->blank_id)) return false;
+
+    int numTokens = 0;
+    int t = first;
+    int winStart = 0, winLen = 0, winSize = 1;
+    while (t < num_frames) {
+        int symCount = 0;
+        while (symCount < cfg->max_symbols_per_step) {
+            // Reuse the scored window while t stays inside it; walking off the
+            // end of a window of blanks doubles the next one
+            if (t < winStart || t >= winStart + winLen) {
+                if (winLen > 0 && winSize < window) winSize *= 2;
+                if (winSize > window) winSize = window;
+                int n = winSize < num_frames - t ? winSize : num_frames - t;
+                if (!scoreWindow(t, n)) return false;
+                winStart = t;
+                winLen = n;
+            }
+            int32_t tokenID = winTokens[t - winStart];
+            int32_t durIdx = winDurs[t - winStart];
+
+            // Clamp duration to valid range
+            if (durIdx < 0) durIdx = 0;
+            if (durIdx >= cfg->num_duration_bins) durIdx = cfg->num_duration_bins - 1;
+            int32_t dur = cfg->duration_bins[durIdx];
+
+            if (tokenID == cfg->blank_id) {
+                if (dur == 0) dur = 1; // prevent infinite loop
+                t += dur;
+                break;
             }
 
-            CoreMLError tensorError = {0, NULL};
-            CoreMLTensor tensor = coreml_tensor_create(shape, rank, dtype, &tensorError);
-            if (tensor == NULL) {
-                for (int j = 0; j < i; j++) {
-                    free((*output_names_out)[j]);
-                    coreml_tensor_free((*outputs_out)[j]);
-                }
-                free((*output_names_out)[i]);
-                free(*output_names_out);
-                free(*outputs_out);
-                *output_names_out = NULL;
-                *outputs_out = NULL;
-                *num_outputs_out = 0;
-                if (tensorError.message) {
-                    set_error(error, 4, nil);
-                    error->message = tensorError.message;
-                } else {
-                    set_error(error, 4, nil);
-                }
+            // Non-blank: emit token, update decoder state
+            if (numTokens >= max_tokens) {
+                set_error_message(error, 4, "token buffer full");
                 return false;
             }
+            tokens_out[numTokens++] = tokenID;
+            *num_tokens_out = numTokens;
+            if (!runDecoder(tokenID)) return false;
+            winLen = 0; // scored against the previous decoder output
+            winSize = 1;
+
+            if (dur > 0) {
+                t += dur;
+                break;
+            }
 
-            // Copy data — stride-aware for non-contiguous MLMultiArray outputs.
-            // CoreML/ANE may return arrays with non-trivial strides, so we can't just memcpy.
-            MLMultiArray* outArray = (__bridge MLMultiArray*)tensor;
-            size_t elemSize = (resultArray.dataType == MLMultiArrayDataTypeFloat16) ? 2 : 4;
-            if (total > 0) {
-                // Check if result array is contiguous (row-major)
-                bool contiguous = true;
-                int64_t expected = 1;
-                for (int d = rank - 1; d >= 0; d--) {
-                    int64_t stride = [resultArray.strides[d] longLongValue];
-                    if (stride != expected) {
-                        contiguous = false;
-                        break;
-                    }
-                    expected *= shape[d];
-                }
+            symCount++;
+        }
 
-                if (contiguous) {
-                    memcpy(outArray.dataPointer, resultArray.dataPointer, total * elemSize);
-                } else {
-                    // Stride-aware element-by-element copy
-                    const uint8_t* src = (const uint8_t*)resultArray.dataPointer;
-                    uint8_t* dst = (uint8_t*)outArray.dataPointer;
-
-                    // Get strides for the result array
-                    int64_t srcStrides[rank];
-                    for (int d = 0; d < rank; d++) {
-                        srcStrides[d] = [resultArray.strides[d] longLongValue];
-                    }
+        if (symCount >= cfg->max_symbols_per_step) {
+            t++;
+        }
+    }
+
+    // Hand the decoder state back for the next chunk
+    if (state != NULL) {
+        memcpy(state->h, hIn.dataPointer, stateLen * sizeof(float));
+        memcpy(state->c, cIn.dataPointer, stateLen * sizeof(float));
+        memcpy(state->decoder_out, decStep.dataPointer, cfg->decoder_hidden * sizeof(float));
+        state->primed = true;
+        state->frame = t;
+    }
+    return true;
+}
+
+CoreMLTDTDecoder coreml_tdt_decoder_create(CoreMLModel decoder, CoreMLModel joint, const CoreMLTDTConfig* cfg,
+                                           CoreMLError* error) {
+    @autoreleasepool {
+        CoreMLTDTDecoderObject* ctx = make_tdt_decoder((__bridge MLModel*)decoder, (__bridge MLModel*)joint, cfg, error);
+        if (ctx == nil) return NULL;
+        return (__bridge_retained void*)ctx;
+    }
+}
 
-                    // Iterate through all elements using multi-dimensional indices
-                    // and compute source offset using strides, dest offset using row-major layout
-                    int64_t indices[rank];
-                    memset(indices, 0, sizeof(indices));
-
-                    for (int64_t flat = 0; flat < total; flat++) {
-                        // Compute source offset from strides
-                        int64_t srcOffset = 0;
-                        for (int d = 0; d < rank; d++) {
-                            srcOffset += indices[d] * srcStrides[d];
-                        }
-
-                        memcpy(dst + flat * elemSize, src + srcOffset * elemSize, elemSize);
-
-                        // Increment multi-dimensional index (last dimension first)
-                        for (int d = rank - 1; d >= 0; d--) {
-                            indices[d]++;
-                            if (indices[d] < shape[d]) break;
-                            indices[d] = 0;
-                        }
+bool coreml_tdt_decoder_decode(CoreMLTDTDecoder ctx, CoreMLTensor encoder, int num_frames, CoreMLTDTState* state,
+                               int32_t* tokens_out, int max_tokens, int* num_tokens_out, CoreMLError* error) {
+    @autoreleasepool {
+        return tdt_decode((__bridge CoreMLTDTDecoderObject*)ctx, (__bridge MLMultiArray*)encoder, num_frames, state,
+                          tokens_out, max_tokens, num_tokens_out, error);
+    }
+}
+
+void coreml_tdt_decoder_free(CoreMLTDTDecoder ctx) {
+    if (ctx != NULL) {
+        CoreMLTDTDecoderObject* c = (__bridge_transfer CoreMLTDTDecoderObject*)ctx;
+        (void)c; // ARC will release
+    }
+}
+
+bool coreml_tdt_greedy_decode(CoreMLModel decoder, CoreMLModel joint,
+                              const float* encoder_out, int num_frames, const CoreMLTDTConfig* cfg,
+                              CoreMLTDTState* state,
+                              int32_t* tokens_out, int max_tokens, int* num_tokens_out,
+                              CoreMLError* error) {
+    @autoreleasepool {
+        *num_tokens_out = 0;
+
+        // Frame-major [num_frames, encoder_hidden] seen as a [1, encoder_hidden, num_frames] view
+        NSError* nsError = nil;
+        MLMultiArray* encoder = [[MLMultiArray alloc]
+            initWithDataPointer:(void*)encoder_out
+                          shape:@[@1, @(cfg->encoder_hidden), @(num_frames)]
+                       dataType:MLMultiArrayDataTypeFloat32
+                        strides:@[@((int64_t)num_frames * cfg->encoder_hidden), @1, @(cfg->encoder_hidden)]
+                    deallocator:nil
+                          error:&nsError];
+        if (encoder == nil) {
+            set_error(error, 1, nsError);
+            return false;
+        }
+        CoreMLTDTDecoderObject* ctx = make_tdt_decoder((__bridge MLModel*)decoder, (__bridge MLModel*)joint, cfg, error);
+        if (ctx == nil) return false;
+        return tdt_decode(ctx, encoder, num_frames, state, tokens_out, max_tokens, num_tokens_out, error);
+    }
+}
+
+bool coreml_tdt_greedy_decode_tensor(CoreMLModel decoder, CoreMLModel joint,
+                                     CoreMLTensor encoder, int num_frames, const CoreMLTDTConfig* cfg,
+                                     CoreMLTDTState* state,
+                                     int32_t* tokens_out, int max_tokens, int* num_tokens_out,
+                                     CoreMLError* error) {
+    @autoreleasepool {
+        *num_tokens_out = 0;
+        CoreMLTDTDecoderObject* ctx = make_tdt_decoder((__bridge MLModel*)decoder, (__bridge MLModel*)joint, cfg, error);
+        if (ctx == nil) return false;
+        return tdt_decode(ctx, (__bridge MLMultiArray*)encoder, num_frames, state,
+                          tokens_out, max_tokens, num_tokens_out, error);
+    }
+}
+
+// Helper to snapshot one latency histogram
+static void snapshot_latency(LatencyCounters* c, CoreMLLatencyHistogram* out) {
+    out->count = atomic_load_explicit(&c->count, memory_order_relaxed);
+    out->total_ns = atomic_load_explicit(&c->total_ns, memory_order_relaxed);
+    out->max_ns = atomic_load_explicit(&c->max_ns, memory_order_relaxed);
+    for (int i = 0; i < COREML_STATS_BUCKETS; i++) {
+        out->buckets[i] = atomic_load_explicit(&c->buckets[i], memory_order_relaxed);
+    }
+}
+
+// Helper to convert MLComputeUnits back to our enum
+static int ml_to_units(MLComputeUnits units) {
+    switch (units) {
+        case MLComputeUnitsCPUOnly: return COREML_COMPUTE_CPU_ONLY;
+        case MLComputeUnitsCPUAndGPU: return COREML_COMPUTE_CPU_AND_GPU;
+        case MLComputeUnitsCPUAndNeuralEngine: return COREML_COMPUTE_CPU_AND_ANE;
+        case MLComputeUnitsAll:
+        default: return COREML_COMPUTE_ALL;
+    }
+}
+
+bool coreml_model_stats(CoreMLModel model, CoreMLModelStats* out) {
+    @autoreleasepool {
+        memset(out, 0, sizeof(*out));
+        CoreMLModelStatsObject* stats = model_stats((__bridge MLModel*)model);
+        if (stats == nil) return false;
+
+        // Fields are read individually; a concurrent prediction may be half-counted
+        out->predictions = atomic_load_explicit(&stats->predictions, memory_order_relaxed);
+        out->failures = atomic_load_explicit(&stats->failures, memory_order_relaxed);
+        snapshot_latency(&stats->stages[STATS_MARSHAL], &out->marshal);
+        snapshot_latency(&stats->stages[STATS_PREDICT], &out->predict);
+        snapshot_latency(&stats->stages[STATS_COPY_OUT], &out->copy_out);
+        out->bytes_copied = atomic_load_explicit(&stats->bytesCopied, memory_order_relaxed);
+        out->strided_copies = atomic_load_explicit(&stats->stridedCopies, memory_order_relaxed);
+        out->backings_rejected = atomic_load_explicit(&stats->backingsRejected, memory_order_relaxed);
+        out->compute_units = ml_to_units(stats.configuration.computeUnits);
+        return true;
+    }
+}
+
+bool coreml_model_compute_plan(CoreMLModel model, CoreMLComputePlanSummary* out, CoreMLError* error) {
+    @autoreleasepool {
+        memset(out, 0, sizeof(*out));
+        CoreMLModelStatsObject* stats = model_stats((__bridge MLModel*)model);
+        if (stats == nil || stats.url == nil) {
+            set_error_message(error, 1, "model has no recorded load URL");
+            return false;
+        }
+
+        if (@available(macOS 14.4, *)) {
+            // The loader is asynchronous; wait for it on this (non-main) thread
+            dispatch_semaphore_t done = dispatch_semaphore_create(0);
+            __block MLComputePlan* plan = nil;
+            __block NSError* planError = nil;
+            [MLComputePlan loadContentsOfURL:stats.url
+                               configuration:stats.configuration
+                           completionHandler:^(MLComputePlan* computePlan, NSError* err) {
+                plan = computePlan;
+                planError = err;
+                dispatch_semaphore_signal(done);
+            }];
+            dispatch_semaphore_wait(done, DISPATCH_TIME_FOREVER);
+            if (plan == nil) {
+                set_error(error, 2, planError);
+                return false;
+            }
+
+            MLModelStructureProgram* program = plan.modelStructure.program;
+            if (program == nil) {
+                set_error_message(error, 3, "compute plan is only available for ML program models");
+                return false;
+            }
+
+            // Top-level operations of every function; nested blocks follow their parent op
+            for (MLModelStructureProgramFunction* function in [program.functions allValues]) {
+                for (MLModelStructureProgramOperation* op in function.block.operations) {
+                    MLComputePlanDeviceUsage* usage = [plan computeDeviceUsageForMLProgramOperation:op];
+                    id device = usage.preferredComputeDevice;
+                    if (device == nil) continue; // constants and other unplaced ops
+                    if ([device isKindOfClass:[MLNeuralEngineComputeDevice class]]) {
+                        out->ane_ops++;
+                    } else if ([device isKindOfClass:[MLGPUComputeDevice class]]) {
+                        out->gpu_ops++;
+                    } else {
+                        out->cpu_ops++;
                     }
                 }
             }
-
-            (*outputs_out)[i] = tensor;
+            return true;
         }
 
-        return true;
+        set_error_message(error, 4, "compute plan requires macOS 14.4");
+        return false;
     }
 }
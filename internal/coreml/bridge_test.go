@@ -3,6 +3,7 @@ package coreml
 import (
 	"math"
 	"testing"
+	"time"
 	"unsafe"
 )
 
@@ -112,6 +113,59 @@ func TestNewTensorWithDataInt32(t *testing.T) {
 	}
 }
 
+func TestNewTensorView(t *testing.T) {
+	data := []float32{1.0, 2.0, 3.0, 4.0, 5.0, 6.0}
+	shape := []int64{2, 3}
+
+	tensor, err := NewTensorView(shape, DTypeFloat32, unsafe.Pointer(&data[0]))
+	if err != nil {
+		t.Fatalf("NewTensorView returned error: %v", err)
+	}
+	defer tensor.Close()
+
+	// View must alias the caller's memory, not a copy
+	if got := tensor.DataPtr(); got != unsafe.Pointer(&data[0]) {
+		t.Errorf("DataPtr() = %p, want caller buffer %p", got, &data[0])
+	}
+	if !tensor.IsContiguous() {
+		t.Error("IsContiguous() = false, want true")
+	}
+	strides := tensor.Strides()
+	if strides[0] != 3 || strides[1] != 1 {
+		t.Errorf("Strides() = %v, want [3 1]", strides)
+	}
+
+	// Writes through the Go slice are visible through the tensor
+	data[4] = 42.0
+	result := unsafe.Slice((*float32)(tensor.DataPtr()), 6)
+	if result[4] != 42.0 {
+		t.Errorf("data[4] through view = %f, want 42", result[4])
+	}
+}
+
+func TestNewTensorViewFloat16(t *testing.T) {
+	data := make([]uint16, 8)
+	tensor, err := NewTensorView([]int64{1, 8}, DTypeFloat16, unsafe.Pointer(&data[0]))
+	if err != nil {
+		t.Fatalf("NewTensorView returned error: %v", err)
+	}
+	defer tensor.Close()
+
+	if got := tensor.DType(); got != DTypeFloat16 {
+		t.Errorf("DType() = %d, want DTypeFloat16 (%d)", got, DTypeFloat16)
+	}
+	if got := tensor.SizeBytes(); got != 16 {
+		t.Errorf("SizeBytes() = %d, want 16", got)
+	}
+}
+
+func TestNewTensorViewNilData(t *testing.T) {
+	_, err := NewTensorView([]int64{4}, DTypeFloat32, nil)
+	if err == nil {
+		t.Fatal("NewTensorView with nil data should return error")
+	}
+}
+
 func TestLoadModelBadPath(t *testing.T) {
 	_, err := LoadModel("/nonexistent/path/to/model.mlmodelc")
 	if err == nil {
@@ -120,6 +174,14 @@ func TestLoadModelBadPath(t *testing.T) {
 	t.Logf("Got expected error: %v", err)
 }
 
+func TestLoadModelWithOptionsBadPath(t *testing.T) {
+	_, err := LoadModelWithOptions("/nonexistent/path/to/model.mlmodelc", LoadOptions{ComputeUnits: ComputeCPUOnly})
+	if err == nil {
+		t.Fatal("LoadModelWithOptions with nonexistent path should return error")
+	}
+	t.Logf("Got expected error: %v", err)
+}
+
 func TestCompileModelBadPath(t *testing.T) {
 	_, err := CompileModel("/nonexistent/path/to/model.mlpackage", "")
 	if err == nil {
@@ -128,6 +190,80 @@ func TestCompileModelBadPath(t *testing.T) {
 	t.Logf("Got expected error: %v", err)
 }
 
+func TestPredictIntoCountMismatch(t *testing.T) {
+	m := &Model{}
+	if _, err := m.PredictInto([]string{"a"}, nil, nil, nil); err == nil {
+		t.Error("PredictInto with mismatched input counts should return error")
+	}
+	if _, err := m.PredictInto(nil, nil, []string{"out"}, nil); err == nil {
+		t.Error("PredictInto with mismatched output counts should return error")
+	}
+}
+
+func TestPredictAllocWithCountMismatch(t *testing.T) {
+	m := &Model{}
+	if _, err := m.PredictAllocWith([]string{"a", "b"}, nil, PredictFloat32); err == nil {
+		t.Error("PredictAllocWith with mismatched input counts should return error")
+	}
+}
+
+func TestPredictBatchCountMismatch(t *testing.T) {
+	m := &Model{}
+	if err := m.PredictBatch(nil, make([][]*Tensor, 2), nil, make([][]*Tensor, 1)); err == nil {
+		t.Error("PredictBatch with mismatched batch sizes should return error")
+	}
+	if err := m.PredictBatch([]string{"a"}, [][]*Tensor{{}}, nil, [][]*Tensor{{}}); err == nil {
+		t.Error("PredictBatch with mismatched per-sample inputs should return error")
+	}
+	if err := m.PredictBatch(nil, nil, nil, nil); err != nil {
+		t.Errorf("PredictBatch with empty batch = %v, want nil", err)
+	}
+}
+
+func TestPrepareCountMismatch(t *testing.T) {
+	m := &Model{}
+	if _, err := m.Prepare([]string{"a"}, nil, nil, nil); err == nil {
+		t.Error("Prepare with mismatched input counts should return error")
+	}
+	if _, err := m.Prepare(nil, nil, []string{"out"}, nil); err == nil {
+		t.Error("Prepare with mismatched output counts should return error")
+	}
+}
+
+func TestPrepareNilModel(t *testing.T) {
+	m := &Model{}
+	if _, err := m.Prepare(nil, nil, nil, nil); err == nil {
+		t.Error("Prepare on an unloaded model should return error")
+	}
+}
+
+func TestNewTDTDecoderNilModel(t *testing.T) {
+	cfg := TDTConfig{MaxSymbolsPerStep: 1, DurationBins: []int32{0, 1}}
+	if _, err := NewTDTDecoder(&Model{}, &Model{}, cfg); err == nil {
+		t.Error("NewTDTDecoder on unloaded models should return error")
+	}
+}
+
+func TestPredictAsyncCountMismatch(t *testing.T) {
+	m := &Model{}
+	res := <-m.PredictAsync([]string{"a"}, nil, PredictDefault)
+	if res.Err == nil {
+		t.Error("PredictAsync with mismatched input counts should return error")
+	}
+}
+
+func TestPredictAsyncNilModel(t *testing.T) {
+	m := &Model{}
+	select {
+	case res := <-m.PredictAsync(nil, nil, PredictDefault):
+		if res.Err == nil {
+			t.Error("PredictAsync on an unloaded model should return error")
+		}
+	case <-time.After(5 * time.Second):
+		t.Fatal("PredictAsync on an unloaded model never completed")
+	}
+}
+
 func TestComputeUnits(t *testing.T) {
 	// Just verify these don't panic
 	SetComputeUnits(ComputeAll)
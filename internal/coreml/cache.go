@@ -0,0 +1,210 @@
+package coreml
+
+import (
+	"crypto/sha256"
+	"encoding/hex"
+	"fmt"
+	"io"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"strings"
+)
+
+// cacheStampSuffix names the sidecar file that records, per package, the cheap
+// stat fingerprint and the content key it hashed to. On startup the fingerprint
+// is recomputed from file sizes and mtimes only; the package contents are
+// rehashed only when that fingerprint changes.
+const cacheStampSuffix = ".stamp"
+
+// CompileModelCached returns a compiled .mlmodelc for packagePath, compiling it
+// only when cacheDir has no bundle for the package's content key. The key is a
+// SHA-256 of the package contents plus RuntimeVersion, so an updated package or
+// an OS update triggers exactly one recompile. Bundles live at
+// cacheDir/<key>/<name>.mlmodelc and are never overwritten in place; the
+// bundle a package's previous key pointed to is removed once it is replaced.
+func CompileModelCached(packagePath, cacheDir string) (string, error) {
+	runtimeVersion := RuntimeVersion()
+	name := strings.TrimSuffix(filepath.Base(packagePath), filepath.Ext(packagePath))
+	stampPath := filepath.Join(cacheDir, name+cacheStampSuffix)
+
+	fingerprint, err := packageFingerprint(packagePath, runtimeVersion)
+	if err != nil {
+		return "", fmt.Errorf("coreml: cache: %w", err)
+	}
+
+	// Fast path: unchanged package, cached bundle still present
+	if key, ok := readCacheStamp(stampPath, fingerprint); ok {
+		compiled := cachedModelPath(cacheDir, key, name)
+		if _, err := os.Stat(compiled); err == nil {
+			return compiled, nil
+		}
+	}
+
+	key, err := packageContentKey(packagePath, runtimeVersion)
+	if err != nil {
+		return "", fmt.Errorf("coreml: cache: %w", err)
+	}
+	compiled := cachedModelPath(cacheDir, key, name)
+
+	if _, err := os.Stat(compiled); err != nil {
+		if err := compileIntoCache(packagePath, cacheDir, key); err != nil {
+			return "", err
+		}
+	}
+
+	if err := updateCacheStamp(cacheDir, stampPath, fingerprint, key); err != nil {
+		return "", fmt.Errorf("coreml: cache: %w", err)
+	}
+	return compiled, nil
+}
+
+// updateCacheStamp records the fingerprint → content key mapping and removes
+// the bundle the stamp pointed to before, unless another package's stamp
+// still points to it. Removal is best effort: a leftover bundle only costs
+// disk space.
+func updateCacheStamp(cacheDir, stampPath, fingerprint, key string) error {
+	prev := cacheStampKey(stampPath)
+	if err := writeCacheStamp(stampPath, fingerprint, key); err != nil {
+		return err
+	}
+	if prev == "" || prev == key || filepath.Base(prev) != prev || prev == ".." {
+		return nil
+	}
+	stamps, _ := filepath.Glob(filepath.Join(cacheDir, "*"+cacheStampSuffix))
+	for _, s := range stamps {
+		if cacheStampKey(s) == prev {
+			return nil
+		}
+	}
+	_ = os.RemoveAll(filepath.Join(cacheDir, prev))
+	return nil
+}
+
+// compileIntoCache compiles packagePath into a staging dir and renames it to
+// cacheDir/key, so a crash mid-compile never leaves a half-written bundle.
+func compileIntoCache(packagePath, cacheDir, key string) error {
+	if err := os.MkdirAll(cacheDir, 0755); err != nil {
+		return fmt.Errorf("coreml: cache: creating %s: %w", cacheDir, err)
+	}
+	staging, err := os.MkdirTemp(cacheDir, "compile-*")
+	if err != nil {
+		return fmt.Errorf("coreml: cache: creating staging dir: %w", err)
+	}
+	defer func() { _ = os.RemoveAll(staging) }()
+
+	if _, err := CompileModel(packagePath, staging); err != nil {
+		return fmt.Errorf("coreml: cache: %w", err)
+	}
+
+	dest := filepath.Join(cacheDir, key)
+	_ = os.RemoveAll(dest) // stale partial entry without a compiled bundle
+	if err := os.Rename(staging, dest); err != nil {
+		return fmt.Errorf("coreml: cache: installing compiled model: %w", err)
+	}
+	return nil
+}
+
+// cachedModelPath returns the compiled bundle path for a content key.
+func cachedModelPath(cacheDir, key, name string) string {
+	return filepath.Join(cacheDir, key, name+".mlmodelc")
+}
+
+// packageFingerprint hashes the relative path, size and mtime of every file in
+// the package plus the runtime version. It never reads file contents.
+func packageFingerprint(packagePath, runtimeVersion string) (string, error) {
+	h := sha256.New()
+	_, _ = io.WriteString(h, runtimeVersion+"\n")
+	err := walkPackage(packagePath, func(rel string, info fs.FileInfo) error {
+		_, _ = fmt.Fprintf(h, "%s\x00%d\x00%d\n", rel, info.Size(), info.ModTime().UnixNano())
+		return nil
+	})
+	if err != nil {
+		return "", err
+	}
+	return hex.EncodeToString(h.Sum(nil)), nil
+}
+
+// packageContentKey hashes the relative path and contents of every file in the
+// package plus the runtime version.
+func packageContentKey(packagePath, runtimeVersion string) (string, error) {
+	h := sha256.New()
+	_, _ = io.WriteString(h, runtimeVersion+"\n")
+	err := walkPackage(packagePath, func(rel string, _ fs.FileInfo) error {
+		f, err := os.Open(filepath.Join(packagePath, rel))
+		if err != nil {
+			return err
+		}
+		defer func() { _ = f.Close() }()
+		_, _ = io.WriteString(h, rel+"\x00")
+		_, err = io.Copy(h, f)
+		return err
+	})
+	if err != nil {
+		return "", err
+	}
+	return hex.EncodeToString(h.Sum(nil)), nil
+}
+
+// walkPackage calls fn for every regular file under root in lexical order.
+// root may also be a single file, in which case rel is its base name.
+func walkPackage(root string, fn func(rel string, info fs.FileInfo) error) error {
+	return filepath.WalkDir(root, func(path string, d fs.DirEntry, err error) error {
+		if err != nil {
+			return err
+		}
+		if d.IsDir() {
+			return nil
+		}
+		info, err := d.Info()
+		if err != nil {
+			return err
+		}
+		rel, err := filepath.Rel(root, path)
+		if err != nil {
+			return err
+		}
+		if rel == "." {
+			rel = filepath.Base(path)
+		}
+		return fn(filepath.ToSlash(rel), info)
+	})
+}
+
+// readCacheStamp returns the content key recorded for fingerprint, if any.
+func readCacheStamp(stampPath, fingerprint string) (string, bool) {
+	fields, ok := readCacheStampFields(stampPath)
+	if !ok || fields[0] != fingerprint {
+		return "", false
+	}
+	return fields[1], true
+}
+
+// cacheStampKey returns the content key recorded in stampPath, whatever its
+// fingerprint, or "" if there is none.
+func cacheStampKey(stampPath string) string {
+	fields, ok := readCacheStampFields(stampPath)
+	if !ok {
+		return ""
+	}
+	return fields[1]
+}
+
+// readCacheStampFields returns the fingerprint and key of a stamp file.
+func readCacheStampFields(stampPath string) ([]string, bool) {
+	data, err := os.ReadFile(stampPath)
+	if err != nil {
+		return nil, false
+	}
+	fields := strings.Fields(string(data))
+	return fields, len(fields) == 2
+}
+
+// writeCacheStamp records the fingerprint → content key mapping atomically.
+func writeCacheStamp(stampPath, fingerprint, key string) error {
+	tmp := stampPath + ".tmp"
+	if err := os.WriteFile(tmp, []byte(fingerprint+" "+key+"\n"), 0644); err != nil {
+		return err
+	}
+	return os.Rename(tmp, stampPath)
+}
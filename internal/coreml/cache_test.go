@@ -0,0 +1,163 @@
+package coreml
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+)
+
+// writePackage creates a fake .mlpackage directory with the given files.
+func writePackage(t *testing.T, files map[string]string) string {
+	t.Helper()
+	dir := filepath.Join(t.TempDir(), "Model.mlpackage")
+	for rel, content := range files {
+		path := filepath.Join(dir, rel)
+		if err := os.MkdirAll(filepath.Dir(path), 0755); err != nil {
+			t.Fatal(err)
+		}
+		if err := os.WriteFile(path, []byte(content), 0644); err != nil {
+			t.Fatal(err)
+		}
+	}
+	return dir
+}
+
+func TestPackageContentKeyStableAcrossTouch(t *testing.T) {
+	pkg := writePackage(t, map[string]string{
+		"Manifest.json":           "{}",
+		"Data/weights/weight.bin": "weights",
+	})
+
+	key1, err := packageContentKey(pkg, "v1")
+	if err != nil {
+		t.Fatalf("packageContentKey: %v", err)
+	}
+	fp1, err := packageFingerprint(pkg, "v1")
+	if err != nil {
+		t.Fatalf("packageFingerprint: %v", err)
+	}
+
+	// Touching a file changes the cheap fingerprint but not the content key
+	future := time.Now().Add(time.Hour)
+	if err := os.Chtimes(filepath.Join(pkg, "Manifest.json"), future, future); err != nil {
+		t.Fatal(err)
+	}
+
+	key2, err := packageContentKey(pkg, "v1")
+	if err != nil {
+		t.Fatalf("packageContentKey: %v", err)
+	}
+	fp2, err := packageFingerprint(pkg, "v1")
+	if err != nil {
+		t.Fatalf("packageFingerprint: %v", err)
+	}
+
+	if key1 != key2 {
+		t.Errorf("content key changed after touch: %s → %s", key1, key2)
+	}
+	if fp1 == fp2 {
+		t.Error("fingerprint unchanged after mtime change")
+	}
+}
+
+func TestPackageContentKeyChanges(t *testing.T) {
+	pkg := writePackage(t, map[string]string{"Data/weight.bin": "a"})
+
+	base, err := packageContentKey(pkg, "v1")
+	if err != nil {
+		t.Fatalf("packageContentKey: %v", err)
+	}
+
+	// A different runtime version yields a different key
+	other, err := packageContentKey(pkg, "v2")
+	if err != nil {
+		t.Fatalf("packageContentKey: %v", err)
+	}
+	if base == other {
+		t.Error("content key unchanged across runtime versions")
+	}
+
+	// Different contents yield a different key
+	if err := os.WriteFile(filepath.Join(pkg, "Data/weight.bin"), []byte("b"), 0644); err != nil {
+		t.Fatal(err)
+	}
+	changed, err := packageContentKey(pkg, "v1")
+	if err != nil {
+		t.Fatalf("packageContentKey: %v", err)
+	}
+	if base == changed {
+		t.Error("content key unchanged after content change")
+	}
+}
+
+func TestCacheStampRoundTrip(t *testing.T) {
+	stamp := filepath.Join(t.TempDir(), "Model"+cacheStampSuffix)
+
+	if _, ok := readCacheStamp(stamp, "fp"); ok {
+		t.Fatal("readCacheStamp on missing file should miss")
+	}
+	if err := writeCacheStamp(stamp, "fp", "key"); err != nil {
+		t.Fatalf("writeCacheStamp: %v", err)
+	}
+	key, ok := readCacheStamp(stamp, "fp")
+	if !ok || key != "key" {
+		t.Errorf("readCacheStamp = (%q, %v), want (\"key\", true)", key, ok)
+	}
+	if _, ok := readCacheStamp(stamp, "other"); ok {
+		t.Error("readCacheStamp with different fingerprint should miss")
+	}
+}
+
+func TestUpdateCacheStampRemovesReplacedBundle(t *testing.T) {
+	cacheDir := t.TempDir()
+	for _, key := range []string{"old", "new", "shared"} {
+		if err := os.MkdirAll(cachedModelPath(cacheDir, key, "Model"), 0755); err != nil {
+			t.Fatal(err)
+		}
+	}
+	stamp := filepath.Join(cacheDir, "Model"+cacheStampSuffix)
+	if err := writeCacheStamp(stamp, "fp1", "old"); err != nil {
+		t.Fatal(err)
+	}
+
+	// The package changed: its previous bundle goes
+	if err := updateCacheStamp(cacheDir, stamp, "fp2", "new"); err != nil {
+		t.Fatalf("updateCacheStamp: %v", err)
+	}
+	if _, err := os.Stat(filepath.Join(cacheDir, "old")); !os.IsNotExist(err) {
+		t.Errorf("replaced bundle still present (stat err = %v)", err)
+	}
+	if _, err := os.Stat(filepath.Join(cacheDir, "new")); err != nil {
+		t.Errorf("current bundle: %v", err)
+	}
+
+	// Rewriting the same key keeps the bundle
+	if err := updateCacheStamp(cacheDir, stamp, "fp3", "new"); err != nil {
+		t.Fatalf("updateCacheStamp: %v", err)
+	}
+	if _, err := os.Stat(filepath.Join(cacheDir, "new")); err != nil {
+		t.Errorf("bundle removed when its key was rewritten: %v", err)
+	}
+
+	// A bundle another package's stamp points to is kept
+	if err := writeCacheStamp(filepath.Join(cacheDir, "Other"+cacheStampSuffix), "fp", "shared"); err != nil {
+		t.Fatal(err)
+	}
+	if err := writeCacheStamp(stamp, "fp3", "shared"); err != nil {
+		t.Fatal(err)
+	}
+	if err := updateCacheStamp(cacheDir, stamp, "fp4", "new"); err != nil {
+		t.Fatalf("updateCacheStamp: %v", err)
+	}
+	if _, err := os.Stat(filepath.Join(cacheDir, "shared")); err != nil {
+		t.Errorf("bundle still in use by another stamp was removed: %v", err)
+	}
+}
+
+func TestCompileModelCachedBadPath(t *testing.T) {
+	_, err := CompileModelCached("/nonexistent/path/to/model.mlpackage", t.TempDir())
+	if err == nil {
+		t.Fatal("CompileModelCached with nonexistent path should return error")
+	}
+}
@@ -0,0 +1,165 @@
+package coreml
+
+/*
+#include "bridge.h"
+#include <stdlib.h>
+*/
+import "C"
+import (
+	"fmt"
+	"log/slog"
+	"math"
+	"time"
+	"unsafe"
+)
+
+// StatsBuckets is the number of buckets in a LatencyHistogram.
+const StatsBuckets = C.COREML_STATS_BUCKETS
+
+// LatencyHistogram is a log2 histogram of stage latencies. Bucket 0 counts
+// durations under 1µs, bucket i durations in [2^(i-1), 2^i) µs, and the last
+// bucket everything above.
+type LatencyHistogram struct {
+	Count   uint64
+	Total   time.Duration
+	Max     time.Duration
+	Buckets [StatsBuckets]uint64
+}
+
+// BucketUpperBound returns the exclusive upper bound of bucket i. The last
+// bucket is open-ended; its bound is reported as the histogram's Max instead.
+func BucketUpperBound(i int) time.Duration {
+	return time.Duration(1<<uint(i)) * time.Microsecond
+}
+
+// Mean returns the average latency, or 0 when nothing was recorded.
+func (h LatencyHistogram) Mean() time.Duration {
+	if h.Count == 0 {
+		return 0
+	}
+	return h.Total / time.Duration(h.Count)
+}
+
+// Quantile returns an upper bound for the q-quantile (0 < q ≤ 1): the upper
+// bound of the bucket holding its nearest-rank sample, capped at Max.
+func (h LatencyHistogram) Quantile(q float64) time.Duration {
+	if h.Count == 0 {
+		return 0
+	}
+	rank := uint64(math.Ceil(q * float64(h.Count)))
+	if rank == 0 {
+		rank = 1
+	}
+	var seen uint64
+	for i, n := range h.Buckets {
+		seen += n
+		if seen >= rank {
+			if i == StatsBuckets-1 {
+				return h.Max
+			}
+			return min(BucketUpperBound(i), h.Max)
+		}
+	}
+	return h.Max
+}
+
+// LogValue implements slog.LogValuer.
+func (h LatencyHistogram) LogValue() slog.Value {
+	return slog.GroupValue(
+		slog.Uint64("n", h.Count),
+		slog.Duration("mean", h.Mean()),
+		slog.Duration("p50", h.Quantile(0.50)),
+		slog.Duration("p99", h.Quantile(0.99)),
+		slog.Duration("max", h.Max),
+	)
+}
+
+// ModelStats are a model's counters accumulated by every prediction entry
+// point since load. Each prediction is split into marshal (building input
+// providers and output backings), predict (CoreML execution) and copy-out
+// (materializing results into caller tensors).
+type ModelStats struct {
+	Predictions      uint64 // successful dispatches; a batch counts once
+	Failures         uint64
+	Marshal          LatencyHistogram
+	Predict          LatencyHistogram
+	CopyOut          LatencyHistogram
+	BytesCopied      uint64       // bytes written by result copies
+	StridedCopies    uint64       // result copies that walked non-contiguous strides
+	BackingsRejected uint64       // backed predictions CoreML did not write in place
+	ComputeUnits     ComputeUnits // compute units the model was loaded with
+}
+
+// LogValue implements slog.LogValuer, so stats can be passed directly as a
+// log attribute value.
+func (s ModelStats) LogValue() slog.Value {
+	return slog.GroupValue(
+		slog.Uint64("predictions", s.Predictions),
+		slog.Uint64("failures", s.Failures),
+		slog.Any("marshal", s.Marshal),
+		slog.Any("predict", s.Predict),
+		slog.Any("copy_out", s.CopyOut),
+		slog.Uint64("bytes_copied", s.BytesCopied),
+		slog.Uint64("strided_copies", s.StridedCopies),
+		slog.Uint64("backings_rejected", s.BackingsRejected),
+		slog.String("compute_units", s.ComputeUnits.String()),
+	)
+}
+
+// Stats returns a snapshot of the model's counters. Models not loaded through
+// this package report zero stats.
+func (m *Model) Stats() ModelStats {
+	var cs C.CoreMLModelStats
+	if m == nil || !C.coreml_model_stats(m.handle, &cs) {
+		return ModelStats{}
+	}
+	return ModelStats{
+		Predictions:      uint64(cs.predictions),
+		Failures:         uint64(cs.failures),
+		Marshal:          histogramFromC(&cs.marshal),
+		Predict:          histogramFromC(&cs.predict),
+		CopyOut:          histogramFromC(&cs.copy_out),
+		BytesCopied:      uint64(cs.bytes_copied),
+		StridedCopies:    uint64(cs.strided_copies),
+		BackingsRejected: uint64(cs.backings_rejected),
+		ComputeUnits:     ComputeUnits(cs.compute_units),
+	}
+}
+
+func histogramFromC(ch *C.CoreMLLatencyHistogram) LatencyHistogram {
+	h := LatencyHistogram{
+		Count: uint64(ch.count),
+		Total: time.Duration(ch.total_ns),
+		Max:   time.Duration(ch.max_ns),
+	}
+	for i := range h.Buckets {
+		h.Buckets[i] = uint64(ch.buckets[i])
+	}
+	return h
+}
+
+// ComputePlan counts a model's top-level ML program operations by the compute
+// device CoreML prefers for them. CoreML does not report where an individual
+// prediction ran; a model loaded for the ANE whose plan places operations on
+// the CPU is the fallback to watch for.
+type ComputePlan struct {
+	CPUOps int
+	GPUOps int
+	ANEOps int
+}
+
+// ComputePlan loads the model's compute plan (macOS 14.4+, ML program models
+// only). It re-plans the model, so call it once, not per prediction.
+func (m *Model) ComputePlan() (ComputePlan, error) {
+	var cp C.CoreMLComputePlanSummary
+	var err C.CoreMLError
+	if !C.coreml_model_compute_plan(m.handle, &cp, &err) {
+		msg := "unknown error"
+		if err.message != nil {
+			msg = C.GoString(err.message)
+			C.free(unsafe.Pointer(err.message))
+		}
+		return ComputePlan{}, fmt.Errorf("compute plan: %s", msg)
+	}
+	return ComputePlan{CPUOps: int(cp.cpu_ops), GPUOps: int(cp.gpu_ops), ANEOps: int(cp.ane_ops)}, nil
+}
@@ -0,0 +1,62 @@
+package coreml
+
+import (
+	"testing"
+	"time"
+)
+
+func TestLatencyHistogramQuantile(t *testing.T) {
+	var h LatencyHistogram
+	// 90 samples in [64µs, 128µs), 10 samples in [1ms, 2ms)
+	h.Buckets[7] = 90
+	h.Buckets[11] = 10
+	h.Count = 100
+	h.Total = 90*100*time.Microsecond + 10*1500*time.Microsecond
+	h.Max = 1900 * time.Microsecond
+
+	if got, want := h.Quantile(0.5), 128*time.Microsecond; got != want {
+		t.Errorf("Quantile(0.5) = %v, want %v", got, want)
+	}
+	if got, want := h.Quantile(0.99), 1900*time.Microsecond; got != want {
+		t.Errorf("Quantile(0.99) = %v, want %v (capped at Max)", got, want)
+	}
+	if got, want := h.Mean(), 240*time.Microsecond; got != want {
+		t.Errorf("Mean() = %v, want %v", got, want)
+	}
+
+	// The median of 3 samples is the 2nd: nearest rank rounds up
+	h.Buckets[7], h.Buckets[11], h.Count = 1, 2, 3
+	if got, want := h.Quantile(0.5), 1900*time.Microsecond; got != want {
+		t.Errorf("Quantile(0.5) of 3 = %v, want %v", got, want)
+	}
+}
+
+func TestLatencyHistogramEmpty(t *testing.T) {
+	var h LatencyHistogram
+	if h.Mean() != 0 || h.Quantile(0.5) != 0 {
+		t.Errorf("empty histogram: Mean() = %v, Quantile(0.5) = %v, want 0", h.Mean(), h.Quantile(0.5))
+	}
+}
+
+func TestStatsNilModel(t *testing.T) {
+	var m Model
+	if got := m.Stats(); got.Predictions != 0 || got.Predict.Count != 0 {
+		t.Errorf("Stats() on unloaded model = %+v, want zero", got)
+	}
+}
+
+func TestComputePlanNilModel(t *testing.T) {
+	var m Model
+	if _, err := m.ComputePlan(); err == nil {
+		t.Fatal("ComputePlan on unloaded model should return error")
+	}
+}
+
+func TestComputeUnitsString(t *testing.T) {
+	if got := ComputeCPUAndANE.String(); got != "cpu+ane" {
+		t.Errorf("ComputeCPUAndANE.String() = %q, want %q", got, "cpu+ane")
+	}
+	if got := ComputeUnits(99).String(); got != "ComputeUnits(99)" {
+		t.Errorf("ComputeUnits(99).String() = %q", got)
+	}
+}
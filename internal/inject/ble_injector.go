@@ -1,17 +1,33 @@
 package inject
 
+import "sync"
+
+// bleTailRunes is how much of the text sent the BLEInjector remembers. A
+// correction reaching further back counts the older characters as typed.
+const bleTailRunes = 4096
+
 // BLESender is the interface the BLE client exposes for sending text.
 type BLESender interface {
 	Send(text string) error
+	// SendEdit has the device delete backspaces characters, then type text.
+	SendEdit(backspaces int, text string) error
+	// CanEdit reports whether the device accepts edits that delete text.
+	CanEdit() bool
 }
 
 // BLEInjector sends transcribed text over BLE to an ESP32-S3.
 type BLEInjector struct {
 	sender BLESender
+
+	mu   sync.Mutex
+	tail []rune // the end of the text sent, as callers see it
 }
 
-// Compile-time interface satisfaction check.
-var _ TextInjector = (*BLEInjector)(nil)
+// Compile-time interface satisfaction checks.
+var (
+	_ DeltaInjector = (*BLEInjector)(nil)
+	_ EditReporter  = (*BLEInjector)(nil)
+)
 
 // NewBLEInjector creates a BLEInjector backed by the given sender.
 // Panics if sender is nil (programmer error).
@@ -27,7 +43,82 @@ func (b *BLEInjector) Inject(text string) error {
 	if text == "" {
 		return nil
 	}
-	return b.sender.Send(text)
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	if err := b.sender.Send(text); err != nil {
+		return err
+	}
+	b.remember(len(b.tail), []rune(text))
+	return nil
+}
+
+// InjectDelta sends a streaming correction to the ESP32, which deletes
+// backspaces characters and types newText. Edits still waiting on the device
+// are merged there, so a revision that arrives before the text it replaces
+// is typed costs no keystrokes.
+//
+// Callers count backspaces in runes, but the device only types HID-typeable
+// characters (see hidTypeable) and skips the rest, so the edit is recomputed
+// over the typeable characters of the text it replaces and of newText.
+func (b *BLEInjector) InjectDelta(backspaces int, newText string) error {
+	if backspaces == 0 && newText == "" {
+		return nil
+	}
+	b.mu.Lock()
+	defer b.mu.Unlock()
+
+	keep := max(len(b.tail)-backspaces, 0)
+	untracked := backspaces - (len(b.tail) - keep) // older than tail
+	del, add := typeableDelta(b.tail[keep:], []rune(newText))
+	if untracked+del > 0 || add != "" {
+		if err := b.sender.SendEdit(untracked+del, add); err != nil {
+			return err
+		}
+	}
+	b.remember(keep, []rune(newText))
+	return nil
+}
+
+// CanEdit reports whether the device firmware applies backspaces.
+func (b *BLEInjector) CanEdit() bool {
+	return b.sender.CanEdit()
+}
+
+// remember replaces the tail after keep runes with text, trimming it to
+// bleTailRunes.
+func (b *BLEInjector) remember(keep int, text []rune) {
+	b.tail = append(b.tail[:keep], text...)
+	if extra := len(b.tail) - bleTailRunes; extra > 0 {
+		b.tail = append(b.tail[:0], b.tail[extra:]...)
+	}
+}
+
+// typeableDelta returns the backspaces and text that turn the typeable
+// characters of prev into those of next.
+func typeableDelta(prev, next []rune) (backspaces int, text string) {
+	p, n := typeableRunes(prev), typeableRunes(next)
+	common := 0
+	for common < len(p) && common < len(n) && p[common] == n[common] {
+		common++
+	}
+	return len(p) - common, string(n[common:])
+}
+
+// typeableRunes returns the runes of s the device types.
+func typeableRunes(s []rune) []rune {
+	out := make([]rune, 0, len(s))
+	for _, r := range s {
+		if hidTypeable(r) {
+			out = append(out, r)
+		}
+	}
+	return out
+}
+
+// hidTypeable reports whether the ESP32 types r: printable ASCII, newline,
+// tab and backspace, as gostt_hid_map_char in the firmware maps them.
+func hidTypeable(r rune) bool {
+	return r == '\n' || r == '\t' || r == '\b' || (r >= 0x20 && r <= 0x7E)
 }
 
 // Close disconnects the BLE client if the sender supports it.
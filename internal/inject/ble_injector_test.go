@@ -2,12 +2,20 @@ package inject
 
 import (
 	"errors"
+	"fmt"
 	"testing"
 )
 
-// mockBLESender records Send calls.
+// mockBLESender records Send and SendEdit calls.
 type mockBLESender struct {
-	sent []string
+	sent    []string
+	edits   []edit
+	noEdits bool
+}
+
+type edit struct {
+	backspaces int
+	text       string
 }
 
 func (m *mockBLESender) Send(text string) error {
@@ -15,6 +23,13 @@ func (m *mockBLESender) Send(text string) error {
 	return nil
 }
 
+func (m *mockBLESender) SendEdit(backspaces int, text string) error {
+	m.edits = append(m.edits, edit{backspaces, text})
+	return nil
+}
+
+func (m *mockBLESender) CanEdit() bool { return !m.noEdits }
+
 func TestBLEInjectorInject(t *testing.T) {
 	mock := &mockBLESender{}
 	inj := NewBLEInjector(mock)
@@ -46,6 +61,10 @@ type errBLESender struct{ err error }
 
 func (e *errBLESender) Send(string) error { return e.err }
 
+func (e *errBLESender) SendEdit(int, string) error { return e.err }
+
+func (e *errBLESender) CanEdit() bool { return true }
+
 func TestBLEInjectorInjectError(t *testing.T) {
 	want := errors.New("ble: disconnected")
 	inj := NewBLEInjector(&errBLESender{err: want})
@@ -55,6 +74,67 @@ func TestBLEInjectorInjectError(t *testing.T) {
 	}
 }
 
+func TestBLEInjectorInjectDelta(t *testing.T) {
+	mock := &mockBLESender{}
+	inj := NewBLEInjector(mock)
+
+	for _, e := range []edit{{0, "hello wrold"}, {4, "orld"}, {0, ""}, {3, ""}} {
+		if err := inj.InjectDelta(e.backspaces, e.text); err != nil {
+			t.Fatalf("InjectDelta(%d, %q) error = %v", e.backspaces, e.text, err)
+		}
+	}
+	// The empty delta is not sent
+	want := []edit{{0, "hello wrold"}, {4, "orld"}, {3, ""}}
+	if fmt.Sprint(mock.edits) != fmt.Sprint(want) {
+		t.Errorf("edits = %v, want %v", mock.edits, want)
+	}
+	if len(mock.sent) != 0 {
+		t.Errorf("sent = %v, want edits only", mock.sent)
+	}
+}
+
+func TestBLEInjectorInjectDeltaNonASCII(t *testing.T) {
+	mock := &mockBLESender{}
+	inj := NewBLEInjector(mock)
+
+	// The device skips "é", "’" and the emoji, so deleting them costs no
+	// backspaces and only the typeable characters are counted
+	if err := inj.Inject("I’m at the café 🙂"); err != nil {
+		t.Fatalf("Inject() error = %v", err)
+	}
+	for _, e := range []edit{{6, "cafe."}, {1, "!"}, {15, "’m here"}} {
+		if err := inj.InjectDelta(e.backspaces, e.text); err != nil {
+			t.Fatalf("InjectDelta(%d, %q) error = %v", e.backspaces, e.text, err)
+		}
+	}
+	want := []edit{{1, "e."}, {1, "!"}, {12, "here"}}
+	if fmt.Sprint(mock.edits) != fmt.Sprint(want) {
+		t.Errorf("edits = %v, want %v", mock.edits, want)
+	}
+
+	// A correction reaching past the remembered text counts the rest as typed
+	mock.edits = nil
+	inj = NewBLEInjector(mock)
+	if err := inj.InjectDelta(5, "é"); err != nil {
+		t.Fatalf("InjectDelta() error = %v", err)
+	}
+	if want := []edit{{5, ""}}; fmt.Sprint(mock.edits) != fmt.Sprint(want) {
+		t.Errorf("edits = %v, want %v", mock.edits, want)
+	}
+}
+
+func TestBLEInjectorCanEdit(t *testing.T) {
+	mock := &mockBLESender{}
+	inj := NewBLEInjector(mock)
+	if !CanEdit(inj) {
+		t.Error("CanEdit() = false, want true")
+	}
+	mock.noEdits = true
+	if CanEdit(inj) {
+		t.Error("CanEdit() with old firmware = true, want false")
+	}
+}
+
 func TestNewBLEInjectorNilSenderPanics(t *testing.T) {
 	defer func() {
 		r := recover()
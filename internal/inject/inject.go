@@ -13,8 +13,32 @@ type TextInjector interface {
 	Inject(text string) error
 }
 
-// Compile-time interface satisfaction check.
-var _ TextInjector = (*Injector)(nil)
+// DeltaInjector is implemented by injectors that can apply the incremental
+// edits of streaming transcription: delete the divergent suffix of the text
+// already injected, then add the new text.
+type DeltaInjector interface {
+	TextInjector
+	InjectDelta(backspaces int, newText string) error
+}
+
+// EditReporter is implemented by injectors that may be unable to delete
+// text already injected, such as a BLE device whose firmware predates edits.
+// An injector that does not implement it can always edit.
+type EditReporter interface {
+	CanEdit() bool
+}
+
+// CanEdit reports whether inj can apply deltas that delete text.
+func CanEdit(inj TextInjector) bool {
+	r, ok := inj.(EditReporter)
+	return !ok || r.CanEdit()
+}
+
+// Compile-time interface satisfaction checks.
+var (
+	_ TextInjector  = (*Injector)(nil)
+	_ DeltaInjector = (*Injector)(nil)
+)
 
 // Injector handles typing or pasting text into the active application.
 type Injector struct {
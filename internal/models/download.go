@@ -10,6 +10,7 @@ import (
 	"strings"
 
 	"github.com/chaz8081/gostt-writer/internal/config"
+	"github.com/chaz8081/gostt-writer/internal/coreml"
 )
 
 const (
@@ -163,10 +164,31 @@ func DownloadParakeet() error {
 		}
 	}
 
+	if err := FillCompileCache(destDir); err != nil {
+		return err
+	}
+
 	fmt.Printf("  Parakeet models installed successfully.\n")
 	return nil
 }
 
+// FillCompileCache compiles every .mlpackage in dir into the compiled-model
+// cache, so the first launch after a download or model update does not stall
+// on CoreML compilation. Models shipped as .mlmodelc need no compilation.
+func FillCompileCache(dir string) error {
+	packages, err := filepath.Glob(filepath.Join(dir, "*.mlpackage"))
+	if err != nil {
+		return fmt.Errorf("listing packages: %w", err)
+	}
+	for _, pkg := range packages {
+		fmt.Printf("  Compiling %s...\n", filepath.Base(pkg))
+		if _, err := coreml.CompileModelCached(pkg, config.DefaultCompiledModelsDir()); err != nil {
+			return fmt.Errorf("compiling %s: %w", filepath.Base(pkg), err)
+		}
+	}
+	return nil
+}
+
 // checkGitLFS verifies git-lfs is installed.
 func checkGitLFS() error {
 	cmd := exec.Command("git", "lfs", "version")
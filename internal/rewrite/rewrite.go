@@ -8,8 +8,11 @@ import (
 	"encoding/json"
 	"fmt"
 	"io"
+	"net"
 	"net/http"
+	"strings"
 	"time"
+	"unicode"
 
 	"github.com/chaz8081/gostt-writer/internal/config"
 )
@@ -17,30 +20,51 @@ import (
 // Rewriter sends transcribed text to a local Ollama LLM for transformation.
 // On any error, Rewrite returns the original text so callers can gracefully
 // fall back to raw transcription.
+//
+// Requests share a keep-alive HTTP transport, so dictations after the first
+// skip the connection setup, and ask Ollama to keep the model loaded for
+// keepAlive after each one; Warm loads it ahead of a request.
 type Rewriter struct {
-	url     string
-	model   string
-	prompt  string
-	timeout time.Duration
-	client  *http.Client
+	url       string
+	model     string
+	prompt    string
+	keepAlive string // Ollama keep_alive duration; "" for the server default
+	timeout   time.Duration
+	client    *http.Client
 }
 
+// idleConnTimeout is how long an idle connection to Ollama is kept open
+// between dictations.
+const idleConnTimeout = 10 * time.Minute
+
 // New creates a Rewriter from the given config.
 func New(cfg *config.RewriteConfig) *Rewriter {
 	timeout := time.Duration(cfg.TimeoutSecs) * time.Second
 	return &Rewriter{
-		url:     cfg.OllamaURL,
-		model:   cfg.Model,
-		prompt:  cfg.Prompt,
-		timeout: timeout,
-		client:  &http.Client{},
+		url:       cfg.OllamaURL,
+		model:     cfg.Model,
+		prompt:    cfg.Prompt,
+		keepAlive: cfg.KeepAlive,
+		timeout:   timeout,
+		client: &http.Client{
+			Transport: &http.Transport{
+				Proxy: http.ProxyFromEnvironment,
+				DialContext: (&net.Dialer{
+					Timeout:   5 * time.Second,
+					KeepAlive: 30 * time.Second,
+				}).DialContext,
+				MaxIdleConnsPerHost: 4,
+				IdleConnTimeout:     idleConnTimeout,
+			},
+		},
 	}
 }
 
 type chatRequest struct {
-	Model    string        `json:"model"`
-	Messages []chatMessage `json:"messages"`
-	Stream   bool          `json:"stream"`
+	Model     string        `json:"model"`
+	Messages  []chatMessage `json:"messages"`
+	Stream    bool          `json:"stream"`
+	KeepAlive string        `json:"keep_alive,omitempty"`
 }
 
 type chatMessage struct {
@@ -50,6 +74,8 @@ type chatMessage struct {
 
 type chatResponse struct {
 	Message chatMessage `json:"message"`
+	Done    bool        `json:"done"`
+	Error   string      `json:"error"`
 }
 
 // Rewrite sends rawText to the Ollama LLM for transformation using the
@@ -59,36 +85,12 @@ func (r *Rewriter) Rewrite(ctx context.Context, rawText string) (string, error)
 	ctx, cancel := context.WithTimeout(ctx, r.timeout)
 	defer cancel()
 
-	req := chatRequest{
-		Model: r.model,
-		Messages: []chatMessage{
-			{Role: "system", Content: r.prompt},
-			{Role: "user", Content: rawText},
-		},
-		Stream: false,
-	}
-
-	body, err := json.Marshal(req)
+	resp, err := r.chat(ctx, r.messages(rawText), false)
 	if err != nil {
-		return rawText, fmt.Errorf("rewrite: marshal request: %w", err)
-	}
-
-	httpReq, err := http.NewRequestWithContext(ctx, http.MethodPost, r.url+"/api/chat", bytes.NewReader(body))
-	if err != nil {
-		return rawText, fmt.Errorf("rewrite: create request: %w", err)
-	}
-	httpReq.Header.Set("Content-Type", "application/json")
-
-	resp, err := r.client.Do(httpReq)
-	if err != nil {
-		return rawText, fmt.Errorf("rewrite: request failed: %w", err)
+		return rawText, err
 	}
 	defer resp.Body.Close()
 
-	if resp.StatusCode != http.StatusOK {
-		return rawText, fmt.Errorf("rewrite: ollama returned HTTP %d", resp.StatusCode)
-	}
-
 	respBody, err := io.ReadAll(resp.Body)
 	if err != nil {
 		return rawText, fmt.Errorf("rewrite: read response: %w", err)
@@ -106,3 +108,125 @@ func (r *Rewriter) Rewrite(ctx context.Context, rawText string) (string, error)
 
 	return rewritten, nil
 }
+
+// RewriteStream is Rewrite with the response streamed: onStable is called
+// with each longer stable prefix of the rewrite as tokens arrive, so it can
+// be typed before generation ends. A prefix is stable up to the last
+// whitespace: only whole words, without leading whitespace. Every prefix
+// extends the one before, and the result, trimmed of surrounding whitespace,
+// extends the last. On any error it returns (rawText, err), and the prefixes
+// already reported are not part of the result.
+func (r *Rewriter) RewriteStream(ctx context.Context, rawText string, onStable func(prefix string)) (string, error) {
+	ctx, cancel := context.WithTimeout(ctx, r.timeout)
+	defer cancel()
+
+	resp, err := r.chat(ctx, r.messages(rawText), true)
+	if err != nil {
+		return rawText, err
+	}
+	defer resp.Body.Close()
+
+	var text strings.Builder
+	var stable int // bytes of text reported
+	dec := json.NewDecoder(resp.Body)
+	for {
+		var chunk chatResponse
+		if err := dec.Decode(&chunk); err != nil {
+			if err == io.EOF {
+				err = io.ErrUnexpectedEOF
+			}
+			return rawText, fmt.Errorf("rewrite: read stream: %w", err)
+		}
+		if chunk.Error != "" {
+			return rawText, fmt.Errorf("rewrite: ollama: %s", chunk.Error)
+		}
+		if text.Len() == 0 {
+			chunk.Message.Content = strings.TrimLeftFunc(chunk.Message.Content, unicode.IsSpace)
+		}
+		text.WriteString(chunk.Message.Content)
+		if chunk.Done {
+			break
+		}
+		if n := stablePrefix(text.String()); n > stable {
+			stable = n
+			onStable(text.String()[:n])
+		}
+	}
+	// Leave the connection reusable
+	_, _ = io.Copy(io.Discard, resp.Body)
+
+	rewritten := strings.TrimRightFunc(text.String(), unicode.IsSpace)
+	if rewritten == "" {
+		return rawText, nil
+	}
+	return rewritten, nil
+}
+
+// stablePrefix returns the length of the stable prefix of text, which has no
+// leading whitespace: up to its last whitespace, with none at the end.
+func stablePrefix(text string) int {
+	end := strings.LastIndexFunc(text, unicode.IsSpace)
+	if end < 0 {
+		return 0
+	}
+	return len(strings.TrimRightFunc(text[:end], unicode.IsSpace))
+}
+
+// Warm asks Ollama to load the model, if it is not already, and keep it
+// loaded for the configured keep-alive, so the next rewrite does not wait
+// for a cold start. Cheap when the model is loaded; call it when a
+// dictation starts.
+func (r *Rewriter) Warm(ctx context.Context) error {
+	ctx, cancel := context.WithTimeout(ctx, r.timeout)
+	defer cancel()
+
+	// A chat without messages only loads the model
+	resp, err := r.chat(ctx, []chatMessage{}, false)
+	if err != nil {
+		return err
+	}
+	defer resp.Body.Close()
+	_, _ = io.Copy(io.Discard, resp.Body)
+	return nil
+}
+
+// messages returns the chat messages that rewrite rawText.
+func (r *Rewriter) messages(rawText string) []chatMessage {
+	return []chatMessage{
+		{Role: "system", Content: r.prompt},
+		{Role: "user", Content: rawText},
+	}
+}
+
+// chat posts a chat request and returns the response once Ollama has
+// accepted it. The caller must close the body.
+func (r *Rewriter) chat(ctx context.Context, messages []chatMessage, stream bool) (*http.Response, error) {
+	req := chatRequest{
+		Model:     r.model,
+		Messages:  messages,
+		Stream:    stream,
+		KeepAlive: r.keepAlive,
+	}
+
+	body, err := json.Marshal(req)
+	if err != nil {
+		return nil, fmt.Errorf("rewrite: marshal request: %w", err)
+	}
+
+	httpReq, err := http.NewRequestWithContext(ctx, http.MethodPost, r.url+"/api/chat", bytes.NewReader(body))
+	if err != nil {
+		return nil, fmt.Errorf("rewrite: create request: %w", err)
+	}
+	httpReq.Header.Set("Content-Type", "application/json")
+
+	resp, err := r.client.Do(httpReq)
+	if err != nil {
+		return nil, fmt.Errorf("rewrite: request failed: %w", err)
+	}
+	if resp.StatusCode != http.StatusOK {
+		_, _ = io.Copy(io.Discard, resp.Body)
+		resp.Body.Close()
+		return nil, fmt.Errorf("rewrite: ollama returned HTTP %d", resp.StatusCode)
+	}
+	return resp, nil
+}
@@ -3,8 +3,10 @@ package rewrite
 import (
 	"context"
 	"encoding/json"
+	"net"
 	"net/http"
 	"net/http/httptest"
+	"sync/atomic"
 	"testing"
 	"time"
 
@@ -129,3 +131,159 @@ func TestRewriteEmptyLLMResponse(t *testing.T) {
 		t.Errorf("Rewrite() = %q, want %q (raw fallback)", result, "hello")
 	}
 }
+
+// streamServer serves a streaming chat response with one Ollama NDJSON chunk
+// per element of tokens, then a done chunk, and records the decoded request.
+func streamServer(t *testing.T, tokens []string, got *chatRequest) *httptest.Server {
+	t.Helper()
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		if err := json.NewDecoder(r.Body).Decode(got); err != nil {
+			t.Errorf("failed to decode request: %v", err)
+		}
+		enc := json.NewEncoder(w)
+		for _, tok := range tokens {
+			enc.Encode(chatResponse{Message: chatMessage{Role: "assistant", Content: tok}})
+			w.(http.Flusher).Flush()
+		}
+		enc.Encode(chatResponse{Done: true})
+	}))
+	t.Cleanup(srv.Close)
+	return srv
+}
+
+func TestRewriteStream(t *testing.T) {
+	var req chatRequest
+	srv := streamServer(t, []string{" Hello", ",", " wor", "ld", ". How", " are", " you?\n"}, &req)
+
+	rw := newTestRewriter(srv.URL, 10)
+	var prefixes []string
+	result, err := rw.RewriteStream(context.Background(), "hello world how are you", func(prefix string) {
+		prefixes = append(prefixes, prefix)
+	})
+	if err != nil {
+		t.Fatalf("RewriteStream() error = %v", err)
+	}
+	if result != "Hello, world. How are you?" {
+		t.Errorf("RewriteStream() = %q, want %q", result, "Hello, world. How are you?")
+	}
+	if !req.Stream {
+		t.Error("stream = false, want true")
+	}
+
+	// Whole words only, each prefix extending the last and the result
+	want := []string{"Hello,", "Hello, world.", "Hello, world. How", "Hello, world. How are you?"}
+	if len(prefixes) != len(want) {
+		t.Fatalf("prefixes = %q, want %q", prefixes, want)
+	}
+	for i := range want {
+		if prefixes[i] != want[i] {
+			t.Errorf("prefixes[%d] = %q, want %q", i, prefixes[i], want[i])
+		}
+	}
+}
+
+func TestRewriteStreamError(t *testing.T) {
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		enc := json.NewEncoder(w)
+		enc.Encode(chatResponse{Message: chatMessage{Content: "Partial "}})
+		enc.Encode(chatResponse{Error: "model crashed"})
+	}))
+	defer srv.Close()
+
+	rw := newTestRewriter(srv.URL, 10)
+	result, err := rw.RewriteStream(context.Background(), "hello", func(string) {})
+	if err == nil {
+		t.Fatal("RewriteStream() should return error for a stream error")
+	}
+	if result != "hello" {
+		t.Errorf("RewriteStream() fallback = %q, want %q", result, "hello")
+	}
+}
+
+func TestRewriteStreamTruncated(t *testing.T) {
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		json.NewEncoder(w).Encode(chatResponse{Message: chatMessage{Content: "Partial text"}})
+	}))
+	defer srv.Close()
+
+	rw := newTestRewriter(srv.URL, 10)
+	result, err := rw.RewriteStream(context.Background(), "hello", func(string) {})
+	if err == nil {
+		t.Fatal("RewriteStream() should return error for a stream without done")
+	}
+	if result != "hello" {
+		t.Errorf("RewriteStream() fallback = %q, want %q", result, "hello")
+	}
+}
+
+func TestRewriteStreamEmpty(t *testing.T) {
+	var req chatRequest
+	srv := streamServer(t, []string{"  ", "\n"}, &req)
+
+	rw := newTestRewriter(srv.URL, 10)
+	result, err := rw.RewriteStream(context.Background(), "hello", func(prefix string) {
+		t.Errorf("unexpected prefix %q", prefix)
+	})
+	if err != nil {
+		t.Fatalf("RewriteStream() error = %v", err)
+	}
+	if result != "hello" {
+		t.Errorf("RewriteStream() = %q, want %q (raw fallback)", result, "hello")
+	}
+}
+
+func TestRewriteStreamReusesConnection(t *testing.T) {
+	var conns atomic.Int32
+	srv := httptest.NewUnstartedServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		enc := json.NewEncoder(w)
+		enc.Encode(chatResponse{Message: chatMessage{Content: "Hello there."}})
+		enc.Encode(chatResponse{Done: true})
+	}))
+	srv.Config.ConnState = func(_ net.Conn, state http.ConnState) {
+		if state == http.StateNew {
+			conns.Add(1)
+		}
+	}
+	srv.Start()
+	defer srv.Close()
+
+	rw := newTestRewriter(srv.URL, 10)
+	for i := 0; i < 3; i++ {
+		if _, err := rw.RewriteStream(context.Background(), "hello there", func(string) {}); err != nil {
+			t.Fatalf("RewriteStream() error = %v", err)
+		}
+	}
+	if n := conns.Load(); n != 1 {
+		t.Errorf("connections = %d, want 1", n)
+	}
+}
+
+func TestWarm(t *testing.T) {
+	var req chatRequest
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		if err := json.NewDecoder(r.Body).Decode(&req); err != nil {
+			t.Errorf("failed to decode request: %v", err)
+		}
+		json.NewEncoder(w).Encode(chatResponse{Done: true})
+	}))
+	defer srv.Close()
+
+	cfg := &config.RewriteConfig{
+		OllamaURL:   srv.URL,
+		Model:       "test-model",
+		TimeoutSecs: 10,
+		KeepAlive:   "30m",
+	}
+	if err := New(cfg).Warm(context.Background()); err != nil {
+		t.Fatalf("Warm() error = %v", err)
+	}
+	if req.Model != "test-model" {
+		t.Errorf("model = %q, want %q", req.Model, "test-model")
+	}
+	if len(req.Messages) != 0 {
+		t.Errorf("messages count = %d, want 0", len(req.Messages))
+	}
+	if req.KeepAlive != "30m" {
+		t.Errorf("keep_alive = %q, want %q", req.KeepAlive, "30m")
+	}
+}
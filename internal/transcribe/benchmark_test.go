@@ -1,85 +1,48 @@
 package transcribe
 
 import (
-	"encoding/json"
+	"errors"
+	"flag"
+	"fmt"
+	"io/fs"
 	"os"
 	"path/filepath"
 	"testing"
 	"time"
 
-	"github.com/go-audio/wav"
+	"github.com/chaz8081/gostt-writer/internal/benchreport"
+	"github.com/chaz8081/gostt-writer/internal/coreml"
 )
 
-// benchSample holds a test audio sample and its reference transcript.
-type benchSample struct {
-	Label      string  `json:"label"`
-	File       string  `json:"file"`
-	Transcript string  `json:"transcript"`
-	DurationS  float64 `json:"duration_sec"`
-}
+var benchReportPath = flag.String("bench-report", "", "write the stage benchmark results as JSON to this file")
 
-// benchReferences is the top-level structure of testdata/references.json.
-type benchReferences struct {
-	Samples []benchSample `json:"samples"`
-}
+// benchReport collects the stage benchmark results for -bench-report.
+var benchReport = benchreport.New()
 
-// loadBenchSamples reads references.json and loads all audio samples.
-// benchSampleWithAudio pairs a benchSample with its decoded audio data.
-type benchSampleWithAudio struct {
-	benchSample
-	audio []float32
+func TestMain(m *testing.M) {
+	flag.Parse()
+	code := m.Run()
+	if *benchReportPath != "" && benchReport.Len() > 0 {
+		if err := benchReport.WriteFile(*benchReportPath); err != nil {
+			fmt.Fprintln(os.Stderr, err)
+			if code == 0 {
+				code = 1
+			}
+		}
+	}
+	os.Exit(code)
 }
 
-// loadBenchSamples reads references.json and loads all audio samples.
-func loadBenchSamples(b *testing.B) []benchSampleWithAudio {
+// loadBenchSamples loads the audio samples listed in testdata/references.json.
+func loadBenchSamples(b *testing.B) []benchreport.Sample {
 	b.Helper()
 
-	refPath := filepath.Join("testdata", "references.json")
-	data, err := os.ReadFile(refPath)
-	if err != nil {
-		b.Fatalf("read references.json: %v", err)
-	}
-
-	var refs benchReferences
-	if err := json.Unmarshal(data, &refs); err != nil {
-		b.Fatalf("parse references.json: %v", err)
-	}
-
-	results := make([]benchSampleWithAudio, 0, len(refs.Samples))
-
-	for _, s := range refs.Samples {
-		wavPath := filepath.Join("testdata", s.File)
-		f, err := os.Open(wavPath)
-		if err != nil {
-			b.Skipf("WAV file not found at %s: %v", wavPath, err)
-		}
-
-		dec := wavDecode(f)
-		_ = f.Close()
-		if dec == nil {
-			b.Fatalf("failed to decode WAV %s", wavPath)
-		}
-
-		results = append(results, benchSampleWithAudio{
-			benchSample: s,
-			audio:       dec,
-		})
+	samples, err := benchreport.LoadSamples("testdata")
+	if errors.Is(err, fs.ErrNotExist) {
+		b.Skipf("benchmark audio not found: %v", err)
 	}
-
-	return results
-}
-
-// wavDecode opens and decodes a WAV file from an os.File, returning float32
-// samples normalized to [-1.0, 1.0]. Returns nil on error.
-func wavDecode(f *os.File) []float32 {
-	dec := wav.NewDecoder(f)
-	buf, err := dec.FullPCMBuffer()
 	if err != nil {
-		return nil
-	}
-	samples := make([]float32, len(buf.Data))
-	for i, s := range buf.Data {
-		samples[i] = float32(s) / 32768.0
+		b.Fatalf("load samples: %v", err)
 	}
 	return samples
 }
@@ -105,12 +68,12 @@ func BenchmarkWhisperProcess(b *testing.B) {
 			b.ReportMetric(s.DurationS*1000, "audio-ms")
 
 			// Warm up: single run outside the loop
-			_, _ = tr.Process(s.audio)
+			_, _ = tr.Process(s.Audio)
 
 			var lastText string
 			b.ResetTimer()
 			for i := 0; i < b.N; i++ {
-				text, err := tr.Process(s.audio)
+				text, err := tr.Process(s.Audio)
 				if err != nil {
 					b.Fatalf("Process: %v", err)
 				}
@@ -150,12 +113,12 @@ func BenchmarkParakeetProcess(b *testing.B) {
 			b.ReportMetric(s.DurationS*1000, "audio-ms")
 
 			// Warm up: single run outside the loop
-			_, _ = tr.Process(s.audio)
+			_, _ = tr.Process(s.Audio)
 
 			var lastText string
 			b.ResetTimer()
 			for i := 0; i < b.N; i++ {
-				text, err := tr.Process(s.audio)
+				text, err := tr.Process(s.Audio)
 				if err != nil {
 					b.Fatalf("Process: %v", err)
 				}
@@ -182,15 +145,9 @@ func BenchmarkWhisperLatency(b *testing.B) {
 	}
 
 	// Use short sample only for latency measurement
-	wavPath := filepath.Join("testdata", "short.wav")
-	f, err := os.Open(wavPath)
+	audio, err := benchreport.DecodeWAV(filepath.Join("testdata", "short.wav"))
 	if err != nil {
-		b.Skipf("short.wav not found: %v", err)
-	}
-	audio := wavDecode(f)
-	_ = f.Close()
-	if audio == nil {
-		b.Fatal("failed to decode short.wav")
+		b.Skipf("short.wav: %v", err)
 	}
 
 	for i := 0; i < b.N; i++ {
@@ -223,15 +180,9 @@ func BenchmarkParakeetLatency(b *testing.B) {
 	}
 
 	// Use short sample only for latency measurement
-	wavPath := filepath.Join("testdata", "short.wav")
-	f, err := os.Open(wavPath)
+	audio, err := benchreport.DecodeWAV(filepath.Join("testdata", "short.wav"))
 	if err != nil {
-		b.Skipf("short.wav not found: %v", err)
-	}
-	audio := wavDecode(f)
-	_ = f.Close()
-	if audio == nil {
-		b.Fatal("failed to decode short.wav")
+		b.Skipf("short.wav: %v", err)
 	}
 
 	for i := 0; i < b.N; i++ {
@@ -255,3 +206,213 @@ func BenchmarkParakeetLatency(b *testing.B) {
 		b.ReportMetric(float64(latency.Milliseconds()), "first-call-ms")
 	}
 }
+
+// BenchmarkParakeetDecodeStep measures one decoder plus joint step of the Go
+// reference TDT decode. Both run through prepared calls over preallocated
+// buffers, so a step should report 0 allocs/op.
+func BenchmarkParakeetDecodeStep(b *testing.B) {
+	modelDir := filepath.Join("..", "..", "models", "parakeet-tdt-v2")
+	if _, err := os.Stat(filepath.Join(modelDir, "Encoder.mlmodelc")); err != nil {
+		b.Skipf("parakeet models not found at %s (run 'task parakeet-model')", modelDir)
+	}
+
+	tr, err := NewParakeetTranscriber(modelDir)
+	if err != nil {
+		b.Fatalf("NewParakeetTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+	ref := newReferenceDecoder(tr)
+	defer ref.Close()
+
+	encoderStep := make([]float32, parakeetEncoderHidden)
+	lstmStateSize := parakeetLSTMLayers * parakeetDecoderHidden
+	h, c := make([]float32, lstmStateSize), make([]float32, lstmStateSize)
+
+	// Warm up: binds the prepared calls and output backings
+	decoderOut, h, c, err := ref.runDecoder(int32(parakeetBlankID), h, c)
+	if err != nil {
+		b.Fatalf("runDecoder: %v", err)
+	}
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		tokenID, _, err := ref.runJoint(encoderStep, decoderOut)
+		if err != nil {
+			b.Fatalf("runJoint: %v", err)
+		}
+		if decoderOut, h, c, err = ref.runDecoder(tokenID, h, c); err != nil {
+			b.Fatalf("runDecoder: %v", err)
+		}
+	}
+}
+
+// BenchmarkParakeetDecode measures the production decode of one encoded
+// window through the transcriber's reused native TDT decoder, as Process runs
+// it. Allocs/op counts only the Go side, which should report 0.
+func BenchmarkParakeetDecode(b *testing.B) {
+	modelDir := filepath.Join("..", "..", "models", "parakeet-tdt-v2")
+	if _, err := os.Stat(filepath.Join(modelDir, "Encoder.mlmodelc")); err != nil {
+		b.Skipf("parakeet models not found at %s (run 'task parakeet-model')", modelDir)
+	}
+	audio, err := benchreport.DecodeWAV(filepath.Join("testdata", "short.wav"))
+	if err != nil {
+		b.Skipf("short.wav: %v", err)
+	}
+
+	tr, err := NewParakeetTranscriber(modelDir)
+	if err != nil {
+		b.Fatalf("NewParakeetTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+
+	full := tr.buckets[len(tr.buckets)-1]
+	prepResult, err := full.runPreprocessor(audio)
+	if err != nil {
+		b.Fatalf("runPreprocessor: %v", err)
+	}
+	encResult, err := full.runEncoder(prepResult)
+	if err != nil {
+		b.Fatalf("runEncoder: %v", err)
+	}
+
+	// Warm up: sizes the decoder's token buffer
+	if _, err := tr.decodeEncoded(encResult); err != nil {
+		b.Fatalf("decodeEncoded: %v", err)
+	}
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if _, err := tr.decodeEncoded(encResult); err != nil {
+			b.Fatalf("decodeEncoded: %v", err)
+		}
+	}
+}
+
+// stageTimed is a transcriber whose pipeline stages can be timed.
+type stageTimed interface {
+	Process(samples []float32) (string, error)
+	SetStageTimer(t *StageTimer)
+}
+
+// BenchmarkWhisperStages reports whisper latency percentiles per stage.
+func BenchmarkWhisperStages(b *testing.B) {
+	modelPath := filepath.Join("..", "..", "models", "ggml-base.en.bin")
+	if _, err := os.Stat(modelPath); err != nil {
+		b.Skipf("whisper model not found at %s (run 'task whisper-model')", modelPath)
+	}
+
+	tr, err := NewWhisperTranscriber(modelPath)
+	if err != nil {
+		b.Fatalf("NewWhisperTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+
+	runStageBenchmark(b, "whisper", tr, nil)
+}
+
+// BenchmarkParakeetStages reports Parakeet latency percentiles per stage,
+// plus each CoreML model's marshal, predict and copy-out cost per run.
+func BenchmarkParakeetStages(b *testing.B) {
+	modelDir := filepath.Join("..", "..", "models", "parakeet-tdt-v2")
+	if _, err := os.Stat(filepath.Join(modelDir, "Encoder.mlmodelc")); err != nil {
+		b.Skipf("parakeet models not found at %s (run 'task parakeet-model')", modelDir)
+	}
+
+	tr, err := NewParakeetTranscriber(modelDir)
+	if err != nil {
+		b.Fatalf("NewParakeetTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+
+	runStageBenchmark(b, "parakeet", tr, tr.models())
+}
+
+// runStageBenchmark runs tr over every sample, timing each Process call and
+// its stages, and adds one entry per sample to benchReport. Total latency,
+// RTF and allocations are also reported as benchmark metrics.
+func runStageBenchmark(b *testing.B, backend string, tr stageTimed, models []namedModel) {
+	samples := loadBenchSamples(b)
+
+	timer := NewStageTimer()
+	tr.SetStageTimer(timer)
+	defer tr.SetStageTimer(nil)
+
+	for _, s := range samples {
+		s := s // capture
+		b.Run(s.Label, func(b *testing.B) {
+			// Warm up: single run outside the loop
+			if _, err := tr.Process(s.Audio); err != nil {
+				b.Fatalf("Process: %v", err)
+			}
+
+			rec := benchreport.NewRecorder(backend+"/"+s.Label, s.Duration())
+			before := modelStats(models)
+			var lastText string
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				timer.Reset()
+				rec.Begin()
+				b.StartTimer()
+
+				start := time.Now()
+				text, err := tr.Process(s.Audio)
+				elapsed := time.Since(start)
+
+				b.StopTimer()
+				if err != nil {
+					b.Fatalf("Process: %v", err)
+				}
+				rec.End(elapsed, timer.Totals())
+				lastText = text
+				b.StartTimer()
+			}
+			b.StopTimer()
+
+			e := rec.Entry(modelCosts(before, modelStats(models)))
+			benchReport.Add(e)
+
+			b.ReportMetric(s.DurationS*1000, "audio-ms")
+			b.ReportMetric(e.RTF, "rtf")
+			b.ReportMetric(e.Total.P50, "p50-ms")
+			b.ReportMetric(e.Total.P99, "p99-ms")
+			b.ReportMetric(e.AllocsPerOp, "allocs/run")
+			b.ReportMetric(ComputeWER(s.Transcript, lastText).WER, "wer")
+		})
+	}
+}
+
+// modelStats snapshots the stats of each model by name.
+func modelStats(models []namedModel) map[string]coreml.ModelStats {
+	stats := make(map[string]coreml.ModelStats, len(models))
+	for _, nm := range models {
+		stats[nm.name] = nm.model.Stats()
+	}
+	return stats
+}
+
+// modelCosts returns what each model spent between two snapshots. Models that
+// ran no predictions (unused length buckets) are left out.
+func modelCosts(before, after map[string]coreml.ModelStats) map[string]benchreport.ModelCost {
+	costs := make(map[string]benchreport.ModelCost)
+	for name, a := range after {
+		s := before[name]
+		if a.Predictions == s.Predictions {
+			continue
+		}
+		costs[name] = benchreport.ModelCost{
+			Predictions: float64(a.Predictions - s.Predictions),
+			MarshalMs:   durationMs(a.Marshal.Total - s.Marshal.Total),
+			PredictMs:   durationMs(a.Predict.Total - s.Predict.Total),
+			CopyOutMs:   durationMs(a.CopyOut.Total - s.CopyOut.Total),
+			BytesCopied: float64(a.BytesCopied - s.BytesCopied),
+		}
+	}
+	return costs
+}
+
+func durationMs(d time.Duration) float64 {
+	return float64(d) / float64(time.Millisecond)
+}
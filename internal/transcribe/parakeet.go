@@ -1,32 +1,60 @@
 package transcribe
 
 import (
+	"context"
 	"fmt"
 	"log/slog"
 	"math"
+	"os"
+	"path/filepath"
+	"sync"
+	"time"
 	"unsafe"
 
+	"github.com/chaz8081/gostt-writer/internal/config"
 	"github.com/chaz8081/gostt-writer/internal/coreml"
 )
 
-const parakeetMaxSamples = 240000 // 15s at 16kHz
+const (
+	parakeetSampleRate = 16000
+	parakeetMaxSamples = 240000 // 15s at 16kHz
+
+	// parakeetWindowKeepMs is the left context each window of long audio
+	// re-encodes before the position its decode resumes at.
+	parakeetWindowKeepMs = 2000
+)
+
+// parakeetTDTConfig describes the TDT decode loop for the native bridge decoder.
+var parakeetTDTConfig = coreml.TDTConfig{
+	EncoderHidden:     parakeetEncoderHidden,
+	DecoderHidden:     parakeetDecoderHidden,
+	LSTMLayers:        parakeetLSTMLayers,
+	BlankID:           parakeetBlankID,
+	MaxSymbolsPerStep: parakeetMaxSymsPerStep,
+	DurationBins:      parakeetDurationBins,
+	JointWindow:       parakeetJointWindow,
+}
 
 // ParakeetTranscriber uses Parakeet TDT 0.6B v2 via CoreML for speech-to-text.
 type ParakeetTranscriber struct {
-	preprocessor *coreml.Model
-	encoder      *coreml.Model
-	decoder      *coreml.Model
-	joint        *coreml.Model
-	vocab        []string
-
-	// Cached I/O names discovered via model introspection (sorted alphabetically).
-	prepInputNames  []string
-	encInputNames   []string
-	decInputNames   []string
-	jointInputNames []string
+	// Preprocessor/encoder pairs by input length, ascending; the last one
+	// covers the full parakeetMaxSamples window.
+	buckets []*parakeetBucket
+	decoder *coreml.Model
+	joint   *coreml.Model
+	vocab   []string
+
+	// Native TDT decode context for decoder and joint. Its arrays and prepared
+	// calls are allocated once and reused by every window and stream chunk.
+	tdt *coreml.TDTDecoder
+
+	stages *StageTimer // per-stage timing, nil unless benchmarking
 }
 
-// NewParakeetTranscriber loads the 4 CoreML models and vocabulary from modelDir.
+// NewParakeetTranscriber loads the 4 CoreML models and vocabulary from modelDir,
+// plus any shorter preprocessor/encoder length buckets found there (see
+// parakeetBucketSeconds). The models are loaded concurrently, each with its own
+// compute-unit options.
 func NewParakeetTranscriber(modelDir string) (*ParakeetTranscriber, error) {
 	// Load vocabulary
 	vocabPath := modelDir + "/parakeet_vocab.json"
@@ -35,67 +63,168 @@ func NewParakeetTranscriber(modelDir string) (*ParakeetTranscriber, error) {
 		return nil, fmt.Errorf("parakeet: %w", err)
 	}
 
-	// Load CoreML models
-	// Preprocessor runs on CPU (mel spectrogram is faster on CPU)
-	coreml.SetComputeUnits(coreml.ComputeCPUOnly)
-	preprocessor, err := coreml.LoadModel(modelDir + "/Preprocessor.mlmodelc")
-	if err != nil {
-		return nil, fmt.Errorf("parakeet: load preprocessor: %w", err)
+	p := &ParakeetTranscriber{vocab: vocab, buckets: discoverBuckets(modelDir)}
+
+	// Preprocessor runs on CPU (mel spectrogram is faster on CPU);
+	// encoder, decoder, joint run on all units (ANE preferred).
+	cpuOnly := coreml.LoadOptions{ComputeUnits: coreml.ComputeCPUOnly}
+	all := coreml.LoadOptions{ComputeUnits: coreml.ComputeAll}
+	type modelLoad struct {
+		name string
+		base string
+		opts coreml.LoadOptions
+		dst  **coreml.Model
+	}
+	var loads []modelLoad
+	for _, b := range p.buckets {
+		loads = append(loads,
+			modelLoad{"preprocessor" + b.suffix, "Preprocessor" + b.suffix, cpuOnly, &b.preprocessor},
+			modelLoad{"encoder" + b.suffix, "Encoder" + b.suffix, all, &b.encoder})
+	}
+	loads = append(loads,
+		modelLoad{"decoder", "Decoder", all, &p.decoder},
+		modelLoad{"joint", "JointDecision", all, &p.joint})
+
+	start := time.Now()
+	errs := make([]error, len(loads))
+	var wg sync.WaitGroup
+	for i, l := range loads {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			path, err := resolveCompiledModel(modelDir, l.base)
+			if err != nil {
+				errs[i] = fmt.Errorf("parakeet: compile %s: %w", l.name, err)
+				return
+			}
+			m, err := coreml.LoadModelWithOptions(path, l.opts)
+			if err != nil {
+				errs[i] = fmt.Errorf("parakeet: load %s: %w", l.name, err)
+				return
+			}
+			*l.dst = m
+		}()
 	}
+	wg.Wait()
 
-	// Encoder, decoder, joint run on all units (ANE preferred)
-	coreml.SetComputeUnits(coreml.ComputeAll)
-	encoder, err := coreml.LoadModel(modelDir + "/Encoder.mlmodelc")
-	if err != nil {
-		preprocessor.Close()
-		return nil, fmt.Errorf("parakeet: load encoder: %w", err)
+	for _, err := range errs {
+		if err != nil {
+			_ = p.Close()
+			return nil, err
+		}
 	}
+	slog.Debug("parakeet models loaded", "elapsed", time.Since(start), "buckets", len(p.buckets))
 
-	decoder, err := coreml.LoadModel(modelDir + "/Decoder.mlmodelc")
-	if err != nil {
-		preprocessor.Close()
-		encoder.Close()
-		return nil, fmt.Errorf("parakeet: load decoder: %w", err)
+	// Cache sorted input names from model introspection
+	for _, b := range p.buckets {
+		b.cacheInputNames()
 	}
 
-	joint, err := coreml.LoadModel(modelDir + "/JointDecision.mlmodelc")
+	p.tdt, err = coreml.NewTDTDecoder(p.decoder, p.joint, parakeetTDTConfig)
 	if err != nil {
-		preprocessor.Close()
-		encoder.Close()
-		decoder.Close()
-		return nil, fmt.Errorf("parakeet: load joint: %w", err)
+		_ = p.Close()
+		return nil, fmt.Errorf("parakeet: %w", err)
 	}
 
-	p := &ParakeetTranscriber{
-		preprocessor: preprocessor,
-		encoder:      encoder,
-		decoder:      decoder,
-		joint:        joint,
-		vocab:        vocab,
+	// Log model I/O for debugging
+	for _, b := range p.buckets {
+		introspectModel("Preprocessor"+b.suffix, b.preprocessor)
+		introspectModel("Encoder"+b.suffix, b.encoder)
 	}
+	introspectModel("Decoder", p.decoder)
+	introspectModel("JointDecision", p.joint)
 
-	// Cache sorted input names from model introspection
-	p.prepInputNames = modelInputNames(preprocessor)
-	p.encInputNames = modelInputNames(encoder)
-	p.decInputNames = modelInputNames(decoder)
-	p.jointInputNames = modelInputNames(joint)
+	return p, nil
+}
 
-	// Log model I/O for debugging
-	introspectModel("Preprocessor", preprocessor)
-	introspectModel("Encoder", encoder)
-	introspectModel("Decoder", decoder)
-	introspectModel("JointDecision", joint)
+// resolveCompiledModel returns the .mlmodelc path for model name in modelDir.
+// A shipped .mlmodelc is used as-is; otherwise a .mlpackage source is compiled
+// through the content-addressed cache, which is a cheap stat check once warm.
+func resolveCompiledModel(modelDir, name string) (string, error) {
+	compiled := filepath.Join(modelDir, name+".mlmodelc")
+	if _, err := os.Stat(compiled); err == nil {
+		return compiled, nil
+	}
+	pkg := filepath.Join(modelDir, name+".mlpackage")
+	if _, err := os.Stat(pkg); err == nil {
+		return coreml.CompileModelCached(pkg, config.DefaultCompiledModelsDir())
+	}
+	return compiled, nil // missing: LoadModel reports a clear error
+}
 
-	return p, nil
+// Prewarm runs one prediction through every stage, in every length bucket, on
+// silent audio so CoreML finishes ANE compilation and output backings are
+// allocated before the first real dictation.
+func (p *ParakeetTranscriber) Prewarm() error {
+	start := time.Now()
+	silence := make([]float32, parakeetSampleRate)
+	for _, b := range p.buckets {
+		if _, err := p.processWindow(b, silence); err != nil {
+			return fmt.Errorf("parakeet: prewarm: %w", err)
+		}
+	}
+	slog.Debug("parakeet prewarmed", "elapsed", time.Since(start))
+
+	// Compute plans re-plan each model, so they are only checked when debugging
+	if slog.Default().Enabled(context.Background(), slog.LevelDebug) {
+		p.logComputePlans()
+	}
+	return nil
+}
+
+// models returns the pipeline's models by name, in pipeline order.
+func (p *ParakeetTranscriber) models() []namedModel {
+	var models []namedModel
+	for _, b := range p.buckets {
+		models = append(models,
+			namedModel{"preprocessor" + b.suffix, b.preprocessor},
+			namedModel{"encoder" + b.suffix, b.encoder})
+	}
+	return append(models,
+		namedModel{"decoder", p.decoder},
+		namedModel{"joint", p.joint})
+}
+
+type namedModel struct {
+	name  string
+	model *coreml.Model
+}
+
+// logStats logs each model's marshal/predict/copy-out timings and counters.
+func (p *ParakeetTranscriber) logStats() {
+	if !slog.Default().Enabled(context.Background(), slog.LevelDebug) {
+		return
+	}
+	for _, nm := range p.models() {
+		slog.Debug("parakeet model stats", "model", nm.name, "stats", nm.model.Stats())
+	}
+}
+
+// logComputePlans logs where CoreML places each model's operations and warns
+// when a model loaded for the Neural Engine has nothing planned on it.
+func (p *ParakeetTranscriber) logComputePlans() {
+	for _, nm := range p.models() {
+		plan, err := nm.model.ComputePlan()
+		if err != nil {
+			slog.Debug("parakeet compute plan unavailable", "model", nm.name, "error", err)
+			continue
+		}
+		units := nm.model.Stats().ComputeUnits
+		slog.Debug("parakeet compute plan", "model", nm.name, "units", units.String(),
+			"cpu_ops", plan.CPUOps, "gpu_ops", plan.GPUOps, "ane_ops", plan.ANEOps)
+		if (units == coreml.ComputeAll || units == coreml.ComputeCPUAndANE) && plan.ANEOps == 0 && plan.CPUOps > 0 {
+			slog.Warn("parakeet: model planned off the Neural Engine", "model", nm.name, "cpu_ops", plan.CPUOps, "gpu_ops", plan.GPUOps)
+		}
+	}
 }
 
 // Close releases all CoreML model resources.
 func (p *ParakeetTranscriber) Close() error {
-	if p.preprocessor != nil {
-		p.preprocessor.Close()
+	if p.tdt != nil {
+		p.tdt.Close()
 	}
-	if p.encoder != nil {
-		p.encoder.Close()
+	for _, b := range p.buckets {
+		b.close()
 	}
 	if p.decoder != nil {
 		p.decoder.Close()
@@ -106,100 +235,182 @@ func (p *ParakeetTranscriber) Close() error {
 	return nil
 }
 
+// SetStageTimer makes Process record its preprocess, encode and decode times
+// into t. Pass nil to stop timing. Must not be called during Process.
+func (p *ParakeetTranscriber) SetStageTimer(t *StageTimer) {
+	p.stages = t
+}
+
 // Process transcribes mono 16kHz float32 audio samples to text.
+// Audio that fits one model window runs through the smallest length bucket that
+// holds it. Longer audio is split into overlapping windows decoded like a
+// stream, and the encoder runs asynchronously on window N+1 while window N is
+// decoded.
 func (p *ParakeetTranscriber) Process(samples []float32) (string, error) {
-	// Pad or truncate to maxModelSamples
-	padded := padAudio(samples, parakeetMaxSamples)
-
-	// Step 1: Preprocessor (audio → mel features)
-	prepResult, err := p.runPreprocessor(padded)
+	var tokens []int32
+	var err error
+	if len(samples) <= parakeetMaxSamples {
+		tokens, err = p.processWindow(bucketFor(p.buckets, len(samples)), samples)
+	} else {
+		tokens, err = p.processPipelined(samples)
+	}
 	if err != nil {
-		return "", fmt.Errorf("parakeet: preprocessor: %w", err)
+		return "", err
 	}
-	defer prepResult.Close()
 
-	// Step 2: Encoder (mel features → encoder hidden states)
-	encResult, err := p.runEncoder(prepResult)
+	p.logStats()
+
+	// Step 5: Convert tokens to text
+	text := decodeTokens(tokens, p.vocab)
+	return text, nil
+}
+
+// processWindow transcribes audio of at most b.samples to tokens.
+func (p *ParakeetTranscriber) processWindow(b *parakeetBucket, samples []float32) ([]int32, error) {
+	// Step 1: Preprocessor (audio → mel features), padded to the bucket's
+	// fixed input length in its preallocated audio buffer
+	start := p.stages.begin()
+	prepResult, err := b.runPreprocessor(samples)
 	if err != nil {
-		return "", fmt.Errorf("parakeet: encoder: %w", err)
+		return nil, fmt.Errorf("parakeet: preprocessor: %w", err)
 	}
-	defer encResult.Close()
+	p.stages.end(StagePreprocess, start)
 
-	// Extract encoder output and length
-	encoderOutput, encoderLength, err := p.extractEncoderOutput(encResult)
+	// Step 2: Encoder (mel features → encoder hidden states)
+	// Both results are bucket-owned output backings; they are not closed here.
+	start = p.stages.begin()
+	encResult, err := b.runEncoder(prepResult)
 	if err != nil {
-		return "", fmt.Errorf("parakeet: %w", err)
+		return nil, fmt.Errorf("parakeet: encoder: %w", err)
 	}
+	p.stages.end(StageEncode, start)
 
-	slog.Debug("parakeet encoder", "frames", encoderLength, "totalFloats", len(encoderOutput))
+	return p.decodeEncoded(encResult)
+}
 
-	// Step 3+4: TDT decode loop (decoder + joint)
-	tokens, err := tdtDecode(encoderOutput, encoderLength, p, p)
+// processPipelined transcribes audio longer than one window through a
+// parakeetStream: each window starts keepFrames before the frame its decode
+// resumes at, the decoder state carries over, and only frames with
+// lookahead frames of right context are committed before the last window, so
+// words crossing a window edge are decoded whole. The next window is
+// scheduled from the commit limit, so its encoder runs while this window is
+// decoded.
+func (p *ParakeetTranscriber) processPipelined(samples []float32) ([]int32, error) {
+	st := newParakeetStream(parakeetMaxSamples*1000/parakeetSampleRate, parakeetWindowKeepMs)
+	start, end := 0, min(st.lengthSamples, len(samples))
+	pending, err := p.startEncode(samples[start:end])
 	if err != nil {
-		return "", fmt.Errorf("parakeet: decode: %w", err)
+		return nil, fmt.Errorf("parakeet: window 0: %w", err)
 	}
+	defer func() {
+		if pending != nil {
+			if r, _ := pending.wait(); r != nil {
+				r.Close()
+			}
+		}
+	}()
+
+	for i := 0; ; i++ {
+		t := p.stages.begin()
+		encResult, err := pending.wait()
+		pending = nil
+		if err != nil {
+			return nil, fmt.Errorf("parakeet: encoder: window %d: %w", i, err)
+		}
+		p.stages.end(StageEncode, t)
 
-	// Step 5: Convert tokens to text
-	text := decodeTokens(tokens, p.vocab)
-	return text, nil
-}
+		encoder, frames, err := chunkHidden(encResult, end-start)
+		if err != nil {
+			encResult.Close()
+			return nil, fmt.Errorf("parakeet: %w", err)
+		}
+		last := end == len(samples)
+
+		// Start the next window's encoder before decoding this one
+		var nextStart, nextEnd int
+		if !last {
+			nextStart, nextEnd = st.nextChunk(start, frames, len(samples))
+			if pending, err = p.startEncode(samples[nextStart:nextEnd]); err != nil {
+				encResult.Close()
+				return nil, fmt.Errorf("parakeet: window %d: %w", i+1, err)
+			}
+		}
 
-// runPreprocessor runs the preprocessor model on raw audio.
-func (p *ParakeetTranscriber) runPreprocessor(audio []float32) (*coreml.PredictAllocResult, error) {
-	// Create audio_signal tensor [1, N]
-	audioTensor, err := coreml.NewTensorWithData(
-		[]int64{1, int64(len(audio))},
-		coreml.DTypeFloat32,
-		unsafe.Pointer(&audio[0]),
-	)
-	if err != nil {
-		return nil, fmt.Errorf("create audio tensor: %w", err)
+		t = p.stages.begin()
+		err = st.decode(p, encoder, frames, start/parakeetSamplesPerFrame, last)
+		encResult.Close()
+		if err != nil {
+			return nil, fmt.Errorf("parakeet: window %d: %w", i, err)
+		}
+		p.stages.end(StageDecode, t)
+
+		if last {
+			return st.committed, nil
+		}
+		start, end = nextStart, nextEnd
 	}
-	defer audioTensor.Close()
+}
 
-	// Create audio_length tensor [1] with value N
-	audioLen := []int32{int32(len(audio))}
-	audioLenTensor, err := coreml.NewTensorWithData(
-		[]int64{1},
-		coreml.DTypeInt32,
-		unsafe.Pointer(&audioLen[0]),
-	)
+// decodeEncoded runs the TDT decode loop over one window's encoder result.
+func (p *ParakeetTranscriber) decodeEncoded(encResult *coreml.PredictAllocResult) ([]int32, error) {
+	// Encoder hidden states stay in the encoder's native layout and dtype
+	encoder, encoderLength, err := encoderHidden(encResult)
 	if err != nil {
-		return nil, fmt.Errorf("create audio_length tensor: %w", err)
+		return nil, fmt.Errorf("parakeet: %w", err)
 	}
-	defer audioLenTensor.Close()
 
-	// Map tensors to sorted input names
-	inputMap := map[string]*coreml.Tensor{
-		"audio_signal": audioTensor,
-		"audio_length": audioLenTensor,
-	}
-	inputs, err := orderInputs(p.prepInputNames, inputMap)
+	slog.Debug("parakeet encoder", "frames", encoderLength, "shape", encoder.Shape(), "dtype", encoder.DType())
+
+	// Step 3+4: TDT decode loop (decoder + joint), run natively in the bridge
+	// with joint inputs viewing the encoder tensor. tdtDecode is the Go
+	// reference implementation of the same loop.
+	start := p.stages.begin()
+	tokens, err := p.tdt.DecodeTensor(encoder, encoderLength, nil)
 	if err != nil {
-		return nil, err
+		return nil, fmt.Errorf("parakeet: decode: %w", err)
 	}
+	p.stages.end(StageDecode, start)
+	return tokens, nil
+}
 
-	return p.preprocessor.PredictAlloc(p.prepInputNames, inputs)
+// pendingEncode is an in-flight asynchronous encoder prediction for one window.
+// Its inputs are the bucket's preprocessor backing, so the bucket's
+// preprocessor must not run again until wait returns.
+type pendingEncode struct {
+	done <-chan coreml.AsyncResult
 }
 
-// runEncoder runs the encoder model on preprocessor outputs.
-func (p *ParakeetTranscriber) runEncoder(prepResult *coreml.PredictAllocResult) (*coreml.PredictAllocResult, error) {
-	// Map preprocessor outputs to encoder input names
-	inputMap := make(map[string]*coreml.Tensor)
-	for i, name := range prepResult.Names {
-		inputMap[name] = prepResult.Tensors[i]
+// startEncode runs the preprocessor on one window and starts the encoder on
+// its features without waiting for the result. A short final window uses the
+// smallest bucket that fits it.
+func (p *ParakeetTranscriber) startEncode(window []float32) (*pendingEncode, error) {
+	b := bucketFor(p.buckets, len(window))
+	start := p.stages.begin()
+	prepResult, err := b.runPreprocessor(window)
+	if err != nil {
+		return nil, fmt.Errorf("preprocessor: %w", err)
 	}
-	inputs, err := orderInputs(p.encInputNames, inputMap)
+	p.stages.end(StagePreprocess, start)
+
+	inputs, err := b.encoderInputs(prepResult)
 	if err != nil {
 		return nil, err
 	}
 
-	return p.encoder.PredictAlloc(p.encInputNames, inputs)
+	return &pendingEncode{
+		done: b.encoder.PredictAsync(b.encInputNames, inputs, coreml.PredictDefault),
+	}, nil
 }
 
-// extractEncoderOutput extracts the flattened encoder hidden states and length from encoder outputs.
-// The encoder output shape is [1, encoderHidden, T] (not [1, T, encoderHidden]).
-func (p *ParakeetTranscriber) extractEncoderOutput(encResult *coreml.PredictAllocResult) ([]float32, int, error) {
+// wait blocks for the encoder result. The caller owns the returned result.
+func (e *pendingEncode) wait() (*coreml.PredictAllocResult, error) {
+	res := <-e.done
+	return res.Result, res.Err
+}
+
+// encoderHidden returns the encoder hidden states tensor, shape [1, encoderHidden, T]
+// in the encoder's native dtype, and the number of valid frames.
+func encoderHidden(encResult *coreml.PredictAllocResult) (*coreml.Tensor, int, error) {
 	encoderTensor := encResult.Tensor("encoder")
 	lengthTensor := encResult.Tensor("encoder_length")
 
@@ -211,18 +422,28 @@ func (p *ParakeetTranscriber) extractEncoderOutput(encResult *coreml.PredictAllo
 	if encoderTensor.Rank() != 3 {
 		return nil, 0, fmt.Errorf("encoder output has rank %d, expected 3", encoderTensor.Rank())
 	}
-
-	H := int(encoderTensor.Dim(1)) // encoder hidden size
 	T := int(encoderTensor.Dim(2)) // number of frames
 
 	// Extract encoder length
-	var encoderLength int
+	encoderLength := T
 	if lengthTensor != nil && lengthTensor.DType() == coreml.DTypeInt32 {
 		data := (*int32)(lengthTensor.DataPtr())
-		encoderLength = int(*data)
-	} else {
-		encoderLength = T
+		encoderLength = min(int(*data), T)
 	}
+	return encoderTensor, encoderLength, nil
+}
+
+// extractEncoderOutput extracts the flattened encoder hidden states and length from encoder outputs.
+// The encoder output shape is [1, encoderHidden, T] (not [1, T, encoderHidden]); it is
+// transposed and widened to fp32 for the Go reference decode (tdtDecode).
+func (p *ParakeetTranscriber) extractEncoderOutput(encResult *coreml.PredictAllocResult) ([]float32, int, error) {
+	encoderTensor, encoderLength, err := encoderHidden(encResult)
+	if err != nil {
+		return nil, 0, err
+	}
+
+	H := int(encoderTensor.Dim(1)) // encoder hidden size
+	T := int(encoderTensor.Dim(2)) // number of frames
 
 	slog.Debug("parakeet encoder output", "shape", encoderTensor.Shape(), "H", H, "T", T, "encoderLength", encoderLength)
 
@@ -253,162 +474,110 @@ func (p *ParakeetTranscriber) extractEncoderOutput(encResult *coreml.PredictAllo
 	return encoderData, encoderLength, nil
 }
 
-// Ensure ParakeetTranscriber implements decoderRunner and jointRunner.
-var _ decoderRunner = (*ParakeetTranscriber)(nil)
-var _ jointRunner = (*ParakeetTranscriber)(nil)
-
-// runDecoder runs the LSTM decoder for one step via CoreML.
-func (p *ParakeetTranscriber) runDecoder(targetID int32, hIn, cIn []float32) (decoderOut, hOut, cOut []float32, err error) {
-	// Create targets tensor [1, 1]
-	targets := []int32{targetID}
-	targetsTensor, err := coreml.NewTensorWithData(
-		[]int64{1, 1},
-		coreml.DTypeInt32,
-		unsafe.Pointer(&targets[0]),
-	)
-	if err != nil {
-		return nil, nil, nil, fmt.Errorf("create targets tensor: %w", err)
+// clampDuration clamps a joint duration index to the valid bin range.
+func clampDuration(duration int32) int32 {
+	if duration < 0 {
+		return 0
 	}
-	defer targetsTensor.Close()
-
-	// Create target_length tensor [1] with value 1 (always decoding 1 target at a time)
-	targetLen := []int32{1}
-	targetLenTensor, err := coreml.NewTensorWithData(
-		[]int64{1},
-		coreml.DTypeInt32,
-		unsafe.Pointer(&targetLen[0]),
-	)
-	if err != nil {
-		return nil, nil, nil, fmt.Errorf("create target_length tensor: %w", err)
+	if int(duration) >= len(parakeetDurationBins) {
+		return int32(len(parakeetDurationBins) - 1)
 	}
-	defer targetLenTensor.Close()
+	return duration
+}
 
-	// Create h_in tensor [2, 1, 640]
-	hInTensor, err := coreml.NewTensorWithData(
-		[]int64{int64(parakeetLSTMLayers), 1, int64(parakeetDecoderHidden)},
-		coreml.DTypeFloat32,
-		unsafe.Pointer(&hIn[0]),
-	)
-	if err != nil {
-		return nil, nil, nil, fmt.Errorf("create h_in tensor: %w", err)
-	}
-	defer hInTensor.Close()
+// stepInput describes one model input bound to a caller-owned buffer.
+type stepInput struct {
+	name  string
+	shape []int64
+	dtype coreml.DType
+	data  unsafe.Pointer
+}
 
-	// Create c_in tensor [2, 1, 640]
-	cInTensor, err := coreml.NewTensorWithData(
-		[]int64{int64(parakeetLSTMLayers), 1, int64(parakeetDecoderHidden)},
-		coreml.DTypeFloat32,
-		unsafe.Pointer(&cIn[0]),
-	)
-	if err != nil {
-		return nil, nil, nil, fmt.Errorf("create c_in tensor: %w", err)
-	}
-	defer cInTensor.Close()
+// preparedStep is a CoreML prepared call bound to tensor views over
+// caller-owned buffers plus its output backings. Callers rewrite the
+// buffers and re-run the call; nothing is allocated per step.
+type preparedStep struct {
+	call    *coreml.PreparedCall
+	inputs  []*coreml.Tensor
+	outputs *coreml.PredictAllocResult
+}
 
-	// Map tensors to sorted input names
-	inputMap := map[string]*coreml.Tensor{
-		"targets":       targetsTensor,
-		"target_length": targetLenTensor,
-		"h_in":          hInTensor,
-		"c_in":          cInTensor,
-	}
-	inputs, err := orderInputs(p.decInputNames, inputMap)
-	if err != nil {
-		return nil, nil, nil, err
+// newPreparedStep creates views for inputs and binds them to m in names order.
+// Output shapes are discovered with one PredictAllocWith on the initial buffer
+// contents; that result then serves as the call's output backings.
+func newPreparedStep(m *coreml.Model, names []string, inputs []stepInput) (*preparedStep, error) {
+	s := &preparedStep{}
+	inputMap := make(map[string]*coreml.Tensor, len(inputs))
+	for _, in := range inputs {
+		t, err := coreml.NewTensorView(in.shape, in.dtype, in.data)
+		if err != nil {
+			s.Close()
+			return nil, fmt.Errorf("create %s tensor: %w", in.name, err)
+		}
+		s.inputs = append(s.inputs, t)
+		inputMap[in.name] = t
 	}
 
-	result, err := p.decoder.PredictAlloc(p.decInputNames, inputs)
+	ordered, err := orderInputs(names, inputMap)
 	if err != nil {
-		return nil, nil, nil, fmt.Errorf("predict: %w", err)
+		s.Close()
+		return nil, err
 	}
-	defer result.Close()
 
-	// Extract outputs by name
-	decTensor := result.Tensor("decoder")
-	hOutTensor := result.Tensor("h_out")
-	cOutTensor := result.Tensor("c_out")
-
-	if decTensor == nil || hOutTensor == nil || cOutTensor == nil {
-		return nil, nil, nil, fmt.Errorf("missing decoder outputs (got %v)", result.Names)
+	s.outputs, err = m.PredictAllocWith(names, ordered, coreml.PredictFloat32)
+	if err != nil {
+		s.Close()
+		return nil, fmt.Errorf("discover outputs: %w", err)
 	}
 
-	// Copy outputs to Go slices
-	decoderOut = copyFloat32FromTensor(decTensor, parakeetDecoderHidden)
-	lstmStateSize := parakeetLSTMLayers * 1 * parakeetDecoderHidden
-	hOut = copyFloat32FromTensor(hOutTensor, lstmStateSize)
-	cOut = copyFloat32FromTensor(cOutTensor, lstmStateSize)
-
-	return decoderOut, hOut, cOut, nil
-}
-
-// runJoint runs the joint decision network for one step via CoreML.
-func (p *ParakeetTranscriber) runJoint(encoderStep, decoderStep []float32) (tokenID, duration int32, err error) {
-	// Create encoder_step tensor [1, 1024, 1]
-	encStep := make([]float32, parakeetEncoderHidden)
-	copy(encStep, encoderStep)
-	encStepTensor, err := coreml.NewTensorWithData(
-		[]int64{1, int64(parakeetEncoderHidden), 1},
-		coreml.DTypeFloat32,
-		unsafe.Pointer(&encStep[0]),
-	)
-	if err != nil {
-		return 0, 0, fmt.Errorf("create encoder_step tensor: %w", err)
-	}
-	defer encStepTensor.Close()
-
-	// Create decoder_step tensor [1, 640, 1]
-	decStep := make([]float32, parakeetDecoderHidden)
-	copy(decStep, decoderStep)
-	decStepTensor, err := coreml.NewTensorWithData(
-		[]int64{1, int64(parakeetDecoderHidden), 1},
-		coreml.DTypeFloat32,
-		unsafe.Pointer(&decStep[0]),
-	)
+	s.call, err = m.Prepare(names, ordered, s.outputs.Names, s.outputs.Tensors)
 	if err != nil {
-		return 0, 0, fmt.Errorf("create decoder_step tensor: %w", err)
+		s.Close()
+		return nil, err
 	}
-	defer decStepTensor.Close()
+	return s, nil
+}
 
-	// Map tensors to sorted input names
-	inputMap := map[string]*coreml.Tensor{
-		"encoder_step": encStepTensor,
-		"decoder_step": decStepTensor,
+// Close releases the call, its output backings and its input views.
+func (s *preparedStep) Close() {
+	if s.call != nil {
+		s.call.Close()
 	}
-	inputs, err := orderInputs(p.jointInputNames, inputMap)
-	if err != nil {
-		return 0, 0, err
+	if s.outputs != nil {
+		s.outputs.Close()
 	}
-
-	result, err := p.joint.PredictAlloc(p.jointInputNames, inputs)
-	if err != nil {
-		return 0, 0, fmt.Errorf("predict: %w", err)
+	for _, t := range s.inputs {
+		t.Close()
 	}
-	defer result.Close()
-
-	// Extract outputs by name
-	tokenTensor := result.Tensor("token_id")
-	durTensor := result.Tensor("duration")
+}
 
-	if tokenTensor == nil || durTensor == nil {
-		return 0, 0, fmt.Errorf("missing joint outputs (got %v)", result.Names)
+// predictBacked runs m with its outputs written directly into *backing.
+// The first call discovers the output shapes via PredictAllocWith and keeps that result
+// as the backing; later calls register it with CoreML via PredictInto, so outputs
+// come back without a copy. The returned result is *backing and must not be closed.
+//
+// Backings keep the model's native output dtype, so an fp16 encoder output stays
+// fp16 (half the memory of an fp32 copy) and is read by the decode through views.
+// Should CoreML decline a backing, the bridge copies the result in without conversion.
+func predictBacked(m *coreml.Model, backing **coreml.PredictAllocResult, names []string, inputs []*coreml.Tensor) (*coreml.PredictAllocResult, error) {
+	if *backing == nil {
+		result, err := m.PredictAllocWith(names, inputs, coreml.PredictDefault)
+		if err != nil {
+			return nil, err
+		}
+		*backing = result
+		return result, nil
 	}
 
-	// Extract token_id and duration
-	tokenPtr := (*int32)(tokenTensor.DataPtr())
-	tokenID = *tokenPtr
-
-	durPtr := (*int32)(durTensor.DataPtr())
-	duration = *durPtr
-
-	// Clamp duration to valid range
-	if duration < 0 {
-		duration = 0
+	b := *backing
+	honored, err := m.PredictInto(names, inputs, b.Names, b.Tensors)
+	if err != nil {
+		return nil, err
 	}
-	if int(duration) >= len(parakeetDurationBins) {
-		duration = int32(len(parakeetDurationBins) - 1)
+	if !honored {
+		slog.Debug("parakeet: output backing not honored, outputs copied", "outputs", b.Names)
 	}
-
-	return tokenID, duration, nil
+	return b, nil
 }
 
 // orderInputs arranges tensors to match the sorted input name order.
@@ -424,30 +593,18 @@ func orderInputs(names []string, tensorMap map[string]*coreml.Tensor) ([]*coreml
 	return result, nil
 }
 
-// padAudio pads or truncates audio to exactly maxSamples.
-func padAudio(samples []float32, maxSamples int) []float32 {
-	if len(samples) >= maxSamples {
-		return samples[:maxSamples]
-	}
-	padded := make([]float32, maxSamples)
-	copy(padded, samples)
-	return padded
-}
-
-// copyFloat32FromTensor copies n float32 values from a tensor's data pointer.
+// copyFloat32Into fills dst with len(dst) values from a tensor's data pointer.
 // Handles float16 → float32 conversion if needed.
-func copyFloat32FromTensor(t *coreml.Tensor, n int) []float32 {
-	result := make([]float32, n)
+func copyFloat32Into(dst []float32, t *coreml.Tensor) {
+	n := len(dst)
 	if t.DType() == coreml.DTypeFloat16 {
 		src := unsafe.Slice((*uint16)(t.DataPtr()), n)
 		for i, v := range src {
-			result[i] = float16ToFloat32(v)
+			dst[i] = float16ToFloat32(v)
 		}
 	} else {
-		src := unsafe.Slice((*float32)(t.DataPtr()), n)
-		copy(result, src)
+		copy(dst, unsafe.Slice((*float32)(t.DataPtr()), n))
 	}
-	return result
 }
 
 // float16ToFloat32 converts a IEEE 754 half-precision float to float32.
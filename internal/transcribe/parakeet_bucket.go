@@ -0,0 +1,178 @@
+package transcribe
+
+import (
+	"fmt"
+	"os"
+	"path/filepath"
+	"unsafe"
+
+	"github.com/chaz8081/gostt-writer/internal/coreml"
+)
+
+// parakeetBucketSeconds are the optional shorter input lengths. A bucket is
+// used when modelDir holds Preprocessor_<N>s and Encoder_<N>s models (compiled
+// .mlmodelc or .mlpackage); the unsuffixed models always cover the full
+// parakeetMaxSamples window.
+var parakeetBucketSeconds = []int{2, 5, 10}
+
+// parakeetBucket is a preprocessor/encoder pair exported for one fixed input
+// length. Audio runs through the smallest bucket that fits, so preprocessor and
+// encoder cost scale with how long the speaker talked rather than always
+// paying for a full window.
+type parakeetBucket struct {
+	samples      int
+	suffix       string // model file suffix; "" for the full window
+	preprocessor *coreml.Model
+	encoder      *coreml.Model
+
+	// Cached I/O names discovered via model introspection (sorted alphabetically).
+	prepInputNames []string
+	encInputNames  []string
+
+	// Preprocessor input buffers and the views bound to them, ordered like
+	// prepInputNames. Created on first use and refilled for every window.
+	audio       []float32
+	audioLen    []int32
+	prepInputs  []*coreml.Tensor
+	prepTensors []*coreml.Tensor // views to release on close
+
+	// Preprocessor and encoder output backings reused across predictions.
+	// Allocated from each model's first result and then registered with CoreML
+	// so later predictions write straight into them (see predictBacked).
+	prepOut *coreml.PredictAllocResult
+	encOut  *coreml.PredictAllocResult
+}
+
+// discoverBuckets returns the buckets available in modelDir in ascending
+// length order, ending with the full window. Models are not loaded yet.
+func discoverBuckets(modelDir string) []*parakeetBucket {
+	var buckets []*parakeetBucket
+	for _, secs := range parakeetBucketSeconds {
+		suffix := fmt.Sprintf("_%ds", secs)
+		if modelExists(modelDir, "Preprocessor"+suffix) && modelExists(modelDir, "Encoder"+suffix) {
+			buckets = append(buckets, &parakeetBucket{samples: secs * parakeetSampleRate, suffix: suffix})
+		}
+	}
+	return append(buckets, &parakeetBucket{samples: parakeetMaxSamples})
+}
+
+// modelExists reports whether modelDir holds model name as .mlmodelc or .mlpackage.
+func modelExists(modelDir, name string) bool {
+	for _, ext := range []string{".mlmodelc", ".mlpackage"} {
+		if _, err := os.Stat(filepath.Join(modelDir, name+ext)); err == nil {
+			return true
+		}
+	}
+	return false
+}
+
+// bucketFor returns the smallest bucket holding n samples, or the full window
+// when n exceeds every bucket. buckets must be ascending.
+func bucketFor(buckets []*parakeetBucket, n int) *parakeetBucket {
+	for _, b := range buckets {
+		if n <= b.samples {
+			return b
+		}
+	}
+	return buckets[len(buckets)-1]
+}
+
+// cacheInputNames records the models' input names after loading.
+func (b *parakeetBucket) cacheInputNames() {
+	b.prepInputNames = modelInputNames(b.preprocessor)
+	b.encInputNames = modelInputNames(b.encoder)
+}
+
+// close releases the bucket's models, input views and output backings.
+func (b *parakeetBucket) close() {
+	if b.preprocessor != nil {
+		b.preprocessor.Close()
+	}
+	if b.encoder != nil {
+		b.encoder.Close()
+	}
+	for _, t := range b.prepTensors {
+		t.Close()
+	}
+	if b.prepOut != nil {
+		b.prepOut.Close()
+	}
+	if b.encOut != nil {
+		b.encOut.Close()
+	}
+}
+
+// preparePreprocessor allocates the audio buffers and binds the preprocessor's
+// input views to them.
+func (b *parakeetBucket) preparePreprocessor() error {
+	b.audio = make([]float32, b.samples)
+	b.audioLen = []int32{int32(b.samples)}
+
+	// audio_signal [1, N]
+	audioTensor, err := coreml.NewTensorView(
+		[]int64{1, int64(b.samples)},
+		coreml.DTypeFloat32,
+		unsafe.Pointer(&b.audio[0]),
+	)
+	if err != nil {
+		return fmt.Errorf("create audio tensor: %w", err)
+	}
+	b.prepTensors = append(b.prepTensors, audioTensor)
+
+	// audio_length [1] with value N (the padded length, as before)
+	audioLenTensor, err := coreml.NewTensorView(
+		[]int64{1},
+		coreml.DTypeInt32,
+		unsafe.Pointer(&b.audioLen[0]),
+	)
+	if err != nil {
+		return fmt.Errorf("create audio_length tensor: %w", err)
+	}
+	b.prepTensors = append(b.prepTensors, audioLenTensor)
+
+	// Map tensors to sorted input names
+	inputMap := map[string]*coreml.Tensor{
+		"audio_signal": audioTensor,
+		"audio_length": audioLenTensor,
+	}
+	inputs, err := orderInputs(b.prepInputNames, inputMap)
+	if err != nil {
+		return err
+	}
+	b.prepInputs = inputs
+	return nil
+}
+
+// runPreprocessor runs the preprocessor model on raw audio zero-padded (or
+// truncated) to b.samples in the bucket's audio buffer. The returned result is
+// owned by the bucket and is overwritten by the next call.
+func (b *parakeetBucket) runPreprocessor(audio []float32) (*coreml.PredictAllocResult, error) {
+	if b.prepInputs == nil {
+		if err := b.preparePreprocessor(); err != nil {
+			return nil, err
+		}
+	}
+	n := copy(b.audio, audio)
+	clear(b.audio[n:])
+
+	return predictBacked(b.preprocessor, &b.prepOut, b.prepInputNames, b.prepInputs)
+}
+
+// encoderInputs maps preprocessor outputs to the encoder's ordered inputs.
+func (b *parakeetBucket) encoderInputs(prepResult *coreml.PredictAllocResult) ([]*coreml.Tensor, error) {
+	inputMap := make(map[string]*coreml.Tensor)
+	for i, name := range prepResult.Names {
+		inputMap[name] = prepResult.Tensors[i]
+	}
+	return orderInputs(b.encInputNames, inputMap)
+}
+
+// runEncoder runs the encoder model on preprocessor outputs.
+// The returned result is owned by the bucket and is overwritten by the next call.
+func (b *parakeetBucket) runEncoder(prepResult *coreml.PredictAllocResult) (*coreml.PredictAllocResult, error) {
+	inputs, err := b.encoderInputs(prepResult)
+	if err != nil {
+		return nil, err
+	}
+	return predictBacked(b.encoder, &b.encOut, b.encInputNames, inputs)
+}
@@ -0,0 +1,47 @@
+package transcribe
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+func TestDiscoverBuckets(t *testing.T) {
+	dir := t.TempDir()
+	// A complete 5s bucket, and a 2s bucket missing its encoder
+	for _, name := range []string{"Preprocessor_5s.mlmodelc", "Encoder_5s.mlpackage", "Preprocessor_2s.mlmodelc"} {
+		if err := os.Mkdir(filepath.Join(dir, name), 0755); err != nil {
+			t.Fatal(err)
+		}
+	}
+
+	buckets := discoverBuckets(dir)
+	if len(buckets) != 2 {
+		t.Fatalf("discoverBuckets returned %d buckets, want 2", len(buckets))
+	}
+	if buckets[0].samples != 5*parakeetSampleRate || buckets[0].suffix != "_5s" {
+		t.Errorf("buckets[0] = {%d, %q}, want {%d, \"_5s\"}", buckets[0].samples, buckets[0].suffix, 5*parakeetSampleRate)
+	}
+	if buckets[1].samples != parakeetMaxSamples || buckets[1].suffix != "" {
+		t.Errorf("last bucket = {%d, %q}, want full window", buckets[1].samples, buckets[1].suffix)
+	}
+}
+
+func TestBucketFor(t *testing.T) {
+	buckets := []*parakeetBucket{{samples: 100}, {samples: 500}, {samples: 1000}}
+	tests := []struct {
+		n    int
+		want int
+	}{
+		{1, 100},
+		{100, 100},
+		{101, 500},
+		{1000, 1000},
+		{5000, 1000}, // longer than every bucket: full window
+	}
+	for _, tt := range tests {
+		if got := bucketFor(buckets, tt.n).samples; got != tt.want {
+			t.Errorf("bucketFor(%d) = %d, want %d", tt.n, got, tt.want)
+		}
+	}
+}
@@ -1,6 +1,11 @@
 package transcribe
 
-import "fmt"
+import (
+	"fmt"
+	"unsafe"
+
+	"github.com/chaz8081/gostt-writer/internal/coreml"
+)
 
 const (
 	parakeetBlankID        = 1024 // blank token index for v2 CoreML model (FluidInference conversion)
@@ -8,6 +13,9 @@ const (
 	parakeetEncoderHidden  = 1024
 	parakeetDecoderHidden  = 640
 	parakeetLSTMLayers     = 2
+
+	// parakeetJointWindow is the most frames scored per batched joint call.
+	parakeetJointWindow = 16
 )
 
 var parakeetDurationBins = []int32{0, 1, 2, 3, 4}
@@ -22,6 +30,71 @@ type jointRunner interface {
 	runJoint(encoderStep, decoderStep []float32) (tokenID, duration int32, err error)
 }
 
+// jointBatchRunner scores several encoder frames against one decoder output
+// in a single call. tokenIDs and durations receive one result per frame.
+type jointBatchRunner interface {
+	runJointBatch(encoderSteps [][]float32, decoderStep []float32, tokenIDs, durations []int32) error
+}
+
+// jointWindow caches joint results for a window of frames scored against the
+// current decoder output. The decoder output only changes when a token is
+// emitted, so while blanks are decoded the joint runs once per window instead
+// of once per frame. The window restarts at one frame after each token and
+// doubles each time decoding walks off the end of a window of blanks, which
+// bounds the frames scored in vain during dense speech.
+type jointWindow struct {
+	batch  jointBatchRunner
+	start  int
+	n      int
+	size   int
+	steps  [][]float32
+	tokens []int32
+	durs   []int32
+}
+
+func newJointWindow(joint jointRunner) *jointWindow {
+	w := &jointWindow{size: 1}
+	if batch, ok := joint.(jointBatchRunner); ok {
+		w.batch = batch
+		w.steps = make([][]float32, parakeetJointWindow)
+		w.tokens = make([]int32, parakeetJointWindow)
+		w.durs = make([]int32, parakeetJointWindow)
+	}
+	return w
+}
+
+// score returns the joint decision for frame t against decoderOut.
+func (w *jointWindow) score(joint jointRunner, encoderOutput []float32, length, t int, decoderOut []float32) (tokenID, duration int32, err error) {
+	frame := func(t int) []float32 {
+		return encoderOutput[t*parakeetEncoderHidden : (t+1)*parakeetEncoderHidden]
+	}
+	if w.batch == nil {
+		return joint.runJoint(frame(t), decoderOut)
+	}
+
+	if t < w.start || t >= w.start+w.n {
+		if w.n > 0 && w.size < parakeetJointWindow {
+			w.size *= 2
+		}
+		w.size = min(w.size, parakeetJointWindow)
+		n := min(w.size, length-t)
+		for k := 0; k < n; k++ {
+			w.steps[k] = frame(t + k)
+		}
+		if err := w.batch.runJointBatch(w.steps[:n], decoderOut, w.tokens[:n], w.durs[:n]); err != nil {
+			return 0, 0, err
+		}
+		w.start, w.n = t, n
+	}
+	return w.tokens[t-w.start], w.durs[t-w.start], nil
+}
+
+// reset drops the cached results after the decoder output changed.
+func (w *jointWindow) reset() {
+	w.n = 0
+	w.size = 1
+}
+
 // tdtDecode runs the TDT greedy decode algorithm over encoder output frames.
 // encoderOutput shape: [T, encoderHidden] flattened.
 // encoderLength: number of valid frames.
@@ -32,27 +105,38 @@ func tdtDecode(
 	dec decoderRunner,
 	joint jointRunner,
 ) ([]int32, error) {
-	// Initialize LSTM state (zeros)
-	lstmStateSize := parakeetLSTMLayers * 1 * parakeetDecoderHidden
-	hState := make([]float32, lstmStateSize)
-	cState := make([]float32, lstmStateSize)
+	return tdtDecodeFrom(encoderOutput, encoderLength, dec, joint, coreml.NewTDTState(parakeetTDTConfig))
+}
 
-	// Initial decoder run with blank token
-	decoderOut, hState, cState, err := dec.runDecoder(int32(parakeetBlankID), hState, cState)
-	if err != nil {
-		return nil, fmt.Errorf("initial decoder run: %w", err)
+// tdtDecodeFrom is tdtDecode resuming from state: decoding starts at
+// state.Frame with the carried LSTM state, and state is updated on success.
+// It is the Go reference for coreml.TDTDecoder.DecodeTensor.
+func tdtDecodeFrom(
+	encoderOutput []float32,
+	encoderLength int,
+	dec decoderRunner,
+	joint jointRunner,
+	state *coreml.TDTState,
+) ([]int32, error) {
+	decoderOut, hState, cState := state.DecoderOut, state.H, state.C
+
+	// Initial decoder run with blank token, unless resuming a stream
+	if !state.Primed {
+		var err error
+		decoderOut, hState, cState, err = dec.runDecoder(int32(parakeetBlankID), hState, cState)
+		if err != nil {
+			return nil, fmt.Errorf("initial decoder run: %w", err)
+		}
 	}
 
 	var tokens []int32
-	t := 0
+	t := state.Frame
+	window := newJointWindow(joint)
 
 	for t < encoderLength {
-		frameStart := t * parakeetEncoderHidden
-		encoderFrame := encoderOutput[frameStart : frameStart+parakeetEncoderHidden]
-
 		symCount := 0
 		for symCount < parakeetMaxSymsPerStep {
-			tokenID, durIdx, err := joint.runJoint(encoderFrame, decoderOut)
+			tokenID, durIdx, err := window.score(joint, encoderOutput, encoderLength, t, decoderOut)
 			if err != nil {
 				return nil, fmt.Errorf("joint at frame %d: %w", t, err)
 			}
@@ -73,6 +157,7 @@ func tdtDecode(
 			if err != nil {
 				return nil, fmt.Errorf("decoder at frame %d: %w", t, err)
 			}
+			window.reset()
 
 			if dur > 0 {
 				t += int(dur)
@@ -87,5 +172,303 @@ func tdtDecode(
 		}
 	}
 
+	// Runners may return their own buffers, so the state keeps copies
+	copy(state.DecoderOut, decoderOut)
+	copy(state.H, hState)
+	copy(state.C, cState)
+	state.Primed = true
+	state.Frame = t
 	return tokens, nil
 }
+
+// referenceDecoder runs the Go reference decode's decoder and joint steps on
+// the transcriber's models, for checking and benchmarking tdtDecode against the
+// native coreml.TDTDecoder the transcriber decodes with. Its step buffers are
+// preallocated, so a step allocates nothing.
+type referenceDecoder struct {
+	decoder *coreml.Model
+	joint   *coreml.Model
+
+	// Cached I/O names discovered via model introspection (sorted alphabetically).
+	decInputNames   []string
+	jointInputNames []string
+
+	// Prepared per-step decoder and joint calls, bound to the input buffers
+	// below. Created on first use.
+	decStep      *preparedStep
+	decTargets   []int32
+	decTargetLen []int32
+	decH, decC   []float32
+	decBufs      [2]decoderBuffers // double-buffered runDecoder outputs
+	decCur       int               // decBufs index the next runDecoder fills
+	jointStep    *preparedStep
+	jointEnc     []float32
+	jointDec     []float32
+	jointBatch   *jointBatch
+}
+
+// Ensure referenceDecoder implements decoderRunner, jointRunner and jointBatchRunner.
+var _ decoderRunner = (*referenceDecoder)(nil)
+var _ jointRunner = (*referenceDecoder)(nil)
+var _ jointBatchRunner = (*referenceDecoder)(nil)
+
+// newReferenceDecoder returns a reference decoder over p's decoder and joint
+// models. Close it before p.
+func newReferenceDecoder(p *ParakeetTranscriber) *referenceDecoder {
+	return &referenceDecoder{
+		decoder:         p.decoder,
+		joint:           p.joint,
+		decInputNames:   modelInputNames(p.decoder),
+		jointInputNames: modelInputNames(p.joint),
+	}
+}
+
+// Close releases the prepared calls and batch buffers.
+func (r *referenceDecoder) Close() {
+	for _, step := range []*preparedStep{r.decStep, r.jointStep} {
+		if step != nil {
+			step.Close()
+		}
+	}
+	if r.jointBatch != nil {
+		r.jointBatch.Close()
+	}
+}
+
+// runDecoder runs the LSTM decoder for one step via CoreML.
+func (r *referenceDecoder) runDecoder(targetID int32, hIn, cIn []float32) (decoderOut, hOut, cOut []float32, err error) {
+	if r.decStep == nil {
+		if err := r.prepareDecoder(); err != nil {
+			return nil, nil, nil, err
+		}
+	}
+
+	// Only the bound buffer contents change between steps
+	r.decTargets[0] = targetID
+	copy(r.decH, hIn)
+	copy(r.decC, cIn)
+	if _, err := r.decStep.call.Run(); err != nil {
+		return nil, nil, nil, fmt.Errorf("predict: %w", err)
+	}
+
+	// Extract outputs by name
+	result := r.decStep.outputs
+	decTensor := result.Tensor("decoder")
+	hOutTensor := result.Tensor("h_out")
+	cOutTensor := result.Tensor("c_out")
+
+	if decTensor == nil || hOutTensor == nil || cOutTensor == nil {
+		return nil, nil, nil, fmt.Errorf("missing decoder outputs (got %v)", result.Names)
+	}
+
+	// Copy outputs into the buffer set the caller is not holding: the previous
+	// step's outputs (this step's hIn/cIn) stay valid, and nothing is allocated.
+	bufs := &r.decBufs[r.decCur]
+	r.decCur ^= 1
+	copyFloat32Into(bufs.out, decTensor)
+	copyFloat32Into(bufs.h, hOutTensor)
+	copyFloat32Into(bufs.c, cOutTensor)
+
+	return bufs.out, bufs.h, bufs.c, nil
+}
+
+// decoderBuffers holds one set of decoder step outputs.
+type decoderBuffers struct {
+	out, h, c []float32
+}
+
+// prepareDecoder binds the decoder's input buffers and output backings once.
+func (r *referenceDecoder) prepareDecoder() error {
+	lstmStateSize := parakeetLSTMLayers * 1 * parakeetDecoderHidden
+	r.decTargets = []int32{int32(parakeetBlankID)}
+	r.decTargetLen = []int32{1} // always decoding 1 target at a time
+	r.decH = make([]float32, lstmStateSize)
+	r.decC = make([]float32, lstmStateSize)
+	for i := range r.decBufs {
+		r.decBufs[i] = decoderBuffers{
+			out: make([]float32, parakeetDecoderHidden),
+			h:   make([]float32, lstmStateSize),
+			c:   make([]float32, lstmStateSize),
+		}
+	}
+
+	lstmShape := []int64{int64(parakeetLSTMLayers), 1, int64(parakeetDecoderHidden)}
+	step, err := newPreparedStep(r.decoder, r.decInputNames, []stepInput{
+		{"targets", []int64{1, 1}, coreml.DTypeInt32, unsafe.Pointer(&r.decTargets[0])},
+		{"target_length", []int64{1}, coreml.DTypeInt32, unsafe.Pointer(&r.decTargetLen[0])},
+		{"h_in", lstmShape, coreml.DTypeFloat32, unsafe.Pointer(&r.decH[0])},
+		{"c_in", lstmShape, coreml.DTypeFloat32, unsafe.Pointer(&r.decC[0])},
+	})
+	if err != nil {
+		return fmt.Errorf("prepare decoder: %w", err)
+	}
+	r.decStep = step
+	return nil
+}
+
+// runJoint runs the joint decision network for one step via CoreML.
+func (r *referenceDecoder) runJoint(encoderStep, decoderStep []float32) (tokenID, duration int32, err error) {
+	if r.jointStep == nil {
+		if err := r.prepareJoint(); err != nil {
+			return 0, 0, err
+		}
+	}
+
+	// Only the bound buffer contents change between steps
+	copy(r.jointEnc, encoderStep)
+	copy(r.jointDec, decoderStep)
+	if _, err := r.jointStep.call.Run(); err != nil {
+		return 0, 0, fmt.Errorf("predict: %w", err)
+	}
+
+	// Extract outputs by name
+	result := r.jointStep.outputs
+	tokenTensor := result.Tensor("token_id")
+	durTensor := result.Tensor("duration")
+
+	if tokenTensor == nil || durTensor == nil {
+		return 0, 0, fmt.Errorf("missing joint outputs (got %v)", result.Names)
+	}
+
+	// Extract token_id and duration
+	tokenPtr := (*int32)(tokenTensor.DataPtr())
+	tokenID = *tokenPtr
+
+	durPtr := (*int32)(durTensor.DataPtr())
+	duration = clampDuration(*durPtr)
+
+	return tokenID, duration, nil
+}
+
+// prepareJoint binds the joint's input buffers and output backings once.
+func (r *referenceDecoder) prepareJoint() error {
+	r.jointEnc = make([]float32, parakeetEncoderHidden)
+	r.jointDec = make([]float32, parakeetDecoderHidden)
+
+	step, err := newPreparedStep(r.joint, r.jointInputNames, []stepInput{
+		{"encoder_step", []int64{1, int64(parakeetEncoderHidden), 1}, coreml.DTypeFloat32, unsafe.Pointer(&r.jointEnc[0])},
+		{"decoder_step", []int64{1, int64(parakeetDecoderHidden), 1}, coreml.DTypeFloat32, unsafe.Pointer(&r.jointDec[0])},
+	})
+	if err != nil {
+		return fmt.Errorf("prepare joint: %w", err)
+	}
+	r.jointStep = step
+	return nil
+}
+
+// runJointBatch scores several encoder frames against one decoder output in a
+// single CoreML batch dispatch. A single frame uses the prepared per-step call.
+func (r *referenceDecoder) runJointBatch(encoderSteps [][]float32, decoderStep []float32, tokenIDs, durations []int32) error {
+	if len(encoderSteps) == 1 {
+		tokenID, duration, err := r.runJoint(encoderSteps[0], decoderStep)
+		tokenIDs[0], durations[0] = tokenID, duration
+		return err
+	}
+	if r.jointBatch == nil {
+		if err := r.prepareJointBatch(); err != nil {
+			return err
+		}
+	}
+
+	jb := r.jointBatch
+	for k, step := range encoderSteps {
+		copy(jb.enc[k*parakeetEncoderHidden:], step)
+	}
+	copy(jb.dec, decoderStep)
+
+	n := len(encoderSteps)
+	if err := r.joint.PredictBatch(r.jointInputNames, jb.inputs[:n], jb.outputNames, jb.outputs[:n]); err != nil {
+		return fmt.Errorf("predict batch: %w", err)
+	}
+	for k := 0; k < n; k++ {
+		tokenIDs[k] = *(*int32)(jb.outputs[k][jb.tokenIdx].DataPtr())
+		durations[k] = clampDuration(*(*int32)(jb.outputs[k][jb.durIdx].DataPtr()))
+	}
+	return nil
+}
+
+// jointBatch holds the joint's batched inputs and outputs: parakeetJointWindow
+// encoder frame views, one decoder output view they all share, and per-sample
+// output tensors shaped like the prepared joint's outputs.
+type jointBatch struct {
+	enc         []float32
+	dec         []float32
+	tensors     []*coreml.Tensor // every view and output, for Close
+	inputs      [][]*coreml.Tensor
+	outputNames []string
+	outputs     [][]*coreml.Tensor
+	tokenIdx    int
+	durIdx      int
+}
+
+// prepareJointBatch allocates the batched joint buffers once.
+func (r *referenceDecoder) prepareJointBatch() error {
+	if r.jointStep == nil {
+		if err := r.prepareJoint(); err != nil {
+			return err
+		}
+	}
+
+	jb := &jointBatch{
+		enc:         make([]float32, parakeetJointWindow*parakeetEncoderHidden),
+		dec:         make([]float32, parakeetDecoderHidden),
+		outputNames: r.jointStep.outputs.Names,
+		tokenIdx:    -1,
+		durIdx:      -1,
+	}
+	for i, name := range jb.outputNames {
+		switch name {
+		case "token_id":
+			jb.tokenIdx = i
+		case "duration":
+			jb.durIdx = i
+		}
+	}
+	if jb.tokenIdx < 0 || jb.durIdx < 0 {
+		return fmt.Errorf("prepare joint batch: missing joint outputs (got %v)", jb.outputNames)
+	}
+
+	newTensor := func(t *coreml.Tensor, err error) (*coreml.Tensor, error) {
+		if err == nil {
+			jb.tensors = append(jb.tensors, t)
+		}
+		return t, err
+	}
+	decView, err := newTensor(coreml.NewTensorView([]int64{1, int64(parakeetDecoderHidden), 1}, coreml.DTypeFloat32, unsafe.Pointer(&jb.dec[0])))
+	if err != nil {
+		jb.Close()
+		return fmt.Errorf("prepare joint batch: create decoder_step tensor: %w", err)
+	}
+	for k := 0; k < parakeetJointWindow; k++ {
+		encView, err := newTensor(coreml.NewTensorView([]int64{1, int64(parakeetEncoderHidden), 1},
+			coreml.DTypeFloat32, unsafe.Pointer(&jb.enc[k*parakeetEncoderHidden])))
+		if err != nil {
+			jb.Close()
+			return fmt.Errorf("prepare joint batch: create encoder_step tensor: %w", err)
+		}
+		inputs, err := orderInputs(r.jointInputNames, map[string]*coreml.Tensor{"encoder_step": encView, "decoder_step": decView})
+		if err != nil {
+			jb.Close()
+			return fmt.Errorf("prepare joint batch: %w", err)
+		}
+		jb.inputs = append(jb.inputs, inputs)
+
+		outputs := make([]*coreml.Tensor, len(jb.outputNames))
+		for i, like := range r.jointStep.outputs.Tensors {
+			if outputs[i], err = newTensor(coreml.NewTensor(like.Shape(), like.DType())); err != nil {
+				jb.Close()
+				return fmt.Errorf("prepare joint batch: create %s tensor: %w", jb.outputNames[i], err)
+			}
+		}
+		jb.outputs = append(jb.outputs, outputs)
+	}
+	r.jointBatch = jb
+	return nil
+}
+
+// Close releases the batch's views and output tensors.
+func (jb *jointBatch) Close() {
+	for _, t := range jb.tensors {
+		t.Close()
+	}
+}
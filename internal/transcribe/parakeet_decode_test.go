@@ -3,6 +3,8 @@ package transcribe
 import (
 	"fmt"
 	"testing"
+
+	"github.com/chaz8081/gostt-writer/internal/coreml"
 )
 
 // mockDecoder returns predetermined decoder outputs for testing.
@@ -196,3 +198,130 @@ type errorDecoder struct {
 func (e *errorDecoder) runDecoder(targetID int32, hIn, cIn []float32) ([]float32, []float32, []float32, error) {
 	return nil, nil, nil, e.err
 }
+
+func TestTDTDecodeFromResumesAcrossChunks(t *testing.T) {
+	encoderOutput := make([]float32, 4*parakeetEncoderHidden)
+	stateSize := parakeetLSTMLayers * 1 * parakeetDecoderHidden
+	out := func(v float32) mockDecoderOutput {
+		o := mockDecoderOutput{
+			decoderOut: make([]float32, parakeetDecoderHidden),
+			hOut:       make([]float32, stateSize),
+			cOut:       make([]float32, stateSize),
+		}
+		o.decoderOut[0], o.hOut[0], o.cOut[0] = v, v, v
+		return o
+	}
+
+	// Chunk 1 (2 frames): emit 5 at frame 0, then a blank jumps 3 frames past the chunk.
+	// Chunk 2 starts at absolute frame 2, so decoding resumes at its frame 1.
+	joint := &mockJoint{results: []mockJointResult{
+		{tokenID: 5, duration: 0},
+		{tokenID: parakeetBlankID, duration: 3},
+		{tokenID: 7, duration: 1},
+	}}
+	dec := &mockDecoder{outputs: []mockDecoderOutput{out(1), out(2), out(3)}}
+
+	state := coreml.NewTDTState(parakeetTDTConfig)
+	first, err := tdtDecodeFrom(encoderOutput, 2, dec, joint, state)
+	if err != nil {
+		t.Fatalf("tdtDecodeFrom chunk 1: %v", err)
+	}
+	if len(first) != 1 || first[0] != 5 {
+		t.Fatalf("chunk 1 tokens = %v, want [5]", first)
+	}
+	if !state.Primed || state.Frame != 3 || state.DecoderOut[0] != 2 || state.H[0] != 2 {
+		t.Fatalf("state after chunk 1 = primed %v frame %d dec %v h %v, want primed frame 3 carrying output 2",
+			state.Primed, state.Frame, state.DecoderOut[0], state.H[0])
+	}
+
+	state.Frame -= 2 // rebase onto chunk 2
+	second, err := tdtDecodeFrom(encoderOutput, 2, dec, joint, state)
+	if err != nil {
+		t.Fatalf("tdtDecodeFrom chunk 2: %v", err)
+	}
+	if len(second) != 1 || second[0] != 7 {
+		t.Errorf("chunk 2 tokens = %v, want [7]", second)
+	}
+	// No second blank priming run: initial + one run per emitted token
+	if dec.calls != 3 {
+		t.Errorf("decoder ran %d times, want 3", dec.calls)
+	}
+}
+
+// frameDecoder reports the last target ID in decoderOut[0].
+type frameDecoder struct{}
+
+func (frameDecoder) runDecoder(targetID int32, hIn, cIn []float32) (decoderOut, hOut, cOut []float32, err error) {
+	decoderOut = make([]float32, parakeetDecoderHidden)
+	decoderOut[0] = float32(targetID)
+	return decoderOut, hIn, cIn, nil
+}
+
+// frameJoint emits token 100+f (duration 0) at each frame f in emitAt, and
+// blank (duration 1) otherwise or once that token has just been decoded. The
+// frame index is read from encoderStep[0].
+type frameJoint struct {
+	emitAt map[int]bool
+	calls  int
+}
+
+func (j *frameJoint) runJoint(encoderStep, decoderStep []float32) (tokenID, duration int32, err error) {
+	j.calls++
+	return j.decide(encoderStep, decoderStep)
+}
+
+func (j *frameJoint) decide(encoderStep, decoderStep []float32) (tokenID, duration int32, err error) {
+	f := int(encoderStep[0])
+	if j.emitAt[f] && decoderStep[0] != float32(100+f) {
+		return int32(100 + f), 0, nil
+	}
+	return parakeetBlankID, 1, nil
+}
+
+// batchFrameJoint is frameJoint with a batched joint call.
+type batchFrameJoint struct {
+	frameJoint
+	batchCalls int
+}
+
+func (j *batchFrameJoint) runJointBatch(encoderSteps [][]float32, decoderStep []float32, tokenIDs, durations []int32) error {
+	j.batchCalls++
+	for k, step := range encoderSteps {
+		tokenIDs[k], durations[k], _ = j.decide(step, decoderStep)
+	}
+	return nil
+}
+
+func TestTDTDecodeBatchedJointMatchesPerFrame(t *testing.T) {
+	const frames = 40
+	encoderOutput := make([]float32, frames*parakeetEncoderHidden)
+	for f := 0; f < frames; f++ {
+		encoderOutput[f*parakeetEncoderHidden] = float32(f)
+	}
+	emitAt := map[int]bool{5: true, 30: true}
+
+	perFrame := &frameJoint{emitAt: emitAt}
+	want, err := tdtDecode(encoderOutput, frames, frameDecoder{}, perFrame)
+	if err != nil {
+		t.Fatalf("tdtDecode per frame: %v", err)
+	}
+
+	batched := &batchFrameJoint{frameJoint: frameJoint{emitAt: emitAt}}
+	got, err := tdtDecode(encoderOutput, frames, frameDecoder{}, batched)
+	if err != nil {
+		t.Fatalf("tdtDecode batched: %v", err)
+	}
+
+	if len(got) != 2 || got[0] != 105 || got[1] != 130 {
+		t.Fatalf("batched tokens = %v, want [105 130]", got)
+	}
+	if len(want) != len(got) || want[0] != got[0] || want[1] != got[1] {
+		t.Errorf("batched tokens %v != per-frame tokens %v", got, want)
+	}
+	if batched.calls != 0 {
+		t.Errorf("batched decode made %d per-frame joint calls, want 0", batched.calls)
+	}
+	if batched.batchCalls*2 >= perFrame.calls {
+		t.Errorf("batched decode made %d joint calls, per-frame %d; want well under half", batched.batchCalls, perFrame.calls)
+	}
+}
@@ -0,0 +1,334 @@
+package transcribe
+
+import (
+	"context"
+	"fmt"
+	"log/slog"
+	"sync"
+	"time"
+
+	"github.com/chaz8081/gostt-writer/internal/coreml"
+)
+
+const (
+	// parakeetSamplesPerFrame is the audio covered by one encoder frame
+	// (10ms mel hop × 8x subsampling = 80ms).
+	parakeetSamplesPerFrame = 1280
+
+	// parakeetStreamLookaheadFrames is the right context (~1s) a frame needs
+	// before its tokens are committed. The encoder is full-context, so frames
+	// near the chunk edge change once more audio arrives; they are decoded
+	// tentatively and re-decoded on the next step.
+	parakeetStreamLookaheadFrames = 12
+)
+
+// ParakeetStreamingTranscriber performs chunked streaming transcription with
+// the Parakeet CoreML pipeline. Every stepMs it encodes a chunk of at most
+// lengthMs of audio that starts keepMs before the committed decode position,
+// resumes the TDT decode from the carried LSTM state and position, and commits
+// the frames that have enough right context. The uncommitted tail is decoded
+// from a copy of the state so text appears while the speaker is still talking.
+// Dictations of any length are covered, since only the chunk is encoded.
+type ParakeetStreamingTranscriber struct {
+	p        *ParakeetTranscriber
+	stepMs   int
+	lengthMs int
+	keepMs   int
+	activity ActivityFunc
+
+	mu       sync.Mutex
+	prevText string // text emitted so far (committed plus tentative tail)
+	cancel   context.CancelFunc
+	done     chan struct{}
+}
+
+var _ Streamer = (*ParakeetStreamingTranscriber)(nil)
+
+// NewParakeetStreamingTranscriber creates a streaming transcriber that shares
+// p's models. p must remain open for the lifetime of this transcriber and must
+// not run Process concurrently with a stream.
+func NewParakeetStreamingTranscriber(p *ParakeetTranscriber, stepMs, lengthMs, keepMs int) *ParakeetStreamingTranscriber {
+	return &ParakeetStreamingTranscriber{
+		p:        p,
+		stepMs:   stepMs,
+		lengthMs: lengthMs,
+		keepMs:   keepMs,
+	}
+}
+
+// SetActivity makes the loop skip steps while activityFn reports no new
+// speech. Call before Start.
+func (s *ParakeetStreamingTranscriber) SetActivity(activityFn ActivityFunc) {
+	s.activity = activityFn
+}
+
+// Start begins the streaming loop in the background. It calls audioFn every
+// stepMs milliseconds and calls deltaFn with incremental text updates. After
+// Stop, the remaining audio is committed in one final pass.
+func (s *ParakeetStreamingTranscriber) Start(audioFn AudioFunc, deltaFn DeltaFunc) {
+	ctx, cancel := context.WithCancel(context.Background())
+
+	s.mu.Lock()
+	s.cancel = cancel
+	s.prevText = ""
+	s.done = make(chan struct{})
+	s.mu.Unlock()
+
+	go func() {
+		defer close(s.done)
+		s.run(ctx, audioFn, deltaFn)
+	}()
+}
+
+// Stop signals the streaming loop to stop and waits for the final
+// transcription to complete.
+func (s *ParakeetStreamingTranscriber) Stop() {
+	s.mu.Lock()
+	cancel := s.cancel
+	done := s.done
+	s.mu.Unlock()
+
+	if cancel != nil {
+		cancel()
+	}
+	if done != nil {
+		<-done
+	}
+}
+
+// FinalText returns the accumulated transcription text after Stop() completes.
+func (s *ParakeetStreamingTranscriber) FinalText() string {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	return s.prevText
+}
+
+func (s *ParakeetStreamingTranscriber) run(ctx context.Context, audioFn AudioFunc, deltaFn DeltaFunc) {
+	ticker := time.NewTicker(time.Duration(s.stepMs) * time.Millisecond)
+	defer ticker.Stop()
+
+	st := newParakeetStream(s.lengthMs, s.keepMs)
+	gate := speechGate{activity: s.activity}
+	for {
+		select {
+		case <-ctx.Done():
+			offset := st.offset()
+			text, err := st.step(s.p, audioFn(offset), offset, true)
+			if err != nil {
+				slog.Error("streaming: parakeet final transcribe failed", "error", err)
+				return
+			}
+			s.emit(text, deltaFn)
+			s.p.logStats()
+			slog.Info("streaming: final transcription", "text", text)
+			return
+		case <-ticker.C:
+			offset := st.offset()
+			samples := audioFn(offset)
+			if len(samples) == 0 || gate.skip(offset, samples) {
+				continue
+			}
+
+			start := time.Now()
+			text, err := st.step(s.p, samples, offset, false)
+			elapsed := time.Since(start)
+			if err != nil {
+				slog.Error("streaming: parakeet step failed", "error", err)
+				continue
+			}
+			if elapsed > time.Duration(s.stepMs)*time.Millisecond {
+				slog.Warn("streaming: transcription slower than step interval",
+					"elapsed", elapsed.Round(time.Millisecond),
+					"step_ms", s.stepMs)
+			}
+			s.emit(text, deltaFn)
+		}
+	}
+}
+
+// emit sends the difference between the previously emitted text and text.
+func (s *ParakeetStreamingTranscriber) emit(text string, deltaFn DeltaFunc) {
+	s.mu.Lock()
+	backspaces, appendText := ComputeDelta(s.prevText, text)
+	if backspaces == 0 && appendText == "" {
+		s.mu.Unlock()
+		return
+	}
+	s.prevText = text
+	s.mu.Unlock()
+
+	deltaFn(backspaces, appendText)
+	slog.Debug("streaming: delta", "backspaces", backspaces, "append", appendText)
+}
+
+// parakeetStream is the decode state of one streaming dictation.
+type parakeetStream struct {
+	lengthSamples   int // chunk size, at most one encoder window
+	keepFrames      int // left context re-encoded before the commit position
+	lookaheadFrames int // right context required before frames are committed
+
+	state       *coreml.TDTState // decoder state after the committed tokens
+	commitFrame int              // absolute frame where the committed decode resumes
+	committed   []int32
+}
+
+func newParakeetStream(lengthMs, keepMs int) *parakeetStream {
+	lengthSamples := parakeetSampleRate * lengthMs / 1000
+	if lengthSamples > parakeetMaxSamples || lengthSamples <= 0 {
+		lengthSamples = parakeetMaxSamples
+	}
+	lengthFrames := lengthSamples / parakeetSamplesPerFrame
+	keepFrames := parakeetSampleRate * keepMs / 1000 / parakeetSamplesPerFrame
+
+	// Each chunk must commit at least one frame beyond its context and lookahead
+	if keepFrames > lengthFrames/2 {
+		keepFrames = lengthFrames / 2
+	}
+	lookahead := parakeetStreamLookaheadFrames
+	if limit := (lengthFrames - keepFrames) / 2; lookahead > limit {
+		lookahead = limit
+	}
+
+	return &parakeetStream{
+		lengthSamples:   lengthSamples,
+		keepFrames:      keepFrames,
+		lookaheadFrames: lookahead,
+		state:           coreml.NewTDTState(parakeetTDTConfig),
+	}
+}
+
+// offset returns the first sample the next chunk encodes: keepFrames before
+// the commit position, frame-aligned. Audio before it is no longer needed.
+func (st *parakeetStream) offset() int {
+	startFrame := st.commitFrame - st.keepFrames
+	if startFrame < 0 {
+		startFrame = 0
+	}
+	return startFrame * parakeetSamplesPerFrame
+}
+
+// window returns the sample range to encode next for n samples of audio: up to
+// lengthSamples starting at offset.
+func (st *parakeetStream) window(n int) (start, end int) {
+	start = st.offset()
+	end = start + st.lengthSamples
+	if end > n {
+		end = n
+	}
+	if start > end {
+		start = end
+	}
+	return start, end
+}
+
+// commitLimit returns how many of a chunk's frames can be committed. Frames in
+// the lookahead stay tentative unless the chunk ends the final audio.
+func (st *parakeetStream) commitLimit(frames int, last bool) int {
+	if last {
+		return frames
+	}
+	return frames - st.lookaheadFrames
+}
+
+// step advances the stream over samples, the recording from sample offset
+// onward (offset must not exceed st.offset()), and returns the current text.
+// When final is set, all remaining audio is committed; otherwise the tail is
+// decoded tentatively. Audio that has grown by more than one chunk since the
+// previous step is caught up chunk by chunk.
+func (st *parakeetStream) step(p *ParakeetTranscriber, samples []float32, offset int, final bool) (string, error) {
+	n := offset + len(samples)
+	var tentative []int32
+	for {
+		start, end := st.window(n)
+		if start == end {
+			break
+		}
+		startFrame := start / parakeetSamplesPerFrame
+		lastChunk := end == n
+
+		encoder, frames, err := p.encodeChunk(samples[start-offset : end-offset])
+		if err != nil {
+			return "", fmt.Errorf("parakeet: stream: %w", err)
+		}
+
+		before := st.commitFrame
+		if err := st.decode(p, encoder, frames, startFrame, final && lastChunk); err != nil {
+			return "", fmt.Errorf("parakeet: stream: %w", err)
+		}
+
+		if !lastChunk && st.commitFrame > before {
+			continue
+		}
+		if !final {
+			tail := st.state.Clone()
+			tentative, err = p.tdt.DecodeTensor(encoder, frames, tail)
+			if err != nil {
+				return "", fmt.Errorf("parakeet: stream: decode tail: %w", err)
+			}
+		}
+		break
+	}
+
+	tokens := append(st.committed[:len(st.committed):len(st.committed)], tentative...)
+	return decodeTokens(tokens, p.vocab), nil
+}
+
+// decode resumes the committed decode over a chunk's encoder frames, the
+// first at absolute frame startFrame, and commits the tokens up to the
+// chunk's commit limit.
+func (st *parakeetStream) decode(p *ParakeetTranscriber, encoder *coreml.Tensor, frames, startFrame int, last bool) error {
+	// Rebase the carried decode position onto this chunk's frames
+	st.state.Frame = st.commitFrame - startFrame
+	if limit := st.commitLimit(frames, last); limit > st.state.Frame {
+		tokens, err := p.tdt.DecodeTensor(encoder, limit, st.state)
+		if err != nil {
+			return fmt.Errorf("decode: %w", err)
+		}
+		st.committed = append(st.committed, tokens...)
+		st.commitFrame = startFrame + st.state.Frame
+	}
+	return nil
+}
+
+// nextChunk returns the sample range of the chunk after one that starts at
+// sample start and has frames encoder frames, for a recording of n samples:
+// keepFrames before the first committed frame's position, assuming the
+// decode commits exactly to the limit (it may run a few frames past, which
+// the next decode skips). Lets the next chunk be encoded before this one is
+// decoded.
+func (st *parakeetStream) nextChunk(start, frames, n int) (nextStart, nextEnd int) {
+	startFrame := start/parakeetSamplesPerFrame + st.commitLimit(frames, false) - st.keepFrames
+	nextStart = startFrame * parakeetSamplesPerFrame
+	return nextStart, min(nextStart+st.lengthSamples, n)
+}
+
+// encodeChunk runs the preprocessor and encoder on up to one window of audio
+// and returns the encoder hidden states in their native layout and dtype, plus
+// the number of frames that cover the chunk (frames produced only by padding
+// are excluded). The tensor is the bucket's output backing and is overwritten
+// by the next encode.
+func (p *ParakeetTranscriber) encodeChunk(samples []float32) (*coreml.Tensor, int, error) {
+	b := bucketFor(p.buckets, len(samples))
+	prepResult, err := b.runPreprocessor(samples)
+	if err != nil {
+		return nil, 0, fmt.Errorf("preprocessor: %w", err)
+	}
+
+	encResult, err := b.runEncoder(prepResult)
+	if err != nil {
+		return nil, 0, fmt.Errorf("encoder: %w", err)
+	}
+	return chunkHidden(encResult, len(samples))
+}
+
+// chunkHidden returns the encoder hidden states of a chunk of n samples and
+// the number of frames that cover it: frames produced only by padding are
+// excluded.
+func chunkHidden(encResult *coreml.PredictAllocResult, n int) (*coreml.Tensor, int, error) {
+	encoder, encoderLength, err := encoderHidden(encResult)
+	if err != nil {
+		return nil, 0, err
+	}
+	frames := min((n+parakeetSamplesPerFrame-1)/parakeetSamplesPerFrame, encoderLength)
+	return encoder, frames, nil
+}
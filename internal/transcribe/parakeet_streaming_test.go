@@ -0,0 +1,121 @@
+package transcribe
+
+import (
+	"strings"
+	"testing"
+)
+
+func TestParakeetStreamWindow(t *testing.T) {
+	st := newParakeetStream(10000, 200)
+	if st.lengthSamples != 10*parakeetSampleRate {
+		t.Fatalf("lengthSamples = %d, want %d", st.lengthSamples, 10*parakeetSampleRate)
+	}
+
+	// Short recording: the whole buffer from the start
+	if start, end := st.window(parakeetSampleRate); start != 0 || end != parakeetSampleRate {
+		t.Errorf("window = [%d, %d), want [0, %d)", start, end, parakeetSampleRate)
+	}
+
+	// After committing, the next chunk starts keepFrames before the commit position
+	st.commitFrame = 100
+	start, end := st.window(30 * parakeetSampleRate)
+	if want := (100 - st.keepFrames) * parakeetSamplesPerFrame; start != want || st.offset() != want {
+		t.Errorf("window start = %d, offset = %d, want %d", start, st.offset(), want)
+	}
+	if end-start != st.lengthSamples {
+		t.Errorf("window length = %d, want %d", end-start, st.lengthSamples)
+	}
+
+	// Commit position past the audio (duration overhang): empty window
+	st.commitFrame = 1000
+	if start, end := st.window(parakeetSampleRate); start != end {
+		t.Errorf("window past audio = [%d, %d), want empty", start, end)
+	}
+}
+
+func TestParakeetStreamClampsToWindow(t *testing.T) {
+	st := newParakeetStream(60000, 200)
+	if st.lengthSamples != parakeetMaxSamples {
+		t.Errorf("lengthSamples = %d, want clamp to %d", st.lengthSamples, parakeetMaxSamples)
+	}
+
+	// A tiny chunk must still commit frames past its context and lookahead
+	st = newParakeetStream(1000, 1000)
+	lengthFrames := st.lengthSamples / parakeetSamplesPerFrame
+	if st.keepFrames+st.lookaheadFrames >= lengthFrames {
+		t.Errorf("keep %d + lookahead %d frames leave no progress in a %d-frame chunk",
+			st.keepFrames, st.lookaheadFrames, lengthFrames)
+	}
+}
+
+func TestParakeetStreamCommitLimit(t *testing.T) {
+	st := newParakeetStream(10000, 200)
+	if got := st.commitLimit(100, false); got != 100-parakeetStreamLookaheadFrames {
+		t.Errorf("commitLimit(100, false) = %d, want %d", got, 100-parakeetStreamLookaheadFrames)
+	}
+	if got := st.commitLimit(100, true); got != 100 {
+		t.Errorf("commitLimit(100, true) = %d, want 100", got)
+	}
+}
+
+func TestParakeetStreamNextChunk(t *testing.T) {
+	st := newParakeetStream(parakeetMaxSamples*1000/parakeetSampleRate, parakeetWindowKeepMs)
+	frames := st.lengthSamples / parakeetSamplesPerFrame
+	n := 40 * parakeetSampleRate
+
+	// The next window overlaps this one by the lookahead plus keepFrames, so
+	// it re-encodes the context of the first frame it commits
+	start, end := st.nextChunk(0, frames, n)
+	if want := (frames - st.lookaheadFrames - st.keepFrames) * parakeetSamplesPerFrame; start != want {
+		t.Errorf("next window start = %d, want %d", start, want)
+	}
+	if end-start != st.lengthSamples {
+		t.Errorf("next window length = %d, want %d", end-start, st.lengthSamples)
+	}
+	if start <= 0 || start >= st.lengthSamples {
+		t.Errorf("next window start %d does not overlap [0, %d)", start, st.lengthSamples)
+	}
+
+	// Near the end the window is cut to the recording
+	if _, end := st.nextChunk(n-st.lengthSamples, frames, n); end != n {
+		t.Errorf("last window end = %d, want %d", end, n)
+	}
+}
+
+func TestParakeetStreamingJFK(t *testing.T) {
+	dir := parakeetModelDir(t)
+	samples := jfkSamples(t)
+
+	tr, err := NewParakeetTranscriber(dir)
+	if err != nil {
+		t.Fatalf("NewParakeetTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+
+	// Feed the recording in 1s increments, as Recorder.SnapshotFrom would grow
+	st := newParakeetStream(5000, 200)
+	var partials int
+	for n := parakeetSampleRate; n < len(samples); n += parakeetSampleRate {
+		offset := st.offset()
+		text, err := st.step(tr, samples[offset:n], offset, false)
+		if err != nil {
+			t.Fatalf("step at %d samples: %v", n, err)
+		}
+		if text != "" {
+			partials++
+		}
+	}
+	offset := st.offset()
+	text, err := st.step(tr, samples[offset:], offset, true)
+	if err != nil {
+		t.Fatalf("final step: %v", err)
+	}
+
+	t.Logf("Streamed transcript: %q (%d partial updates)", text, partials)
+	if partials == 0 {
+		t.Error("expected partial text before the final step")
+	}
+	if !strings.Contains(strings.ToLower(text), "ask not what your country") {
+		t.Errorf("expected transcript to contain 'ask not what your country', got: %q", text)
+	}
+}
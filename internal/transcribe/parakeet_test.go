@@ -5,6 +5,8 @@ import (
 	"path/filepath"
 	"strings"
 	"testing"
+
+	"github.com/chaz8081/gostt-writer/internal/coreml"
 )
 
 // parakeetModelDir returns the path to the parakeet model directory, skipping if not found.
@@ -17,44 +19,6 @@ func parakeetModelDir(t *testing.T) string {
 	return dir
 }
 
-func TestPadAudioShorter(t *testing.T) {
-	input := []float32{1.0, 2.0, 3.0}
-	result := padAudio(input, 5)
-	if len(result) != 5 {
-		t.Fatalf("padAudio len = %d, want 5", len(result))
-	}
-	// Original values preserved
-	if result[0] != 1.0 || result[1] != 2.0 || result[2] != 3.0 {
-		t.Errorf("original values not preserved: %v", result[:3])
-	}
-	// Padding is zero
-	if result[3] != 0.0 || result[4] != 0.0 {
-		t.Errorf("padding not zero: %v", result[3:])
-	}
-}
-
-func TestPadAudioExact(t *testing.T) {
-	input := []float32{1.0, 2.0, 3.0}
-	result := padAudio(input, 3)
-	if len(result) != 3 {
-		t.Fatalf("padAudio len = %d, want 3", len(result))
-	}
-	if result[0] != 1.0 || result[1] != 2.0 || result[2] != 3.0 {
-		t.Errorf("values changed: %v", result)
-	}
-}
-
-func TestPadAudioLonger(t *testing.T) {
-	input := []float32{1.0, 2.0, 3.0, 4.0, 5.0}
-	result := padAudio(input, 3)
-	if len(result) != 3 {
-		t.Fatalf("padAudio len = %d, want 3", len(result))
-	}
-	if result[0] != 1.0 || result[1] != 2.0 || result[2] != 3.0 {
-		t.Errorf("truncated values wrong: %v", result)
-	}
-}
-
 func TestNewParakeetTranscriber(t *testing.T) {
 	dir := parakeetModelDir(t)
 
@@ -77,9 +41,9 @@ func TestParakeetProcessJFK(t *testing.T) {
 	}
 	defer func() { _ = tr.Close() }()
 
-	// Debug: run preprocessor manually
-	padded := padAudio(samples, parakeetMaxSamples)
-	prepResult, err := tr.runPreprocessor(padded)
+	// Debug: run preprocessor manually (full-window bucket)
+	full := tr.buckets[len(tr.buckets)-1]
+	prepResult, err := full.runPreprocessor(samples)
 	if err != nil {
 		t.Fatalf("runPreprocessor: %v", err)
 	}
@@ -89,7 +53,7 @@ func TestParakeetProcessJFK(t *testing.T) {
 	}
 
 	// Debug: run encoder manually
-	encResult, err := tr.runEncoder(prepResult)
+	encResult, err := full.runEncoder(prepResult)
 	if err != nil {
 		t.Fatalf("runEncoder: %v", err)
 	}
@@ -114,9 +78,6 @@ func TestParakeetProcessJFK(t *testing.T) {
 	}
 	t.Logf("Encoder output: %d/%d non-zero values", nonZero, len(encoderOutput))
 
-	prepResult.Close()
-	encResult.Close()
-
 	// Now run full process
 	text, err := tr.Process(samples)
 	if err != nil {
@@ -130,3 +91,182 @@ func TestParakeetProcessJFK(t *testing.T) {
 		t.Errorf("expected transcript to contain 'ask not what your country', got: %q", text)
 	}
 }
+
+func TestParakeetProcessAcrossWindows(t *testing.T) {
+	dir := parakeetModelDir(t)
+	jfk := jfkSamples(t)
+
+	tr, err := NewParakeetTranscriber(dir)
+	if err != nil {
+		t.Fatalf("NewParakeetTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+
+	// Lead in with silence so the speech crosses the 15s window boundary,
+	// and the recording needs more than one window
+	samples := make([]float32, 8*parakeetSampleRate, 8*parakeetSampleRate+len(jfk)+4*parakeetSampleRate)
+	samples = append(samples, jfk...)
+	samples = append(samples, make([]float32, 4*parakeetSampleRate)...)
+	if len(samples) <= parakeetMaxSamples {
+		t.Fatalf("test audio is %d samples, want more than one window (%d)", len(samples), parakeetMaxSamples)
+	}
+
+	text, err := tr.Process(samples)
+	if err != nil {
+		t.Fatalf("Process: %v", err)
+	}
+	t.Logf("Transcript: %q", text)
+
+	lower := strings.ToLower(text)
+	for _, phrase := range []string{"ask not what your country can do for you", "ask what you can do for your country"} {
+		if !strings.Contains(lower, phrase) {
+			t.Errorf("expected transcript to contain %q, got: %q", phrase, text)
+		}
+	}
+}
+
+func TestParakeetDecodeStepAllocs(t *testing.T) {
+	dir := parakeetModelDir(t)
+
+	tr, err := NewParakeetTranscriber(dir)
+	if err != nil {
+		t.Fatalf("NewParakeetTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+	ref := newReferenceDecoder(tr)
+	defer ref.Close()
+
+	encoderStep := make([]float32, parakeetEncoderHidden)
+	lstmStateSize := parakeetLSTMLayers * parakeetDecoderHidden
+	h, c := make([]float32, lstmStateSize), make([]float32, lstmStateSize)
+	decoderOut, h, c, err := ref.runDecoder(int32(parakeetBlankID), h, c)
+	if err != nil {
+		t.Fatalf("runDecoder: %v", err)
+	}
+
+	allocs := testing.AllocsPerRun(20, func() {
+		tokenID, _, err := ref.runJoint(encoderStep, decoderOut)
+		if err != nil {
+			t.Fatalf("runJoint: %v", err)
+		}
+		if decoderOut, h, c, err = ref.runDecoder(tokenID, h, c); err != nil {
+			t.Fatalf("runDecoder: %v", err)
+		}
+	})
+	if allocs != 0 {
+		t.Errorf("decode step allocated %.1f times, want 0", allocs)
+	}
+}
+
+func TestParakeetNativeDecodeAllocs(t *testing.T) {
+	dir := parakeetModelDir(t)
+	samples := jfkSamples(t)
+
+	tr, err := NewParakeetTranscriber(dir)
+	if err != nil {
+		t.Fatalf("NewParakeetTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+
+	full := tr.buckets[len(tr.buckets)-1]
+	prepResult, err := full.runPreprocessor(samples)
+	if err != nil {
+		t.Fatalf("runPreprocessor: %v", err)
+	}
+	encResult, err := full.runEncoder(prepResult)
+	if err != nil {
+		t.Fatalf("runEncoder: %v", err)
+	}
+	encoder, frames, err := encoderHidden(encResult)
+	if err != nil {
+		t.Fatalf("encoderHidden: %v", err)
+	}
+
+	// The transcriber's decoder is reused: after the first decode sizes its
+	// token buffer, decoding a window allocates nothing on the Go side
+	state := coreml.NewTDTState(parakeetTDTConfig)
+	if _, err := tr.tdt.DecodeTensor(encoder, frames, nil); err != nil {
+		t.Fatalf("DecodeTensor: %v", err)
+	}
+	allocs := testing.AllocsPerRun(5, func() {
+		if _, err := tr.tdt.DecodeTensor(encoder, frames, nil); err != nil {
+			t.Fatalf("DecodeTensor: %v", err)
+		}
+		state.Primed, state.Frame = false, 0
+		if _, err := tr.tdt.DecodeTensor(encoder, frames, state); err != nil {
+			t.Fatalf("DecodeTensor with state: %v", err)
+		}
+	})
+	if allocs != 0 {
+		t.Errorf("native decode allocated %.1f times, want 0", allocs)
+	}
+}
+
+func TestParakeetNativeDecodeMatchesReference(t *testing.T) {
+	dir := parakeetModelDir(t)
+	samples := jfkSamples(t)
+
+	tr, err := NewParakeetTranscriber(dir)
+	if err != nil {
+		t.Fatalf("NewParakeetTranscriber: %v", err)
+	}
+	defer func() { _ = tr.Close() }()
+
+	full := tr.buckets[len(tr.buckets)-1]
+	prepResult, err := full.runPreprocessor(samples)
+	if err != nil {
+		t.Fatalf("runPreprocessor: %v", err)
+	}
+
+	encResult, err := full.runEncoder(prepResult)
+	if err != nil {
+		t.Fatalf("runEncoder: %v", err)
+	}
+	encoderOutput, encoderLength, err := tr.extractEncoderOutput(encResult)
+	if err != nil {
+		t.Fatalf("extractEncoderOutput: %v", err)
+	}
+
+	ref := newReferenceDecoder(tr)
+	defer ref.Close()
+	want, err := tdtDecode(encoderOutput, encoderLength, ref, ref)
+	if err != nil {
+		t.Fatalf("tdtDecode: %v", err)
+	}
+	got, err := coreml.TDTGreedyDecode(tr.decoder, tr.joint, encoderOutput, encoderLength, parakeetTDTConfig)
+	if err != nil {
+		t.Fatalf("TDTGreedyDecode: %v", err)
+	}
+
+	// The tensor path reads frames through views of the native encoder output
+	encoder, frames, err := encoderHidden(encResult)
+	if err != nil {
+		t.Fatalf("encoderHidden: %v", err)
+	}
+	gotTensor, err := coreml.TDTGreedyDecodeTensor(tr.decoder, tr.joint, encoder, frames, parakeetTDTConfig)
+	if err != nil {
+		t.Fatalf("TDTGreedyDecodeTensor: %v", err)
+	}
+
+	// The transcriber's reused decoder must match on every decode, not just the first
+	var gotReused []int32
+	for i := 0; i < 2; i++ {
+		tokens, err := tr.tdt.DecodeTensor(encoder, frames, nil)
+		if err != nil {
+			t.Fatalf("DecodeTensor %d: %v", i, err)
+		}
+		gotReused = append(gotReused[:0], tokens...)
+	}
+
+	for name, got := range map[string][]int32{"native": got, "native tensor": gotTensor, "native reused": gotReused} {
+		if len(got) != len(want) {
+			t.Errorf("%s decode emitted %d tokens, reference %d", name, len(got), len(want))
+			continue
+		}
+		for i := range want {
+			if got[i] != want[i] {
+				t.Errorf("%s token[%d] = %d, reference %d", name, i, got[i], want[i])
+			}
+		}
+	}
+}
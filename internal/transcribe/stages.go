@@ -0,0 +1,72 @@
+package transcribe
+
+import (
+	"sync"
+	"time"
+)
+
+// Pipeline stages recorded by a StageTimer.
+const (
+	// Parakeet: mel spectrogram, encoder, and the TDT decoder/joint loop. In
+	// the pipelined multi-window path, StageEncode is the time spent waiting
+	// for an encoder that ran concurrently with the previous decode.
+	StagePreprocess = "preprocess"
+	StageEncode     = "encode"
+	StageDecode     = "decode"
+
+	// Whisper: context creation, whisper.cpp inference (mel, encoder and
+	// decoder are not separable through the bindings), and segment collection.
+	StageContext  = "context"
+	StageInfer    = "infer"
+	StageSegments = "segments"
+)
+
+// StageTimer accumulates the wall time of each pipeline stage across a
+// transcriber's Process calls. Transcribers without a timer (the default)
+// skip the clock reads entirely. Safe for concurrent use.
+type StageTimer struct {
+	mu     sync.Mutex
+	totals map[string]time.Duration
+}
+
+// NewStageTimer returns an empty timer.
+func NewStageTimer() *StageTimer {
+	return &StageTimer{totals: make(map[string]time.Duration)}
+}
+
+// Totals returns the accumulated time per stage since the last Reset.
+func (t *StageTimer) Totals() map[string]time.Duration {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	totals := make(map[string]time.Duration, len(t.totals))
+	for stage, d := range t.totals {
+		totals[stage] = d
+	}
+	return totals
+}
+
+// Reset clears the accumulated times.
+func (t *StageTimer) Reset() {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	clear(t.totals)
+}
+
+// begin returns the start time of a stage, or the zero time on a nil timer.
+func (t *StageTimer) begin() time.Time {
+	if t == nil {
+		return time.Time{}
+	}
+	return time.Now()
+}
+
+// end adds the time since start to stage. A nil timer records nothing.
+func (t *StageTimer) end(stage string, start time.Time) {
+	if t == nil {
+		return
+	}
+	d := time.Since(start)
+	t.mu.Lock()
+	t.totals[stage] += d
+	t.mu.Unlock()
+}
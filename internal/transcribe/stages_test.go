@@ -0,0 +1,38 @@
+package transcribe
+
+import (
+	"testing"
+	"time"
+)
+
+func TestStageTimer(t *testing.T) {
+	timer := NewStageTimer()
+	for i := 0; i < 3; i++ {
+		start := timer.begin()
+		time.Sleep(time.Millisecond)
+		timer.end(StageDecode, start)
+	}
+	timer.end(StageEncode, timer.begin())
+
+	totals := timer.Totals()
+	if len(totals) != 2 {
+		t.Fatalf("Totals() = %v, want 2 stages", totals)
+	}
+	if totals[StageDecode] < 3*time.Millisecond {
+		t.Errorf("decode total = %v, want at least 3ms", totals[StageDecode])
+	}
+
+	timer.Reset()
+	if totals := timer.Totals(); len(totals) != 0 {
+		t.Errorf("Totals() after Reset = %v, want empty", totals)
+	}
+}
+
+func TestStageTimerNil(t *testing.T) {
+	var timer *StageTimer
+	start := timer.begin()
+	if !start.IsZero() {
+		t.Errorf("nil timer begin() = %v, want zero time", start)
+	}
+	timer.end(StageDecode, start) // must not panic
+}
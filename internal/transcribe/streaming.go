@@ -5,7 +5,6 @@ import (
 	"fmt"
 	"io"
 	"log/slog"
-	"strings"
 	"sync"
 	"time"
 
@@ -19,14 +18,19 @@ type StreamResult struct {
 	IsFinal bool   // true for the final transcription after recording stops
 }
 
-// StreamingTranscriber performs sliding-window streaming transcription using
-// whisper.cpp. It periodically transcribes audio snapshots during recording
-// and emits incremental text deltas.
+// StreamingTranscriber performs streaming transcription using whisper.cpp. It
+// periodically transcribes audio snapshots during recording and emits
+// incremental text deltas. By default every step re-transcribes a sliding
+// window of the last lengthMs of audio; in incremental mode stable segments
+// are committed and only the uncommitted tail is transcribed, so step cost
+// stays bounded however long the dictation runs.
 type StreamingTranscriber struct {
-	model    whisper.Model
-	stepMs   int
-	lengthMs int
-	keepMs   int
+	model       whisper.Model
+	stepMs      int
+	lengthMs    int
+	keepMs      int
+	incremental bool
+	activity    ActivityFunc
 
 	mu       sync.Mutex
 	prevText string // accumulated text from previous windows
@@ -34,24 +38,72 @@ type StreamingTranscriber struct {
 	done     chan struct{}
 }
 
-// AudioFunc returns the current audio buffer snapshot (mono 16kHz float32).
-type AudioFunc func() []float32
+// AudioFunc returns the audio recorded from sample offset onward (mono 16kHz
+// float32). Streamers pass the earliest sample they still need. The slice may
+// alias the recorder's buffer: it is read-only and is not retained past the
+// step that requested it.
+type AudioFunc func(offset int) []float32
 
 // DeltaFunc is called with each incremental text update.
 type DeltaFunc func(backspaces int, newText string)
 
+// ActivityFunc reports whether speech was detected in the audio recorded from
+// sample offset onward.
+type ActivityFunc func(offset int) bool
+
+// Streamer transcribes audio while it is being recorded, emitting text deltas.
+// StreamingTranscriber (whisper) and ParakeetStreamingTranscriber implement it.
+type Streamer interface {
+	// Start begins streaming from audioFn, calling deltaFn with each update.
+	Start(audioFn AudioFunc, deltaFn DeltaFunc)
+	// Stop ends streaming and waits for the final transcription.
+	Stop()
+	// FinalText returns the text emitted so far; complete once Stop returns.
+	FinalText() string
+	// SetActivity makes the streamer skip steps while activityFn reports no
+	// new speech. Call before Start; nil (the default) runs every step.
+	SetActivity(activityFn ActivityFunc)
+}
+
+// speechGate skips streaming steps while nobody is speaking: a step runs only
+// if speech arrived after the audio the previous step covered.
+type speechGate struct {
+	activity ActivityFunc
+	seen     int // end of the audio covered by the last step that ran
+}
+
+// skip reports whether a step over samples, the audio from offset onward, can
+// be skipped. When it returns false the step is recorded as run.
+func (g *speechGate) skip(offset int, samples []float32) bool {
+	if g.activity != nil && !g.activity(g.seen) {
+		return true
+	}
+	g.seen = offset + len(samples)
+	return false
+}
+
+var _ Streamer = (*StreamingTranscriber)(nil)
+
 // NewStreamingTranscriber creates a streaming transcriber that shares the
 // given whisper model. The model must remain open for the lifetime of this
-// transcriber.
-func NewStreamingTranscriber(model whisper.Model, stepMs, lengthMs, keepMs int) *StreamingTranscriber {
+// transcriber. When incremental is set, keepMs is unused: continuity comes from
+// prompting each pass with the committed text instead.
+func NewStreamingTranscriber(model whisper.Model, stepMs, lengthMs, keepMs int, incremental bool) *StreamingTranscriber {
 	return &StreamingTranscriber{
-		model:    model,
-		stepMs:   stepMs,
-		lengthMs: lengthMs,
-		keepMs:   keepMs,
+		model:       model,
+		stepMs:      stepMs,
+		lengthMs:    lengthMs,
+		keepMs:      keepMs,
+		incremental: incremental,
 	}
 }
 
+// SetActivity makes the loop skip steps while activityFn reports no new
+// speech. Call before Start.
+func (s *StreamingTranscriber) SetActivity(activityFn ActivityFunc) {
+	s.activity = activityFn
+}
+
 // Start begins the streaming transcription loop. It calls audioFn every
 // stepMs milliseconds to get the current audio, transcribes a sliding window,
 // and calls deltaFn with incremental text updates. Blocks until Stop() is
@@ -97,14 +149,19 @@ func (s *StreamingTranscriber) FinalText() string {
 }
 
 func (s *StreamingTranscriber) run(ctx context.Context, audioFn AudioFunc, deltaFn DeltaFunc) {
+	if s.incremental {
+		s.runIncremental(ctx, audioFn, deltaFn)
+		return
+	}
+
 	ticker := time.NewTicker(time.Duration(s.stepMs) * time.Millisecond)
 	defer ticker.Stop()
 
-	sampleRate := 16000 // whisper expects 16kHz
-	windowSamples := sampleRate * s.lengthMs / 1000
-	keepSamples := sampleRate * s.keepMs / 1000
+	windowSamples := whisperSampleRate * s.lengthMs / 1000
+	keepSamples := whisperSampleRate * s.keepMs / 1000
 
 	var prompt string // context carry-forward from previous window
+	gate := speechGate{activity: s.activity}
 
 	for {
 		select {
@@ -113,8 +170,8 @@ func (s *StreamingTranscriber) run(ctx context.Context, audioFn AudioFunc, delta
 			s.finalTranscribe(audioFn, deltaFn, prompt)
 			return
 		case <-ticker.C:
-			samples := audioFn()
-			if len(samples) == 0 {
+			samples := audioFn(0)
+			if len(samples) == 0 || gate.skip(0, samples) {
 				continue
 			}
 
@@ -152,7 +209,7 @@ func (s *StreamingTranscriber) run(ctx context.Context, audioFn AudioFunc, delta
 
 			// Compute and emit delta
 			s.mu.Lock()
-			backspaces, appendText := computeDelta(s.prevText, text)
+			backspaces, appendText := ComputeDelta(s.prevText, text)
 			if backspaces > 0 || appendText != "" {
 				s.prevText = text
 				s.mu.Unlock()
@@ -168,8 +225,65 @@ func (s *StreamingTranscriber) run(ctx context.Context, audioFn AudioFunc, delta
 	}
 }
 
+// runIncremental is the incremental streaming loop: each step transcribes
+// only the audio after the last committed segment.
+func (s *StreamingTranscriber) runIncremental(ctx context.Context, audioFn AudioFunc, deltaFn DeltaFunc) {
+	ticker := time.NewTicker(time.Duration(s.stepMs) * time.Millisecond)
+	defer ticker.Stop()
+
+	st := newWhisperStream(s.lengthMs)
+	gate := speechGate{activity: s.activity}
+	for {
+		select {
+		case <-ctx.Done():
+			text, err := st.step(s.transcribeSegments, audioFn(st.offset), true)
+			if err != nil {
+				slog.Error("streaming: final transcribe failed", "error", err)
+				return
+			}
+			s.emit(text, deltaFn)
+			slog.Info("streaming: final transcription", "text", text)
+			return
+		case <-ticker.C:
+			samples := audioFn(st.offset)
+			if len(samples) == 0 || gate.skip(st.offset, samples) {
+				continue
+			}
+
+			start := time.Now()
+			text, err := st.step(s.transcribeSegments, samples, false)
+			elapsed := time.Since(start)
+			if err != nil {
+				slog.Error("streaming: transcribe step failed", "error", err)
+				continue
+			}
+			if elapsed > time.Duration(s.stepMs)*time.Millisecond {
+				slog.Warn("streaming: transcription slower than step interval",
+					"elapsed", elapsed.Round(time.Millisecond),
+					"step_ms", s.stepMs)
+			}
+			s.emit(text, deltaFn)
+		}
+	}
+}
+
+// emit sends the difference between the previously emitted text and text.
+func (s *StreamingTranscriber) emit(text string, deltaFn DeltaFunc) {
+	s.mu.Lock()
+	backspaces, appendText := ComputeDelta(s.prevText, text)
+	if backspaces == 0 && appendText == "" {
+		s.mu.Unlock()
+		return
+	}
+	s.prevText = text
+	s.mu.Unlock()
+
+	deltaFn(backspaces, appendText)
+	slog.Debug("streaming: delta", "backspaces", backspaces, "append", appendText)
+}
+
 func (s *StreamingTranscriber) finalTranscribe(audioFn AudioFunc, deltaFn DeltaFunc, prompt string) {
-	samples := audioFn()
+	samples := audioFn(0)
 	if len(samples) == 0 {
 		return
 	}
@@ -185,7 +299,7 @@ func (s *StreamingTranscriber) finalTranscribe(audioFn AudioFunc, deltaFn DeltaF
 	}
 
 	s.mu.Lock()
-	backspaces, appendText := computeDelta(s.prevText, text)
+	backspaces, appendText := ComputeDelta(s.prevText, text)
 	s.prevText = text
 	s.mu.Unlock()
 
@@ -197,9 +311,19 @@ func (s *StreamingTranscriber) finalTranscribe(audioFn AudioFunc, deltaFn DeltaF
 }
 
 func (s *StreamingTranscriber) transcribeWindow(samples []float32, prompt string) (string, error) {
+	segments, err := s.transcribeSegments(samples, prompt)
+	if err != nil {
+		return "", err
+	}
+	return segmentText(segments), nil
+}
+
+// transcribeSegments runs whisper on samples and returns its segments with
+// their end offsets in samples.
+func (s *StreamingTranscriber) transcribeSegments(samples []float32, prompt string) ([]whisperSegment, error) {
 	ctx, err := s.model.NewContext()
 	if err != nil {
-		return "", fmt.Errorf("streaming: create context: %w", err)
+		return nil, fmt.Errorf("streaming: create context: %w", err)
 	}
 
 	if prompt != "" {
@@ -207,20 +331,23 @@ func (s *StreamingTranscriber) transcribeWindow(samples []float32, prompt string
 	}
 
 	if err := ctx.Process(samples, nil, nil, nil); err != nil {
-		return "", fmt.Errorf("streaming: process: %w", err)
+		return nil, fmt.Errorf("streaming: process: %w", err)
 	}
 
-	var segments []string
+	var segments []whisperSegment
 	for {
 		seg, err := ctx.NextSegment()
 		if err == io.EOF {
 			break
 		}
 		if err != nil {
-			return "", fmt.Errorf("streaming: next segment: %w", err)
+			return nil, fmt.Errorf("streaming: next segment: %w", err)
 		}
-		segments = append(segments, seg.Text)
+		segments = append(segments, whisperSegment{
+			text: seg.Text,
+			end:  int(seg.End.Milliseconds()) * whisperSampleRate / 1000,
+		})
 	}
 
-	return strings.TrimSpace(strings.Join(segments, " ")), nil
+	return segments, nil
 }
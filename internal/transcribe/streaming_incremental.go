@@ -0,0 +1,152 @@
+package transcribe
+
+import "strings"
+
+const (
+	// whisperSampleRate is the input rate whisper.cpp expects.
+	whisperSampleRate = 16000
+
+	// whisperStreamLookaheadMs is the right context a segment needs before it
+	// is committed in incremental mode. Segments ending closer to the end of
+	// the audio may still change once more speech arrives.
+	whisperStreamLookaheadMs = 1000
+
+	// whisperPromptChars bounds the committed text carried into the next pass
+	// as the initial prompt (whisper keeps at most half its text context).
+	whisperPromptChars = 200
+)
+
+// whisperSegment is one decoded whisper segment. end is where the segment
+// ends, in samples from the start of the audio that was transcribed.
+type whisperSegment struct {
+	text string
+	end  int
+}
+
+// segmentFunc transcribes samples, prompted with the preceding text.
+type segmentFunc func(samples []float32, prompt string) ([]whisperSegment, error)
+
+// whisperStream is the state of one incremental whisper dictation. Segments
+// that end at least lookaheadSamples before the end of the audio are committed
+// and their audio is dropped, so each step transcribes only the uncommitted
+// tail (at most windowSamples), prompted with the end of the committed text.
+type whisperStream struct {
+	windowSamples    int // most uncommitted audio transcribed in one pass
+	lookaheadSamples int // right context required before a segment is committed
+
+	offset    int    // absolute sample where the uncommitted audio starts
+	committed string // text of the committed segments
+}
+
+func newWhisperStream(lengthMs int) *whisperStream {
+	windowSamples := whisperSampleRate * lengthMs / 1000
+	lookahead := whisperSampleRate * whisperStreamLookaheadMs / 1000
+	if lookahead > windowSamples/2 {
+		lookahead = windowSamples / 2
+	}
+	return &whisperStream{
+		windowSamples:    windowSamples,
+		lookaheadSamples: lookahead,
+	}
+}
+
+// step advances the stream over samples, the recording from st.offset onward,
+// and returns the current text. When final is set, all remaining audio is
+// committed; otherwise the uncommitted tail is transcribed tentatively. A tail
+// longer than one window is caught up window by window.
+func (st *whisperStream) step(transcribe segmentFunc, samples []float32, final bool) (string, error) {
+	var tentative string
+	for len(samples) > 0 {
+		chunk := samples
+		if len(chunk) > st.windowSamples {
+			chunk = chunk[:st.windowSamples]
+		}
+		last := len(chunk) == len(samples)
+
+		segs, err := transcribe(chunk, st.prompt())
+		if err != nil {
+			return "", err
+		}
+
+		n, end := st.stable(segs, len(chunk), final && last)
+		st.committed = joinText(st.committed, segmentText(segs[:n]))
+		st.offset += end
+		samples = samples[end:]
+		tentative = segmentText(segs[n:])
+
+		if last || end == 0 {
+			break
+		}
+	}
+	return joinText(st.committed, tentative), nil
+}
+
+// stable returns how many leading segments of a pass over n samples can be
+// committed, and how many samples they cover. A pass that fills the window
+// always commits, so the tail never grows past one window.
+func (st *whisperStream) stable(segs []whisperSegment, n int, all bool) (count, end int) {
+	if all {
+		return len(segs), n
+	}
+
+	limit := n - st.lookaheadSamples
+	for count < len(segs) && segs[count].end <= limit {
+		count++
+	}
+
+	switch {
+	case count > 0:
+	case n < st.windowSamples:
+		if len(segs) == 0 && limit > 0 {
+			return 0, limit // silence: drop it, keeping the lookahead
+		}
+		return 0, 0
+	case len(segs) > 1:
+		count = len(segs) - 1
+	default:
+		return len(segs), n
+	}
+
+	end = segs[count-1].end
+	if end > n {
+		end = n
+	}
+	if end <= 0 {
+		// No usable timestamps: drop the whole pass rather than stall
+		return len(segs), n
+	}
+	return count, end
+}
+
+// prompt returns the end of the committed text, cut at a word boundary.
+func (st *whisperStream) prompt() string {
+	p := st.committed
+	if len(p) > whisperPromptChars {
+		p = p[len(p)-whisperPromptChars:]
+		if i := strings.IndexByte(p, ' '); i >= 0 {
+			p = p[i+1:]
+		}
+	}
+	return p
+}
+
+// segmentText joins segment texts with single spaces.
+func segmentText(segs []whisperSegment) string {
+	var text string
+	for _, seg := range segs {
+		text = joinText(text, seg.text)
+	}
+	return text
+}
+
+// joinText joins two pieces of transcript with one space, skipping empties.
+func joinText(a, b string) string {
+	a, b = strings.TrimSpace(a), strings.TrimSpace(b)
+	switch {
+	case a == "":
+		return b
+	case b == "":
+		return a
+	}
+	return a + " " + b
+}
@@ -0,0 +1,139 @@
+package transcribe
+
+import "testing"
+
+// fakeSegments returns a segmentFunc that splits audio into one segment per
+// segSamples, recording the length and prompt of every pass.
+func fakeSegments(segSamples int, passes *[]int, prompts *[]string) segmentFunc {
+	return func(samples []float32, prompt string) ([]whisperSegment, error) {
+		*passes = append(*passes, len(samples))
+		*prompts = append(*prompts, prompt)
+		var segs []whisperSegment
+		for end := segSamples; end-segSamples < len(samples); end += segSamples {
+			if end > len(samples) {
+				end = len(samples)
+			}
+			segs = append(segs, whisperSegment{text: " word", end: end})
+		}
+		return segs, nil
+	}
+}
+
+func TestWhisperStreamCommitsStableSegments(t *testing.T) {
+	st := newWhisperStream(10000)
+	var passes []int
+	var prompts []string
+	transcribe := fakeSegments(whisperSampleRate, &passes, &prompts)
+
+	// 3.5s of audio: segments end at 1s, 2s, 3s and 3.5s; only those with
+	// 1s of right context (1s, 2s) are committed
+	text, err := st.step(transcribe, make([]float32, 3*whisperSampleRate+whisperSampleRate/2), false)
+	if err != nil {
+		t.Fatalf("step: %v", err)
+	}
+	if text != "word word word word" {
+		t.Errorf("text = %q, want 4 words", text)
+	}
+	if st.offset != 2*whisperSampleRate {
+		t.Errorf("offset = %d, want %d", st.offset, 2*whisperSampleRate)
+	}
+	if st.committed != "word word" {
+		t.Errorf("committed = %q, want %q", st.committed, "word word")
+	}
+
+	// The next pass covers only the uncommitted tail and is prompted
+	_, err = st.step(transcribe, make([]float32, 2*whisperSampleRate), false)
+	if err != nil {
+		t.Fatalf("step: %v", err)
+	}
+	if passes[1] != 2*whisperSampleRate {
+		t.Errorf("second pass transcribed %d samples, want %d", passes[1], 2*whisperSampleRate)
+	}
+	if prompts[1] != "word word" {
+		t.Errorf("second pass prompt = %q, want committed text", prompts[1])
+	}
+}
+
+func TestWhisperStreamBoundsPassToWindow(t *testing.T) {
+	st := newWhisperStream(5000)
+	var passes []int
+	var prompts []string
+
+	// One segment spanning everything never has right context; a full window
+	// must still commit so the next pass does not grow
+	long := func(samples []float32, prompt string) ([]whisperSegment, error) {
+		passes = append(passes, len(samples))
+		prompts = append(prompts, prompt)
+		return []whisperSegment{{text: "long", end: len(samples)}}, nil
+	}
+	if _, err := st.step(long, make([]float32, 12*whisperSampleRate), false); err != nil {
+		t.Fatalf("step: %v", err)
+	}
+	for i, n := range passes {
+		if n > st.windowSamples {
+			t.Errorf("pass %d transcribed %d samples, window is %d", i, n, st.windowSamples)
+		}
+	}
+	if st.offset != 10*whisperSampleRate {
+		t.Errorf("offset = %d, want two full windows committed (%d)", st.offset, 10*whisperSampleRate)
+	}
+}
+
+func TestWhisperStreamFinalCommitsAll(t *testing.T) {
+	st := newWhisperStream(10000)
+	var passes []int
+	var prompts []string
+	transcribe := fakeSegments(whisperSampleRate, &passes, &prompts)
+
+	samples := make([]float32, 2*whisperSampleRate+whisperSampleRate/2)
+	text, err := st.step(transcribe, samples, true)
+	if err != nil {
+		t.Fatalf("step: %v", err)
+	}
+	if text != "word word word" || st.committed != text {
+		t.Errorf("text = %q, committed = %q, want all 3 words committed", text, st.committed)
+	}
+	if st.offset != len(samples) {
+		t.Errorf("offset = %d, want %d", st.offset, len(samples))
+	}
+}
+
+func TestWhisperStreamDropsSilence(t *testing.T) {
+	st := newWhisperStream(10000)
+	silence := func([]float32, string) ([]whisperSegment, error) { return nil, nil }
+
+	if _, err := st.step(silence, make([]float32, 3*whisperSampleRate), false); err != nil {
+		t.Fatalf("step: %v", err)
+	}
+	if want := 3*whisperSampleRate - st.lookaheadSamples; st.offset != want {
+		t.Errorf("offset = %d, want %d (silence dropped up to the lookahead)", st.offset, want)
+	}
+}
+
+func TestWhisperStreamPromptCutsAtWord(t *testing.T) {
+	st := &whisperStream{}
+	for len(st.committed) <= whisperPromptChars {
+		st.committed = joinText(st.committed, "lorem ipsum")
+	}
+	p := st.prompt()
+	if len(p) > whisperPromptChars {
+		t.Errorf("prompt length = %d, want <= %d", len(p), whisperPromptChars)
+	}
+	if p[:5] != "lorem" && p[:5] != "ipsum" {
+		t.Errorf("prompt %q does not start at a word boundary", p)
+	}
+}
+
+func TestJoinText(t *testing.T) {
+	tests := []struct{ a, b, want string }{
+		{"", " hello", "hello"},
+		{"hello ", "", "hello"},
+		{" hello", " world ", "hello world"},
+		{"", "", ""},
+	}
+	for _, tt := range tests {
+		if got := joinText(tt.a, tt.b); got != tt.want {
+			t.Errorf("joinText(%q, %q) = %q, want %q", tt.a, tt.b, got, tt.want)
+		}
+	}
+}
@@ -90,7 +90,7 @@ func TestComputeDelta(t *testing.T) {
 
 	for _, tt := range tests {
 		t.Run(tt.name, func(t *testing.T) {
-			backspaces, appendText := computeDelta(tt.prev, tt.new)
+			backspaces, appendText := ComputeDelta(tt.prev, tt.new)
 			if backspaces != tt.wantBackspaces {
 				t.Errorf("backspaces = %d, want %d", backspaces, tt.wantBackspaces)
 			}
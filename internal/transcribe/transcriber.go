@@ -7,6 +7,7 @@ package transcribe
 
 import (
 	"fmt"
+	"log/slog"
 
 	"github.com/chaz8081/gostt-writer/internal/config"
 )
@@ -23,7 +24,16 @@ type Transcriber interface {
 func New(cfg *config.TranscribeConfig) (Transcriber, error) {
 	switch cfg.Backend {
 	case "parakeet":
-		return NewParakeetTranscriber(cfg.ParakeetModelDir)
+		p, err := NewParakeetTranscriber(cfg.ParakeetModelDir)
+		if err != nil {
+			return nil, err
+		}
+		if cfg.Prewarm {
+			if err := p.Prewarm(); err != nil {
+				slog.Warn("transcribe: prewarm failed, first dictation may be slow", "error", err)
+			}
+		}
+		return p, nil
 	case "whisper", "":
 		return NewWhisperTranscriber(cfg.ModelPath)
 	default:
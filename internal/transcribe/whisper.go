@@ -10,7 +10,8 @@ import (
 
 // WhisperTranscriber wraps a whisper.cpp model for speech-to-text.
 type WhisperTranscriber struct {
-	model whisper.Model
+	model  whisper.Model
+	stages *StageTimer // per-stage timing, nil unless benchmarking
 }
 
 // NewWhisperTranscriber loads a whisper model from the given path.
@@ -37,17 +38,29 @@ func (t *WhisperTranscriber) Close() error {
 	return nil
 }
 
+// SetStageTimer makes Process record its context, inference and segment times
+// into st. Pass nil to stop timing. Must not be called during Process.
+func (t *WhisperTranscriber) SetStageTimer(st *StageTimer) {
+	t.stages = st
+}
+
 // Process transcribes mono 16kHz float32 audio samples to text.
 func (t *WhisperTranscriber) Process(samples []float32) (string, error) {
+	start := t.stages.begin()
 	ctx, err := t.model.NewContext()
 	if err != nil {
 		return "", fmt.Errorf("transcribe: create context: %w", err)
 	}
+	t.stages.end(StageContext, start)
 
+	start = t.stages.begin()
 	if err := ctx.Process(samples, nil, nil, nil); err != nil {
 		return "", fmt.Errorf("transcribe: process: %w", err)
 	}
+	t.stages.end(StageInfer, start)
 
+	start = t.stages.begin()
+	defer t.stages.end(StageSegments, start)
 	var segments []string
 	for {
 		seg, err := ctx.NextSegment()